@@ -29,62 +29,73 @@
 NEMIVER_BEGIN_NAMESPACE (nemiver)
 NEMIVER_BEGIN_NAMESPACE (common)
 
-Address::Address ()
+Address::Address () :
+    m_value (0),
+    m_is_set (false)
 {
 }
 
-Address::Address (const std::string &a)
+Address::Address (const std::string &a) :
+    m_value (0),
+    m_is_set (false)
+{
+    *this = a;
+}
+
+/// Build an address from its numeric value.  Its textual form, in
+/// hexadecimal, is only produced by the first call to to_string.
+Address::Address (size_t a_value) :
+    m_value (a_value),
+    m_is_set (true)
 {
-    string str = a;
-    str_utils::chomp (str);
-    if (!str.empty () && !str_utils::string_is_number (str)) {
-        stringstream msg;
-        msg << "Invalid address format: " << str;
-        THROW (msg.str ());
-    }
-    m_addr = str;
 }
 
 Address::Address (const Address &a_other) :
-    m_addr (a_other.m_addr)
+    m_addr (a_other.m_addr),
+    m_value (a_other.m_value),
+    m_is_set (a_other.m_is_set)
 {
 }
 
 bool
 Address::empty () const
 {
-    return m_addr.empty ();
+    return !m_is_set;
 }
 
 const std::string&
 Address::to_string () const
 {
+    if (m_is_set && m_addr.empty ()) {
+        std::ostringstream os;
+        os << "0x" << std::hex << m_value;
+        m_addr = os.str ();
+    }
     return m_addr;
 }
 
 Address::operator size_t () const
 {
-    if (m_addr.empty ())
-        return 0;
-    return str_utils::hexa_to_int (m_addr);
+    return m_value;
 }
 
 
 size_t
 Address::size () const
 {
-    if (m_addr.empty ())
+    const std::string &addr = to_string ();
+    if (addr.empty ())
         return 0;
     int suffix_len = 0;
-    if (m_addr[0] == '0' && m_addr[1] == 'x')
+    if (addr[0] == '0' && addr[1] == 'x')
         suffix_len = 2;
-    return m_addr.size () - suffix_len;
+    return addr.size () - suffix_len;
 }
 
 size_t
 Address::string_size () const
 {
-    return m_addr.size ();
+    return to_string ().size ();
 }
 
 Address&
@@ -99,61 +110,65 @@ Address::operator= (const std::string &a_addr)
         THROW (msg.str ());
     }
     m_addr = addr;
+    m_is_set = !addr.empty ();
+    m_value = m_is_set ? str_utils::hexa_to_int (addr) : 0;
     return *this;
 }
 
 bool
 Address::operator< (const Address &a_addr) const
 {
-  return ((size_t) *this < (size_t) a_addr);
+  return m_value < a_addr.m_value;
 }
 
 bool
 Address::operator> (const Address &a_addr) const
 {
-  return ((size_t) *this > (size_t) a_addr);
+  return m_value > a_addr.m_value;
 }
 
 bool
 Address::operator>= (const Address &a_addr) const
 {
-  return ((size_t) *this >= (size_t) a_addr);
+  return m_value >= a_addr.m_value;
 }
 
 bool
 Address::operator<= (const Address &a_addr) const
 {
-  return ((size_t) *this <= (size_t) a_addr);
+  return m_value <= a_addr.m_value;
 }
 
 bool
 Address::operator== (const Address &a_addr) const
 {
-  return ((size_t) *this == (size_t)a_addr);
+  return m_value == a_addr.m_value;
 }
 
 const char&
 Address::operator[] (size_t a_index) const
 {
-    return m_addr[a_index];
+    return to_string ()[a_index];
 }
 
 void
 Address::clear ()
 {
     m_addr.clear ();
+    m_value = 0;
+    m_is_set = false;
 }
 
 bool
 Address::operator== (const std::string &a_addr) const
 {
-    return m_addr == a_addr;
+    return to_string () == a_addr;
 }
 
 bool
 Address::operator== (size_t a_addr) const
 {
-    return (size_t) *this == a_addr;
+    return m_value == a_addr;
 }
 
 NEMIVER_END_NAMESPACE (common)
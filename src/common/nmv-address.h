@@ -31,13 +31,25 @@
 NEMIVER_BEGIN_NAMESPACE (nemiver)
 NEMIVER_BEGIN_NAMESPACE (common)
 
+/// The address of a byte in the inferior.
+///
+/// The address is parsed once, when it is set, so comparing
+/// addresses and converting them to size_t costs no more than
+/// comparing integers.  Addresses can thus be sorted and used as
+/// keys of maps cheaply.  The textual form of an address built from
+/// an integer is only produced when it is asked for.
 class NEMIVER_API Address
 {
-    std::string m_addr;
+    // The textual form of the address.  Empty until to_string is
+    // called if the address was built from an integer.
+    mutable std::string m_addr;
+    size_t m_value;
+    bool m_is_set;
 
 public:
     Address ();
     explicit Address (const std::string &a_addr);
+    explicit Address (size_t a_value);
     Address (const Address &);
     bool empty () const;
     const std::string& to_string () const;
@@ -30,6 +30,7 @@
 #include "nmv-namespace.h"
 #include "nmv-api-macros.h"
 #include "nmv-exception.h"
+#include "nmv-address.h"
 
 NEMIVER_BEGIN_NAMESPACE (nemiver)
 NEMIVER_BEGIN_NAMESPACE (common)
@@ -39,8 +40,10 @@ NEMIVER_BEGIN_NAMESPACE (common)
 /// the function the instruction is from, offset of the instruction
 /// starting from the beginning of the function, and the instruction
 /// itself, represented by a string.
+/// The address is parsed once, when the instruction is built, so
+/// instructions can be ordered by address cheaply.
 class AsmInstr {
-  string m_address;
+  Address m_address;
   string m_func;
   string m_offset;
   string m_instr;
@@ -65,8 +68,8 @@ class AsmInstr {
     {
     }
 
-  const string& address () const {return m_address;}
-  void address (string &a) {m_address = a;}
+  const Address& address () const {return m_address;}
+  void address (const Address &a) {m_address = a;}
 
   const string& function () const {return m_func;}
   void function (const string &a_str) {m_func = a_str;}
@@ -152,7 +155,7 @@ class Asm {
   {
     switch (which ()) {
     case TYPE_PURE: {
-      const AsmInstr instr = boost::get<AsmInstr> (m_asm);
+      const AsmInstr &instr = boost::get<AsmInstr> (m_asm);
       return instr.address ().empty ();
     }
       break;
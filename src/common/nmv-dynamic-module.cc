@@ -30,9 +30,12 @@
  *
  */
 #include "config.h"
+#include <sys/stat.h>
+#include <cstring>
 #include <string>
 #include <map>
 #include <glibmm.h>
+#include <glib/gstdio.h>
 #include "nmv-exception.h"
 #include "nmv-dynamic-module.h"
 #include "nmv-libxml-utils.h"
@@ -79,9 +82,346 @@ ModuleRegistry::put_library_into_cache (const UString a_name,
     m_priv->library_cache[a_name] = a_library;
 }
 
+/// \return the path of the config file of the module a_module_name
+/// in the directory a_dir.
+static string
+module_config_file_path (const UString &a_dir, const string &a_module_name)
+{
+    vector<string> path_elements;
+    path_elements.push_back (a_dir.raw ());
+    path_elements.push_back (a_module_name + ".conf");
+    return Glib::build_filename (path_elements);
+}
+
+/// A registry of the modules found so far, saved across runs.
+///
+/// It maps the config search paths and the name of each module to
+/// the path of its config file, the config parsed from it, and the
+/// path of its library.  It is saved in the user's nemiver directory
+/// so that neither are the XML module config files parsed, nor the
+/// library search paths walked, at each start up.  An entry is valid
+/// as long as the modification time (to the nanosecond) and the size
+/// of its config file don't change, no config search path that comes
+/// before the directory of that file got a config file for the
+/// module, and its library is still there.  The registry is a binary
+/// file in the byte order of the host; if it can't be read, it is
+/// just rebuilt.  It is written each time an entry changes, which
+/// only happens when a module is found for the first time or its
+/// files changed.
+class ModuleConfigCache {
+    /// The config search paths, joined by join_paths, and the name
+    /// of the module.
+    typedef pair<string, string> Key;
+
+    struct Entry {
+        string config_path;
+        gint64 mtime_sec;
+        gint64 mtime_nsec;
+        gint64 size;
+        UString library_name;
+        vector<UString> custom_library_search_paths;
+        UString library_path;
+
+        Entry () :
+            mtime_sec (0),
+            mtime_nsec (0),
+            size (0)
+        {}
+    };//end struct Entry
+
+    Glib::Mutex mutex;
+    map<Key, Entry> entries;
+    bool loaded;
+
+    ModuleConfigCache () :
+        loaded (false)
+    {}
+
+    static const string&
+    magic ()
+    {
+        static const string s_magic ("NMVMODC\3", 8);
+        return s_magic;
+    }
+
+    static string
+    cache_file_path ()
+    {
+        return Glib::build_filename (env::get_user_db_dir ().raw (),
+                                     "modules.cache");
+    }
+
+    /// \return the config search paths a_paths, as one string.
+    static string
+    join_paths (const vector<UString> &a_paths)
+    {
+        string result;
+        for (vector<UString>::const_iterator it = a_paths.begin ();
+             it != a_paths.end ();
+             ++it) {
+            result += it->raw ();
+            result += '\0';
+        }
+        return result;
+    }
+
+    static void
+    write_uint (string &a_out, guint32 a_value)
+    {
+        a_out.append (reinterpret_cast<const char*> (&a_value),
+                      sizeof (a_value));
+    }
+
+    static void
+    write_int64 (string &a_out, gint64 a_value)
+    {
+        a_out.append (reinterpret_cast<const char*> (&a_value),
+                      sizeof (a_value));
+    }
+
+    static void
+    write_string (string &a_out, const string &a_value)
+    {
+        write_uint (a_out, a_value.size ());
+        a_out.append (a_value);
+    }
+
+    template<class T>
+    static bool
+    read_pod (const string &a_in, string::size_type &a_from, T &a_value)
+    {
+        if (a_in.size () - a_from < sizeof (T))
+            return false;
+        memcpy (&a_value, a_in.data () + a_from, sizeof (T));
+        a_from += sizeof (T);
+        return true;
+    }
+
+    static bool
+    read_string (const string &a_in,
+                 string::size_type &a_from,
+                 string &a_value)
+    {
+        guint32 len = 0;
+        if (!read_pod (a_in, a_from, len)
+            || a_in.size () - a_from < len)
+            return false;
+        a_value.assign (a_in, a_from, len);
+        a_from += len;
+        return true;
+    }
+
+    /// Load the cache file, if it's there and well formed.  Must be
+    /// called with the mutex held.
+    void
+    load ()
+    {
+        if (loaded)
+            return;
+        loaded = true;
+
+        gchar *contents = 0;
+        gsize len = 0;
+        if (!g_file_get_contents (cache_file_path ().c_str (),
+                                  &contents, &len, 0))
+            return;
+        string in (contents, len);
+        g_free (contents);
+
+        if (in.compare (0, magic ().size (), magic ()))
+            return;
+        string::size_type from = magic ().size ();
+        guint32 nb_entries = 0;
+        if (!read_pod (in, from, nb_entries))
+            return;
+
+        map<Key, Entry> result;
+        for (guint32 i = 0; i < nb_entries; ++i) {
+            Key key;
+            string str;
+            Entry entry;
+            guint32 nb_paths = 0;
+            if (!read_string (in, from, key.first)
+                || !read_string (in, from, key.second)
+                || !read_string (in, from, entry.config_path)
+                || !read_pod (in, from, entry.mtime_sec)
+                || !read_pod (in, from, entry.mtime_nsec)
+                || !read_pod (in, from, entry.size)
+                || !read_string (in, from, str))
+                return;
+            entry.library_name = str;
+            if (!read_pod (in, from, nb_paths))
+                return;
+            for (guint32 j = 0; j < nb_paths; ++j) {
+                if (!read_string (in, from, str))
+                    return;
+                entry.custom_library_search_paths.push_back (str);
+            }
+            if (!read_string (in, from, str))
+                return;
+            entry.library_path = str;
+            result[key] = entry;
+        }
+        entries.swap (result);
+    }
+
+    /// Save the cache file.  Must be called with the mutex held.
+    void
+    save ()
+    {
+        string out (magic ());
+        write_uint (out, entries.size ());
+        for (map<Key, Entry>::const_iterator it = entries.begin ();
+             it != entries.end ();
+             ++it) {
+            write_string (out, it->first.first);
+            write_string (out, it->first.second);
+            write_string (out, it->second.config_path);
+            write_int64 (out, it->second.mtime_sec);
+            write_int64 (out, it->second.mtime_nsec);
+            write_int64 (out, it->second.size);
+            write_string (out, it->second.library_name.raw ());
+            write_uint (out, it->second.custom_library_search_paths.size ());
+            for (vector<UString>::const_iterator p =
+                     it->second.custom_library_search_paths.begin ();
+                 p != it->second.custom_library_search_paths.end ();
+                 ++p) {
+                write_string (out, p->raw ());
+            }
+            write_string (out, it->second.library_path.raw ());
+        }
+
+        if (!env::create_user_db_dir ())
+            return;
+        GError *error = 0;
+        if (!g_file_set_contents (cache_file_path ().c_str (),
+                                  out.data (), out.size (), &error)) {
+            LOG_D ("could not save the module config cache: "
+                   << (error ? error->message : ""),
+                   "module-loading-domain");
+            if (error)
+                g_error_free (error);
+        }
+    }
+
+public:
+
+    static ModuleConfigCache&
+    instance ()
+    {
+        static ModuleConfigCache s_cache;
+        return s_cache;
+    }
+
+    /// Look up the module a_module_name.
+    /// \param a_module_name the name of the module.
+    /// \param a_config_search_paths the paths the config file of the
+    /// module would be searched in.
+    /// \param a_config the config of the module, if found.
+    /// \param a_library_path the path of the library of the module,
+    /// if found.  It can be empty if the config was found, but the
+    /// library was never looked for.
+    /// \return true if the module was found, false if it's not in
+    /// the cache, if its files changed since it got cached, or if a
+    /// config file that would now be found first was added.
+    bool
+    lookup (const string &a_module_name,
+            const vector<UString> &a_config_search_paths,
+            DynamicModule::ConfigSafePtr &a_config,
+            UString &a_library_path)
+    {
+        Glib::Mutex::Lock lock (mutex);
+        load ();
+
+        map<Key, Entry>::const_iterator it =
+            entries.find (Key (join_paths (a_config_search_paths),
+                               a_module_name));
+        if (it == entries.end ())
+            return false;
+
+        struct stat st;
+        // A config file in a directory searched before the one of the
+        // cached config would shadow it.
+        for (vector<UString>::const_iterator dir =
+                                        a_config_search_paths.begin ();
+             dir != a_config_search_paths.end ();
+             ++dir) {
+            string path = module_config_file_path (*dir, a_module_name);
+            if (path == it->second.config_path)
+                break;
+            if (!g_stat (path.c_str (), &st))
+                return false;
+        }
+
+        if (g_stat (it->second.config_path.c_str (), &st)
+            || it->second.mtime_sec != (gint64) st.st_mtim.tv_sec
+            || it->second.mtime_nsec != (gint64) st.st_mtim.tv_nsec
+            || it->second.size != (gint64) st.st_size)
+            return false;
+        if (!it->second.library_path.empty ()
+            && g_stat (it->second.library_path.c_str (), &st))
+            return false;
+
+        a_config.reset (new DynamicModule::Config);
+        a_config->library_name = it->second.library_name;
+        a_config->custom_library_search_paths =
+                                it->second.custom_library_search_paths;
+        a_library_path = it->second.library_path;
+        return true;
+    }
+
+    /// Add the config of the module a_module_name, as parsed from
+    /// the config file a_config_path, to the cache.
+    void
+    store_config (const string &a_module_name,
+                  const vector<UString> &a_config_search_paths,
+                  const string &a_config_path,
+                  const struct stat &a_stat,
+                  const DynamicModule::Config &a_config)
+    {
+        Glib::Mutex::Lock lock (mutex);
+        load ();
+
+        Entry &entry = entries[Key (join_paths (a_config_search_paths),
+                                    a_module_name)];
+        entry.config_path = a_config_path;
+        entry.mtime_sec = a_stat.st_mtim.tv_sec;
+        entry.mtime_nsec = a_stat.st_mtim.tv_nsec;
+        entry.size = a_stat.st_size;
+        entry.library_name = a_config.library_name;
+        entry.custom_library_search_paths =
+                                a_config.custom_library_search_paths;
+        entry.library_path.clear ();
+        save ();
+    }
+
+    /// Record the path of the library of the module a_module_name,
+    /// which config must have been stored already, for the same
+    /// config search paths.
+    void
+    store_library_path (const string &a_module_name,
+                        const vector<UString> &a_config_search_paths,
+                        const UString &a_library_path)
+    {
+        Glib::Mutex::Lock lock (mutex);
+        load ();
+
+        map<Key, Entry>::iterator it =
+            entries.find (Key (join_paths (a_config_search_paths),
+                               a_module_name));
+        if (it == entries.end ()
+            || it->second.library_path == a_library_path)
+            return;
+        it->second.library_path = a_library_path;
+        save ();
+    }
+};//end class ModuleConfigCache
+
 struct DynamicModule::Loader::Priv {
     vector<UString> config_search_paths;
     map<std::string, DynamicModule::ConfigSafePtr> config_map ;
+    // Maps module names to the paths of their libraries.
+    map<UString, UString> library_path_map;
     vector<UString> module_library_path;
     DynamicModuleManager * module_manager;
 
@@ -124,27 +464,48 @@ DynamicModule::Loader::module_config (const string &a_module_name)
 
     map<string, ConfigSafePtr>::iterator iter =
                                     m_priv->config_map.find (a_module_name);
-    if (iter == m_priv->config_map.end ()) {
-        //we didn't find the module config in config cache.
-        //Let's walk the module conf paths
-        //and try to parse module confs from there.
-        for (vector<UString>::const_iterator it = config_search_paths ().begin ();
-             it != config_search_paths ().end ();
-             ++it) {
-            vector<string> path_elements;
-            path_elements.push_back (it->c_str ());
-            path_elements.push_back (a_module_name + ".conf");
-            string path = Glib::build_filename (path_elements);
-            if (!Glib::file_test (path, Glib::FILE_TEST_EXISTS)) {continue;}
+    if (iter != m_priv->config_map.end ())
+        return iter->second;
+
+    // The registry of the modules found by the previous runs spares
+    // the parsing of the config file and the search for the library.
+    Glib::Timer timer;
+    UString library_path;
+    if (ModuleConfigCache::instance ().lookup (a_module_name,
+                                               config_search_paths (),
+                                               result,
+                                               library_path)) {
+        m_priv->config_map[a_module_name] = result;
+        if (!library_path.empty ())
+            m_priv->library_path_map[a_module_name] = library_path;
+        LOG_D ("got module " << a_module_name << " from cache in "
+               << (int) (timer.elapsed () * 1000000) << "us",
+               "module-loading-domain");
+        return result;
+    }
 
-            result = parse_module_config_file (path.c_str ());
-            if (!result) {return result;}
+    //we didn't find the module config in config cache.
+    //Let's walk the module conf paths
+    //and try to parse module confs from there.
+    for (vector<UString>::const_iterator it = config_search_paths ().begin ();
+         it != config_search_paths ().end ();
+         ++it) {
+        string path = module_config_file_path (*it, a_module_name);
+        struct stat st;
+        if (g_stat (path.c_str (), &st)) {continue;}
+
+        result = parse_module_config_file (path.c_str ());
+        if (!result) {return result;}
+        ModuleConfigCache::instance ().store_config (a_module_name,
+                                                     config_search_paths (),
+                                                     path, st, *result);
+        LOG_D ("parsed config of module " << a_module_name
+               << " in " << (int) (timer.elapsed () * 1000000)
+               << "us",
+               "module-loading-domain");
 
-            m_priv->config_map[a_module_name] = result;
-            break;
-        }
-    } else {
-        result = iter->second;
+        m_priv->config_map[a_module_name] = result;
+        break;
     }
     return result;
 }
@@ -260,6 +621,11 @@ DynamicModule::Loader::parse_module_config_file (const UString &a_path)
 UString
 DynamicModule::Loader::module_library_path (const UString &a_module_name)
 {
+    map<UString, UString>::const_iterator it =
+                        m_priv->library_path_map.find (a_module_name);
+    if (it != m_priv->library_path_map.end ())
+        return it->second;
+
     UString library_name, library_path;
     DynamicModule::ConfigSafePtr mod_conf = module_config (a_module_name);
     THROW_IF_FAIL2 (mod_conf,
@@ -269,8 +635,20 @@ DynamicModule::Loader::module_library_path (const UString &a_module_name)
     //***********************************************
     //get the library name from the module names map
     //***********************************************
+    // module_config fills library_path_map from the cache.
+    it = m_priv->library_path_map.find (a_module_name);
+    if (it != m_priv->library_path_map.end ())
+        return it->second;
+
     library_name = mod_conf->library_name;
     library_path = build_library_path (a_module_name, library_name);
+    if (!library_path.empty ()) {
+        m_priv->library_path_map[a_module_name] = library_path;
+        ModuleConfigCache::instance ().store_library_path
+                                        (a_module_name,
+                                         config_search_paths (),
+                                         library_path);
+    }
     return library_path;
 }
 
@@ -223,7 +223,12 @@ get_gdb_program ()
 #error the macro GDB_PROG must be set at compile time !
 #endif
 
-    static const UString s_gdb_prog (GDB_PROG);
+    // NMV_GDB_PROGRAM lets tests run a stand-in for GDB, like the
+    // fake GDB/MI server of the test suite.
+    static const char *s_env_gdb_prog = g_getenv ("NMV_GDB_PROGRAM");
+    static const UString s_gdb_prog ((s_env_gdb_prog && *s_env_gdb_prog)
+                                     ? s_env_gdb_prog
+                                     : GDB_PROG);
     return s_gdb_prog;
 }
 
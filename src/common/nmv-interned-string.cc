@@ -0,0 +1,176 @@
+/*
+ *This file is part of the Nemiver project
+ *
+ *Nemiver is free software; you can redistribute
+ *it and/or modify it under the terms of
+ *the GNU General Public License as published by the
+ *Free Software Foundation; either version 2,
+ *or (at your option) any later version.
+ *
+ *Nemiver is distributed in the hope that it will
+ *be useful, but WITHOUT ANY WARRANTY;
+ *without even the implied warranty of
+ *MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ *See the GNU General Public License for more details.
+ *
+ *You should have received a copy of the
+ *GNU General Public License along with Nemiver;
+ *see the file COPYING.
+ *If not, write to the Free Software Foundation,
+ *Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+ *
+ *See COPYRIGHT file copyright information.
+ */
+#include "config.h"
+#include <glibmm/thread.h>
+#include "nmv-interned-string.h"
+
+#if defined(HAVE_TR1_UNORDERED_MAP)
+#include <tr1/unordered_map>
+#elif defined(HAVE_BOOST_TR1_UNORDERED_MAP_HPP)
+#include <boost/tr1/unordered_map.hpp>
+#else
+#include <map>
+#endif
+
+NEMIVER_BEGIN_NAMESPACE (nemiver)
+NEMIVER_BEGIN_NAMESPACE (common)
+
+//************************
+//<InternedString methods>
+//************************
+
+/// Build a handle to a string that is not interned.  Equal
+/// instances built that way don't share their underlying string.
+InternedString::InternedString (const std::string &a_value) :
+    m_rep (new Rep (a_value))
+{
+}
+
+/// \return the underlying string.
+const UString&
+InternedString::ustr () const
+{
+    static const UString s_empty;
+    if (!m_rep)
+        return s_empty;
+    return m_rep->value;
+}
+
+/// \return the underlying string as a std::string.
+const std::string&
+InternedString::raw () const
+{
+    return ustr ().raw ();
+}
+
+bool
+InternedString::empty () const
+{
+    return !m_rep || m_rep->value.empty ();
+}
+
+void
+InternedString::clear ()
+{
+    m_rep.reset ();
+}
+
+bool
+InternedString::operator== (const InternedString &a_other) const
+{
+    if (m_rep == a_other.m_rep)
+        return true;
+    return ustr ().raw () == a_other.ustr ().raw ();
+}
+
+bool
+InternedString::operator!= (const InternedString &a_other) const
+{
+    return !operator== (a_other);
+}
+
+//************************
+//</InternedString methods>
+//************************
+
+#if defined(HAVE_TR1_UNORDERED_MAP) || defined(HAVE_BOOST_TR1_UNORDERED_MAP_HPP)
+typedef std::tr1::unordered_map<std::string,
+                                InternedString> InternedStringsMap;
+#else
+typedef std::map<std::string, InternedString> InternedStringsMap;
+#endif
+
+struct StringInternTable::Priv {
+    InternedStringsMap strings;
+    // The table can be shared by the thread that parses the output
+    // of GDB and the main thread.
+    mutable Glib::Mutex mutex;
+};//end struct StringInternTable::Priv
+
+StringInternTable::StringInternTable () :
+    m_priv (new Priv)
+{
+}
+
+StringInternTable::~StringInternTable ()
+{
+}
+
+/// Intern a string.
+///
+/// \param a_str the string to intern.
+///
+/// \return a handle to the interned copy of a_str.  All the handles
+/// returned for strings equal to a_str share the same underlying
+/// string.
+InternedString
+StringInternTable::intern (const std::string &a_str)
+{
+    if (a_str.empty ())
+        return InternedString ();
+
+    Glib::Mutex::Lock lock (m_priv->mutex);
+    InternedStringsMap::iterator it = m_priv->strings.find (a_str);
+    if (it != m_priv->strings.end ())
+        return it->second;
+
+    InternedString result
+        (InternedString::RepSafePtr (new InternedString::Rep (a_str)));
+    m_priv->strings[a_str] = result;
+    return result;
+}
+
+/// \return the number of strings held by the table.
+size_t
+StringInternTable::size () const
+{
+    Glib::Mutex::Lock lock (m_priv->mutex);
+    return m_priv->strings.size ();
+}
+
+/// Drop the strings that are referenced by nobody but the table.
+void
+StringInternTable::purge ()
+{
+    Glib::Mutex::Lock lock (m_priv->mutex);
+    InternedStringsMap::iterator it = m_priv->strings.begin ();
+    while (it != m_priv->strings.end ()) {
+        if (it->second.m_rep->get_refcount () <= 1)
+            m_priv->strings.erase (it++);
+        else
+            ++it;
+    }
+}
+
+/// Drop all the strings of the table.  The handles that were handed
+/// out remain valid.
+void
+StringInternTable::clear ()
+{
+    Glib::Mutex::Lock lock (m_priv->mutex);
+    m_priv->strings.clear ();
+}
+
+NEMIVER_END_NAMESPACE (common)
+NEMIVER_END_NAMESPACE (nemiver)
@@ -0,0 +1,106 @@
+/*
+ *This file is part of the Nemiver project
+ *
+ *Nemiver is free software; you can redistribute
+ *it and/or modify it under the terms of
+ *the GNU General Public License as published by the
+ *Free Software Foundation; either version 2,
+ *or (at your option) any later version.
+ *
+ *Nemiver is distributed in the hope that it will
+ *be useful, but WITHOUT ANY WARRANTY;
+ *without even the implied warranty of
+ *MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ *See the GNU General Public License for more details.
+ *
+ *You should have received a copy of the
+ *GNU General Public License along with Nemiver;
+ *see the file COPYING.
+ *If not, write to the Free Software Foundation,
+ *Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+ *
+ *See COPYRIGHT file copyright information.
+ */
+#ifndef __NMV_INTERNED_STRING_H__
+#define __NMV_INTERNED_STRING_H__
+
+#include <string>
+#include "nmv-ustring.h"
+#include "nmv-object.h"
+#include "nmv-safe-ptr-utils.h"
+
+NEMIVER_BEGIN_NAMESPACE (nemiver)
+NEMIVER_BEGIN_NAMESPACE (common)
+
+class StringInternTable;
+
+/// A cheap handle to an immutable string.
+///
+/// Copying an InternedString only copies a reference to the
+/// underlying string.  When the InternedString comes from a
+/// StringInternTable, all the handles to equal strings share the same
+/// underlying string, so comparing them boils down to comparing
+/// pointers.
+class NEMIVER_API InternedString {
+    friend class StringInternTable;
+
+    struct Rep : public Object {
+        UString value;
+
+        explicit Rep (const std::string &a_value) :
+            value (a_value)
+        {
+        }
+    };//end struct Rep
+    typedef SafePtr<Rep, ObjectRef, ObjectUnref> RepSafePtr;
+
+    RepSafePtr m_rep;
+
+    explicit InternedString (const RepSafePtr &a_rep) :
+        m_rep (a_rep)
+    {
+    }
+
+public:
+    InternedString () {}
+    explicit InternedString (const std::string &a_value);
+    const UString& ustr () const;
+    const std::string& raw () const;
+    bool empty () const;
+    void clear ();
+    bool operator== (const InternedString &) const;
+    bool operator!= (const InternedString &) const;
+};//end class InternedString
+
+/// A table of interned strings.
+///
+/// Interning a string that was interned before returns a handle to
+/// the string that is already in the table, instead of allocating a
+/// new one.  This is useful for strings that are seen over and over
+/// again, like the function and file names of the frames of a call
+/// stack.
+class NEMIVER_API StringInternTable : public Object {
+    // non copyable
+    StringInternTable (const StringInternTable &);
+    StringInternTable& operator= (const StringInternTable &);
+
+    struct Priv;
+    SafePtr<Priv> m_priv;
+
+public:
+    StringInternTable ();
+    virtual ~StringInternTable ();
+    InternedString intern (const std::string &a_str);
+    size_t size () const;
+    void purge ();
+    void clear ();
+};//end class StringInternTable
+
+typedef SafePtr<StringInternTable,
+                ObjectRef,
+                ObjectUnref> StringInternTableSafePtr;
+
+NEMIVER_END_NAMESPACE (common)
+NEMIVER_END_NAMESPACE (nemiver)
+
+#endif // __NMV_INTERNED_STRING_H__
@@ -131,31 +131,43 @@ LOG_STREAM << LOG_LEVEL_VERBOSE___ << LOG_MARKER_INFO << HERE << message << nemi
     } while (false)
 #endif
 
+// The ScopeLogger::Site of a scope is static, so that the log
+// domain of the scope is only computed once.
+#ifndef LOG_SCOPE_LEVEL_D
+#define LOG_SCOPE_LEVEL_D(scopename, level, domain) \
+static nemiver::common::ScopeLogger::Site scope_logger_site \
+    (scopename, level, domain); \
+nemiver::common::ScopeLogger scope_logger (scope_logger_site);
+#endif
+
 #ifndef LOG_SCOPE_VERBOSE
 #define LOG_SCOPE_VERBOSE(scopename) \
-nemiver::common::ScopeLogger scope_logger (scopename, nemiver::common::LogStream::LOG_LEVEL_VERBOSE);
+LOG_SCOPE_LEVEL_D (scopename, nemiver::common::LogStream::LOG_LEVEL_VERBOSE, \
+                   NMV_GENERAL_DOMAIN)
 #endif
 
 #ifndef LOG_SCOPE
 #define LOG_SCOPE(scopename) \
-nemiver::common::ScopeLogger scope_logger (scopename, nemiver::common::LogStream::LOG_LEVEL_NORMAL);
+LOG_SCOPE_LEVEL_D (scopename, nemiver::common::LogStream::LOG_LEVEL_NORMAL, \
+                   NMV_GENERAL_DOMAIN)
 #endif
 
 #ifndef LOG_SCOPE_D
 #define LOG_SCOPE_D(scopename, domain) \
-nemiver::common::ScopeLogger scope_logger \
-        (scopename, nemiver::common::LogStream::LOG_LEVEL_VERBOSE, domain);
+LOG_SCOPE_LEVEL_D (scopename, nemiver::common::LogStream::LOG_LEVEL_VERBOSE, \
+                   domain)
 #endif
 
 #ifndef LOG_SCOPE_NORMAL
 #define LOG_SCOPE_NORMAL(scopename) \
-nemiver::common::ScopeLogger scope_logger (scopename, nemiver::common::LogStream::LOG_LEVEL_NORMAL);
+LOG_SCOPE_LEVEL_D (scopename, nemiver::common::LogStream::LOG_LEVEL_NORMAL, \
+                   NMV_GENERAL_DOMAIN)
 #endif
 
 #ifndef LOG_SCOPE_NORMAL_D
 #define LOG_SCOPE_NORMAL_D(scopename, domain) \
-nemiver::common::ScopeLogger scope_logger \
-    (scopename, nemiver::common::LogStream::LOG_LEVEL_NORMAL, domain);
+LOG_SCOPE_LEVEL_D (scopename, nemiver::common::LogStream::LOG_LEVEL_NORMAL, \
+                   domain)
 #endif
 
 #ifndef LOG_FUNCTION_SCOPE
@@ -42,6 +42,7 @@
 #include "nmv-exception.h"
 #include "nmv-date-utils.h"
 #include "nmv-safe-ptr-utils.h"
+#include "nmv-scope-logger.h"
 
 #if defined(HAVE_TR1_UNORDERED_MAP)
 #include <tr1/unordered_map>
@@ -218,15 +219,35 @@ public:
 };//end class OfstreamLogSink
 
 typedef SafePtr<LogSink, ObjectRef, ObjectUnref> LogSinkSafePtr;
+
+// The domains pushed by LogStream::push_domain in the current thread,
+// along with the stream they were pushed on.  The output of GDB is
+// parsed on a thread of its own that logs through the same streams as
+// the main loop, so the stack can't be shared.
+typedef std::vector<std::pair<const void*, string> > DomainStack;
+static Glib::StaticPrivate<DomainStack> s_domain_stack =
+    GLIBMM_STATIC_PRIVATE_INIT;
+
+static DomainStack&
+get_domain_stack ()
+{
+    DomainStack *stack = s_domain_stack.get ();
+    if (!stack) {
+        stack = new DomainStack;
+        s_domain_stack.set (stack);
+    }
+    return *stack;
+}
+
 struct LogStream::Priv
 {
     enum LogStream::StreamType stream_type;
     LogSinkSafePtr sink;
 
-    //the stack of default domains name
-    //to consider when logging functions don't
-    //specify the domain name in their parameters
-    list<string> default_domains;
+    //the domain to consider when logging functions don't
+    //specify the domain name in their parameters, and
+    //no domain has been pushed in the current thread.
+    string default_domain;
 
     //the list of domains (keywords) this stream
     //is allowed to log against. (It is a map, just for speed purposes)
@@ -245,8 +266,7 @@ struct LogStream::Priv
             stream_type (LogStream::COUT_STREAM),
             level (LogStream::LOG_LEVEL_NORMAL)
     {
-        default_domains.clear ();
-        default_domains.push_front (a_domain);
+        default_domain = a_domain;
 
         //NMV_GENERAL_DOMAIN is always enabled by default.
         allowed_domains[NMV_GENERAL_DOMAIN] = true;
@@ -291,7 +311,19 @@ struct LogStream::Priv
 
     bool is_logging_allowed ()
     {
-        return is_logging_allowed (default_domains.front ());
+        return is_logging_allowed (current_domain ());
+    }
+
+    /// \return the last domain pushed in the current thread, or
+    /// the default domain of the stream.
+    const string& current_domain () const
+    {
+        const DomainStack &stack = get_domain_stack ();
+        DomainStack::const_reverse_iterator it;
+        for (it = stack.rbegin (); it != stack.rend (); ++it)
+            if (it->first == this)
+                return it->second;
+        return default_domain;
     }
 
     void load_enabled_domains_from_env ()
@@ -336,6 +368,13 @@ void
 LogStream::set_log_level_filter (enum LogLevel a_level)
 {
     s_level_filter = a_level;
+    ScopeLogger::invalidate_sites ();
+}
+
+enum LogStream::LogLevel
+LogStream::get_log_level_filter ()
+{
+    return s_level_filter;
 }
 
 void
@@ -349,6 +388,7 @@ void
 LogStream::activate (bool a_activate)
 {
     s_is_active = a_activate;
+    ScopeLogger::invalidate_sites ();
 }
 
 bool
@@ -409,6 +449,7 @@ LogStream::enable_domain (const string &a_domain,
     } else {
         m_priv->allowed_domains.erase (a_domain.c_str ());
     }
+    ScopeLogger::invalidate_sites ();
 }
 
 bool
@@ -421,6 +462,12 @@ LogStream::is_domain_enabled (const std::string &a_domain)
     return false;
 }
 
+bool
+LogStream::is_logging_allowed (const std::string &a_domain)
+{
+    return m_priv->is_logging_allowed (a_domain);
+}
+
 LogStream&
 LogStream::write (const char* a_buf, long a_buflen, const string &a_domain)
 {
@@ -500,16 +547,20 @@ LogStream::write (char a_msg,
 void
 LogStream::push_domain (const string &a_domain)
 {
-    m_priv->default_domains.push_front (a_domain);
+    get_domain_stack ().push_back (make_pair (m_priv.get (), a_domain));
 }
 
 void
 LogStream::pop_domain ()
 {
-    if (m_priv->default_domains.size () <= 1) {
-        return;
+    DomainStack &stack = get_domain_stack ();
+    for (DomainStack::iterator it = stack.end (); it != stack.begin ();) {
+        --it;
+        if (it->first == m_priv.get ()) {
+            stack.erase (it);
+            return;
+        }
     }
-    m_priv->default_domains.pop_front ();
 }
 
 LogStream&
@@ -522,37 +573,37 @@ LogStream::write (const Glib::ustring &a_msg, const string &a_domain)
 LogStream&
 LogStream::operator<< (const char* a_c_string)
 {
-    return write (a_c_string, -1, m_priv->default_domains.front ());
+    return write (a_c_string, -1, m_priv->current_domain ());
 }
 
 LogStream&
 LogStream::operator<< (const std::string &a_string)
 {
-    return write (a_string.c_str (), -1, m_priv->default_domains.front ());
+    return write (a_string.c_str (), -1, m_priv->current_domain ());
 }
 
 LogStream&
 LogStream::operator<< (const Glib::ustring &a_string)
 {
-    return write (a_string, m_priv->default_domains.front ());
+    return write (a_string, m_priv->current_domain ());
 }
 
 LogStream&
 LogStream::operator<< (int a_msg)
 {
-    return write (a_msg, m_priv->default_domains.front ());
+    return write (a_msg, m_priv->current_domain ());
 }
 
 LogStream&
 LogStream::operator<< (double a_msg)
 {
-    return write (a_msg, m_priv->default_domains.front ());
+    return write (a_msg, m_priv->current_domain ());
 }
 
 LogStream&
 LogStream::operator<< (char a_msg)
 {
-    return write (a_msg, m_priv->default_domains.front ());
+    return write (a_msg, m_priv->current_domain ());
 
 }
 
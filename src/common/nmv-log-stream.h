@@ -117,6 +117,11 @@ public:
     /// \param a_level the level of verbosity you want your log streams to have.
     static void set_log_level_filter (enum LogLevel a_level);
 
+    /// \brief gets the log level filter.
+    /// \return the log level filter set by
+    /// LogStream::set_log_level_filter().
+    static enum LogLevel get_log_level_filter ();
+
     /// \brief sets a filter on the log domain
     /// only streams that have the same domain as the one set here will
     /// be logging data.
@@ -163,6 +168,11 @@ public:
     /// \return true is logging is enabled for domain @a_domain
     bool is_domain_enabled (const string &a_domain);
 
+    /// \return true if a message logged against domain @a_domain
+    /// would actually be written, given the log level of the
+    /// stream, its enabled domains and whether logging is active.
+    bool is_logging_allowed (const string &a_domain);
+
     /// \brief writes a text string to the stream
     /// \param a_buf the buffer that contains the text string.
     /// \param a_buflen the length of the buffer. If <0, a_buf is
@@ -40,10 +40,22 @@ NEMIVER_BEGIN_NAMESPACE (common)
 struct ObjectPriv;
 class UString;
 
+/// The base class of the reference counted objects.
+///
+/// The reference count is held by the object itself, so creating
+/// an Object costs no allocation.  The map of the objects attached
+/// with attach_object is only allocated by the first attachment.
+/// The reference count is updated atomically, so that objects can
+/// be handed from one thread to another.
 class NEMIVER_API Object {
     friend struct ObjectPriv;
 
+    long m_refcount;
+    bool m_refcount_enabled;
+
 protected:
+    // Holds the attached objects; null until the first one is
+    // attached.
     SafePtr<ObjectPriv> m_priv;
 
 public:
@@ -28,6 +28,10 @@
  *
  */
 #include "config.h"
+#include <time.h>
+#include <algorithm>
+#include <map>
+#include <vector>
 #include <glibmm.h>
 #include "nmv-exception.h"
 #include "nmv-ustring.h"
@@ -37,75 +41,326 @@
 namespace nemiver {
 namespace common {
 
-static const UString DELETE ("delete");
+volatile gint ScopeLogger::s_generation = 0;
+volatile gint ScopeLogger::s_is_profiling = 0;
 
-struct ScopeLoggerPriv
+/// The time spent in a scope, when it is called from a given call
+/// path.  The nodes of a thread make up a call tree.
+struct ScopeProfileNode
 {
-    Glib::Timer timer;
-    LogStream *out;
-    bool can_free;
-    UString name;
-    UString domain;
+    typedef std::map<const ScopeLogger::Site*, ScopeProfileNode*> Children;
 
-    ScopeLoggerPriv (const char*a_scope_name,
-                     enum LogStream::LogLevel a_level,
-                     const UString &a_log_domain,
-                     bool a_use_default_log_stream) :
-        out (0), can_free (false)
+    const ScopeLogger::Site *site;
+    ScopeProfileNode *parent;
+    unsigned long nb_calls;
+    // In microseconds.
+    gint64 inclusive_time;
+    gint64 children_time;
+    Children children;
+
+    ScopeProfileNode (const ScopeLogger::Site *a_site,
+                      ScopeProfileNode *a_parent) :
+        site (a_site),
+        parent (a_parent),
+        nb_calls (0),
+        inclusive_time (0),
+        children_time (0)
+    {
+    }
+
+    ~ScopeProfileNode ()
+    {
+        for (Children::iterator it = children.begin ();
+             it != children.end ();
+             ++it)
+            delete it->second;
+    }
+
+    ScopeProfileNode* get_child (const ScopeLogger::Site *a_site)
     {
-        if (!a_use_default_log_stream) {
-            out = new LogStream (a_level);
-            can_free = true;
-        } else {
-            out = &(LogStream::default_log_stream ());
-            can_free = false;
-        }
-        name = a_scope_name;
-        domain = a_log_domain;
-
-        out->push_domain (a_log_domain);
-        *out  << "|{|" << name << ":{" << common::endl;
-        out->pop_domain ();
-
-        timer.start ();
+        Children::iterator it = children.find (a_site);
+        if (it != children.end ())
+            return it->second;
+        ScopeProfileNode *child = new ScopeProfileNode (a_site, this);
+        children[a_site] = child;
+        return child;
+    }
+};//end struct ScopeProfileNode
+
+/// The call tree of a thread.
+struct ScopeProfileThread
+{
+    ScopeProfileNode root;
+    ScopeProfileNode *current;
+
+    ScopeProfileThread () :
+        root (0, 0),
+        current (&root)
+    {
+    }
+};//end struct ScopeProfileThread
+
+// The call tree of the current thread.  It is never freed, as the
+// profile is written when the program exits.
+static __thread ScopeProfileThread *tls_profile_thread = 0;
+
+static Glib::Mutex&
+get_profile_threads_mutex ()
+{
+    static Glib::Mutex s_mutex;
+    return s_mutex;
+}
+
+static std::vector<ScopeProfileThread*>&
+get_profile_threads ()
+{
+    static std::vector<ScopeProfileThread*> s_threads;
+    return s_threads;
+}
+
+/// \return the time elapsed since an arbitrary point, in
+/// microseconds.
+static gint64
+now_us ()
+{
+    struct timespec now;
+    clock_gettime (CLOCK_MONOTONIC, &now);
+    return (gint64) now.tv_sec * 1000000 + now.tv_nsec / 1000;
+}
+
+ScopeLogger::Site::Site (const char *a_name,
+                         enum LogStream::LogLevel a_level,
+                         const UString &a_domain) :
+    name (a_name),
+    domain (a_domain.raw ()),
+    level (a_level),
+    generation (-1),
+    is_enabled (0)
+{
+}
+
+/// Look up whether the domain of the site is enabled for logging.
+/// \param a_generation the generation of the log settings, as read
+/// before the look up.  If the settings change during the look up,
+/// the site is thus looked up again the next time.
+void
+ScopeLogger::Site::update (gint a_generation)
+{
+    bool enabled =
+        level <= LogStream::get_log_level_filter ()
+        && LogStream::default_log_stream ().is_logging_allowed (domain);
+    g_atomic_int_set (&is_enabled, enabled);
+    g_atomic_int_set (&generation, a_generation);
+}
+
+void
+ScopeLogger::log_entry ()
+{
+    LogStream &out = LogStream::default_log_stream ();
+    out.push_domain (m_site.domain);
+    out << "|{|" << m_site.name << ":{" << common::endl;
+    out.pop_domain ();
+    m_action = LOGGED;
+    m_start = now_us ();
+}
+
+void
+ScopeLogger::log_exit ()
+{
+    double elapsed = (now_us () - m_start) / 1000000.0;
+    LogStream &out = LogStream::default_log_stream ();
+    out.push_domain (m_site.domain);
+    out << "|}|" << m_site.name << ":}elapsed: "
+        << elapsed << "secs" << common::endl;
+    out.pop_domain ();
+}
+
+void
+ScopeLogger::enter_profile ()
+{
+    ScopeProfileThread *thread = tls_profile_thread;
+    if (!thread) {
+        thread = new ScopeProfileThread;
+        Glib::Mutex::Lock lock (get_profile_threads_mutex ());
+        get_profile_threads ().push_back (thread);
+        tls_profile_thread = thread;
     }
+    m_node = thread->current->get_child (&m_site);
+    thread->current = m_node;
+    m_action = PROFILED;
+    m_start = now_us ();
+}
+
+void
+ScopeLogger::leave_profile ()
+{
+    gint64 elapsed = now_us () - m_start;
+    ++m_node->nb_calls;
+    m_node->inclusive_time += elapsed;
+    m_node->parent->children_time += elapsed;
+    tls_profile_thread->current = m_node->parent;
+}
+
+/// Have all the sites look their log domain up again.  This must be
+/// called each time the log settings change.
+void
+ScopeLogger::invalidate_sites ()
+{
+    g_atomic_int_inc (&s_generation);
+}
+
+/// Start accounting the time spent in each scope, instead of logging
+/// the scopes.
+void
+ScopeLogger::start_profiling ()
+{
+    // Make sure the mutex is created before there is more than one
+    // thread to use it.
+    get_profile_threads_mutex ();
+    g_atomic_int_set (&s_is_profiling, 1);
+}
+
+void
+ScopeLogger::stop_profiling ()
+{
+    g_atomic_int_set (&s_is_profiling, 0);
+}
+
+bool
+ScopeLogger::is_profiling ()
+{
+    return g_atomic_int_get (&s_is_profiling);
+}
+
+/// The name of a scope, as a frame of a folded stack.
+static std::string
+folded_frame_name (const char *a_name)
+{
+    std::string name = a_name ? a_name : "?";
+    std::replace (name.begin (), name.end (), ';', ':');
+    std::replace (name.begin (), name.end (), '\n', ' ');
+    return name;
+}
 
-    ~ScopeLoggerPriv ()
+static void
+write_folded_node (const ScopeProfileNode &a_node,
+                   const std::string &a_path,
+                   std::ostream &a_out)
+{
+    std::string path = a_path;
+    if (a_node.site) {
+        if (!path.empty ())
+            path += ';';
+        path += folded_frame_name (a_node.site->name);
+        gint64 exclusive = a_node.inclusive_time - a_node.children_time;
+        if (exclusive > 0)
+            a_out << path << ' ' << exclusive << '\n';
+    }
+    for (ScopeProfileNode::Children::const_iterator it =
+             a_node.children.begin ();
+         it != a_node.children.end ();
+         ++it)
+        write_folded_node (*it->second, path, a_out);
+}
+
+/// Write the time spent in each call path, in the "folded stacks"
+/// format of flamegraph.pl: one line per call path, made of the
+/// names of the scopes separated by ';', then of the time spent in
+/// the last scope itself, in microseconds.  If more than one thread
+/// was profiled, the call paths start with the thread number.
+///
+/// The profile should be written once the other threads are done.
+void
+ScopeLogger::write_profile (std::ostream &a_out)
+{
+    Glib::Mutex::Lock lock (get_profile_threads_mutex ());
+    const std::vector<ScopeProfileThread*> &threads = get_profile_threads ();
+    for (unsigned i = 0; i < threads.size (); ++i) {
+        std::string path;
+        if (threads.size () > 1)
+            path = "thread-" + UString::from_int (i + 1).raw ();
+        write_folded_node (threads[i]->root, path, a_out);
+    }
+    a_out.flush ();
+}
+
+struct ScopeSummary {
+    const char *name;
+    unsigned long nb_calls;
+    gint64 inclusive_time;
+    gint64 exclusive_time;
+
+    ScopeSummary () :
+        name (0),
+        nb_calls (0),
+        inclusive_time (0),
+        exclusive_time (0)
     {
-        timer.stop ();
-
-        if (!out) {return;}
-
-        out->push_domain (domain);
-        *out << "|}|" << name <<":}elapsed: "
-             << timer.elapsed () << "secs" << common::endl;
-        out->pop_domain ();
-        if (can_free) {
-            if (out) {
-                delete out;
-            }
-        }
-        out = 0;
     }
-};
+};//end struct ScopeSummary
 
+static bool
+has_more_exclusive_time (const ScopeSummary &a_left,
+                         const ScopeSummary &a_right)
+{
+    return a_left.exclusive_time > a_right.exclusive_time;
+}
+
+typedef std::map<const ScopeLogger::Site*, ScopeSummary> ScopeSummaries;
 
-ScopeLogger::ScopeLogger (const char*a_scope_name,
-                          enum LogStream::LogLevel a_level,
-                          const UString &a_log_domain,
-                          bool a_use_default_log_stream) :
-    m_priv (new ScopeLoggerPriv (a_scope_name, a_level,
-                                 a_log_domain, a_use_default_log_stream))
+static void
+summarize_node (const ScopeProfileNode &a_node, ScopeSummaries &a_summaries)
 {
+    if (a_node.site) {
+        ScopeSummary &summary = a_summaries[a_node.site];
+        summary.name = a_node.site->name;
+        summary.nb_calls += a_node.nb_calls;
+        summary.inclusive_time += a_node.inclusive_time;
+        summary.exclusive_time +=
+            a_node.inclusive_time - a_node.children_time;
+    }
+    for (ScopeProfileNode::Children::const_iterator it =
+             a_node.children.begin ();
+         it != a_node.children.end ();
+         ++it)
+        summarize_node (*it->second, a_summaries);
 }
 
-ScopeLogger::~ScopeLogger ()
+/// Write the scopes that took the most time by themselves, with
+/// their number of calls and their inclusive and exclusive times,
+/// summed over all their call paths and all the threads.  The
+/// inclusive time of a recursive scope counts the nested calls more
+/// than once.
+/// \param a_out where to write the summary.
+/// \param a_max_nb_scopes the maximum number of scopes to write.
+void
+ScopeLogger::write_profile_summary (std::ostream &a_out,
+                                    unsigned a_max_nb_scopes)
 {
-    //commented this out for performance reasons.
-    //yeah, real reasons that got highlighted by profiling!
-    //LOG_DD (DELETE);
+    ScopeSummaries summaries;
+    {
+        Glib::Mutex::Lock lock (get_profile_threads_mutex ());
+        const std::vector<ScopeProfileThread*> &threads =
+            get_profile_threads ();
+        for (unsigned i = 0; i < threads.size (); ++i)
+            summarize_node (threads[i]->root, summaries);
+    }
+
+    std::vector<ScopeSummary> sorted;
+    for (ScopeSummaries::const_iterator it = summaries.begin ();
+         it != summaries.end ();
+         ++it)
+        sorted.push_back (it->second);
+    std::sort (sorted.begin (), sorted.end (), has_more_exclusive_time);
+
+    a_out << "calls\tinclusive(ms)\texclusive(ms)\tscope\n";
+    for (unsigned i = 0; i < sorted.size () && i < a_max_nb_scopes; ++i)
+        a_out << sorted[i].nb_calls << '\t'
+              << sorted[i].inclusive_time / 1000.0 << '\t'
+              << sorted[i].exclusive_time / 1000.0 << '\t'
+              << sorted[i].name << '\n';
+    a_out.flush ();
 }
 
 }//end namespace common
 }//end namespace nemiver
-
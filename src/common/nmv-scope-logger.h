@@ -30,32 +30,121 @@
 #ifndef __NMV_SCOPE_LOGGER_H__
 #define __NMV_SCOPE_LOGGER_H__
 
+#include <ostream>
+#include <string>
+#include <glib.h>
 #include "nmv-api-macros.h"
 #include "nmv-log-stream-utils.h"
-#include "nmv-safe-ptr-utils.h"
 
 namespace nemiver {
 namespace common {
 
-struct ScopeLoggerPriv;
+struct ScopeProfileNode;
+
+/// Logs the entry and the exit of a scope, or, if profiling is on,
+/// accounts the time spent in the scope.
+///
+/// A ScopeLogger is instanciated at each entry of a scope, by the
+/// LOG_SCOPE* and LOG_FUNCTION_SCOPE* macros, so it is meant to cost
+/// nothing when neither logging nor profiling is on: it then neither
+/// allocates memory nor looks the log domain up.  Whether the
+/// domain of a scope is enabled is cached in the ScopeLogger::Site
+/// of the scope, and only looked up again after the log settings
+/// changed.
+///
+/// When profiling is on, the scopes are not logged.  Instead, each
+/// thread accounts the number of calls and the time spent in each
+/// scope, per call path, and the result can be written as a flame
+/// graph compatible report with ScopeLogger::write_profile.
 class NEMIVER_API ScopeLogger
 {
-    friend struct ScopeLoggerPriv;
+public:
+
+    /// A place where a scope is logged.  There is one static
+    /// instance of this per LOG_SCOPE* macro expansion.
+    struct NEMIVER_API Site {
+        const char *name;
+        std::string domain;
+        enum LogStream::LogLevel level;
+        // The generation of the log settings is_enabled was
+        // computed for.
+        volatile gint generation;
+        volatile gint is_enabled;
+
+        Site (const char *a_name,
+              enum LogStream::LogLevel a_level,
+              const UString &a_domain);
+
+        void update (gint a_generation);
+
+        bool is_logging_enabled ()
+        {
+            gint cur = g_atomic_int_get (&s_generation);
+            if (G_UNLIKELY (g_atomic_int_get (&generation) != cur))
+                update (cur);
+            return g_atomic_int_get (&is_enabled);
+        }
+    };//end struct Site
+
+private:
+    // Bumped each time the log settings change.
+    static volatile gint s_generation;
+    static volatile gint s_is_profiling;
+
+    Site &m_site;
+    // What the constructor did: 0, LOGGED or PROFILED.
+    int m_action;
+    gint64 m_start;
+    ScopeProfileNode *m_node;
+
+    enum {LOGGED = 1, PROFILED = 2};
 
-    SafePtr<ScopeLoggerPriv> m_priv;
     //forbid copy/assignation
     ScopeLogger (ScopeLogger const &);
     ScopeLogger& operator= (ScopeLogger const &);
     ScopeLogger ();
 
+    void enter_profile ();
+    void leave_profile ();
+    void log_entry ();
+    void log_exit ();
+
 public:
 
-    ScopeLogger (const char*a_scope_name,
-                 enum LogStream::LogLevel a_level=LogStream::LOG_LEVEL_NORMAL,
-                 const UString &a_log_domain=NMV_GENERAL_DOMAIN,
-                 bool a_use_default_log_stream=true);
+    ScopeLogger (Site &a_site) :
+        m_site (a_site),
+        m_action (0),
+        m_start (0),
+        m_node (0)
+    {
+        if (G_UNLIKELY (g_atomic_int_get (&s_is_profiling)))
+            enter_profile ();
+        else if (G_UNLIKELY (m_site.is_logging_enabled ()))
+            log_entry ();
+    }
+
+    ~ScopeLogger ()
+    {
+        if (G_LIKELY (!m_action))
+            return;
+        if (m_action == PROFILED)
+            leave_profile ();
+        else
+            log_exit ();
+    }
+
+    static void invalidate_sites ();
+
+    static void start_profiling ();
 
-    virtual ~ScopeLogger ();
+    static void stop_profiling ();
+
+    static bool is_profiling ();
+
+    static void write_profile (std::ostream &a_out);
+
+    static void write_profile_summary (std::ostream &a_out,
+                                       unsigned a_max_nb_scopes = 30);
 
 };//class ScopeLogger
 
@@ -63,4 +152,3 @@ public:
 }//end namespace nemiver
 
 #endif
-
@@ -0,0 +1,127 @@
+/*
+ *This file is part of the Nemiver project
+ *
+ *Nemiver is free software; you can redistribute
+ *it and/or modify it under the terms of
+ *the GNU General Public License as published by the
+ *Free Software Foundation; either version 2,
+ *or (at your option) any later version.
+ *
+ *Nemiver is distributed in the hope that it will
+ *be useful, but WITHOUT ANY WARRANTY;
+ *without even the implied warranty of
+ *MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ *See the GNU General Public License for more details.
+ *
+ *You should have received a copy of the
+ *GNU General Public License along with Nemiver;
+ *see the file COPYING.
+ *If not, write to the Free Software Foundation,
+ *Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+ *
+ *See COPYRIGHT file copyright information.
+ */
+#ifndef __NMV_SPSC_QUEUE_H__
+#define __NMV_SPSC_QUEUE_H__
+
+#include <vector>
+#include "nmv-namespace.h"
+
+NEMIVER_BEGIN_NAMESPACE (nemiver)
+NEMIVER_BEGIN_NAMESPACE (common)
+
+/// A bounded, lock-free queue between exactly one producer thread
+/// and exactly one consumer thread.
+///
+/// Only the producer may call push, and only the consumer may call
+/// pop.  Neither of them ever blocks: push returns false when the
+/// queue is full and pop returns false when it is empty.
+///
+/// Popping an element resets its slot to T (), so the references
+/// the element holds are dropped by the consumer thread.
+template<class T>
+class SPSCQueue {
+    // non copyable
+    SPSCQueue (const SPSCQueue &);
+    SPSCQueue& operator= (const SPSCQueue &);
+
+    std::vector<T> m_slots;
+    size_t m_mask;
+    // The index of the next element to pop.  Only written by the
+    // consumer.
+    volatile size_t m_head;
+    // The index of the next element to push.  Only written by the
+    // producer.
+    volatile size_t m_tail;
+
+public:
+
+    /// \param a_capacity the number of elements the queue can hold.
+    /// It is rounded up to a power of two.
+    explicit SPSCQueue (size_t a_capacity = 64) :
+        m_mask (0),
+        m_head (0),
+        m_tail (0)
+    {
+        size_t size = 2;
+        while (size < a_capacity)
+            size <<= 1;
+        m_slots.resize (size);
+        m_mask = size - 1;
+    }
+
+    /// Append an element to the queue.
+    ///
+    /// \param a_value the element to append.
+    ///
+    /// \return true if the element was appended, false if the queue
+    /// was full.
+    bool push (const T &a_value)
+    {
+        size_t tail = m_tail;
+        if (tail - m_head == m_slots.size ())
+            return false;
+        // Make sure the consumer is done with the slot before
+        // writing it.
+        __sync_synchronize ();
+        m_slots[tail & m_mask] = a_value;
+        // Publish the element before publishing the new tail.
+        __sync_synchronize ();
+        m_tail = tail + 1;
+        return true;
+    }
+
+    /// Remove the first element of the queue.
+    ///
+    /// \param a_value output parameter.  Set to the element removed.
+    ///
+    /// \return true if an element was removed, false if the queue
+    /// was empty.
+    bool pop (T &a_value)
+    {
+        size_t head = m_head;
+        if (head == m_tail)
+            return false;
+        // Don't read the element before having seen the tail that
+        // published it.
+        __sync_synchronize ();
+        a_value = m_slots[head & m_mask];
+        m_slots[head & m_mask] = T ();
+        // Be done with the slot before handing it back.
+        __sync_synchronize ();
+        m_head = head + 1;
+        return true;
+    }
+
+    /// \return true if the queue is empty.  This is only a hint
+    /// when called by the producer.
+    bool empty () const
+    {
+        return m_head == m_tail;
+    }
+};//end class SPSCQueue
+
+NEMIVER_END_NAMESPACE (common)
+NEMIVER_END_NAMESPACE (nemiver)
+
+#endif // __NMV_SPSC_QUEUE_H__
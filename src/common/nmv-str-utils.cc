@@ -35,16 +35,22 @@ NEMIVER_BEGIN_NAMESPACE (str_utils)
 using nemiver::common::UString;
 using namespace nemiver::common;
 
-static const char *SUPPORTED_ENCODINGS[] =
+/// A byte order mark, and the encoding it denotes.
+struct ByteOrderMark {
+    const char *bytes;
+    std::string::size_type size;
+    const char *encoding;
+};
+
+static const ByteOrderMark BYTE_ORDER_MARKS[] =
 {
-    "UTF-8",
-    "ISO-8859",
-    "ISO-8859-1",
-    "ISO-8859-15",
+    {"\xEF\xBB\xBF", 3, "UTF-8"},
+    {"\xFF\xFE", 2, "UTF-16LE"},
+    {"\xFE\xFF", 2, "UTF-16BE"},
 };
 
-#define SIZE_OF_SUPPORTED_ENCODINGS \
-sizeof (SUPPORTED_ENCODINGS)/sizeof (SUPPORTED_ENCODINGS[0])
+#define SIZE_OF_BYTE_ORDER_MARKS \
+sizeof (BYTE_ORDER_MARKS)/sizeof (BYTE_ORDER_MARKS[0])
 
 
 static bool
@@ -336,14 +342,125 @@ vprintf (const UString &a_format, va_list a_args)
     return result;
 }
 
+/// \return true if a_buffer is valid UTF-8.
+///
+/// Source files are mostly made of ASCII, so the buffer is first
+/// scanned one machine word at a time, until a word that contains a
+/// non ASCII or a nul byte is found.  Only the rest of the buffer is
+/// then handed to g_utf8_validate.
 bool
 is_buffer_valid_utf8 (const char *a_buffer, unsigned a_len)
 {
-    
     RETURN_VAL_IF_FAIL (a_buffer, false);
+
+    typedef unsigned long Word;
+    const Word ones = ~(Word) 0 / 0xFF;
+    const Word high_bits = ones * 0x80;
+
+    unsigned i = 0;
+    for (; i + sizeof (Word) <= a_len; i += sizeof (Word)) {
+        Word word;
+        memcpy (&word, a_buffer + i, sizeof (Word));
+        // Stop on a word with a non ASCII byte, or with a nul byte.
+        if ((word & high_bits) || ((word - ones) & ~word & high_bits))
+            break;
+    }
+
     const char *end=0;
-    bool is_valid = g_utf8_validate (a_buffer, a_len, &end);
-    return is_valid;
+    return g_utf8_validate (a_buffer + i, a_len - i, &end);
+}
+
+/// Guess the encoding of a buffer in a single pass.
+///
+/// A byte order mark wins, if any.  Otherwise, if the buffer is
+/// valid UTF-8, that is its encoding.  Otherwise the buffer is
+/// assumed to be in one of the common 8-bit character sets, and the
+/// bytes it contains tell which one:
+///
+///  - bytes in the 0x80-0x9F range are control characters in the
+///  ISO-8859 character sets, so they are hardly ever found in text
+///  files, whereas they are printable characters in WINDOWS-1252,
+///  except for a handful of them.
+///
+///  - 0xA4 is the euro sign in ISO-8859-15 and the (rarely used)
+///  currency sign in ISO-8859-1.
+///
+/// \param a_input the buffer to consider.
+///
+/// \param a_encoding the resulting encoding.
+///
+/// \param a_bom_size the size of the byte order mark that starts the
+/// buffer, or zero if there is none.
+void
+detect_buffer_encoding (const std::string &a_input,
+                        std::string &a_encoding,
+                        std::string::size_type &a_bom_size)
+{
+    a_bom_size = 0;
+    for (unsigned i = 0; i < SIZE_OF_BYTE_ORDER_MARKS; ++i) {
+        const ByteOrderMark &bom = BYTE_ORDER_MARKS[i];
+        if (!a_input.compare (0, bom.size, bom.bytes, bom.size)) {
+            a_encoding = bom.encoding;
+            a_bom_size = bom.size;
+            return;
+        }
+    }
+
+    if (is_buffer_valid_utf8 (a_input.c_str (), a_input.size ())) {
+        a_encoding = "UTF-8";
+        return;
+    }
+
+    unsigned nb_c1_bytes = 0, nb_undefined_in_cp1252 = 0;
+    bool has_euro_sign = false;
+    for (std::string::const_iterator it = a_input.begin ();
+         it != a_input.end ();
+         ++it) {
+        unsigned char c = *it;
+        if (c < 0x80) {
+            continue;
+        } else if (c <= 0x9F) {
+            ++nb_c1_bytes;
+            if (c == 0x81 || c == 0x8D || c == 0x8F
+                || c == 0x90 || c == 0x9D)
+                ++nb_undefined_in_cp1252;
+        } else if (c == 0xA4) {
+            has_euro_sign = true;
+        }
+    }
+
+    if (nb_c1_bytes && !nb_undefined_in_cp1252)
+        a_encoding = "WINDOWS-1252";
+    else if (has_euro_sign)
+        a_encoding = "ISO-8859-15";
+    else
+        a_encoding = "ISO-8859-1";
+}
+
+/// Convert a buffer to UTF-8.
+///
+/// \param a_input the buffer to convert.
+///
+/// \param a_from_encoding the encoding of a_input.
+///
+/// \param a_output the resulting UTF-8 content.
+///
+/// \return true upon successful conversion, false otherwise.
+static bool
+convert_buffer_to_utf8 (const std::string &a_input,
+                        const std::string &a_from_encoding,
+                        UString &a_output)
+{
+    std::string utf8_content;
+    try {
+        utf8_content = Glib::convert (a_input, "UTF-8", a_from_encoding);
+    } catch (Glib::Exception &e) {
+        return false;
+    }
+    if (!a_input.empty () && utf8_content.empty ())
+        return false;
+    a_output = utf8_content;
+    return true;
 }
 
 bool
@@ -351,68 +468,86 @@ ensure_buffer_is_in_utf8 (const std::string &a_input,
 			  const std::list<std::string> &a_supported_encodings,
 			  UString &a_output)
 {
-    UString buf_content;
-    if (is_buffer_valid_utf8 (a_input.c_str (), a_input.size ())) {
+    std::string encoding;
+    return ensure_buffer_is_in_utf8 (a_input, a_supported_encodings,
+                                     "", a_output, encoding);
+}
+
+/// Convert a buffer to UTF-8, if it is not UTF-8 already.
+///
+/// The buffer is converted at most once, from the first of these
+/// encodings that works:
+///
+///  - the encoding denoted by the byte order mark of the buffer, if
+///  any;
+///
+///  - a_known_encoding, typically the encoding that was detected the
+///  last time the same file was loaded;
+///
+///  - the encodings listed by the user, in order;
+///
+///  - the 8-bit encoding guessed by detect_buffer_encoding.
+///
+/// \param a_input the buffer to convert.
+///
+/// \param a_supported_encodings the encodings the user listed.
+///
+/// \param a_known_encoding the encoding to try first, or an empty
+/// string.
+///
+/// \param a_output the resulting UTF-8 content.
+///
+/// \param a_encoding the encoding a_input turned out to be in.
+///
+/// \return true upon successful conversion, false otherwise.
+bool
+ensure_buffer_is_in_utf8 (const std::string &a_input,
+                          const std::list<std::string> &a_supported_encodings,
+                          const std::string &a_known_encoding,
+                          UString &a_output,
+                          std::string &a_encoding)
+{
+    std::string detected_encoding;
+    std::string::size_type bom_size = 0;
+    detect_buffer_encoding (a_input, detected_encoding, bom_size);
+
+    if (bom_size) {
+        a_encoding = detected_encoding;
+        return convert_buffer_to_utf8 (a_input.substr (bom_size),
+                                       a_encoding, a_output);
+    }
+
+    if (detected_encoding == "UTF-8") {
+        a_encoding = detected_encoding;
         a_output = a_input;
         return true;
     }
 
-    UString utf8_content;
-    bool converted = false;
-
-    // get the list of candidate encodings that could be the encoding
-    // of the a_input. If for a reason we cannot sucessfully proceed
-    // with the conversion then we will fall back to a hardcoded list
-    // of encodings.
-    std::string current_charset;
-    if (!a_supported_encodings.empty ()) {
-        std::list<std::string>::const_iterator it;
-        for (it = a_supported_encodings.begin ();
-             it != a_supported_encodings.end ();
-             ++it) {
-            current_charset = *it;
-            try {
-                utf8_content =
-                    Glib::convert (a_input, "UTF-8", current_charset);
-            } catch (Glib::Exception &e) {
-                continue;
-            } catch (...) {
-                return false;
-            }
-            converted = true;
-            break;
-        }
+    if (!a_known_encoding.empty ()
+        && a_known_encoding != "UTF-8"
+        && convert_buffer_to_utf8 (a_input, a_known_encoding, a_output)) {
+        a_encoding = a_known_encoding;
+        return true;
     }
 
-    if (!converted) {
-        // fall back to trying the hardcoded list of supported encodings
-        for (unsigned int i=0; i < SIZE_OF_SUPPORTED_ENCODINGS; i++) {
-            try {
-                utf8_content =
-                    Glib::convert (a_input,
-                                   "UTF-8",
-                                   SUPPORTED_ENCODINGS[i]);
-            } catch (Glib::Exception &e) {
-                continue;
-            } catch (...) {
-                return false;
-            }
-            converted = true;
+    std::list<std::string>::const_iterator it;
+    for (it = a_supported_encodings.begin ();
+         it != a_supported_encodings.end ();
+         ++it) {
+        // The buffer is known not to be valid UTF-8.
+        if (*it == "UTF-8" || *it == a_known_encoding)
+            continue;
+        if (convert_buffer_to_utf8 (a_input, *it, a_output)) {
+            a_encoding = *it;
+            return true;
         }
     }
 
-    if (!converted)
-        return false;
-
-    const char *end=0;
-    if (utf8_content.empty ()
-        || !g_utf8_validate (utf8_content.raw ().c_str (),
-                             utf8_content.bytes (),
-                             &end)) {
-        return false;
+    if (convert_buffer_to_utf8 (a_input, detected_encoding, a_output)) {
+        a_encoding = detected_encoding;
+        return true;
     }
-    a_output = utf8_content;
-    return true;
+    return false;
 }
 
 NEMIVER_END_NAMESPACE (str_utils)
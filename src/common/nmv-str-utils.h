@@ -88,9 +88,20 @@ UString vprintf (const UString &a_format, va_list a_args);
 
 bool is_buffer_valid_utf8 (const char *a_buffer, unsigned a_len);
 
+void detect_buffer_encoding (const std::string &a_input,
+                             std::string &a_encoding,
+                             std::string::size_type &a_bom_size);
+
 bool ensure_buffer_is_in_utf8 (const std::string &a_input,
 			       const std::list<std::string> &supported_encodings,
 			       UString &a_output);
+
+bool ensure_buffer_is_in_utf8
+                        (const std::string &a_input,
+                         const std::list<std::string> &a_supported_encodings,
+                         const std::string &a_known_encoding,
+                         UString &a_output,
+                         std::string &a_encoding);
 			       
 
 NEMIVER_END_NAMESPACE (str_utils)
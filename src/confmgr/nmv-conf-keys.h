@@ -61,6 +61,11 @@ extern const char* CONF_KEY_DEFAULT_NUM_ASM_INSTRS;
 extern const char* CONF_KEY_FOLLOW_FORK_MODE;
 extern const char* CONF_KEY_DISASSEMBLY_FLAVOR;
 extern const char* CONF_KEY_PRETTY_PRINTING;
+extern const char* CONF_KEY_PRETTY_PRINTING_MAX_CHILDREN;
+extern const char* CONF_KEY_NO_PRETTY_PRINTING_TYPES;
+extern const char* CONF_KEY_NO_PRETTY_PRINTING_EXACT_TYPES;
+extern const char* CONF_KEY_NON_STOP_MODE;
+extern const char* CONF_KEY_STANDBY_GDB;
 extern const char* CONF_KEY_CONTEXT_PANE_LOCATION;
 extern const char* CONF_KEY_NEMIVER_CALLSTACK_EXPANSION_CHUNK;
 extern const char* CONF_KEY_DBG_PERSPECTIVE_LAYOUT;
@@ -86,6 +86,16 @@ const char* CONF_KEY_DISASSEMBLY_FLAVOR =
                 "/apps/nemiver/dbgperspective/disassembly-flavor";
 const char* CONF_KEY_PRETTY_PRINTING =
     "/apps/nemiver/dbgperspective/pretty-printing";
+const char* CONF_KEY_PRETTY_PRINTING_MAX_CHILDREN =
+    "/apps/nemiver/dbgperspective/pretty-printing-max-children";
+const char* CONF_KEY_NO_PRETTY_PRINTING_TYPES =
+    "/apps/nemiver/dbgperspective/no-pretty-printing-types";
+const char* CONF_KEY_NO_PRETTY_PRINTING_EXACT_TYPES =
+    "/apps/nemiver/dbgperspective/no-pretty-printing-exact-types";
+const char* CONF_KEY_NON_STOP_MODE =
+    "/apps/nemiver/dbgperspective/non-stop-mode";
+const char* CONF_KEY_STANDBY_GDB =
+    "/apps/nemiver/dbgperspective/standby-gdb";
 
 const char* CONF_KEY_CONTEXT_PANE_LOCATION =
                 "/apps/nemiver/dbgperspective/context-pane-location";
@@ -67,6 +67,13 @@ const char* CONF_KEY_GDB_BINARY = "gdb-binary";
 const char* CONF_KEY_FOLLOW_FORK_MODE = "follow-fork-mode";
 const char* CONF_KEY_DISASSEMBLY_FLAVOR = "disassembly-flavor";
 const char* CONF_KEY_PRETTY_PRINTING = "pretty-printing";
+const char* CONF_KEY_PRETTY_PRINTING_MAX_CHILDREN =
+  "pretty-printing-max-children";
+const char* CONF_KEY_NO_PRETTY_PRINTING_TYPES = "no-pretty-printing-types";
+const char* CONF_KEY_NO_PRETTY_PRINTING_EXACT_TYPES =
+  "no-pretty-printing-exact-types";
+const char* CONF_KEY_NON_STOP_MODE = "non-stop-mode";
+const char* CONF_KEY_STANDBY_GDB = "standby-gdb";
 const char* CONF_KEY_CONTEXT_PANE_LOCATION = "context-pane-location";
 const char* CONF_KEY_NEMIVER_CALLSTACK_EXPANSION_CHUNK =
                 "callstack-expansion-chunk";
@@ -222,7 +222,7 @@ update_debugger_variable (IDebugger::Variable &a_to,
     if (!a_from.value ().empty ())
         a_to.value (a_from.value ());
     if (!a_from.type ().empty ())
-        a_to.value (a_to.type ());
+        a_to.type (a_from.type ());
     a_to.has_more_children (a_from.has_more_children ());
     a_to.in_scope (a_from.in_scope ());
     a_to.is_dynamic (a_from.is_dynamic ());
@@ -97,13 +97,17 @@ class Command {
     IDebugger::VariableSafePtr m_var;
     sigc::slot_base m_slot;
     bool m_should_emit_signal;
+    bool m_is_refresh;
+    int m_refresh_thread;
 
 public:
 
     Command () :
     m_tag2 (0),
       m_slot (0),
-      m_should_emit_signal (true)
+      m_should_emit_signal (true),
+      m_is_refresh (false),
+      m_refresh_thread (-1)
     {
         clear ();
     }
@@ -113,7 +117,9 @@ public:
     m_value (a_value),
       m_tag2 (0),
       m_slot (0),
-      m_should_emit_signal (true)
+      m_should_emit_signal (true),
+      m_is_refresh (false),
+      m_refresh_thread (-1)
     {
     }
 
@@ -122,7 +128,9 @@ public:
       m_value (a_value),
       m_tag2 (0),
       m_slot (0),
-      m_should_emit_signal (true)
+      m_should_emit_signal (true),
+      m_is_refresh (false),
+      m_refresh_thread (-1)
     {
     }
 
@@ -134,7 +142,9 @@ public:
       m_value (a_value),
       m_tag2 (0),
       m_slot (0),
-      m_should_emit_signal (true)
+      m_should_emit_signal (true),
+      m_is_refresh (false),
+      m_refresh_thread (-1)
     {
     }
 
@@ -189,6 +199,16 @@ public:
     bool should_emit_signal () const {return m_should_emit_signal;}
     void should_emit_signal (bool a) {m_should_emit_signal = a;}
 
+    /// Whether the command was queued to refresh the views of the
+    /// state of the inferior, and so can be dropped once that state
+    /// is superseded.  See IDebugger::set_refreshing.
+    bool is_refresh () const {return m_is_refresh;}
+    void is_refresh (bool a) {m_is_refresh = a;}
+
+    /// The thread which state a refresh command lists.
+    int refresh_thread () const {return m_refresh_thread;}
+    void refresh_thread (int a) {m_refresh_thread = a;}
+
     /// @}
 
     void clear ()
@@ -201,6 +221,8 @@ public:
         m_tag3.clear ();
         m_tag4.clear ();
 	m_should_emit_signal = true;
+        m_is_refresh = false;
+        m_refresh_thread = -1;
     }
 };//end class Command
 
@@ -283,6 +305,7 @@ public:
         UString m_signal_meaning;
         bool m_has_modified_breakpoint;
         IDebugger::Breakpoint m_modified_breakpoint;
+        bool m_libraries_changed;
 
     public:
 
@@ -409,6 +432,13 @@ public:
 
         /// @}
 
+        /// Getter of the "libraries_changed" flag.  This flag is
+        /// true if the underlying debugging engine reports that a
+        /// shared library got loaded in, or unloaded from, the
+        /// inferior.
+        bool libraries_changed () const {return m_libraries_changed;}
+        void libraries_changed (bool a_in) {m_libraries_changed = a_in;}
+
 	void clear ()
 	{
 	    m_has_stream_record = false;
@@ -424,6 +454,7 @@ public:
 	    m_signal_type.clear ();
 	    m_has_modified_breakpoint = 0;
 	    m_modified_breakpoint.clear();
+	    m_libraries_changed = false;
 	}
     };//end class OutOfBandRecord
     typedef list<OutOfBandRecord> OutOfBandRecords;
@@ -474,6 +505,10 @@ public:
         std::list<int> m_thread_list;
         bool m_has_thread_list;
 
+        //threads info listed members
+        std::list<IDebugger::ThreadInfo> m_thread_info_list;
+        bool m_has_thread_info_list;
+
         //files listed members
         std::vector<UString> m_file_list;
         bool m_has_file_list;
@@ -505,6 +540,10 @@ public:
         size_t m_memory_address;
         bool m_has_memory_values;
 
+        // blocks of memory read with -data-read-memory-bytes
+        std::list<IDebugger::MemoryBlock> m_memory_blocks;
+        bool m_has_memory_blocks;
+
         // asm instruction list
         std::list<common::Asm> m_asm_instrs;
         bool m_has_asm_instrs;
@@ -519,6 +558,8 @@ public:
         // Children variables of a given variable.
         vector<IDebugger::VariableSafePtr> m_variable_children;
         bool m_has_variable_children;
+        // True if the variable has more children than those listed.
+        bool m_variable_children_has_more;
 
 	// A list of the changes that occurred on a given variable.
 	// Whenever a user issues IDebugger::list_changed_variables on
@@ -561,6 +602,8 @@ public:
             m_has_variable_value = false;
             m_thread_list.clear ();
             m_has_thread_list = false;
+            m_thread_info_list.clear ();
+            m_has_thread_info_list = false;
             m_thread_id = 0;
             m_frame_in_thread.clear ();
             m_thread_id_got_selected = false;
@@ -576,11 +619,14 @@ public:
             m_memory_values.clear ();
             m_memory_address = 0;
             m_has_memory_values = false;
+            m_memory_blocks.clear ();
+            m_has_memory_blocks = false;
             m_asm_instrs.clear ();
 	    m_has_asm_instrs = false;
 	    m_has_variable = false;
             m_nb_variable_deleted = 0;
             m_has_variable_children = false;
+            m_variable_children_has_more = false;
 	    m_var_changes.clear ();
             m_has_var_changes = false;
 	    m_new_num_children = -1;
@@ -671,6 +717,18 @@ public:
             has_memory_values (true);
         }
 
+        bool has_memory_blocks () const { return m_has_memory_blocks; }
+        void has_memory_blocks (bool a_flag) { m_has_memory_blocks = a_flag; }
+        const std::list<IDebugger::MemoryBlock>& memory_blocks () const
+        {
+            return m_memory_blocks;
+        }
+        void memory_blocks (const std::list<IDebugger::MemoryBlock> &a_blocks)
+        {
+            m_memory_blocks = a_blocks;
+            has_memory_blocks (true);
+        }
+
         bool has_asm_instruction_list () const {return m_has_asm_instrs;}
         void has_asm_instruction_list (bool a) {m_has_asm_instrs = a;}
 
@@ -736,6 +794,19 @@ public:
             has_thread_list (true);
         }
 
+        bool has_thread_info_list () const {return m_has_thread_info_list;}
+        void has_thread_info_list (bool a_in) {m_has_thread_info_list = a_in;}
+
+        const std::list<IDebugger::ThreadInfo>& thread_info_list () const
+        {
+            return m_thread_info_list;
+        }
+        void thread_info_list (const std::list<IDebugger::ThreadInfo> &a_in)
+        {
+            m_thread_info_list = a_in;
+            has_thread_info_list (true);
+        }
+
         bool thread_id_got_selected () const {return m_thread_id_got_selected;}
         void thread_id_got_selected (bool a_in) {m_thread_id_got_selected = a_in;}
 
@@ -825,6 +896,15 @@ public:
             has_variable_children (true);
         }
 
+        bool variable_children_has_more () const
+        {
+            return m_variable_children_has_more;
+        }
+        void variable_children_has_more (bool a_in)
+        {
+            m_variable_children_has_more = a_in;
+        }
+
         bool has_var_changes () const
         {
             return m_has_var_changes;
@@ -25,6 +25,7 @@
 #include <iostream>
 #include "nmv-debugger-utils.h"
 #include "common/nmv-exception.h"
+#include "common/nmv-str-utils.h"
 
 NEMIVER_BEGIN_NAMESPACE (nemiver)
 NEMIVER_BEGIN_NAMESPACE (debugger_utils)
@@ -193,5 +194,172 @@ variable_format_to_string (IDebugger::Variable::Format a_format)
     return result;
 }
 
+/// Build an expression that evaluates to both the address and the
+/// size of the object designated by a_expression, so that
+/// parse_watchpoint_extent can get them from a single evaluation.
+///
+/// \param a_expression the expression of a watched object.
+///
+/// \return an expression of type pointer to array of char, which
+/// value is printed like "(char (*)[72]) 0x7fffffffe3a0".
+UString
+watchpoint_extent_expression (const UString &a_expression)
+{
+    return "(char (*)[sizeof (" + a_expression + ")]) &("
+        + a_expression + ")";
+}
+
+/// Read the address and the size of a watched object from the value
+/// of the expression built by watchpoint_extent_expression.
+///
+/// \param a_value the value, like "(char (*)[72]) 0x7fffffffe3a0".
+///
+/// \param a_address output parameter.  The address of the object.
+///
+/// \param a_size output parameter.  The size of the object.
+///
+/// \return true upon successful completion.
+bool
+parse_watchpoint_extent (const UString &a_value,
+                         size_t &a_address,
+                         size_t &a_size)
+{
+    const std::string &value = a_value.raw ();
+    std::string::size_type size_start = value.find (")[");
+    std::string::size_type addr_start = value.find (") 0x");
+    if (size_start == std::string::npos
+        || addr_start == std::string::npos)
+        return false;
+
+    gchar *end = 0;
+    guint64 size =
+        g_ascii_strtoull (value.c_str () + size_start + 2, &end, 10);
+    if (!end || *end != ']')
+        return false;
+    guint64 address =
+        g_ascii_strtoull (value.c_str () + addr_start + 2, &end, 16);
+    if (!end || (*end && !g_ascii_isspace (*end)))
+        return false;
+
+    a_size = size;
+    a_address = address;
+    return true;
+}
+
+/// Split the region of memory of a watched object into aligned
+/// chunks that debug registers can watch, and tell whether the
+/// watchpoint can be a hardware one.
+///
+/// A debug register watches a region which size is a power of two,
+/// at most a_max_chunk_size, and which address is a multiple of that
+/// size.  So the region is covered from its start with the biggest
+/// such chunks that fit.  If more chunks are needed than there are
+/// debug registers, the debugger would resort to a software
+/// watchpoint.
+///
+/// \param a_address the address of the watched object.
+///
+/// \param a_size the size of the watched object.
+///
+/// \param a_max_chunk_size the size of the biggest region a debug
+/// register can watch.
+///
+/// \param a_nb_registers the number of debug registers.
+///
+/// \param a_plan output parameter.  Its mode, address, size, chunks
+/// and number of registers are set.
+void
+plan_watchpoint (size_t a_address,
+                 size_t a_size,
+                 unsigned a_max_chunk_size,
+                 unsigned a_nb_registers,
+                 IDebugger::WatchpointPlan &a_plan)
+{
+    a_plan.address (a_address);
+    a_plan.size (a_size);
+    a_plan.nb_registers (a_nb_registers);
+    a_plan.chunks ().clear ();
+
+    size_t cur = a_address, end = a_address + a_size;
+    while (cur < end && a_plan.chunks ().size () <= a_nb_registers) {
+        unsigned chunk_size = a_max_chunk_size;
+        while (chunk_size > 1
+               && (cur % chunk_size || cur + chunk_size > end))
+            chunk_size /= 2;
+        a_plan.chunks ().push_back
+            (IDebugger::WatchpointPlan::Chunk (cur, chunk_size));
+        cur += chunk_size;
+    }
+
+    if (a_size && cur >= end && a_plan.chunks ().size () <= a_nb_registers)
+        a_plan.mode (IDebugger::WatchpointPlan::HARDWARE_MODE);
+    else
+        a_plan.mode (IDebugger::WatchpointPlan::SOFTWARE_MODE);
+}
+
+/// Split the message of a dprintf, as typed by the user, into its
+/// format and its arguments.
+///
+/// \param a_message the message, like "i = %d, j = %d\n", i, f (i, j)
+///
+/// \param a_format output parameter.  The format, without its
+/// double quotes.
+///
+/// \param a_args output parameter.  The expressions of the arguments.
+///
+/// \return true upon successful completion, false if a_message doesn't
+/// start with a double quoted format.
+bool
+split_dprintf_message (const UString &a_message,
+                       UString &a_format,
+                       vector<UString> &a_args)
+{
+    const string &msg = a_message.raw ();
+    string::size_type cur = msg.find_first_not_of (" \t");
+    if (cur == string::npos || msg[cur] != '"')
+        return false;
+
+    string::size_type start = ++cur;
+    for (; cur < msg.size () && msg[cur] != '"'; ++cur)
+        if (msg[cur] == '\\')
+            ++cur;
+    if (cur >= msg.size ())
+        return false;
+    a_format = msg.substr (start, cur - start);
+
+    // The arguments are separated by the commas that are outside of
+    // any parenthesis, bracket or string literal.
+    a_args.clear ();
+    int depth = 0;
+    char quote = 0;
+    string arg;
+    for (++cur; cur < msg.size (); ++cur) {
+        char c = msg[cur];
+        if (quote) {
+            if (c == '\\' && cur + 1 < msg.size ())
+                arg += msg[cur++];
+            else if (c == quote)
+                quote = 0;
+        } else if (c == '"' || c == '\'') {
+            quote = c;
+        } else if (c == '(' || c == '[' || c == '{') {
+            ++depth;
+        } else if ((c == ')' || c == ']' || c == '}') && depth) {
+            --depth;
+        } else if (c == ',' && !depth) {
+            str_utils::chomp (arg);
+            if (!arg.empty ())
+                a_args.push_back (arg);
+            arg.clear ();
+            continue;
+        }
+        arg += c;
+    }
+    str_utils::chomp (arg);
+    if (!arg.empty ())
+        a_args.push_back (arg);
+    return true;
+}
+
 NEMIVER_END_NAMESPACE (debugger_utils)
 NEMIVER_END_NAMESPACE (nemiver)
@@ -81,6 +81,42 @@ std::string variable_format_to_string (IDebugger::Variable::Format);
 
 IDebuggerSafePtr load_debugger_iface_with_gconf ();
 
+/// The number of debug registers, and the size of the biggest region
+/// one of them can watch.  Only those of x86 processors are known;
+/// elsewhere, watchpoints are not planned and GDB chooses their kind
+/// on its own.  These are the registers of the machine Nemiver is
+/// built for, so they are wrong for a remote target of another
+/// architecture.
+#if defined (__x86_64__)
+const bool HW_WATCHPOINT_REGISTERS_KNOWN = true;
+const unsigned NB_HW_WATCHPOINT_REGISTERS = 4;
+const unsigned MAX_HW_WATCHPOINT_SIZE = 8;
+#elif defined (__i386__)
+const bool HW_WATCHPOINT_REGISTERS_KNOWN = true;
+const unsigned NB_HW_WATCHPOINT_REGISTERS = 4;
+const unsigned MAX_HW_WATCHPOINT_SIZE = 4;
+#else
+const bool HW_WATCHPOINT_REGISTERS_KNOWN = false;
+const unsigned NB_HW_WATCHPOINT_REGISTERS = 0;
+const unsigned MAX_HW_WATCHPOINT_SIZE = 0;
+#endif
+
+UString watchpoint_extent_expression (const UString &a_expression);
+
+bool parse_watchpoint_extent (const UString &a_value,
+                              size_t &a_address,
+                              size_t &a_size);
+
+void plan_watchpoint (size_t a_address,
+                      size_t a_size,
+                      unsigned a_max_chunk_size,
+                      unsigned a_nb_registers,
+                      IDebugger::WatchpointPlan &a_plan);
+
+bool split_dprintf_message (const UString &a_message,
+                            UString &a_format,
+                            vector<UString> &a_args);
+
 // Template implementations.
 
 template<class ostream_type>
@@ -22,18 +22,23 @@
  *
  *See COPYRIGHT file copyright information.
  */
+#include <cstdlib>
 #include <cstring>
 #include <ctype.h>
 #include <unistd.h>
 #include <fcntl.h>
 #include <signal.h>
+#include <sys/stat.h>
+#include <sys/wait.h>
 #include <termios.h>
 #include <sstream>
 #include <boost/variant.hpp>
 #include <algorithm>
 #include <memory>
+#include <set>
 #include <fstream>
 #include <iostream>
+#include <glibmm/timer.h>
 #include "nmv-i-debugger.h"
 #include "common/nmv-env.h"
 #include "common/nmv-exception.h"
@@ -41,6 +46,7 @@
 #include "common/nmv-proc-utils.h"
 #include "common/nmv-str-utils.h"
 #include "nmv-gdb-engine.h"
+#include "nmv-gdbmi-reader.h"
 #include "langs/nmv-cpp-parser.h"
 #include "langs/nmv-cpp-ast-utils.h"
 #include "nmv-i-lang-trait.h"
@@ -68,6 +74,9 @@ static const char* DEFAULT_GDB_BINARY = "default-gdb-binary";
 static const char* GDB_DEFAULT_PRETTY_PRINTING_VISUALIZER =
     "gdb.default_visualizer";
 static const char* GDB_NULL_PRETTY_PRINTING_VISUALIZER = "None";
+static const char* VAROBJ_COST_DOMAIN = "varobj-cost-domain";
+// The default of the CONF_KEY_PRETTY_PRINTING_MAX_CHILDREN key.
+static const int DEFAULT_PRETTY_PRINTING_MAX_CHILDREN = 1000;
 
 NEMIVER_BEGIN_NAMESPACE (nemiver)
 
@@ -75,6 +84,11 @@ extern const char* CONF_KEY_GDB_BINARY;
 extern const char* CONF_KEY_FOLLOW_FORK_MODE;
 extern const char* CONF_KEY_DISASSEMBLY_FLAVOR;
 extern const char* CONF_KEY_PRETTY_PRINTING;
+extern const char* CONF_KEY_PRETTY_PRINTING_MAX_CHILDREN;
+extern const char* CONF_KEY_NO_PRETTY_PRINTING_TYPES;
+extern const char* CONF_KEY_NO_PRETTY_PRINTING_EXACT_TYPES;
+extern const char* CONF_KEY_NON_STOP_MODE;
+extern const char* CONF_KEY_STANDBY_GDB;
 
 // Helper function to handle escaping the arguments 
 static UString
@@ -92,6 +106,32 @@ quote_args (const vector<UString> &a_prog_args)
     return args;
 }
 
+/// Quote a string so that GDB/MI reads it back as one argument.
+static UString
+quote_mi_c_string (const UString &a_str)
+{
+    string result = "\"";
+    for (string::const_iterator it = a_str.raw ().begin ();
+         it != a_str.raw ().end ();
+         ++it) {
+        if (*it == '"' || *it == '\\')
+            result += '\\';
+        result += *it;
+    }
+    return result + "\"";
+}
+
+/// Return the name of the root variable object of the variable
+/// object named a_name, e.g, "var12" for "var12.public.m_age".
+static UString
+root_varobj_name (const UString &a_name)
+{
+    UString::size_type dot = a_name.find ('.');
+    if (dot == UString::npos)
+        return a_name;
+    return a_name.substr (0, dot);
+}
+
 //**************************************************************
 // <Helper functions to generate a serialized form of location>
 //**************************************************************
@@ -202,15 +242,64 @@ public:
     int gdb_stderr_fd;
     int master_pty_fd;
     bool is_attached;
+    // A GDB launched ahead of time with the same command line as the
+    // current one, so that it has loaded the symbols of the program
+    // by the time the program is loaded again, e.g. to restart it.
+    // It is then adopted in place of a freshly launched GDB.  Its
+    // output is left unread until then.
+    struct StandbyGDB {
+        vector<UString> argv;
+        time_t prog_mtime;
+        Glib::Pid pid;
+        int stdout_fd;
+        int stderr_fd;
+        int master_pty_fd;
+
+        StandbyGDB () :
+            prog_mtime (0),
+            pid (0),
+            stdout_fd (-1),
+            stderr_fd (-1),
+            master_pty_fd (-1)
+        {}
+    };
+    StandbyGDB standby_gdb;
+    // True if a standby GDB is to be launched once a program is
+    // loaded.
+    bool standby_gdb_enabled;
+    // The command line of the GDB that is loading a program, for the
+    // standby GDB to be launched with once it is loaded.
+    vector<UString> pending_standby_argv;
+    // Measures the time it takes from the launch of GDB to the
+    // loading of the program.
+    Glib::Timer load_timer;
+    bool is_timing_load;
+    bool load_uses_standby_gdb;
     Glib::RefPtr<Glib::IOChannel> gdb_stdout_channel;
     Glib::RefPtr<Glib::IOChannel> gdb_stderr_channel;
     Glib::RefPtr<Glib::IOChannel> master_pty_channel;
-    std::string gdb_stdout_buffer;
+    GDBMIFramer gdb_stdout_framer;
     std::string gdb_stderr_buffer;
     list<Command> queued_commands;
     list<Command> started_commands;
     bool line_busy;
+    // Whether the commands queued now are refreshing the views of
+    // the state of the inferior.  See IDebugger::set_refreshing.
+    bool is_refreshing;
     map<string, IDebugger::Breakpoint> cached_breakpoints;
+    // "-var-update *" updates all the variable objects at once, and
+    // GDB won't report the changes again.  The changes to variable
+    // objects nobody asked about are kept here, by root variable
+    // object name, until somebody lists the changes of that root.
+    map<UString, list<VarChangePtr> > unclaimed_var_changes;
+    // The number of debug registers the hardware watchpoints set by
+    // set_watchpoint use, by watched expression.
+    map<string, unsigned> watchpoint_nb_registers;
+    // The register names only depend on the architecture of the
+    // inferior, so they are listed once per inferior and served from
+    // here afterwards.
+    map<IDebugger::register_id_t, UString> cached_register_names;
+    bool register_names_cached;
     enum InBufferStatus {
         DEFAULT,
         FILLING,
@@ -228,6 +317,18 @@ public:
     int tty_fd;
     int cur_frame_level;
     int cur_thread_num;
+    // True if GDB is to be set in non-stop mode the next time it is
+    // launched.
+    bool non_stop_mode_requested;
+    // True if GDB accepted to be set in non-stop mode when it was
+    // launched.
+    bool non_stop_mode;
+    // All the threads of the inferior are running if threads_running
+    // is true, and stopped otherwise, but the threads which ids are in
+    // threads_in_other_state.  Unless GDB is in non-stop mode, that
+    // set is always empty.
+    bool threads_running;
+    std::set<int> threads_in_other_state;
     Address cur_frame_address;
     ILangTraitSafePtr lang_trait;
     UString non_persistent_debugger_path;
@@ -235,12 +336,38 @@ public:
     UString follow_fork_mode;
     UString disassembly_flavor;
     GDBMIParser gdbmi_parser;
+    // Interns the function, file and library names of the frames
+    // parsed by gdbmi_parser, as they are the same from one stop to
+    // another.
+    StringInternTableSafePtr string_intern_table;
+    // Reads and parses the output of GDB on a thread of its own,
+    // when that is supported.  Otherwise, gdb_stdout_channel is
+    // read and parsed from the main loop.
+    SafePtr<GDBMIReader> gdbmi_reader;
     bool enable_pretty_printing;
     // Once pretty printing has been globally enabled once, there is
     // no command to globally disable it.  So once it has been enabled
     // globally, we shouldn't try to globally enable it again.  So
     // let's keep track of if we enabled it once.
     bool pretty_printing_enabled_once;
+    // The maximum number of children of a variable to fetch through
+    // its pretty-printer, or 0 for no limit.
+    int pretty_printing_max_children;
+    // True if the user chose pretty_printing_max_children, in which
+    // case it is also the number of elements of arrays and strings GDB
+    // prints.  Otherwise GDB keeps its own default for that.
+    bool print_elements_limited;
+    // Patterns of the types of the variables that must be displayed
+    // without pretty-printer.
+    list<UString> no_pretty_printing_types;
+    // Types of the variables that must be displayed without
+    // pretty-printer, matched as they are spelled: as '*' is in
+    // pointer types, they can't be taken as patterns.
+    list<UString> no_pretty_printing_exact_types;
+    // Started whenever a command is sent to GDB.  As GDB is given one
+    // command at a time, it tells how long the command being handled
+    // took.
+    Glib::Timer command_timer;
     sigc::signal<void> gdb_died_signal;
     sigc::signal<void, const UString& > master_pty_signal;
     sigc::signal<void, const UString& > gdb_stdout_signal;
@@ -257,6 +384,8 @@ public:
 
     mutable sigc::signal<void, const UString&> log_message_signal;
 
+    mutable sigc::signal<void, const UString&> dprintf_output_signal;
+
     mutable sigc::signal<void, const UString&, const UString&>
                                                         command_done_signal;
 
@@ -297,6 +426,10 @@ public:
                          const list<int>,
                          const UString& > threads_listed_signal;
 
+    mutable sigc::signal<void,
+                         const list<IDebugger::ThreadInfo>&,
+                         const UString& > threads_info_listed_signal;
+
     mutable sigc::signal<void,
                          const vector<UString>&,
                          const UString& > files_listed_signal;
@@ -306,6 +439,8 @@ public:
                          const Frame * const,
                          const UString&> thread_selected_signal;
 
+    mutable sigc::signal<void> libraries_changed_signal;
+
     mutable sigc::signal<void, const vector<IDebugger::Frame>&, const UString&>
                                                     frames_listed_signal;
 
@@ -355,6 +490,8 @@ public:
 
     mutable sigc::signal<void> running_signal;
 
+    mutable sigc::signal<void, int, bool> thread_state_changed_signal;
+
     mutable sigc::signal<void, const UString&, const UString&>
                                                         signal_received_signal;
     mutable sigc::signal<void, const UString&> error_signal;
@@ -498,46 +635,53 @@ public:
         LOG_D ("<debuggeroutput>\n" << a_buf << "\n</debuggeroutput>",
                GDBMI_OUTPUT_DOMAIN);
 
-        Output output (a_buf);
-
-        UString::size_type from (0), to (0), end (a_buf.size ());
-        gdbmi_parser.push_input (a_buf);
-        for (; from < end;) {
-            if (!gdbmi_parser.parse_output_record (from, to, output)) {
-                LOG_ERROR ("output record parsing failed: "
-                        << a_buf.substr (from, end - from)
-                        << "\npart of buf: " << a_buf
-                        << "\nfrom: " << (int) from
-                        << "\nto: " << (int) to << "\n"
-                        << "\nstrlen: " << (int) a_buf.size ());
-                gdbmi_parser.skip_output_record (from, to);
-                output.parsing_succeeded (false);
-            } else {
-                output.parsing_succeeded (true);
-            }
+        list<CommandAndOutput> outputs;
+        GDBMIReader::parse_output (gdbmi_parser, a_buf, outputs);
+        dispatch_outputs (outputs);
+    }
 
+    void on_gdbmi_reader_records_signal (GDBMIReader::Records &a_records)
+    {
+        LOG_D ("<debuggeroutput>\n" << a_records.buffer
+               << "\n</debuggeroutput>",
+               GDBMI_OUTPUT_DOMAIN);
+        dispatch_outputs (a_records.outputs);
+    }
+
+    void on_gdbmi_reader_eof_signal ()
+    {
+        on_gdb_stdout_hup ();
+    }
+
+    /// Dispatch the parsed output records of a buffer sent by GDB to
+    /// the output handlers, and issue the next queued command once
+    /// GDB has acknowledged the current one.
+    void dispatch_outputs (list<CommandAndOutput> &a_outputs)
+    {
+        list<CommandAndOutput>::iterator it;
+        for (it = a_outputs.begin (); it != a_outputs.end (); ++it) {
+            CommandAndOutput &command_and_output = *it;
+            const Output &output = command_and_output.output ();
 
             // Check if the output contains the result to a command issued by
             // the user. If yes, build the CommandAndResult, update the
             // command queue and notify the user that the command it issued
             // has a result.
-
-            UString output_value;
-            output_value.assign (a_buf, from, to - from +1);
-            output.raw_value (output_value);
-            CommandAndOutput command_and_output;
             if (output.has_result_record ()) {
                 if (!started_commands.empty ()) {
                     command_and_output.command (*started_commands.begin ());
                 }
             }
-            command_and_output.output (output);
             LOG_DD ("received command was: '"
                     << command_and_output.command ().name ()
                     << "'");
+            // The commands queued while the result of a refresh
+            // command is handled are part of the refresh too.
+            bool was_refreshing = is_refreshing;
+            if (command_and_output.command ().is_refresh ())
+                is_refreshing = true;
             stdout_signal.emit (command_and_output);
-            from = to;
-            while (from < end && isspace (a_buf.raw ()[from])) {++from;}
+            is_refreshing = was_refreshing;
             if (output.has_result_record ()/*gdb acknowledged previous
                                              cmd*/
                 || !output.parsing_succeeded ()) {
@@ -556,7 +700,6 @@ public:
                 }
             }
         }
-        gdbmi_parser.pop_input ();
     }
 
     Priv (DynamicModule *a_dynmod) :
@@ -565,7 +708,12 @@ public:
         gdb_stdout_fd (0), gdb_stderr_fd (0),
         master_pty_fd (0),
         is_attached (false),
+        is_timing_load (false),
+        load_uses_standby_gdb (false),
+        standby_gdb_enabled (false),
         line_busy (false),
+        is_refreshing (false),
+        register_names_cached (false),
         error_buffer_status (DEFAULT),
         state (IDebugger::NOT_STARTED),
         is_running (false),
@@ -573,14 +721,31 @@ public:
         tty_fd (-1),
         cur_frame_level (0),
         cur_thread_num (1),
+        non_stop_mode_requested (false),
+        non_stop_mode (false),
+        threads_running (false),
         follow_fork_mode ("parent"),
         disassembly_flavor ("att"),
         gdbmi_parser (GDBMIParser::BROKEN_MODE),
         enable_pretty_printing (true),
-        pretty_printing_enabled_once (false)
+        pretty_printing_enabled_once (false),
+        pretty_printing_max_children (DEFAULT_PRETTY_PRINTING_MAX_CHILDREN),
+        print_elements_limited (false)
     {
         memset (&tty_attributes, 0, sizeof (tty_attributes));
 
+        string_intern_table.reset (new StringInternTable);
+        gdbmi_parser.set_string_intern_table (string_intern_table);
+
+        if (GDBMIReader::is_supported ()
+            && !g_getenv ("NMV_SYNCHRONOUS_MI_READER")) {
+            gdbmi_reader.reset (new GDBMIReader (string_intern_table));
+            gdbmi_reader->records_signal ().connect (sigc::mem_fun
+                (*this, &Priv::on_gdbmi_reader_records_signal));
+            gdbmi_reader->eof_signal ().connect (sigc::mem_fun
+                (*this, &Priv::on_gdbmi_reader_eof_signal));
+        }
+
         enable_pretty_printing =
             g_getenv ("NMV_DISABLE_PRETTY_PRINTING") == 0;
 
@@ -609,6 +774,10 @@ public:
 
     void free_resources ()
     {
+        if (gdbmi_reader) {
+            gdbmi_reader->stop ();
+        }
+        gdb_stdout_framer.clear ();
         if (gdb_pid) {
             g_spawn_close_pid (gdb_pid);
             gdb_pid = 0;
@@ -657,6 +826,14 @@ public:
             return;
         }
 
+        // In non-stop mode, the state is that of the current thread:
+        // while it runs, it can't be inspected, nor resumed.
+        if (a_state == IDebugger::READY
+            && non_stop_mode
+            && is_thread_running (cur_thread_num)) {
+            a_state = IDebugger::RUNNING;
+        }
+
         //don't emit any signal if a_state equals the
         //current state.
         if (state == a_state) {
@@ -728,12 +905,26 @@ public:
 
     bool launch_gdb_real (const vector<UString> a_argv)
     {
-        RETURN_VAL_IF_FAIL (launch_program (a_argv,
-                                            gdb_pid,
-                                            master_pty_fd,
-                                            gdb_stdout_fd,
-                                            gdb_stderr_fd),
-                            false);
+        // A new GDB might be debugging an inferior of a different
+        // architecture.
+        invalidate_register_names_cache ();
+        string_intern_table->purge ();
+
+        non_stop_mode = false;
+        threads_running = false;
+        threads_in_other_state.clear ();
+        unclaimed_var_changes.clear ();
+        pending_standby_argv.clear ();
+
+        load_uses_standby_gdb = adopt_standby_gdb (a_argv);
+        if (!load_uses_standby_gdb) {
+            RETURN_VAL_IF_FAIL (launch_program (a_argv,
+                                                gdb_pid,
+                                                master_pty_fd,
+                                                gdb_stdout_fd,
+                                                gdb_stderr_fd),
+                                false);
+        }
 
         RETURN_VAL_IF_FAIL (gdb_pid, false);
 
@@ -759,7 +950,10 @@ public:
                                  gdb_stderr_channel,
                                  get_event_loop_context ());
 
-        attach_channel_to_loop_context_as_source
+        if (!gdbmi_reader
+            || !gdbmi_reader->start (gdb_stdout_fd,
+                                     get_event_loop_context ())) {
+            attach_channel_to_loop_context_as_source
                                 (Glib::IO_IN | Glib::IO_PRI
                                  | Glib::IO_HUP | Glib::IO_ERR,
                                  sigc::mem_fun
@@ -767,10 +961,109 @@ public:
                                       &Priv::on_gdb_stdout_has_data_signal),
                                  gdb_stdout_channel,
                                  get_event_loop_context ());
+        }
+
+        return true;
+    }
 
+    /// Return the modification time of the file at a_path, or 0 if
+    /// it can't be known.
+    static time_t get_file_mtime (const UString &a_path)
+    {
+        struct stat st;
+        if (a_path.empty ()
+            || stat (Glib::filename_from_utf8 (a_path).c_str (), &st))
+            return 0;
+        return st.st_mtime;
+    }
+
+    /// Launch a standby GDB with the command line a_argv, in place of
+    /// the previous one, if any.  The last element of a_argv is the
+    /// path of the program to debug.
+    ///
+    /// Nothing is launched unless the CONF_KEY_STANDBY_GDB key is
+    /// set.  Setting the NMV_NO_STANDBY_GDB environment variable
+    /// disables standby GDBs altogether.
+    void launch_standby_gdb (const vector<UString> &a_argv)
+    {
+        LOG_FUNCTION_SCOPE_NORMAL_DD;
+
+        kill_standby_gdb ();
+        if (!standby_gdb_enabled
+            || a_argv.empty () || a_argv.back ().empty ()
+            || g_getenv ("NMV_NO_STANDBY_GDB"))
+            return;
+
+        if (!launch_program (a_argv,
+                             standby_gdb.pid,
+                             standby_gdb.master_pty_fd,
+                             standby_gdb.stdout_fd,
+                             standby_gdb.stderr_fd)) {
+            LOG_ERROR ("Could not launch a standby GDB");
+            standby_gdb = StandbyGDB ();
+            return;
+        }
+        standby_gdb.argv = a_argv;
+        standby_gdb.prog_mtime = get_file_mtime (a_argv.back ());
+        LOG_DD ("launched standby GDB " << (int) standby_gdb.pid);
+    }
+
+    void kill_standby_gdb ()
+    {
+        if (standby_gdb.pid) {
+            kill (standby_gdb.pid, SIGKILL);
+            waitpid (standby_gdb.pid, 0, 0);
+            g_spawn_close_pid (standby_gdb.pid);
+        }
+        if (standby_gdb.stdout_fd >= 0)
+            close (standby_gdb.stdout_fd);
+        if (standby_gdb.stderr_fd >= 0)
+            close (standby_gdb.stderr_fd);
+        if (standby_gdb.master_pty_fd >= 0)
+            close (standby_gdb.master_pty_fd);
+        standby_gdb = StandbyGDB ();
+    }
+
+    /// If the standby GDB was launched with the command line a_argv,
+    /// is still alive and the program didn't change on disk since it
+    /// was launched, make it the current GDB.  Otherwise, get rid of
+    /// the standby GDB.
+    ///
+    /// \return true if the standby GDB became the current GDB.
+    bool adopt_standby_gdb (const vector<UString> &a_argv)
+    {
+        LOG_FUNCTION_SCOPE_NORMAL_DD;
+
+        if (!standby_gdb.pid)
+            return false;
+
+        if (waitpid (standby_gdb.pid, 0, WNOHANG) != 0) {
+            LOG_ERROR ("The standby GDB died");
+            g_spawn_close_pid (standby_gdb.pid);
+            standby_gdb.pid = 0;
+        }
+        if (!standby_gdb.pid
+            || standby_gdb.argv != a_argv
+            || standby_gdb.prog_mtime != get_file_mtime (a_argv.back ())) {
+            kill_standby_gdb ();
+            return false;
+        }
+
+        gdb_pid = standby_gdb.pid;
+        master_pty_fd = standby_gdb.master_pty_fd;
+        gdb_stdout_fd = standby_gdb.stdout_fd;
+        gdb_stderr_fd = standby_gdb.stderr_fd;
+        standby_gdb = StandbyGDB ();
+        LOG_DD ("adopted standby GDB " << (int) gdb_pid);
         return true;
     }
 
+    void invalidate_register_names_cache ()
+    {
+        cached_register_names.clear ();
+        register_names_cached = false;
+    }
+
     bool find_prog_in_path (const UString &a_prog,
                             UString &a_prog_path)
     {
@@ -849,7 +1142,223 @@ public:
         argv.push_back (prog_path);
 
         source_search_dirs = a_source_search_dirs;
-        return launch_gdb_real (argv);
+        load_timer.start ();
+        is_timing_load = true;
+        if (!launch_gdb_real (argv))
+            return false;
+        // Get the next GDB ready, while the user debugs with this
+        // one.  That waits for this one to load the program, so that
+        // both don't compete for loading the symbols.
+        pending_standby_argv = argv;
+        queue_non_stop_mode_commands ();
+        return true;
+    }
+
+    /// If the user asked for it, set the GDB that was just launched
+    /// in non-stop mode.  GDB accepts that only before the inferior
+    /// is started or attached to, so a change of the setting is
+    /// taken into account the next time GDB is launched.
+    ///
+    /// The engine only considers GDB to be in non-stop mode once it
+    /// accepted it; see on_non_stop_mode_command_done.
+    void queue_non_stop_mode_commands ()
+    {
+        LOG_FUNCTION_SCOPE_NORMAL_DD;
+
+        non_stop_mode = false;
+        LOG_DD ("non-stop mode requested: "
+                << (int) non_stop_mode_requested);
+        if (!non_stop_mode_requested)
+            return;
+        queue_command (Command ("set-mi-async", "-gdb-set mi-async on"));
+    }
+
+    /// Carry on setting GDB in non-stop mode, once it answered one of
+    /// the commands queued to that end.  The next command is issued
+    /// right away, before the ones queued meanwhile, as GDB refuses
+    /// to change the mode once the inferior runs.
+    ///
+    /// \param a_command_name the name of the command GDB answered.
+    ///
+    /// \param a_succeeded true if GDB accepted the command.
+    void on_non_stop_mode_command_done (const UString &a_command_name,
+                                        bool a_succeeded)
+    {
+        LOG_FUNCTION_SCOPE_NORMAL_DD;
+
+        if (a_command_name == "set-mi-async") {
+            // mi-async is called target-async before GDB 7.8.
+            if (a_succeeded)
+                queued_commands.push_front
+                    (Command ("set-non-stop", "-gdb-set non-stop on"));
+            else
+                queued_commands.push_front
+                    (Command ("set-target-async",
+                              "-gdb-set target-async on"));
+        } else if (a_command_name == "set-target-async") {
+            if (a_succeeded)
+                queued_commands.push_front
+                    (Command ("set-non-stop", "-gdb-set non-stop on"));
+            else
+                LOG_ERROR ("GDB can't run asynchronously, "
+                           "staying in all-stop mode");
+        } else if (a_command_name == "set-non-stop") {
+            non_stop_mode = a_succeeded;
+        }
+        LOG_DD ("non-stop mode: " << (int) non_stop_mode);
+    }
+
+    bool is_thread_running (int a_thread_id) const
+    {
+        if (threads_in_other_state.count (a_thread_id))
+            return !threads_running;
+        return threads_running;
+    }
+
+    /// Record that a thread of the inferior got resumed, or stopped,
+    /// and emit thread_state_changed_signal if that changes anything.
+    ///
+    /// \param a_thread_id the id of the thread, or -1 to mean all the
+    /// threads.
+    ///
+    /// \param a_is_running true if the thread got resumed.
+    void set_thread_running (int a_thread_id, bool a_is_running)
+    {
+        if (a_thread_id < 0) {
+            if (threads_running == a_is_running
+                && threads_in_other_state.empty ())
+                return;
+            threads_running = a_is_running;
+            threads_in_other_state.clear ();
+        } else {
+            if (is_thread_running (a_thread_id) == a_is_running)
+                return;
+            if (a_is_running == threads_running)
+                threads_in_other_state.erase (a_thread_id);
+            else
+                threads_in_other_state.insert (a_thread_id);
+        }
+        thread_state_changed_signal.emit (a_thread_id, a_is_running);
+    }
+
+    /// Dispatch the changes reported by a "-var-update *" to the root
+    /// variables they belong to.  See
+    /// GDBEngine::list_changed_variables.
+    ///
+    /// \param a_changes the changes of all the variable objects.
+    ///
+    /// \param a_roots the root variables the caller asked about.
+    ///
+    /// \param a_slot the slot to call for each of a_roots.
+    ///
+    /// \param a_cookie the cookie to pass to changed_variables_signal.
+    void on_root_var_changes_listed
+                        (const list<VarChangePtr> &a_changes,
+                         const IDebugger::VariableList &a_roots,
+                         const IDebugger::VariableChangesSlot &a_slot,
+                         const UString &a_cookie)
+    {
+        map<UString, list<VarChangePtr> > changes_per_root;
+        for (list<VarChangePtr>::const_iterator it = a_changes.begin ();
+             it != a_changes.end ();
+             ++it) {
+            THROW_IF_FAIL ((*it)->variable ());
+            UString root =
+                root_varobj_name ((*it)->variable ()->internal_name ());
+            changes_per_root[root].push_back (*it);
+        }
+
+        IDebugger::VariableList::const_iterator it;
+        for (it = a_roots.begin (); it != a_roots.end (); ++it) {
+            THROW_IF_FAIL (*it);
+            const UString &root = (*it)->internal_name ();
+            list<VarChangePtr> changes;
+            map<UString, list<VarChangePtr> >::iterator c =
+                unclaimed_var_changes.find (root);
+            if (c != unclaimed_var_changes.end ()) {
+                changes.splice (changes.end (), c->second);
+                unclaimed_var_changes.erase (c);
+            }
+            c = changes_per_root.find (root);
+            if (c != changes_per_root.end ()) {
+                changes.splice (changes.end (), c->second);
+                changes_per_root.erase (c);
+            }
+
+            IDebugger::VariableList vars;
+            for (list<VarChangePtr>::const_iterator i = changes.begin ();
+                 i != changes.end ();
+                 ++i)
+                (*i)->apply_to_variable (*it, vars);
+            a_slot (vars, *it);
+            changed_variables_signal.emit (vars, a_cookie);
+        }
+
+        // Whatever is left belongs to roots somebody else watches.
+        map<UString, list<VarChangePtr> >::iterator c;
+        for (c = changes_per_root.begin ();
+             c != changes_per_root.end ();
+             ++c) {
+            list<VarChangePtr>::const_iterator i;
+            for (i = c->second.begin (); i != c->second.end (); ++i)
+                stash_unclaimed_var_change (c->first, *i);
+        }
+    }
+
+    /// Keep a change of a variable object aside, until somebody lists
+    /// the changes of its root a_root.  The change is merged into the
+    /// last change kept aside for the same variable object, so that
+    /// the changes of a root nobody looks at don't pile up at each
+    /// stop:
+    ///
+    ///  - its value, type and flags supersede the previous ones;
+    ///
+    ///  - children added on top of the children the previous change
+    ///    added are appended to them.
+    ///
+    /// Only a change that removes children is kept apart, as it can't
+    /// be told which children it removes before it is applied.
+    void stash_unclaimed_var_change (const UString &a_root,
+                                     const VarChangePtr &a_change)
+    {
+        list<VarChangePtr> &changes = unclaimed_var_changes[a_root];
+        const UString &name = a_change->variable ()->internal_name ();
+        list<VarChangePtr>::reverse_iterator prev;
+        for (prev = changes.rbegin (); prev != changes.rend (); ++prev) {
+            if ((*prev)->variable ()->internal_name () == name)
+                break;
+        }
+        if (prev == changes.rend ()) {
+            changes.push_back (a_change);
+            return;
+        }
+
+        int prev_num = (*prev)->new_num_children ();
+        int num = a_change->new_num_children ();
+        if (num < 0) {
+            update_debugger_variable (*(*prev)->variable (),
+                                      *a_change->variable ());
+        } else if (prev_num < 0) {
+            // a_change supersedes the previous change, but for the
+            // parts of the variable it doesn't report.
+            if (a_change->variable ()->type ().empty ())
+                a_change->variable ()->type
+                                ((*prev)->variable ()->type ());
+            changes.erase (--prev.base ());
+            changes.push_back (a_change);
+        } else if (num >= prev_num
+                   && (int) a_change->new_children ().size ()
+                       == num - prev_num) {
+            update_debugger_variable (*(*prev)->variable (),
+                                      *a_change->variable ());
+            (*prev)->new_children ().insert
+                                ((*prev)->new_children ().end (),
+                                 a_change->new_children ().begin (),
+                                 a_change->new_children ().end ());
+            (*prev)->new_num_children (num);
+        } else {
+            changes.push_back (a_change);
+        }
     }
 
     bool launch_gdb_and_set_args (const UString &working_dir,
@@ -894,8 +1403,30 @@ public:
             argv.push_back ("--mode=execute");
         }
 
-        argv.push_back (env::get_gdb_program ());
+        THROW_IF_FAIL (get_debugger_full_path () != "");
+        argv.push_back (get_debugger_full_path ());
         argv.push_back ("--interpreter=mi2");
+        // Most of the time it takes to open a big core is spent by
+        // GDB indexing the symbols of the program and of its shared
+        // libraries.  GDB 8.3 and later can keep these indexes in an
+        // index cache, so that the next core of the same program
+        // opens faster.  Older ones complain about the command, so it
+        // is only used if NMV_CORE_INDEX_CACHE is set.  The command is
+        // set before anything is loaded, hence -iex.
+        const char *nmv_core_index_cache = g_getenv ("NMV_CORE_INDEX_CACHE");
+        if (nmv_core_index_cache && atoi (nmv_core_index_cache)) {
+            LOG_DD ("using the index cache of GDB");
+            argv.push_back ("-iex");
+            argv.push_back ("set index-cache on");
+        }
+        // For the really huge programs, the symbols can be not read
+        // at all.  The stack is then shown without function names
+        // and source locations, but it is shown right away.
+        const char *nmv_core_readnever = g_getenv ("NMV_CORE_READNEVER");
+        if (nmv_core_readnever && atoi (nmv_core_readnever)) {
+            LOG_DD ("not reading the symbols of the core file");
+            argv.push_back ("--readnever");
+        }
         argv.push_back (a_prog_path);
         argv.push_back (a_core_path);
         return launch_gdb_real (argv);
@@ -923,6 +1454,7 @@ public:
                 (a_command.value () + "\n") == Glib::IO_STATUS_NORMAL) {
             master_pty_channel->flush ();
             THROW_IF_FAIL (started_commands.size () <= 1);
+            command_timer.start ();
 
             if (a_do_record)
                 started_commands.push_back (a_command);
@@ -938,11 +1470,82 @@ public:
         return false;
     }
 
+    /// \return true if a_command resumes the inferior.
+    bool resumes_inferior (const Command &a_command) const
+    {
+        return (a_command.value ().raw ().compare (0, 6, "-exec-") == 0
+                && a_command.name () != "interrupt");
+    }
+
+    /// \return true if a_command only lists a part of the state of
+    /// the inferior, without changing anything in GDB, so that it can
+    /// be dropped if that state is gone before it is sent.  Commands
+    /// that create, update or delete variable objects are not.
+    bool is_droppable_listing (const Command &a_command) const
+    {
+        const UString &name = a_command.name ();
+        return (name == "list-frames"
+                || name == "list-frames-arguments"
+                || name == "list-local-variables"
+                || name == "list-register-names"
+                || name == "list-register-values"
+                || name == "list-changed-registers"
+                || name == "list-threads"
+                || name == "list-threads-info");
+    }
+
+    /// \return true if a_command is a refresh command that the
+    /// resumption of the inferior made useless.
+    ///
+    /// \param a_resumed_thread the thread that is about to be resumed
+    /// in non-stop mode, or -1 to consider the threads that are
+    /// running.  In all-stop mode, the whole inferior is resumed.
+    bool is_superseded_refresh (const Command &a_command,
+                                int a_resumed_thread) const
+    {
+        if (!a_command.is_refresh ())
+            return false;
+        if (!non_stop_mode)
+            return true;
+        if (a_resumed_thread >= 0)
+            return a_command.refresh_thread () == a_resumed_thread;
+        return is_thread_running (a_command.refresh_thread ());
+    }
+
+    /// Drop the queued refresh commands that the resumption of the
+    /// inferior made useless.  See IDebugger::drop_refresh_commands.
+    ///
+    /// \param a_resumed_thread see is_superseded_refresh.
+    unsigned drop_refresh_commands (int a_resumed_thread = -1)
+    {
+        unsigned nb_dropped = 0;
+        list<Command>::iterator it = queued_commands.begin ();
+        while (it != queued_commands.end ()) {
+            if (is_superseded_refresh (*it, a_resumed_thread)) {
+                LOG_DD ("dropping command: '" << it->value () << "'");
+                it = queued_commands.erase (it);
+                ++nb_dropped;
+            } else {
+                ++it;
+            }
+        }
+        return nb_dropped;
+    }
+
     bool queue_command (const Command &a_command)
     {
         bool result (false);
         LOG_DD ("queuing command: '" << a_command.value () << "'");
+        // The refresh commands that didn't go out yet would describe
+        // a state the inferior is about to leave.  In non-stop mode,
+        // only the current thread is resumed.
+        if (!is_refreshing && resumes_inferior (a_command))
+            drop_refresh_commands (non_stop_mode ? cur_thread_num : -1);
         queued_commands.push_back (a_command);
+        if (is_refreshing && is_droppable_listing (a_command)) {
+            queued_commands.back ().is_refresh (true);
+            queued_commands.back ().refresh_thread (cur_thread_num);
+        }
         if (!line_busy && started_commands.empty ()) {
             result = issue_command (*queued_commands.begin (), true);
             queued_commands.erase (queued_commands.begin ());
@@ -986,6 +1589,54 @@ public:
                                         disassembly_flavor);
         get_conf_mgr ()->get_key_value (CONF_KEY_PRETTY_PRINTING,
                                         enable_pretty_printing);
+        get_conf_mgr ()->get_key_value (CONF_KEY_PRETTY_PRINTING_MAX_CHILDREN,
+                                        pretty_printing_max_children);
+        print_elements_limited = (pretty_printing_max_children
+                                  != DEFAULT_PRETTY_PRINTING_MAX_CHILDREN);
+        get_conf_mgr ()->get_key_value (CONF_KEY_NO_PRETTY_PRINTING_TYPES,
+                                        no_pretty_printing_types);
+        get_conf_mgr ()->get_key_value
+                                (CONF_KEY_NO_PRETTY_PRINTING_EXACT_TYPES,
+                                 no_pretty_printing_exact_types);
+        get_conf_mgr ()->get_key_value (CONF_KEY_NON_STOP_MODE,
+                                        non_stop_mode_requested);
+        get_conf_mgr ()->get_key_value (CONF_KEY_STANDBY_GDB,
+                                        standby_gdb_enabled);
+    }
+
+    /// Tell GDB how many elements of arrays and strings to print, if
+    /// the user chose the maximum number of children to fetch through
+    /// pretty-printers.  That also limits what the pretty-printers of
+    /// containers print.
+    void set_print_elements_limit ()
+    {
+        if (!print_elements_limited)
+            return;
+        set_debugger_parameter
+            ("print elements",
+             UString::from_int (pretty_printing_max_children < 0
+                                ? 0
+                                : pretty_printing_max_children));
+    }
+
+    /// Return true iff variables of type a_type must be displayed
+    /// without pretty-printer.
+    bool is_pretty_printing_disabled_for_type (const UString &a_type) const
+    {
+        if (a_type.empty ())
+            return false;
+        if (std::find (no_pretty_printing_exact_types.begin (),
+                       no_pretty_printing_exact_types.end (),
+                       a_type) != no_pretty_printing_exact_types.end ())
+            return true;
+        list<UString>::const_iterator it;
+        for (it = no_pretty_printing_types.begin ();
+             it != no_pretty_printing_types.end ();
+             ++it) {
+            if (g_pattern_match_simple (it->c_str (), a_type.c_str ()))
+                return true;
+        }
+        return false;
     }
 
     /// Lists the frames which numbers are in a given range.
@@ -1069,6 +1720,16 @@ public:
                                     "set inferior-tty " + a_tty_path));
     }
 
+    /// Called when GDB has closed its standard output.
+    void on_gdb_stdout_hup ()
+    {
+        LOG_ERROR ("Connection lost from stdout channel to gdb");
+        gdb_stdout_channel.clear ();
+        kill_gdb ();
+        gdb_died_signal.emit ();
+        LOG_ERROR ("GDB killed");
+    }
+
     bool on_gdb_stdout_has_data_signal (Glib::IOCondition a_cond)
     {
         if (!gdb_stdout_channel) {
@@ -1084,64 +1745,27 @@ public:
             Glib::IOStatus status (Glib::IO_STATUS_NORMAL);
             std::string meaningful_buffer;
             while (true) {
-                memset (buf, 0, CHUNK_SIZE + 1);
                 status = gdb_stdout_channel->read (buf, CHUNK_SIZE, nb_read);
                 if (status == Glib::IO_STATUS_NORMAL &&
                     nb_read && (nb_read <= CHUNK_SIZE)) {
-                    std::string raw_str (buf, nb_read);
-                    gdb_stdout_buffer.append (raw_str);
+                    gdb_stdout_framer.push (buf, nb_read);
                 } else {
                     break;
                 }
                 nb_read = 0;
             }
-            LOG_DD ("gdb_stdout_buffer: <buf>"
-                    << gdb_stdout_buffer
-                    << "</buf>");
-
-            UString::size_type i = 0;
-            while ((i = gdb_stdout_buffer.find ("\n(gdb)")) !=
-                   std::string::npos) {
-                i += 6;/*is the offset in the buffer of the end of
-                         *of the '(gdb)' prompt
-                         */
-                int size = i+1;
-                //basically, gdb can send more or less than a complete
-                //output record. So let's take that in account in the way
-                //we manage he incoming buffer.
-                //TODO: optimize the way we handle this so that we do
-                //less allocation and copying.
-                meaningful_buffer = gdb_stdout_buffer.substr (0, size);
-                str_utils::chomp (meaningful_buffer);
-                meaningful_buffer += '\n';
+
+            //basically, gdb can send more or less than a complete
+            //output record. So let's take that in account in the way
+            //we manage he incoming buffer.
+            while (gdb_stdout_framer.pop (meaningful_buffer)) {
                 LOG_DD ("emiting gdb_stdout_signal () with '"
                         << meaningful_buffer << "'");
                 gdb_stdout_signal.emit (meaningful_buffer);
-                gdb_stdout_buffer.erase (0, size);
-                while (!gdb_stdout_buffer.empty ()
-                       && isspace (gdb_stdout_buffer[0])) {
-                    gdb_stdout_buffer.erase (0,1);
-                }
-            }
-            if (gdb_stdout_buffer.find ("[0] cancel")
-                    != std::string::npos
-                && gdb_stdout_buffer.find ("> ")
-                    != std::string::npos) {
-                // this is not a gdbmi ouptut, but rather a plain gdb
-                // command line. It is actually a prompt sent by gdb
-                // to let the user choose between a list of
-                // overloaded functions
-                LOG_DD ("emitting gdb_stdout_signal.emit()");
-                gdb_stdout_signal.emit (gdb_stdout_buffer);
-                gdb_stdout_buffer.clear ();
             }
         }
         if (a_cond & Glib::IO_HUP) {
-            LOG_ERROR ("Connection lost from stdout channel to gdb");
-            gdb_stdout_channel.clear ();
-            kill_gdb ();
-            gdb_died_signal.emit ();
-            LOG_ERROR ("GDB killed");
+            on_gdb_stdout_hup ();
         }
         if (a_cond & Glib::IO_ERR) {
             LOG_ERROR ("Error over the wire");
@@ -1213,6 +1837,21 @@ public:
     void on_state_changed_signal (IDebugger::State a_state)
     {
         state = a_state;
+
+        if (a_state == IDebugger::INFERIOR_LOADED && is_timing_load) {
+            load_timer.stop ();
+            is_timing_load = false;
+            LOG_D ("program loaded in "
+                   << (int) (load_timer.elapsed () * 1000) << "ms"
+                   << (load_uses_standby_gdb ? " by the standby GDB" : ""),
+                   "gdb-loading-domain");
+        }
+        if (a_state == IDebugger::INFERIOR_LOADED
+            && !pending_standby_argv.empty ()) {
+            vector<UString> argv;
+            argv.swap (pending_standby_argv);
+            launch_standby_gdb (argv);
+        }
     }
 
     void on_thread_selected_signal (unsigned a_thread_id,
@@ -1226,6 +1865,12 @@ public:
         if (a_frame)
             cur_frame_level = a_frame->level ();
 
+        // The newly selected thread might be running, or not.
+        if (non_stop_mode)
+            set_state (is_thread_running (cur_thread_num)
+                       ? IDebugger::RUNNING
+                       : IDebugger::READY);
+
         NEMIVER_CATCH_NOX
     }
 
@@ -1289,6 +1934,33 @@ public:
                     pretty_printing_enabled_once = true;
                 }
             }
+        } else if (a_key == CONF_KEY_PRETTY_PRINTING_MAX_CHILDREN
+                   && conf_mgr->get_key_value (a_key,
+                                               pretty_printing_max_children,
+                                               a_namespace)) {
+            print_elements_limited = true;
+            if (is_gdb_running ())
+                set_print_elements_limit ();
+        } else if (a_key == CONF_KEY_NO_PRETTY_PRINTING_TYPES) {
+            no_pretty_printing_types.clear ();
+            conf_mgr->get_key_value (a_key,
+                                     no_pretty_printing_types,
+                                     a_namespace);
+        } else if (a_key == CONF_KEY_NO_PRETTY_PRINTING_EXACT_TYPES) {
+            no_pretty_printing_exact_types.clear ();
+            conf_mgr->get_key_value (a_key,
+                                     no_pretty_printing_exact_types,
+                                     a_namespace);
+        } else if (a_key == CONF_KEY_NON_STOP_MODE) {
+            conf_mgr->get_key_value (a_key,
+                                     non_stop_mode_requested,
+                                     a_namespace);
+        } else if (a_key == CONF_KEY_STANDBY_GDB
+                   && conf_mgr->get_key_value (a_key,
+                                               standby_gdb_enabled,
+                                               a_namespace)) {
+            if (!standby_gdb_enabled)
+                kill_standby_gdb ();
         } else if (a_key == CONF_KEY_DISASSEMBLY_FLAVOR
                    && conf_mgr->get_key_value (a_key,
                                                disassembly_flavor,
@@ -1315,6 +1987,7 @@ public:
     ~Priv ()
     {
         kill_gdb ();
+        kill_standby_gdb ();
     }
 };//end GDBEngine::Priv
 
@@ -1329,9 +2002,14 @@ public:
 
 struct OnStreamRecordHandler: OutputHandler {
     GDBEngine *m_engine;
+    // True if the output of the last dprintf didn't end with a new
+    // line yet: GDB can split the message of one hit across several
+    // console records, of which only the first one is marked.
+    bool m_dprintf_line_open;
 
     OnStreamRecordHandler (GDBEngine *a_engine) :
-        m_engine (a_engine)
+        m_engine (a_engine),
+        m_dprintf_line_open (false)
     {}
 
     bool can_handle (CommandAndOutput &a_in)
@@ -1351,14 +2029,44 @@ struct OnStreamRecordHandler: OutputHandler {
 
         list<Output::OutOfBandRecord>::const_iterator iter;
         UString debugger_console, target_output, debugger_log;
+        UString dprintf_output;
+        static const UString::size_type marker_len =
+            strlen (GDBMI_DPRINTF_MARKER);
 
         for (iter = a_in.output ().out_of_band_records ().begin ();
              iter != a_in.output ().out_of_band_records ().end ();
              ++iter) {
             if (iter->has_stream_record ()) {
-                if (iter->stream_record ().debugger_console () != ""){
-                    debugger_console +=
-                        iter->stream_record ().debugger_console ();
+                const UString &console =
+                    iter->stream_record ().debugger_console ();
+                bool marked = !console.raw ().compare
+                                        (0, marker_len, GDBMI_DPRINTF_MARKER);
+                if (marked || (m_dprintf_line_open && console != "")) {
+                    // The output of a dprintf, or the rest of it; see
+                    // GDBEngine::set_dprintf.  GDB can put the
+                    // lines of several hits in the same record,
+                    // where only the last new line is unescaped.
+                    string lines = marked
+                        ? console.raw ().substr (marker_len)
+                        : console.raw ();
+                    string::size_type i = 0;
+                    while ((i = lines.find (GDBMI_DPRINTF_MARKER, i))
+                           != string::npos) {
+                        if (i > 1 && lines[i - 2] == '\\'
+                            && lines[i - 1] == 'n') {
+                            lines.replace (i - 2, 2 + marker_len, "\n");
+                            --i;
+                        } else if (i && lines[i - 1] == '\n') {
+                            lines.erase (i, marker_len);
+                        } else {
+                            ++i;
+                        }
+                    }
+                    dprintf_output += lines;
+                    m_dprintf_line_open =
+                        lines.empty () || lines[lines.size () - 1] != '\n';
+                } else if (console != "") {
+                    debugger_console += console;
                 }
                 if (iter->stream_record ().target_output () != ""){
                     target_output += iter->stream_record ().target_output ();
@@ -1380,6 +2088,10 @@ struct OnStreamRecordHandler: OutputHandler {
         if (!debugger_log.empty ()) {
             m_engine->log_message_signal ().emit (debugger_log);
         }
+
+        if (!dprintf_output.empty ()) {
+            m_engine->dprintf_output_signal ().emit (dprintf_output);
+        }
     }
 };//end struct OnStreamRecordHandler
 
@@ -1628,6 +2340,18 @@ struct OnBreakpointHandler: OutputHandler {
                     if (!i->has_modified_breakpoint ())
                         continue;
                     IDebugger::Breakpoint &b = i->modified_breakpoint ();
+                    IDebugger::Breakpoint cached;
+                    if (b.type () == IDebugger::Breakpoint::DPRINTF_TYPE
+                        && m_engine->get_breakpoint_from_cache (b.id (),
+                                                                cached)) {
+                        // A dprintf is modified each time it is hit,
+                        // as its hit count changes.  Don't make the
+                        // listeners reload it for that, as it can be
+                        // hit thousands of times per second.  Its
+                        // hit count shows up at the next listing.
+                        m_engine->append_breakpoint_to_cache (b);
+                        continue;
+                    }
                     LOG_DD ("bp " << b.id () << ": notify deleted");
                     notify_breakpoint_deleted_signal (b.id ());
                     LOG_DD ("bp "
@@ -1657,7 +2381,8 @@ struct OnBreakpointHandler: OutputHandler {
 
         if (has_breaks_set
             && (a_in.command ().name () == "set-breakpoint"
-                || a_in.command ().name () == "set-countpoint")) {
+                || a_in.command ().name () == "set-countpoint"
+                || a_in.command ().name () == "set-dprintf")) {
             // We are getting this reply b/c we did set a breakpoint;
             // be aware that sometimes GDB can actually set multiple
             // breakpoints as a result.
@@ -1708,6 +2433,94 @@ struct OnBreakpointHandler: OutputHandler {
     }
 };//end struct OnBreakpointHandler
 
+/// Keeps track of which threads of the inferior are running, from
+/// the *running and *stopped records GDB sends.
+struct OnThreadStateHandler: OutputHandler {
+    GDBEngine *m_engine;
+
+    OnThreadStateHandler (GDBEngine *a_engine) :
+        m_engine (a_engine)
+    {}
+
+    bool can_handle (CommandAndOutput &a_in)
+    {
+        if (!a_in.output ().has_out_of_band_record ())
+            return false;
+        list<Output::OutOfBandRecord>::const_iterator it;
+        for (it = a_in.output ().out_of_band_records ().begin ();
+             it != a_in.output ().out_of_band_records ().end ();
+             ++it) {
+            if (it->is_running () || it->is_stopped ())
+                return true;
+        }
+        return false;
+    }
+
+    void do_handle (CommandAndOutput &a_in)
+    {
+        LOG_FUNCTION_SCOPE_NORMAL_DD;
+
+        THROW_IF_FAIL (m_engine);
+
+        // Unless GDB is in non-stop mode, all the threads are resumed
+        // and stop together.
+        bool non_stop = m_engine->is_non_stop_mode ();
+        list<Output::OutOfBandRecord>::const_iterator it;
+        for (it = a_in.output ().out_of_band_records ().begin ();
+             it != a_in.output ().out_of_band_records ().end ();
+             ++it) {
+            if (it->is_running ()) {
+                m_engine->set_thread_running (non_stop ? it->thread_id () : -1,
+                                              true);
+            } else if (it->is_stopped ()) {
+                int thread_id = -1;
+                if (non_stop
+                    && !IDebugger::is_exited (it->stop_reason ())
+                    && it->thread_id () > 0)
+                    thread_id = it->thread_id ();
+                m_engine->set_thread_running (thread_id, false);
+            }
+        }
+    }
+};//end struct OnThreadStateHandler
+
+/// Follows the answers of GDB to the commands that set it in
+/// non-stop mode.
+struct OnNonStopModeHandler: OutputHandler {
+    GDBEngine *m_engine;
+
+    OnNonStopModeHandler (GDBEngine *a_engine) :
+        m_engine (a_engine)
+    {}
+
+    bool can_handle (CommandAndOutput &a_in)
+    {
+        if (a_in.output ().has_result_record ()
+            && (a_in.command ().name () == "set-mi-async"
+                || a_in.command ().name () == "set-target-async"
+                || a_in.command ().name () == "set-non-stop")) {
+            LOG_DD ("handler selected");
+            return true;
+        }
+        return false;
+    }
+
+    void do_handle (CommandAndOutput &a_in)
+    {
+        LOG_FUNCTION_SCOPE_NORMAL_DD;
+
+        THROW_IF_FAIL (m_engine);
+
+        bool succeeded = a_in.output ().result_record ().kind ()
+                            == Output::ResultRecord::DONE;
+        m_engine->on_non_stop_mode_command_done (a_in.command ().name (),
+                                                 succeeded);
+        // OnErrorHandler leaves the errors of set-mi-async alone.
+        if (!succeeded && a_in.command ().name () == "set-mi-async")
+            m_engine->set_state (IDebugger::READY);
+    }
+};//end struct OnNonStopModeHandler
+
 struct OnStoppedHandler: OutputHandler {
     GDBEngine *m_engine;
     Output::OutOfBandRecord m_out_of_band_record;
@@ -1766,6 +2579,26 @@ struct OnStoppedHandler: OutputHandler {
             || reason == IDebugger::WATCHPOINT_SCOPE)
             breakpoint_number = m_out_of_band_record.breakpoint_number ();
 
+        // In non-stop mode, the other threads keep running.  If the
+        // user is looking at another stopped thread, don't get in
+        // the way: the thread list shows this one stopped.
+        // Otherwise, make the stopped thread the current one, so
+        // that what is listed from now on is about it.
+        if (m_engine->is_non_stop_mode ()
+            && !IDebugger::is_exited (reason)
+            && thread_id > 0
+            && thread_id != (int) m_engine->get_current_thread ()) {
+            if (!m_engine->is_thread_running
+                                    (m_engine->get_current_thread ())) {
+                LOG_DD ("thread " << thread_id << " stopped, "
+                        "staying on thread "
+                        << (int) m_engine->get_current_thread ());
+                m_engine->set_state (IDebugger::READY);
+                return;
+            }
+            m_engine->select_thread (thread_id);
+        }
+
         if (m_out_of_band_record.has_frame ()) {
             m_engine->set_current_frame_level
                     (m_out_of_band_record.frame ().level ());
@@ -1851,6 +2684,37 @@ struct OnThreadListHandler : OutputHandler {
     }
 };//end OnThreadListHandler
 
+struct OnThreadInfoListHandler : OutputHandler {
+    GDBEngine *m_engine;
+
+    OnThreadInfoListHandler (GDBEngine *a_engine) :
+        m_engine (a_engine)
+    {}
+
+    bool can_handle (CommandAndOutput &a_in)
+    {
+        THROW_IF_FAIL (m_engine);
+        if (a_in.output ().has_result_record ()
+            && a_in.output ().result_record ().has_thread_info_list ()) {
+            return true;
+        }
+        return false;
+    }
+
+    void do_handle (CommandAndOutput &a_in)
+    {
+        LOG_FUNCTION_SCOPE_NORMAL_DD;
+
+        THROW_IF_FAIL (m_engine);
+        LOG_DD ("num threads parsed: "
+                << (int) a_in.output ().result_record ()
+                                       .thread_info_list ().size ());
+        m_engine->threads_info_listed_signal ().emit
+            (a_in.output ().result_record ().thread_info_list (),
+             a_in.command ().cookie ());
+    }
+};//end OnThreadInfoListHandler
+
 struct OnThreadSelectedHandler : OutputHandler {
     GDBEngine *m_engine;
     long thread_id;
@@ -1900,6 +2764,40 @@ struct OnThreadSelectedHandler : OutputHandler {
     }
 };//end OnThreadSelectedHandler
 
+struct OnLibrariesChangedHandler : OutputHandler {
+
+    GDBEngine *m_engine;
+
+    OnLibrariesChangedHandler (GDBEngine *a_engine) :
+        m_engine (a_engine)
+    {}
+
+    bool can_handle (CommandAndOutput &a_in)
+    {
+        if (!a_in.output ().has_out_of_band_record ())
+            return false;
+        list<Output::OutOfBandRecord>::const_iterator it;
+        for (it = a_in.output ().out_of_band_records ().begin ();
+             it != a_in.output ().out_of_band_records ().end ();
+             ++it) {
+            if (it->libraries_changed ())
+                return true;
+        }
+        return false;
+    }
+
+    void do_handle (CommandAndOutput &)
+    {
+        LOG_FUNCTION_SCOPE_NORMAL_DD;
+
+        THROW_IF_FAIL (m_engine);
+
+        // Emit only once, even if a bunch of libraries were loaded
+        // at once.
+        m_engine->libraries_changed_signal ().emit ();
+    }
+};//end OnLibrariesChangedHandler
+
 struct OnCommandDoneHandler : OutputHandler {
 
     GDBEngine *m_engine;
@@ -2666,6 +3564,8 @@ struct OnRegisterNamesListedHandler : OutputHandler {
     void do_handle (CommandAndOutput &a_in)
     {
         LOG_FUNCTION_SCOPE_NORMAL_DD;
+        m_engine->cache_register_names
+            (a_in.output ().result_record ().register_names ());
         m_engine->register_names_listed_signal ().emit
             (a_in.output ().result_record ().register_names (),
              a_in.command ().cookie ());
@@ -2763,22 +3663,69 @@ struct OnSetRegisterValueHandler : OutputHandler {
              a_in.command ().cookie ());
         m_engine->set_state (IDebugger::READY);
     }
-};//struct OnSetRegisterValueHandler
+};//struct OnSetRegisterValueHandler
+
+struct OnReadMemoryHandler : OutputHandler {
+
+    GDBEngine *m_engine;
+
+    OnReadMemoryHandler (GDBEngine *a_engine) :
+        m_engine (a_engine)
+    {}
+
+    bool can_handle (CommandAndOutput &a_in)
+    {
+        if (a_in.output ().has_result_record ()
+            && (a_in.output ().result_record ().kind ()
+                == Output::ResultRecord::DONE)
+            && (a_in.output ().result_record ().has_memory_values ()
+                || a_in.output ().result_record ().has_memory_blocks ())) {
+            LOG_DD ("handler selected");
+            return true;
+        }
+        // Memory that can't be read at all yields an empty result
+        // rather than an error.
+        if (a_in.output ().has_result_record ()
+            && (a_in.output ().result_record ().kind ()
+                == Output::ResultRecord::ERROR)
+            && a_in.command ().name () == "read-memory-bytes") {
+            LOG_DD ("handler selected");
+            return true;
+        }
+        return false;
+    }
+
+    void do_handle (CommandAndOutput &a_in)
+    {
+        LOG_FUNCTION_SCOPE_NORMAL_DD;
+        if (a_in.command ().name () == "read-memory-bytes") {
+            if (a_in.command ().has_slot ()) {
+                IDebugger::MemoryBlocksSlot slot =
+                    a_in.command ().get_slot<IDebugger::MemoryBlocksSlot> ();
+                slot (a_in.output ().result_record ().memory_blocks ());
+            }
+        } else {
+            m_engine->read_memory_signal ().emit
+                (a_in.output ().result_record ().memory_address (),
+                 a_in.output ().result_record ().memory_values (),
+                 a_in.command ().cookie ());
+        }
+        m_engine->set_state (IDebugger::READY);
+    }
+};//struct OnReadMemoryHandler
 
-struct OnReadMemoryHandler : OutputHandler {
+struct OnPlanWatchpointHandler : OutputHandler {
 
     GDBEngine *m_engine;
 
-    OnReadMemoryHandler (GDBEngine *a_engine) :
+    OnPlanWatchpointHandler (GDBEngine *a_engine) :
         m_engine (a_engine)
     {}
 
     bool can_handle (CommandAndOutput &a_in)
     {
-        if (a_in.output ().has_result_record ()
-            && (a_in.output ().result_record ().kind ()
-                == Output::ResultRecord::DONE)
-            && (a_in.output ().result_record ().has_memory_values ())) {
+        if (a_in.command ().name () == "plan-watchpoint"
+            && a_in.output ().has_result_record ()) {
             LOG_DD ("handler selected");
             return true;
         }
@@ -2788,13 +3735,39 @@ struct OnReadMemoryHandler : OutputHandler {
     void do_handle (CommandAndOutput &a_in)
     {
         LOG_FUNCTION_SCOPE_NORMAL_DD;
-        m_engine->read_memory_signal ().emit
-            (a_in.output ().result_record ().memory_address (),
-             a_in.output ().result_record ().memory_values (),
-             a_in.command ().cookie ());
+
+        // If the expression doesn't designate an object, e.g. because
+        // it is not an lvalue, GDB answers with an error and the mode
+        // of the plan stays unknown.
+        IDebugger::WatchpointPlan plan;
+        size_t address = 0, size = 0;
+        const Output::ResultRecord &record = a_in.output ().result_record ();
+        if (debugger_utils::HW_WATCHPOINT_REGISTERS_KNOWN
+            && record.kind () == Output::ResultRecord::DONE
+            && record.has_variable_value ()
+            && record.variable_value ()
+            && debugger_utils::parse_watchpoint_extent
+                                (record.variable_value ()->value (),
+                                 address, size)) {
+            debugger_utils::plan_watchpoint
+                (address, size,
+                 debugger_utils::MAX_HW_WATCHPOINT_SIZE,
+                 m_engine->get_nb_free_watchpoint_registers (),
+                 plan);
+        }
+        plan.expression (a_in.command ().tag0 ());
+        LOG_DD ("watchpoint on '" << plan.expression () << "': mode "
+                << (int) plan.mode () << ", "
+                << (int) plan.chunks ().size () << " chunks");
+
+        if (a_in.command ().has_slot ()) {
+            IDebugger::WatchpointPlanSlot slot =
+                a_in.command ().get_slot<IDebugger::WatchpointPlanSlot> ();
+            slot (plan);
+        }
         m_engine->set_state (IDebugger::READY);
     }
-};//struct OnReadMemoryHandler
+};//struct OnPlanWatchpointHandler
 
 struct OnSetMemoryHandler : OutputHandler
 {
@@ -2843,7 +3816,14 @@ struct OnErrorHandler : OutputHandler {
     {
         if (a_in.output ().has_result_record ()
             && (a_in.output ().result_record ().kind ()
-                == Output::ResultRecord::ERROR)) {
+                == Output::ResultRecord::ERROR)
+            // Handled by OnReadMemoryHandler.
+            && a_in.command ().name () != "read-memory-bytes"
+            // Handled by OnPlanWatchpointHandler.
+            && a_in.command ().name () != "plan-watchpoint"
+            // Expected from GDB older than 7.8; handled by
+            // OnNonStopModeHandler.
+            && a_in.command ().name () != "set-mi-async") {
             LOG_DD ("handler selected");
             return true;
         }
@@ -2902,10 +3882,10 @@ struct OnDisassembleHandler : OutputHandler {
         if (!instrs.empty ()) {
             std::list<common::Asm>::const_iterator it = instrs.begin ();
             if (!it->empty ()) {
-                info.start_address ((*it).instr ().address ());
+                info.start_address ((*it).instr ().address ().to_string ());
                 it = instrs.end ();
                 it--;
-                info.end_address ((*it).instr ().address ());
+                info.end_address ((*it).instr ().address ().to_string ());
             }
         }
         // Call the slot associated to IDebugger::disassemble, if any.
@@ -2954,6 +3934,12 @@ struct OnCreateVariableHandler : public OutputHandler
         // in the tag0 member of the command.
         var->name (a_in.command ().tag0 ());
 
+        var->backend_cost_ms (m_engine->get_current_command_duration_ms ());
+        LOG_D ("created " << var->name () << " (" << var->type () << ") in "
+               << (int) var->backend_cost_ms () << "ms",
+               VAROBJ_COST_DOMAIN);
+        m_engine->apply_pretty_printing_opt_out (var);
+
         // Call the slot associated to IDebugger::create_variable (), if
         // any.
         if (a_in.command ().has_slot ()) {
@@ -3020,6 +4006,15 @@ struct OnDeleteVariableHandler : public OutputHandler {
                 slot ();
             }
         }
+        // A "-var-update *" sent before the deletion may have kept
+        // changes of the variable aside after delete_variable dropped
+        // them.
+        UString name = a_in.command ().variable ()
+            ? a_in.command ().variable ()->internal_name ()
+            : a_in.command ().value ().substr (strlen ("-var-delete "));
+        list<VarChangePtr> dropped_changes;
+        m_engine->take_unclaimed_var_changes (name, dropped_changes);
+
         // Emit the general IDebugger::variable_deleted_signal ().
         m_engine->variable_deleted_signal ().emit (var,
                                                    a_in.command ().cookie ());
@@ -3061,7 +4056,20 @@ struct OnUnfoldVariableHandler : public OutputHandler {
              it != children_vars.end ();
              ++it) {
             parent_var->append (*it);
+            m_engine->apply_pretty_printing_opt_out (*it);
         }
+        // Tell whether the children listed are only the first ones of
+        // the pretty-printer, so that the views can say so.
+        if (parent_var->is_dynamic ())
+            parent_var->has_more_children
+                (a_in.output ().result_record ().variable_children_has_more ());
+
+        unsigned int cost = m_engine->get_current_command_duration_ms ();
+        parent_var->backend_cost_ms (parent_var->backend_cost_ms () + cost);
+        LOG_D ("listed " << (int) children_vars.size () << " children of "
+               << parent_var->name () << " (" << parent_var->type ()
+               << ") in " << (int) cost << "ms",
+               VAROBJ_COST_DOMAIN);
 
         // Call the slot associated to IDebugger::unfold_variable (), if
         // any.
@@ -3093,7 +4101,9 @@ struct OnListChangedVariableHandler : public OutputHandler
             && a_in.output ().result_record ().kind ()
                 == Output::ResultRecord::DONE
             && a_in.output ().result_record ().has_var_changes ()
-            && a_in.command ().name () == "list-changed-variables") {
+            && (a_in.command ().name () == "list-changed-variables"
+                || a_in.command ().name ()
+                    == "list-changed-root-variables")) {
             LOG_DD ("handler selected");
             return true;
         }
@@ -3102,9 +4112,23 @@ struct OnListChangedVariableHandler : public OutputHandler
 
     void do_handle (CommandAndOutput &a_in)
     {
-        THROW_IF_FAIL (a_in.command ().variable ());
         THROW_IF_FAIL (a_in.output ().result_record ().has_var_changes ());
 
+        // The changes of all the variable objects are dispatched to
+        // their roots by the slot set by
+        // GDBEngine::list_changed_variables.
+        if (a_in.command ().name () == "list-changed-root-variables") {
+            if (a_in.command ().has_slot ()) {
+                typedef sigc::slot<void, const list<VarChangePtr>&>
+                                                                SlotType;
+                SlotType slot = a_in.command ().get_slot<SlotType> ();
+                slot (a_in.output ().result_record ().var_changes ());
+            }
+            return;
+        }
+
+        THROW_IF_FAIL (a_in.command ().variable ());
+
         // Each element of a_in.output ().result_record ().var_changes
         // () describes changes that occurred to the variable
         // a_in.command ().variable ().  Some of these changes might
@@ -3116,11 +4140,18 @@ struct OnListChangedVariableHandler : public OutputHandler
         // come up with a list of updated variables, that we'll notify
         // client code with.
         list<IDebugger::VariableSafePtr> vars;
-        const list<VarChangePtr> &var_changes =
-            a_in.output ().result_record ().var_changes ();
-
         IDebugger::VariableSafePtr variable = a_in.command ().variable ();
 
+        // Changes reported earlier by a "-var-update *" come first.
+        list<VarChangePtr> var_changes;
+        m_engine->take_unclaimed_var_changes (variable->internal_name (),
+                                              var_changes);
+        var_changes.insert (var_changes.end (),
+                            a_in.output ().result_record ()
+                                .var_changes ().begin (),
+                            a_in.output ().result_record ()
+                                .var_changes ().end ());
+
         // Each element of var_changes is either a change of variable
         // itself, or a change of one its children.  So apply those
         // changes to variable so that it reflects its new state, and
@@ -3369,9 +4400,14 @@ GDBEngine::load_program (const UString &a_prog,
         if (m_priv->enable_pretty_printing)
             queue_command (Command ("load-program",
                                     "-enable-pretty-printing"));
+        m_priv->set_print_elements_limit ();
         set_attached_to_target (true);
     } else {
         LOG_DD("Re-using the same GDB");
+        m_priv->invalidate_register_names_cache ();
+        // Drop the names of the frames of the previous program that
+        // nobody holds anymore.
+        m_priv->string_intern_table->purge ();
         Command command ("load-program",
                          UString ("-file-exec-and-symbols ") + a_prog);
         queue_command (command);
@@ -3433,6 +4469,7 @@ GDBEngine::attach_to_target (unsigned int a_pid,
     if (a_pid == (unsigned int)m_priv->gdb_pid) {
         return false;
     }
+    m_priv->invalidate_register_names_cache ();
     queue_command (Command ("attach-to-program",
                             "attach " + UString::from_int (a_pid)));
     queue_command (Command ("info proc"));
@@ -3444,6 +4481,7 @@ bool
 GDBEngine::attach_to_remote_target (const UString &a_host,
 				    unsigned a_port)
 {
+    m_priv->invalidate_register_names_cache ();
     queue_command (Command ("-target-select remote " + a_host +
                             ":" + UString::from_int (a_port)));
     return true;
@@ -3452,6 +4490,7 @@ GDBEngine::attach_to_remote_target (const UString &a_host,
 bool
 GDBEngine::attach_to_remote_target (const UString &a_serial_line)
 {
+    m_priv->invalidate_register_names_cache ();
     queue_command (Command ("-target-select remote " + a_serial_line));
     return true;
 }
@@ -3548,6 +4587,22 @@ GDBEngine::get_state () const
     return m_priv->state;
 }
 
+void
+GDBEngine::set_refreshing (bool a_flag)
+{
+    LOG_FUNCTION_SCOPE_NORMAL_DD;
+
+    m_priv->is_refreshing = a_flag;
+}
+
+unsigned
+GDBEngine::drop_refresh_commands ()
+{
+    LOG_FUNCTION_SCOPE_NORMAL_DD;
+
+    return m_priv->drop_refresh_commands ();
+}
+
 int
 GDBEngine::get_current_frame_level () const
 {
@@ -3619,6 +4674,18 @@ GDBEngine::get_mi_thread_location (UString &a_str) const
     LOG_DD ("a_str: " << a_str);
 }
 
+/// Get the option to pass to the commands that resume the inferior
+/// so that they resume the current thread only.  That is needed in
+/// non-stop mode only; otherwise a_str is set to "" as all the
+/// threads are resumed anyway.
+void
+GDBEngine::get_mi_exec_thread_location (UString &a_str) const
+{
+    a_str.clear ();
+    if (is_non_stop_mode ())
+        get_mi_thread_location (a_str);
+}
+
 void
 GDBEngine::init_output_handlers ()
 {
@@ -3626,6 +4693,10 @@ GDBEngine::init_output_handlers ()
                 (OutputHandlerSafePtr (new OnStreamRecordHandler (this)));
     m_priv->output_handler_list.add
                 (OutputHandlerSafePtr (new OnDetachHandler (this)));
+    m_priv->output_handler_list.add
+                (OutputHandlerSafePtr (new OnThreadStateHandler (this)));
+    m_priv->output_handler_list.add
+                (OutputHandlerSafePtr (new OnNonStopModeHandler (this)));
     m_priv->output_handler_list.add
                 (OutputHandlerSafePtr (new OnStoppedHandler (this)));
     m_priv->output_handler_list.add
@@ -3658,8 +4729,12 @@ GDBEngine::init_output_handlers ()
             (OutputHandlerSafePtr (new OnDisassembleHandler (this)));
     m_priv->output_handler_list.add
             (OutputHandlerSafePtr (new OnThreadListHandler (this)));
+    m_priv->output_handler_list.add
+            (OutputHandlerSafePtr (new OnThreadInfoListHandler (this)));
     m_priv->output_handler_list.add
             (OutputHandlerSafePtr (new OnThreadSelectedHandler (this)));
+    m_priv->output_handler_list.add
+            (OutputHandlerSafePtr (new OnLibrariesChangedHandler (this)));
     m_priv->output_handler_list.add
             (OutputHandlerSafePtr (new OnFileListHandler (this)));
     m_priv->output_handler_list.add
@@ -3672,6 +4747,8 @@ GDBEngine::init_output_handlers ()
             (OutputHandlerSafePtr (new OnRegisterValuesListedHandler (this)));
     m_priv->output_handler_list.add
             (OutputHandlerSafePtr (new OnReadMemoryHandler (this)));
+    m_priv->output_handler_list.add
+            (OutputHandlerSafePtr (new OnPlanWatchpointHandler (this)));
     m_priv->output_handler_list.add
             (OutputHandlerSafePtr (new OnSetMemoryHandler (this)));
     m_priv->output_handler_list.add
@@ -3728,6 +4805,12 @@ GDBEngine::log_message_signal () const
     return m_priv->log_message_signal;
 }
 
+sigc::signal<void, const UString&>&
+GDBEngine::dprintf_output_signal () const
+{
+    return m_priv->dprintf_output_signal;
+}
+
 sigc::signal<void, const UString&, const UString&>&
 GDBEngine::command_done_signal () const
 {
@@ -3793,6 +4876,12 @@ GDBEngine::threads_listed_signal () const
     return m_priv->threads_listed_signal;
 }
 
+sigc::signal<void, const list<IDebugger::ThreadInfo>&, const UString& >&
+GDBEngine::threads_info_listed_signal () const
+{
+    return m_priv->threads_info_listed_signal;
+}
+
 
 sigc::signal<void, const vector<UString>&, const UString&>&
 GDBEngine::files_listed_signal () const
@@ -3806,6 +4895,12 @@ GDBEngine::thread_selected_signal () const
     return m_priv->thread_selected_signal;
 }
 
+sigc::signal<void>&
+GDBEngine::libraries_changed_signal () const
+{
+    return m_priv->libraries_changed_signal;
+}
+
 sigc::signal<void, const vector<IDebugger::Frame>&, const UString&>&
 GDBEngine::frames_listed_signal () const
 {
@@ -3945,6 +5040,12 @@ GDBEngine::running_signal () const
     return m_priv->running_signal;
 }
 
+sigc::signal<void, int, bool>&
+GDBEngine::thread_state_changed_signal () const
+{
+    return m_priv->thread_state_changed_signal;
+}
+
 sigc::signal<void, const UString&, const UString&>&
 GDBEngine::signal_received_signal () const
 {
@@ -4433,8 +5534,10 @@ GDBEngine::do_continue (const UString &a_cookie)
 {
     LOG_FUNCTION_SCOPE_NORMAL_DD;
 
+    UString thread;
+    get_mi_exec_thread_location (thread);
     Command command ("do-continue",
-                     "-exec-continue ",
+                     "-exec-continue " + thread,
                      a_cookie);
     queue_command (command);
 }
@@ -4558,6 +5661,15 @@ GDBEngine::stop_target ()
         return false;
     }
 
+    // In non-stop mode, GDB accepts commands while threads are
+    // running; interrupt the current thread only.
+    if (is_non_stop_mode ()) {
+        UString thread;
+        get_mi_exec_thread_location (thread);
+        queue_command (Command ("interrupt", "-exec-interrupt " + thread));
+        return true;
+    }
+
     //return  (kill (m_priv->target_pid, SIGINT) == 0);
     return  (kill (m_priv->gdb_pid, SIGINT) == 0);
 }
@@ -4593,8 +5705,10 @@ GDBEngine::step_in (const UString &a_cookie)
 {
     LOG_FUNCTION_SCOPE_NORMAL_DD;
 
+    UString thread;
+    get_mi_exec_thread_location (thread);
     Command command ("step-in",
-                     "-exec-step",
+                     "-exec-step " + thread,
                      a_cookie);
     queue_command (command);
 }
@@ -4604,8 +5718,10 @@ GDBEngine::step_out (const UString &a_cookie)
 {
     LOG_FUNCTION_SCOPE_NORMAL_DD;
 
+    UString thread;
+    get_mi_exec_thread_location (thread);
     Command command ("step-out",
-                     "-exec-finish",
+                     "-exec-finish " + thread,
                      a_cookie);
     queue_command (command);
 }
@@ -4615,8 +5731,10 @@ GDBEngine::step_over (const UString &a_cookie)
 {
     LOG_FUNCTION_SCOPE_NORMAL_DD;
 
+    UString thread;
+    get_mi_exec_thread_location (thread);
     Command command ("step-over",
-                     "-exec-next ",
+                     "-exec-next " + thread,
                      a_cookie);
     queue_command (command);
 }
@@ -4626,8 +5744,10 @@ GDBEngine::step_over_asm (const UString &a_cookie)
 {
     LOG_FUNCTION_SCOPE_NORMAL_DD;
 
+    UString thread;
+    get_mi_exec_thread_location (thread);
     Command command ("step-over-asm",
-                     "-exec-next-instruction",
+                     "-exec-next-instruction " + thread,
                      a_cookie);
     queue_command (command);
 }
@@ -4637,8 +5757,10 @@ GDBEngine::step_in_asm (const UString &a_cookie)
 {
     LOG_FUNCTION_SCOPE_NORMAL_DD;
 
+    UString thread;
+    get_mi_exec_thread_location (thread);
     Command command ("step-in-asm",
-                     "-exec-step-instruction",
+                     "-exec-step-instruction " + thread,
                      a_cookie);
     queue_command (command);
 }
@@ -4650,8 +5772,10 @@ GDBEngine::continue_to_position (const UString &a_path,
 {
     LOG_FUNCTION_SCOPE_NORMAL_DD;
 
+    UString thread;
+    get_mi_exec_thread_location (thread);
     queue_command (Command ("continue-to-position",
-                            "-exec-until "
+                            "-exec-until " + thread + " "
                             + a_path
                             + ":"
                             + UString::from_int (a_line_num),
@@ -4676,8 +5800,10 @@ GDBEngine::jump_to_position (const Loc &a_loc,
 
     location_to_string (a_loc, location);
 
+    UString thread;
+    get_mi_exec_thread_location (thread);
     Command command ("jump-to-position",
-                     "-exec-jump " + location);
+                     "-exec-jump " + thread + " " + location);
     command.set_slot (a_slot);
     queue_command (command);
 }
@@ -4955,13 +6081,78 @@ GDBEngine::delete_breakpoint (const UString &a_path,
 void
 GDBEngine::set_watchpoint (const UString &a_expression,
                            bool a_write, bool a_read,
-                           const UString &a_cookie)
+                           const UString &a_cookie,
+                           bool a_allow_software)
+{
+    LOG_FUNCTION_SCOPE_NORMAL_DD;
+
+    if (a_expression.empty ())
+        return;
+
+    plan_watchpoint (a_expression,
+                     sigc::bind (sigc::mem_fun
+                                     (*this,
+                                      &GDBEngine::on_watchpoint_planned),
+                                 a_write, a_read, a_cookie,
+                                 a_allow_software));
+}
+
+/// Find out whether a watchpoint on an expression can use the debug
+/// registers of the processor, or if it would be a software
+/// watchpoint.
+///
+/// \param a_expression the expression to watch.
+///
+/// \param a_slot the slot called with the plan of the watchpoint.
+void
+GDBEngine::plan_watchpoint (const UString &a_expression,
+                            const WatchpointPlanSlot &a_slot)
 {
     LOG_FUNCTION_SCOPE_NORMAL_DD;
 
     if (a_expression.empty ())
         return;
 
+    Command command ("plan-watchpoint",
+                     "-data-evaluate-expression "
+                     + quote_mi_c_string
+                         (debugger_utils::watchpoint_extent_expression
+                                                        (a_expression)));
+    command.tag0 (a_expression);
+    command.set_slot (a_slot);
+    queue_command (command);
+}
+
+/// Set the watchpoint planned by plan_watchpoint, unless it would be
+/// a software watchpoint and the caller didn't allow that.
+void
+GDBEngine::on_watchpoint_planned (const WatchpointPlan &a_plan,
+                                  bool a_write,
+                                  bool a_read,
+                                  const UString &a_cookie,
+                                  bool a_allow_software)
+{
+    LOG_FUNCTION_SCOPE_NORMAL_DD;
+
+    NEMIVER_TRY
+
+    if (a_plan.mode () == WatchpointPlan::SOFTWARE_MODE
+        && !a_allow_software) {
+        LOG_ERROR ("refusing software watchpoint on "
+                   << a_plan.expression ());
+        error_signal ().emit
+            (UString ("Not setting a watchpoint on ") + a_plan.expression ()
+             + ": its " + UString::from_int (a_plan.size ())
+             + " bytes don't fit in the debug registers, so it would be"
+             " a software watchpoint, which makes the program run about"
+             " a thousand times slower");
+        return;
+    }
+
+    // When the object fits in the debug registers, GDB splits it into
+    // the same aligned chunks as the plan, so the expression is
+    // passed as is; that way, GDB still deletes the watchpoint when
+    // the object goes out of scope.
     string cmd_str = "-break-watch";
 
     if (a_write && a_read)
@@ -4969,11 +6160,17 @@ GDBEngine::set_watchpoint (const UString &a_expression,
     else if (a_read == true)
         cmd_str += " -r";
 
-    cmd_str += " " + a_expression;
+    cmd_str += " " + a_plan.expression ();
+
+    if (a_plan.mode () == WatchpointPlan::HARDWARE_MODE)
+        m_priv->watchpoint_nb_registers[a_plan.expression ()] =
+            a_plan.chunks ().size ();
 
     Command command ("set-watchpoint", cmd_str, a_cookie);
     queue_command (command);
     list_breakpoints (a_cookie);
+
+    NEMIVER_CATCH_NOX
 }
 
 /// Set a breakpoint to a function name.
@@ -5178,6 +6375,66 @@ GDBEngine::append_breakpoints_to_cache
 }
 
 
+/// Set a dprintf, i.e. a breakpoint that logs a message each time it
+/// is hit, and lets the inferior go on without notifying the
+/// listeners of a stop.
+///
+/// The message logged is emitted by IDebugger::dprintf_output_signal.
+///
+/// \param a_loc the location of the dprintf.
+///
+/// \param a_format the message, as a printf format in double quotes
+/// followed by its arguments, like in "i = %d\n", i.
+///
+/// \param a_condition the condition of the dprintf.  If not empty,
+/// the message is logged iff the condition evaluates to true.
+///
+/// \param a_cookie a string passed to
+/// IDebugger::breakpoints_set_signal once the dprintf is set.
+void
+GDBEngine::set_dprintf (const Loc &a_loc,
+                        const UString &a_format,
+                        const UString &a_condition,
+                        const UString &a_cookie)
+{
+    LOG_FUNCTION_SCOPE_NORMAL_DD;
+
+    THROW_IF_FAIL (a_loc.kind () != Loc::UNDEFINED_LOC_KIND);
+
+    UString format;
+    vector<UString> args;
+    if (!debugger_utils::split_dprintf_message (a_format, format, args)) {
+        LOG_ERROR ("dprintf message must start with a quoted format: "
+                   << a_format);
+        return;
+    }
+
+    // Tag the output so that OnStreamRecordHandler can tell it apart
+    // from the rest of the console output, and end it with a new
+    // line so that the records of two hits don't merge.
+    format = GDBMI_DPRINTF_MARKER + format;
+    if (format.raw ().size () < 2
+        || format.raw ().compare (format.raw ().size () - 2, 2, "\\n"))
+        format += "\\n";
+
+    UString loc_str;
+    location_to_string (a_loc, loc_str);
+
+    UString cmd_str = "-dprintf-insert -f";
+    if (!a_condition.empty ())
+        cmd_str += " -c " + quote_mi_c_string (a_condition);
+    cmd_str += " " + quote_mi_c_string (loc_str);
+    // The format is already a C string body; GDB/MI unescapes it and
+    // -dprintf-insert escapes it again.
+    cmd_str += " \"" + format + "\"";
+    for (vector<UString>::const_iterator it = args.begin ();
+         it != args.end ();
+         ++it)
+        cmd_str += " " + quote_mi_c_string (*it);
+
+    queue_command (Command ("set-dprintf", cmd_str, a_cookie));
+}
+
 void
 GDBEngine::set_catch (const UString &a_event,
 		      const UString &a_cookie)
@@ -5202,6 +6459,19 @@ GDBEngine::list_threads (const UString &a_cookie)
     queue_command (Command ("list-threads", "-thread-list-ids", a_cookie));
 }
 
+/// List the threads of the inferior, along with their target id,
+/// name, state and current frame, in a single round trip.  When the
+/// list is fetched, IDebugger::threads_info_listed_signal is emitted.
+///
+/// \param a_cookie a string to pass to the signal.
+void
+GDBEngine::list_threads_info (const UString &a_cookie)
+{
+    LOG_FUNCTION_SCOPE_NORMAL_DD;
+
+    queue_command (Command ("list-threads-info", "-thread-info", a_cookie));
+}
+
 void
 GDBEngine::select_thread (unsigned int a_thread_id,
                           const UString &a_cookie)
@@ -5223,6 +6493,155 @@ GDBEngine::get_current_thread () const
     return m_priv->cur_thread_num;
 }
 
+/// \return true if GDB runs in non-stop mode, i.e. if a thread of
+/// the inferior can stop while the others keep running.
+bool
+GDBEngine::is_non_stop_mode () const
+{
+    return m_priv->non_stop_mode;
+}
+
+/// Ask for GDB to be set in non-stop mode, or not, the next time it
+/// is launched, for this session only.  The default comes from the
+/// CONF_KEY_NON_STOP_MODE key.
+///
+/// \param a_flag true to ask for non-stop mode.
+void
+GDBEngine::set_non_stop_mode (bool a_flag)
+{
+    m_priv->non_stop_mode_requested = a_flag;
+}
+
+/// Enable the launch of a standby GDB once a program is loaded, or
+/// disable it, for this session only.  The default comes from the
+/// CONF_KEY_STANDBY_GDB key.
+///
+/// \param a_flag true to enable the standby GDB.
+void
+GDBEngine::set_standby_gdb (bool a_flag)
+{
+    m_priv->standby_gdb_enabled = a_flag;
+    if (!a_flag)
+        m_priv->kill_standby_gdb ();
+}
+
+/// \return true if the GDB in use was adopted from the standby GDB
+/// when the program was last loaded.
+bool
+GDBEngine::is_using_standby_gdb () const
+{
+    return m_priv->load_uses_standby_gdb;
+}
+
+/// Carry on setting GDB in non-stop mode, once it answered one of
+/// the commands queued to that end.
+///
+/// \param a_command_name the name of the command GDB answered.
+///
+/// \param a_succeeded true if GDB accepted the command.
+void
+GDBEngine::on_non_stop_mode_command_done (const UString &a_command_name,
+                                          bool a_succeeded)
+{
+    m_priv->on_non_stop_mode_command_done (a_command_name, a_succeeded);
+}
+
+/// \return true if the thread which id is a_thread_id is running.
+bool
+GDBEngine::is_thread_running (int a_thread_id) const
+{
+    return m_priv->is_thread_running (a_thread_id);
+}
+
+/// Record that a thread of the inferior got resumed, or stopped.
+///
+/// \param a_thread_id the id of the thread, or -1 to mean all the
+/// threads.
+///
+/// \param a_is_running true if the thread got resumed.
+void
+GDBEngine::set_thread_running (int a_thread_id, bool a_is_running)
+{
+    m_priv->set_thread_running (a_thread_id, a_is_running);
+}
+
+/// Move the changes of the variable objects under the root variable
+/// object a_root_name, that were reported to nobody yet, into
+/// a_changes.  See GDBEngine::Priv::unclaimed_var_changes.
+void
+GDBEngine::take_unclaimed_var_changes (const UString &a_root_name,
+                                       list<VarChangePtr> &a_changes)
+{
+    map<UString, list<VarChangePtr> >::iterator it =
+        m_priv->unclaimed_var_changes.find (a_root_name);
+    if (it == m_priv->unclaimed_var_changes.end ())
+        return;
+    a_changes.splice (a_changes.begin (), it->second);
+    m_priv->unclaimed_var_changes.erase (it);
+}
+
+/// Return the number of debug registers the enabled hardware
+/// watchpoints leave free.  A watchpoint set by set_watchpoint uses
+/// as many registers as its plan had chunks; any other one, e.g. set
+/// from the GDB console, is assumed to use one.
+unsigned
+GDBEngine::get_nb_free_watchpoint_registers ()
+{
+    typedef map<string, IDebugger::Breakpoint> BPMap;
+    unsigned nb_used = 0;
+    BPMap &breakpoints = get_cached_breakpoints ();
+    for (BPMap::const_iterator it = breakpoints.begin ();
+         it != breakpoints.end ();
+         ++it) {
+        const IDebugger::Breakpoint &bp = it->second;
+        if (bp.type () != IDebugger::Breakpoint::WATCHPOINT_TYPE
+            || !bp.is_hardware_watchpoint ()
+            || !bp.enabled ())
+            continue;
+        map<string, unsigned>::const_iterator n =
+            m_priv->watchpoint_nb_registers.find (bp.expression ());
+        nb_used += n == m_priv->watchpoint_nb_registers.end ()
+            ? 1
+            : n->second;
+    }
+    if (nb_used >= debugger_utils::NB_HW_WATCHPOINT_REGISTERS)
+        return 0;
+    return debugger_utils::NB_HW_WATCHPOINT_REGISTERS - nb_used;
+}
+
+/// Return the time GDB has spent so far on the command it is
+/// handling, in milliseconds.
+unsigned int
+GDBEngine::get_current_command_duration_ms () const
+{
+    return (unsigned int) (m_priv->command_timer.elapsed () * 1000);
+}
+
+/// If a_var has a pretty-printer, but its type is one of those the
+/// user doesn't want pretty-printed, drop the pretty-printer of the
+/// variable object, before anything gets its children.
+///
+/// \param a_var the variable to consider.
+void
+GDBEngine::apply_pretty_printing_opt_out (const VariableSafePtr a_var)
+{
+    THROW_IF_FAIL (a_var);
+
+    if (!a_var->is_dynamic ()
+        || a_var->internal_name ().empty ()
+        || !m_priv->is_pretty_printing_disabled_for_type (a_var->type ()))
+        return;
+
+    LOG_DD ("not pretty-printing " << a_var->internal_name ()
+            << " of type " << a_var->type ());
+    set_variable_visualizer (a_var, GDB_NULL_PRETTY_PRINTING_VISUALIZER,
+                             &null_const_variable_slot);
+    a_var->visualizer (GDB_NULL_PRETTY_PRINTING_VISUALIZER);
+    a_var->is_dynamic (false);
+    // Without its pretty-printer, the variable shows its members.
+    a_var->has_more_children (true);
+}
+
 
 void
 GDBEngine::choose_function_overload (int a_overload_number,
@@ -5618,7 +7037,11 @@ GDBEngine::revisualize_variable (const VariableSafePtr a_var,
 
     NEMIVER_CATCH_NOX;
 
-    revisualize_variable (a_var, m_priv->enable_pretty_printing, a_slot);
+    revisualize_variable (a_var,
+                          m_priv->enable_pretty_printing
+                          && !m_priv->is_pretty_printing_disabled_for_type
+                                                            (a_var->type ()),
+                          a_slot);
 }
 
 /// A subroutine of GDBEngine::revisualize_variable above.
@@ -5931,17 +7354,44 @@ out:
     return true;
 }
 
+/// List the names of the registers of the inferior.
+///
+/// Upon completion, IDebugger::register_names_listed_signal is
+/// emitted.  The names are cached for the current inferior so that
+/// only the first call actually costs a round trip to GDB.
+///
+/// \param a_cookie a string passed to the
+/// IDebugger::register_names_listed_signal.
 void
 GDBEngine::list_register_names (const UString &a_cookie)
 {
     LOG_FUNCTION_SCOPE_NORMAL_DD;
 
+    if (m_priv->register_names_cached) {
+        LOG_DD ("serving register names from the cache");
+        register_names_listed_signal ().emit (m_priv->cached_register_names,
+                                              a_cookie);
+        return;
+    }
+
     queue_command (Command ("list-register-names",
                             "-data-list-register-names ",
                             a_cookie));
 }
 
 
+/// Remember the register names listed by GDB for the current
+/// inferior.  This is used by the handler of the reply to
+/// -data-list-register-names.
+///
+/// \param a_names the map of register numbers to register names.
+void
+GDBEngine::cache_register_names (const map<register_id_t, UString> &a_names)
+{
+    m_priv->cached_register_names = a_names;
+    m_priv->register_names_cached = true;
+}
+
 void
 GDBEngine::list_changed_registers (const UString &a_cookie)
 {
@@ -6025,6 +7475,31 @@ GDBEngine::read_memory (size_t a_start_addr,
                             a_cookie));
 }
 
+/// Read a_num_bytes of memory from a_start_addr, with
+/// -data-read-memory-bytes.  Its result is much more compact than
+/// the one of -data-read-memory, so this is the one to use to read
+/// big ranges of memory, a chunk at a time.
+///
+/// \param a_slot called with the blocks of memory that could be
+/// read.  There is a gap between two blocks wherever the memory
+/// couldn't be read; there is no block at all if no byte could be
+/// read.
+void
+GDBEngine::read_memory_bytes (size_t a_start_addr,
+                              size_t a_num_bytes,
+                              const MemoryBlocksSlot &a_slot,
+                              const UString &a_cookie)
+{
+    LOG_FUNCTION_SCOPE_NORMAL_DD;
+    UString cmd;
+    cmd.printf ("-data-read-memory-bytes %zu %zu",
+                a_start_addr,
+                a_num_bytes);
+    Command command ("read-memory-bytes", cmd, a_cookie);
+    command.set_slot (a_slot);
+    queue_command (command);
+}
+
 void
 GDBEngine::set_memory (size_t a_addr,
                        const std::vector<uint8_t>& a_bytes,
@@ -6283,6 +7758,7 @@ GDBEngine::delete_variable (const VariableSafePtr a_var,
     THROW_IF_FAIL (a_var);
     THROW_IF_FAIL (!a_var->internal_name ().empty ());
 
+    m_priv->unclaimed_var_changes.erase (a_var->internal_name ());
     Command command ("delete-variable",
                      "-var-delete " + a_var->internal_name (),
                      a_cookie);
@@ -6313,6 +7789,7 @@ GDBEngine::delete_variable (const UString &a_internal_name,
 
     THROW_IF_FAIL (!a_internal_name.empty ());
 
+    m_priv->unclaimed_var_changes.erase (a_internal_name);
     Command command ("delete-variable",
                      "-var-delete " + a_internal_name,
                      a_cookie);
@@ -6399,6 +7876,10 @@ GDBEngine::unfold_variable (VariableSafePtr a_var,
 
     THROW_IF_FAIL (a_var);
 
+    // The user may have asked for the type of this variable not to be
+    // pretty-printed since it was created.
+    apply_pretty_printing_opt_out (a_var);
+
     // If this variable was asked to be revisualized, let the backend
     // use the visualizer for it during its unfolding process.
     if (a_var->needs_revisualizing ()) {
@@ -6414,10 +7895,23 @@ GDBEngine::unfold_variable (VariableSafePtr a_var,
     }
     THROW_IF_FAIL (!a_var->internal_name ().empty ());
 
+    // Only get the first children of variables that have a
+    // pretty-printer; a container can have millions of them.  Make
+    // the later "-var-update" only look at those children too, or
+    // else GDB would fetch all of them again.
+    UString range;
+    if (a_var->is_dynamic () && m_priv->pretty_printing_max_children > 0) {
+        range = " 0 "
+            + UString::from_int (m_priv->pretty_printing_max_children);
+        queue_command (Command ("set-variable-update-range",
+                                "-var-set-update-range "
+                                + a_var->internal_name () + range));
+    }
+
     Command command ("unfold-variable",
                      "-var-list-children "
                      " --all-values "
-                     + a_var->internal_name (),
+                     + a_var->internal_name () + range,
                      a_cookie);
     command.variable (a_var);
     command.set_slot (a_slot);
@@ -6521,6 +8015,41 @@ GDBEngine::list_changed_variables
     queue_command (command);
 }
 
+/// List the changes of several root variables with a single
+/// "-var-update *", rather than one "-var-update" per root.
+///
+/// GDB/MI can only update one variable object, or all of them.  So
+/// the changes of the variable objects that are not under a_roots
+/// are kept aside until the next time somebody lists the changes of
+/// their root.
+///
+/// \param a_roots the root variables to consider.
+///
+/// \param a_slot the slot called for each of a_roots, with the
+/// sub-variables of that root that changed.
+///
+/// \param a_cookie the cookie passed to changed_variables_signal.
+void
+GDBEngine::list_changed_variables (const VariableList &a_roots,
+                                   const VariableChangesSlot &a_slot,
+                                   const UString &a_cookie)
+{
+    LOG_FUNCTION_SCOPE_NORMAL_DD;
+
+    if (a_roots.empty ())
+        return;
+
+    sigc::slot<void, const list<VarChangePtr>&> slot =
+        sigc::bind (sigc::mem_fun (*m_priv,
+                                   &Priv::on_root_var_changes_listed),
+                    a_roots, a_slot, a_cookie);
+    Command command ("list-changed-root-variables",
+                     "-var-update --all-values *",
+                     a_cookie);
+    command.set_slot (slot);
+    queue_command (command);
+}
+
 void
 GDBEngine::query_variable_path_expr (const VariableSafePtr a_var,
                                      const UString &a_cookie)
@@ -6628,6 +8157,88 @@ GDBEngine::enable_pretty_printing (bool a_flag)
                                    a_flag);
 }
 
+/// Set the maximum number of children of a variable to fetch through
+/// its pretty-printer, for the rest of this session.  The default
+/// comes from the CONF_KEY_PRETTY_PRINTING_MAX_CHILDREN key.  GDB
+/// then prints that many elements of arrays and strings too.
+///
+/// \param a_max the maximum number of children, or 0 for no limit.
+void
+GDBEngine::set_pretty_printing_max_children (int a_max)
+{
+    LOG_FUNCTION_SCOPE_NORMAL_DD;
+
+    if (a_max < 0)
+        a_max = 0;
+    if (a_max == m_priv->pretty_printing_max_children)
+        return;
+    m_priv->pretty_printing_max_children = a_max;
+    m_priv->print_elements_limited = true;
+    if (m_priv->is_gdb_running ())
+        m_priv->set_print_elements_limit ();
+}
+
+int
+GDBEngine::get_pretty_printing_max_children () const
+{
+    return m_priv->pretty_printing_max_children;
+}
+
+/// Add a type to the CONF_KEY_NO_PRETTY_PRINTING_EXACT_TYPES key, or
+/// remove it from there, along with the patterns of the
+/// CONF_KEY_NO_PRETTY_PRINTING_TYPES key that match it.  The
+/// variables created afterwards honour the new setting; use
+/// revisualize_variable for the existing ones.
+///
+/// \param a_type the type to consider.
+///
+/// \param a_disabled true to stop pretty-printing variables of type
+/// a_type.
+void
+GDBEngine::disable_pretty_printing_for_type (const UString &a_type,
+                                             bool a_disabled)
+{
+    LOG_FUNCTION_SCOPE_NORMAL_DD;
+
+    THROW_IF_FAIL (!a_type.empty ());
+
+    if (a_disabled == m_priv->is_pretty_printing_disabled_for_type (a_type))
+        return;
+
+    list<UString> &exact_types = m_priv->no_pretty_printing_exact_types;
+    if (a_disabled) {
+        exact_types.push_back (a_type);
+        get_conf_mgr ().set_key_value
+                    (CONF_KEY_NO_PRETTY_PRINTING_EXACT_TYPES, exact_types);
+        return;
+    }
+
+    list<UString>::size_type nb_exact_types = exact_types.size ();
+    exact_types.remove (a_type);
+    if (exact_types.size () != nb_exact_types)
+        get_conf_mgr ().set_key_value
+                    (CONF_KEY_NO_PRETTY_PRINTING_EXACT_TYPES, exact_types);
+
+    list<UString> &patterns = m_priv->no_pretty_printing_types;
+    list<UString>::size_type nb_patterns = patterns.size ();
+    list<UString>::iterator it = patterns.begin ();
+    while (it != patterns.end ()) {
+        if (g_pattern_match_simple (it->c_str (), a_type.c_str ()))
+            it = patterns.erase (it);
+        else
+            ++it;
+    }
+    if (patterns.size () != nb_patterns)
+        get_conf_mgr ().set_key_value (CONF_KEY_NO_PRETTY_PRINTING_TYPES,
+                                       patterns);
+}
+
+bool
+GDBEngine::is_pretty_printing_disabled_for_type (const UString &a_type) const
+{
+    return m_priv->is_pretty_printing_disabled_for_type (a_type);
+}
+
 /// Instruct GDB to set the variable vizualizer used by the GDB Pretty
 /// Printing system to print the value of a given variable.
 /// 
@@ -64,6 +64,8 @@ public:
 
     sigc::signal<void, const UString&>& log_message_signal () const;
 
+    sigc::signal<void, const UString&>& dprintf_output_signal () const;
+
     sigc::signal<void, const UString&, const UString&>&
                                         command_done_signal () const;
 
@@ -106,6 +108,10 @@ public:
                  const list<int>,
                  const UString& >& threads_listed_signal () const;
 
+    sigc::signal<void,
+                 const list<IDebugger::ThreadInfo>&,
+                 const UString& >& threads_info_listed_signal () const;
+
     sigc::signal<void, const vector<UString>&, const UString& >&
                                                 files_listed_signal () const;
 
@@ -114,6 +120,8 @@ public:
                  const Frame* const,
                  const UString&>& thread_selected_signal () const ;
 
+    sigc::signal<void>& libraries_changed_signal () const;
+
     sigc::signal<void,
                  const vector<IDebugger::Frame>&,
                  const UString&>& frames_listed_signal () const;
@@ -162,6 +170,8 @@ public:
 
     sigc::signal<void>& running_signal () const;
 
+    sigc::signal<void, int, bool>& thread_state_changed_signal () const;
+
     sigc::signal<void, const UString&, const UString&>&
                                         signal_received_signal () const;
 
@@ -229,6 +239,11 @@ public:
     void on_detached_from_target_signal ();
 
     void on_program_finished_signal ();
+    void on_watchpoint_planned (const WatchpointPlan &a_plan,
+                                bool a_write,
+                                bool a_read,
+                                const UString &a_cookie,
+                                bool a_allow_software);
     void on_rv_eval_var (const VariableSafePtr,
 			 const UString&,
 			 const ConstVariableSlot&);
@@ -269,6 +284,14 @@ public:
     void set_event_loop_context (const Glib::RefPtr<Glib::MainContext> &);
     void run_loop_iterations (int a_nb_iters);
     void set_state (IDebugger::State a_state);
+    void set_thread_running (int a_thread_id, bool a_is_running);
+    void on_non_stop_mode_command_done (const UString &a_command_name,
+                                        bool a_succeeded);
+    void take_unclaimed_var_changes (const UString &a_root_name,
+                                     list<VarChangePtr> &a_changes);
+    unsigned get_nb_free_watchpoint_registers ();
+    unsigned int get_current_command_duration_ms () const;
+    void apply_pretty_printing_opt_out (const VariableSafePtr a_var);
     bool stop_target () ;
     void exit_engine ();
     void execute_command (const Command &a_command);
@@ -349,6 +372,10 @@ public:
 
     IDebugger::State get_state () const;
 
+    void set_refreshing (bool a_flag);
+
+    unsigned drop_refresh_commands ();
+
     int get_current_frame_level () const;
 
     void set_current_frame_level (int);
@@ -359,6 +386,8 @@ public:
 
     void get_mi_thread_location (UString &a_str) const;
 
+    void get_mi_exec_thread_location (UString &a_str) const;
+
     void get_mi_thread_and_frame_location (UString &a_str) const;
 
     void reset_command_queue ();
@@ -440,7 +469,11 @@ public:
 
     void set_watchpoint (const UString &a_expression,
                          bool a_write, bool a_read,
-                         const UString &a_cookie);
+                         const UString &a_cookie,
+                         bool a_allow_software);
+
+    void plan_watchpoint (const UString &a_expression,
+                          const WatchpointPlanSlot &a_slot);
 
     void list_breakpoints (const UString &a_cookie);
 
@@ -452,6 +485,11 @@ public:
     void set_catch (const UString &a_event,
                     const UString &a_cookie) ;
 
+    void set_dprintf (const Loc &a_loc,
+                      const UString &a_format,
+                      const UString &a_condition,
+                      const UString &a_cookie);
+
 
     void choose_function_overload (int a_overload_number,
                                    const UString &a_cookie);
@@ -461,11 +499,23 @@ public:
 
     void list_threads (const UString &a_cookie);
 
+    void list_threads_info (const UString &a_cookie);
+
     void select_thread (unsigned int a_thread_id,
                         const UString &a_cookie);
 
     unsigned int get_current_thread () const;
 
+    bool is_non_stop_mode () const;
+
+    void set_non_stop_mode (bool a_flag);
+
+    void set_standby_gdb (bool a_flag);
+
+    bool is_using_standby_gdb () const;
+
+    bool is_thread_running (int a_thread_id) const;
+
     void delete_breakpoint (const string &a_break_num,
                             const UString &a_cookie);
 
@@ -545,6 +595,8 @@ public:
 
     void list_register_names (const UString &a_cookie);
 
+    void cache_register_names (const std::map<register_id_t, UString> &a_names);
+
     void list_register_values (std::list<register_id_t> a_registers,
                                const UString &a_cookie);
 
@@ -559,6 +611,10 @@ public:
     void read_memory (size_t a_start_addr,
                       size_t a_num_bytes,
                       const UString& a_cookie);
+    void read_memory_bytes (size_t a_start_addr,
+                            size_t a_num_bytes,
+                            const MemoryBlocksSlot &a_slot,
+                            const UString &a_cookie);
     void set_memory (size_t a_addr,
                      const std::vector<uint8_t>& a_bytes,
                      const UString& a_cookie);
@@ -651,6 +707,11 @@ public:
                  const ConstVariableListSlot &a_slot,
                  const UString &a_cookie);
 
+    void list_changed_variables
+                (const VariableList &a_roots,
+                 const VariableChangesSlot &a_slot,
+                 const UString &a_cookie);
+
     void query_variable_path_expr (const VariableSafePtr a_root,
                                    const UString &a_cookie);
 
@@ -668,6 +729,15 @@ public:
 
     void enable_pretty_printing (bool a_flag);
 
+    void set_pretty_printing_max_children (int a_max);
+
+    int get_pretty_printing_max_children () const;
+
+    void disable_pretty_printing_for_type (const UString &a_type,
+                                           bool a_disabled);
+
+    bool is_pretty_printing_disabled_for_type (const UString &a_type) const;
+
     void set_variable_visualizer (const VariableSafePtr a_var,
 				  const std::string &a_vizualizer,
 				  const ConstVariableSlot &a_slot);
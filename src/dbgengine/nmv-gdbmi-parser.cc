@@ -39,6 +39,7 @@ static const UString GDBMI_OUTPUT_DOMAIN = "gdbmi-output-domain";
 
 #define LOG_PARSING_ERROR(a_from) \
 do { \
+++m_priv->nb_parsing_errors; \
 Glib::ustring str_01 (m_priv->input, (a_from), m_priv->end - (a_from));\
 LOG_ERROR ("parsing failed for buf: >>>" \
              << m_priv->input << "<<<" \
@@ -47,6 +48,7 @@ LOG_ERROR ("parsing failed for buf: >>>" \
 
 #define LOG_PARSING_ERROR_MSG(a_from, msg) \
 do { \
+++m_priv->nb_parsing_errors; \
 Glib::ustring str_01 (m_priv->input, (a_from), m_priv->end - (a_from));\
 LOG_ERROR ("parsing failed for buf: >>>" \
              << m_priv->input << "<<<" \
@@ -125,6 +127,8 @@ GDBMITuple::clear ()
 // </Definitions of GDBMITuple>
 // *******************************
 
+const char* GDBMI_DPRINTF_MARKER = "[nmv-dprintf] ";
+
 // prefixes of command output records.
 static const char* PREFIX_DONE = "^done";
 static const char* PREFIX_RUNNING = "^running";
@@ -135,6 +139,7 @@ static const char* PREFIX_BKPT = "bkpt={";
 static const char* PREFIX_BREAKPOINT_TABLE = "BreakpointTable={";
 static const char* PREFIX_BREAKPOINT_MODIFIED_ASYNC_OUTPUT = "=breakpoint-modified,";
 static const char* PREFIX_THREAD_IDS = "thread-ids={";
+static const char* PREFIX_THREADS = "threads=[";
 static const char* PREFIX_NEW_THREAD_ID = "new-thread-id=\"";
 static const char* PREFIX_FILES = "files=[";
 static const char* PREFIX_STACK = "stack=[";
@@ -147,13 +152,17 @@ static const char* PREFIX_REGISTER_NAMES = "register-names=";
 static const char* PREFIX_CHANGED_REGISTERS = "changed-registers=";
 static const char* PREFIX_REGISTER_VALUES = "register-values=";
 static const char* PREFIX_MEMORY_VALUES = "addr=";
+static const char* PREFIX_MEMORY_BYTES = "memory=[";
 static const char* PREFIX_RUNNING_ASYNC_OUTPUT = "*running,";
 static const char* PREFIX_STOPPED_ASYNC_OUTPUT = "*stopped,";
 static const char* PREFIX_THREAD_SELECTED_ASYNC_OUTPUT = "=thread-selected,";
+static const char* PREFIX_LIBRARY_LOADED_ASYNC_OUTPUT = "=library-loaded,";
+static const char* PREFIX_LIBRARY_UNLOADED_ASYNC_OUTPUT = "=library-unloaded,";
 static const char* PREFIX_NAME = "name=\"";
 static const char* PREFIX_VARIABLE_DELETED = "ndeleted=\"";
 static const char* NDELETED = "ndeleted";
 static const char* PREFIX_NUMCHILD = "numchild=\"";
+static const char* PREFIX_HAS_MORE = ",has_more=\"";
 static const char* NUMCHILD = "numchild";
 static const char* PREFIX_VARIABLES_CHANGED_LIST = "changelist=[";
 static const char* CHANGELIST = "changelist";
@@ -264,6 +273,14 @@ gdbmi_result_to_string (GDBMIResultSafePtr a_result,
     UString variable, value;
     variable = a_result->variable ();
 
+    // In BROKEN_MODE, a tuple can hold bare strings, like the
+    // commands of a breakpoint in script={"silent","bt"}.  These
+    // come as singular results without value.
+    if (a_result->is_singular () && !a_result->value ()) {
+        a_string = variable;
+        return true;
+    }
+
     if (!gdbmi_value_to_string (a_result->value (), value))
         return false;
 
@@ -524,16 +541,21 @@ struct GDBMIParser::Priv {
     UString::size_type end;
     Mode mode;
     list<UString> input_stack;
+    StringInternTableSafePtr string_intern_table;
+    // The number of parsing errors logged so far.
+    unsigned long nb_parsing_errors;
 
     Priv (Mode a_mode = GDBMIParser::STRICT_MODE):
         end (0),
-        mode (a_mode)
+        mode (a_mode),
+        nb_parsing_errors (0)
     {
     }
 
     Priv (const UString &a_input, Mode a_mode) :
         end (0),
-        mode (a_mode)
+        mode (a_mode),
+        nb_parsing_errors (0)
 
     {
         push_input (a_input);
@@ -583,6 +605,53 @@ struct GDBMIParser::Priv {
             set_input (input_stack.front ());
         }
     }
+
+    /// Intern a string through the string intern table, if any.
+    /// Without an intern table, the returned handle is not shared.
+    InternedString intern (const UString &a_str)
+    {
+        if (string_intern_table)
+            return string_intern_table->intern (a_str.raw ());
+        return InternedString (a_str.raw ());
+    }
+
+    /// Fill a frame from the RESULTs of a GDB/MI frame tuple, e.g.
+    /// {level="0",addr="0x08048414",func="main",file="foo.c",line="5"}.
+    void set_frame_from_tuple (const GDBMITupleSafePtr &a_tuple,
+                               IDebugger::Frame &a_frame)
+    {
+        THROW_IF_FAIL (a_tuple);
+
+        list<GDBMIResultSafePtr>::const_iterator res_it;
+        UString name, value;
+        for (res_it = a_tuple->content ().begin ();
+             res_it != a_tuple->content ().end ();
+             ++res_it) {
+            if (!(*res_it)
+                || !(*res_it)->value ()
+                || (*res_it)->value ()->content_type ()
+                    != GDBMIValue::STRING_TYPE) {
+                continue;
+            }
+            name = (*res_it)->variable ();
+            value = (*res_it)->value ()->get_string_content ();
+            if (name == "level") {
+                a_frame.level (atoi (value.c_str ()));
+            } else if (name == "addr") {
+                a_frame.address () = value.raw ();
+            } else if (name == "func") {
+                a_frame.function_name (intern (value));
+            } else if (name == "file") {
+                a_frame.file_name (intern (value));
+            } else if (name == "fullname") {
+                a_frame.file_full_name (intern (value));
+            } else if (name == "from") {
+                a_frame.library (intern (value));
+            } else if (name == "line") {
+                a_frame.line (atoi (value.c_str ()));
+            }
+        }
+    }
 };//end class GDBMIParser;
 
 
@@ -630,6 +699,30 @@ GDBMIParser::get_mode () const
     return m_priv->mode;
 }
 
+/// Set the table used to intern the strings that are repeated
+/// over and over in the parsed output, like the function and file
+/// names of frames.
+void
+GDBMIParser::set_string_intern_table (const StringInternTableSafePtr &a_t)
+{
+    m_priv->string_intern_table = a_t;
+}
+
+const StringInternTableSafePtr&
+GDBMIParser::get_string_intern_table () const
+{
+    return m_priv->string_intern_table;
+}
+
+/// Return the number of parsing errors this parser logged since it
+/// was created.  That counts the errors of the parsing functions
+/// called by others too, even when their caller recovered from them.
+unsigned long
+GDBMIParser::get_nb_parsing_errors () const
+{
+    return m_priv->nb_parsing_errors;
+}
+
 bool
 GDBMIParser::parse_string (UString::size_type a_from,
                            UString::size_type &a_to,
@@ -1578,35 +1671,8 @@ GDBMIParser::parse_frame (UString::size_type a_from,
         LOG_PARSING_ERROR (cur);
         return false;
     }
-    list<GDBMIResultSafePtr>::const_iterator res_it;
-    GDBMIResultSafePtr tmp_res;
     IDebugger::Frame frame;
-    UString name, value;
-    for (res_it = result_value_tuple->content ().begin ();
-         res_it != result_value_tuple->content ().end ();
-         ++res_it) {
-        if (!(*res_it)) {continue;}
-        tmp_res = *res_it;
-        if (!tmp_res->value ()
-            ||tmp_res->value ()->content_type () != GDBMIValue::STRING_TYPE) {
-            continue;
-        }
-        name = tmp_res->variable ();
-        value = tmp_res->value ()->get_string_content ();
-        if (name == "level") {
-            frame.level (atoi (value.c_str ()));
-        } else if (name == "addr") {
-            frame.address () = value.raw ();
-        } else if (name == "func") {
-            frame.function_name (value.raw ());
-        } else if (name == "file") {
-            frame.file_name (value);
-        } else if (name == "fullname") {
-            frame.file_full_name (value);
-        } else if (name == "line") {
-            frame.line (atoi (value.c_str ()));
-        }
-    }
+    m_priv->set_frame_from_tuple (result_value_tuple, frame);
     a_frame = frame;
     a_to = cur;
     return true;
@@ -1821,6 +1887,21 @@ GDBMIParser::parse_out_of_band_record (UString::size_type a_from,
         goto end;
     }
 
+    if (!RAW_INPUT.compare (cur,
+                            strlen (PREFIX_LIBRARY_LOADED_ASYNC_OUTPUT),
+                            PREFIX_LIBRARY_LOADED_ASYNC_OUTPUT)
+        || !RAW_INPUT.compare (cur,
+                               strlen (PREFIX_LIBRARY_UNLOADED_ASYNC_OUTPUT),
+                               PREFIX_LIBRARY_UNLOADED_ASYNC_OUTPUT)) {
+        // We don't care about the details of the library yet, just
+        // about the fact that the code mapped in the inferior
+        // changed.
+        record.libraries_changed (true);
+        while (!m_priv->index_passed_end (cur)
+               && RAW_CHAR_AT (cur) != '\n') {++cur;}
+        goto end;
+    }
+
     if (RAW_CHAR_AT (cur) == '=' || RAW_CHAR_AT (cur) == '*') {
        //this is an unknown async notification sent by gdb.
        //For now, the only one
@@ -1891,6 +1972,12 @@ fetch_gdbmi_result:
                 if (parse_threads_list (cur, cur, thread_ids)) {
                     result_record.thread_list (thread_ids);
                 }
+            } else if (!RAW_INPUT.compare (cur, strlen (PREFIX_THREADS),
+                                           PREFIX_THREADS)) {
+                std::list<IDebugger::ThreadInfo> threads;
+                if (parse_thread_info_list (cur, cur, threads)) {
+                    result_record.thread_info_list (threads);
+                }
             } else if (!RAW_INPUT.compare (cur,
                                            strlen (PREFIX_NEW_THREAD_ID),
                                            PREFIX_NEW_THREAD_ID)) {
@@ -2018,6 +2105,16 @@ fetch_gdbmi_result:
                     LOG_D ("parsed memory values", GDBMI_PARSING_DOMAIN);
                     result_record.memory_values (addr, values);
                 }
+            } else if (!RAW_INPUT.compare (cur,
+                                           strlen (PREFIX_MEMORY_BYTES),
+                                           PREFIX_MEMORY_BYTES)) {
+                std::list<IDebugger::MemoryBlock> blocks;
+                if (!parse_memory_bytes (cur, cur, blocks)) {
+                    LOG_PARSING_ERROR (cur);
+                } else {
+                    LOG_D ("parsed memory bytes", GDBMI_PARSING_DOMAIN);
+                    result_record.memory_blocks (blocks);
+                }
             } else if (!RAW_INPUT.compare (cur,
                                            strlen (PREFIX_ASM_INSTRUCTIONS),
                                            PREFIX_ASM_INSTRUCTIONS)) {
@@ -2058,8 +2155,10 @@ fetch_gdbmi_result:
             } else if (!RAW_INPUT.compare (cur, strlen (PREFIX_NUMCHILD),
                                            PREFIX_NUMCHILD)) {
                 vector<IDebugger::VariableSafePtr> vars;
-                if (parse_var_list_children (cur, cur, vars)) {
+                bool has_more = false;
+                if (parse_var_list_children (cur, cur, vars, has_more)) {
                     result_record.variable_children (vars);
+                    result_record.variable_children_has_more (has_more);
                 } else {
                     LOG_PARSING_ERROR (cur);
                 }
@@ -2372,8 +2471,37 @@ GDBMIParser::parse_breakpoint_with_one_loc (Glib::ustring::size_type a_from,
     string type = attrs["type"];
     if (type.find ("breakpoint") != type.npos)
         a_bkpt.type (IDebugger::Breakpoint::STANDARD_BREAKPOINT_TYPE);
-    else if (type.find ("watchpoint") != type.npos)
+    else if (type.find ("watchpoint") != type.npos) {
         a_bkpt.type (IDebugger::Breakpoint::WATCHPOINT_TYPE);
+        // GDB calls the hardware watchpoints "hw watchpoint", "read
+        // watchpoint" or "acc watchpoint", and the software ones just
+        // "watchpoint".
+        a_bkpt.is_hardware_watchpoint (type != "watchpoint");
+    }
+    else if (type == "dprintf") {
+        a_bkpt.type (IDebugger::Breakpoint::DPRINTF_TYPE);
+        // GDB implements a dprintf as a breakpoint which only
+        // command is 'printf "format",args'; its script looks like
+        // {printf "format",args}.
+        UString format = attrs["script"];
+        if (format.size () > 1
+            && format[0] == '{'
+            && format[format.size () - 1] == '}')
+            format = format.substr (1, format.size () - 2);
+        if (!format.raw ().compare (0, 7, "printf "))
+            format.erase (0, 7);
+        UString::size_type marker = format.find (GDBMI_DPRINTF_MARKER);
+        if (marker == 1 && format[0] == '"')
+            format.erase (1, strlen (GDBMI_DPRINTF_MARKER));
+        // The backslashes of the escapes of the format are escaped
+        // in the script.
+        string unescaped = format.raw ();
+        for (string::size_type i = 0;
+             (i = unescaped.find ("\\\\", i)) != string::npos;
+             ++i)
+            unescaped.erase (i, 1);
+        a_bkpt.dprintf_format (unescaped);
+    }
 
     // Set the initial ignore count
     if (ignore_count_present)
@@ -2658,6 +2786,128 @@ GDBMIParser::parse_threads_list (UString::size_type a_from,
     return true;
 }
 
+/// Parse the result of the -thread-info command, e.g.:
+///
+/// threads=[{id="2",target-id="Thread 0xb7e14b90 (LWP 21257)",
+///           name="worker",frame={level="0",addr="0xffffe410",
+///           func="__kernel_vsyscall",args=[]},state="stopped",
+///           core="1"},
+///          {id="1",target-id="Thread 0xb7e156b0 (LWP 21254)",
+///           state="running"}],
+/// current-thread-id="1"
+///
+/// \param a_from the index to start parsing from.
+///
+/// \param a_to out parameter.  Set to the index right after the
+/// parsed construct, if the parsing succeeded.
+///
+/// \param a_threads out parameter.  The resulting threads.
+///
+/// \return true upon successful parsing, false otherwise.
+bool
+GDBMIParser::parse_thread_info_list
+                        (UString::size_type a_from,
+                         UString::size_type &a_to,
+                         std::list<IDebugger::ThreadInfo> &a_threads)
+{
+    LOG_FUNCTION_SCOPE_NORMAL_D (GDBMI_PARSING_DOMAIN);
+    UString::size_type cur = a_from;
+
+    if (RAW_INPUT.compare (cur, strlen (PREFIX_THREADS), PREFIX_THREADS)) {
+        LOG_PARSING_ERROR (cur);
+        return false;
+    }
+
+    GDBMIResultSafePtr gdbmi_result;
+    if (!parse_gdbmi_result (cur, cur, gdbmi_result)) {
+        LOG_PARSING_ERROR (cur);
+        return false;
+    }
+    THROW_IF_FAIL (gdbmi_result
+                   && gdbmi_result->variable () == "threads");
+
+    if (!gdbmi_result->value ()
+        || gdbmi_result->value ()->content_type ()
+            != GDBMIValue::LIST_TYPE) {
+        LOG_PARSING_ERROR (cur);
+        return false;
+    }
+
+    std::list<IDebugger::ThreadInfo> threads;
+    GDBMIListSafePtr gdbmi_list = gdbmi_result->value ()->get_list_content ();
+    if (gdbmi_list && !gdbmi_list->empty ()) {
+        if (gdbmi_list->content_type () != GDBMIList::VALUE_TYPE) {
+            LOG_PARSING_ERROR (cur);
+            return false;
+        }
+        list<GDBMIValueSafePtr> values;
+        gdbmi_list->get_value_content (values);
+        list<GDBMIValueSafePtr>::const_iterator value_it;
+        list<GDBMIResultSafePtr>::const_iterator res_it;
+        for (value_it = values.begin ();
+             value_it != values.end ();
+             ++value_it) {
+            if (!*value_it
+                || (*value_it)->content_type () != GDBMIValue::TUPLE_TYPE) {
+                LOG_PARSING_ERROR (cur);
+                return false;
+            }
+            GDBMITupleSafePtr tuple = (*value_it)->get_tuple_content ();
+            THROW_IF_FAIL (tuple);
+
+            IDebugger::ThreadInfo thread;
+            for (res_it = tuple->content ().begin ();
+                 res_it != tuple->content ().end ();
+                 ++res_it) {
+                if (!*res_it || !(*res_it)->value ()) {continue;}
+                const UString &name = (*res_it)->variable ();
+                GDBMIValueSafePtr value = (*res_it)->value ();
+                if (name == "frame"
+                    && value->content_type () == GDBMIValue::TUPLE_TYPE) {
+                    IDebugger::Frame frame;
+                    m_priv->set_frame_from_tuple (value->get_tuple_content (),
+                                                  frame);
+                    thread.frame (frame);
+                    continue;
+                }
+                if (value->content_type () != GDBMIValue::STRING_TYPE)
+                    continue;
+                if (name == "id") {
+                    thread.id (atoi (value->get_string_content ().c_str ()));
+                } else if (name == "target-id") {
+                    thread.target_id (value->get_string_content ());
+                } else if (name == "name") {
+                    thread.name (value->get_string_content ());
+                } else if (name == "state") {
+                    thread.state (value->get_string_content ());
+                }
+            }
+            if (!thread.id ()) {
+                LOG_ERROR ("got a thread without id");
+                return false;
+            }
+            threads.push_back (thread);
+        }
+    }
+
+    // Consume the trailing current-thread-id RESULT, if any.  The
+    // current thread is known from the stop state already.
+    SKIP_BLANK (cur);
+    if (RAW_CHAR_AT (cur) == ',') {
+        ++cur;
+        CHECK_END (cur);
+        SKIP_BLANK (cur);
+        if (!parse_gdbmi_result (cur, cur, gdbmi_result)) {
+            LOG_PARSING_ERROR (cur);
+            return false;
+        }
+    }
+
+    a_threads = threads;
+    a_to = cur;
+    return true;
+}
+
 bool
 GDBMIParser::parse_new_thread_id (UString::size_type a_from,
                                   UString::size_type &a_to,
@@ -2859,17 +3109,17 @@ GDBMIParser::parse_call_stack (const UString::size_type a_from,
             if ((*frame_part_iter)->variable () == "addr") {
                 frame.address () = value.raw ();
             } else if ((*frame_part_iter)->variable () == "func") {
-                frame.function_name (value.raw ());
+                frame.function_name (m_priv->intern (value));
             } else if ((*frame_part_iter)->variable () == "file") {
-                frame.file_name (value);
+                frame.file_name (m_priv->intern (value));
             } else if ((*frame_part_iter)->variable () == "fullname") {
-                frame.file_full_name (value);
+                frame.file_full_name (m_priv->intern (value));
             } else if ((*frame_part_iter)->variable () == "line") {
                 frame.line (atol (value.c_str ()));
             } else if ((*frame_part_iter)->variable () == "level") {
                 frame.level (atol (value.c_str ()));
             } else if ((*frame_part_iter)->variable () == "from") {
-                frame.library (value.c_str ());
+                frame.library (m_priv->intern (value));
 	    }
         }
         THROW_IF_FAIL (frame.has_empty_address () != true);
@@ -3515,9 +3765,27 @@ GDBMIParser::parse_var_list_children
                             (UString::size_type a_from,
                              UString::size_type &a_to,
                              std::vector<IDebugger::VariableSafePtr> &a_vars)
+{
+    bool has_more = false;
+    return parse_var_list_children (a_from, a_to, a_vars, has_more);
+}
+
+/// Same as above, but also parses the 'has_more=N' RESULT that
+/// follows the children of a variable that has a pretty-printer,
+/// when only a range of its children was listed.
+///
+/// \param a_has_more set to true iff the variable has children past
+/// the ones that were listed.
+bool
+GDBMIParser::parse_var_list_children
+                            (UString::size_type a_from,
+                             UString::size_type &a_to,
+                             std::vector<IDebugger::VariableSafePtr> &a_vars,
+                             bool &a_has_more)
 {
     LOG_FUNCTION_SCOPE_NORMAL_D (GDBMI_PARSING_DOMAIN);
     UString::size_type cur = a_from;
+    a_has_more = false;
     CHECK_END (cur);
 
     if (RAW_INPUT.compare (cur, strlen (PREFIX_NUMCHILD),
@@ -3690,6 +3958,18 @@ GDBMIParser::parse_var_list_children
             a_vars.push_back (var);
         }
     }
+
+    if (!RAW_INPUT.compare (cur, strlen (PREFIX_HAS_MORE), PREFIX_HAS_MORE)) {
+        ++cur;
+        if (!parse_gdbmi_result (cur, cur, result)
+            || !result
+            || !result->value ()
+            || result->value ()->content_type () != GDBMIValue::STRING_TYPE) {
+            LOG_PARSING_ERROR (cur);
+            return false;
+        }
+        a_has_more = result->value ()->get_string_content () != "0";
+    }
     a_to = cur;
     return true;
 }
@@ -3783,7 +4063,7 @@ grok_var_changed_list_components (GDBMIValueSafePtr a_value,
                     internal_name = v;
                 } else if (n == "value") {
                     value = v;
-                } else if (n == "type") {
+                } else if (n == "type" || n == "new_type") {
                     type = v;
                 } else if (n == "in_scope") {
                     in_scope = (v == "true");
@@ -4285,6 +4565,114 @@ GDBMIParser::parse_memory_values (UString::size_type a_from,
     return true;
 }
 
+/// Parse the result of -data-read-memory-bytes, which is of the
+/// form:
+///
+///   memory=[{begin="0x601040",offset="0x0",end="0x601048",
+///            contents="0100000002000000"}]
+///
+/// GDB only returns the blocks of memory it could read, so there is
+/// a gap between two blocks wherever some memory could not be read.
+/// The blocks that are contiguous are merged.
+///
+/// \param a_from where to start parsing from.
+/// \param a_to out parameter.  Where the parsing stopped.
+/// \param a_blocks out parameter.  The address and the bytes of each
+/// block read, in increasing order of address.  It is empty if no
+/// memory could be read.
+/// \return true upon successful parsing, false otherwise.
+bool
+GDBMIParser::parse_memory_bytes (UString::size_type a_from,
+                                 UString::size_type &a_to,
+                                 std::list<IDebugger::MemoryBlock> &a_blocks)
+{
+    LOG_FUNCTION_SCOPE_NORMAL_D (GDBMI_PARSING_DOMAIN);
+    UString::size_type cur = a_from;
+
+    if (RAW_INPUT.compare (cur, strlen (PREFIX_MEMORY_BYTES),
+                           PREFIX_MEMORY_BYTES)) {
+        LOG_PARSING_ERROR (cur);
+        return false;
+    }
+    cur += strlen ("memory=");
+
+    GDBMIListSafePtr blocks;
+    if (!parse_gdbmi_list (cur, cur, blocks) || !blocks) {
+        LOG_PARSING_ERROR (cur);
+        return false;
+    }
+
+    std::list<IDebugger::MemoryBlock> result;
+    if (!blocks->empty ()) {
+        if (blocks->content_type () != GDBMIList::VALUE_TYPE) {
+            LOG_PARSING_ERROR (cur);
+            return false;
+        }
+        std::list<GDBMIValueSafePtr> block_list;
+        blocks->get_value_content (block_list);
+        std::list<GDBMIValueSafePtr>::const_iterator it;
+        for (it = block_list.begin (); it != block_list.end (); ++it) {
+            if ((*it)->content_type () != GDBMIValue::TUPLE_TYPE) {
+                LOG_PARSING_ERROR (cur);
+                return false;
+            }
+            GDBMITupleSafePtr block = (*it)->get_tuple_content ();
+            THROW_IF_FAIL (block);
+            size_t begin = 0, offset = 0;
+            const UString *contents = 0;
+            std::list<GDBMIResultSafePtr>::const_iterator r;
+            for (r = block->content ().begin ();
+                 r != block->content ().end ();
+                 ++r) {
+                if (!(*r)->value ()
+                    || (*r)->value ()->content_type ()
+                        != GDBMIValue::STRING_TYPE)
+                    continue;
+                const UString &str = (*r)->value ()->get_string_content ();
+                if ((*r)->variable () == "begin")
+                    begin = strtoull (str.c_str (), 0, 16);
+                else if ((*r)->variable () == "offset")
+                    offset = strtoull (str.c_str (), 0, 16);
+                else if ((*r)->variable () == "contents")
+                    contents = &str;
+            }
+            if (!contents || contents->bytes () % 2) {
+                LOG_PARSING_ERROR (cur);
+                return false;
+            }
+            begin += offset;
+
+            const std::string &hex = contents->raw ();
+            std::vector<uint8_t> values;
+            values.reserve (hex.size () / 2);
+            for (std::string::size_type i = 0; i < hex.size (); i += 2) {
+                int hi = g_ascii_xdigit_value (hex[i]);
+                int lo = g_ascii_xdigit_value (hex[i + 1]);
+                if (hi < 0 || lo < 0) {
+                    LOG_PARSING_ERROR (cur);
+                    return false;
+                }
+                values.push_back ((hi << 4) | lo);
+            }
+            if (!result.empty ()
+                && result.back ().first + result.back ().second.size ()
+                    == begin) {
+                // GDB may split a readable range in several blocks.
+                std::vector<uint8_t> &prev = result.back ().second;
+                prev.insert (prev.end (), values.begin (), values.end ());
+            } else {
+                // Either the first block, or a block after a hole of
+                // unreadable memory.
+                result.push_back (IDebugger::MemoryBlock (begin, values));
+            }
+        }
+    }
+
+    a_blocks.swap (result);
+    a_to = cur;
+    return true;
+}
+
 bool
 GDBMIParser::parse_asm_instruction_list
                                 (UString::size_type a_from,
@@ -314,6 +314,11 @@ bool gdbmi_value_to_string (GDBMIValueSafePtr a_value, UString &a_string);
 
 bool gdbmi_tuple_to_string (GDBMITupleSafePtr a_result, UString &a_string);
 
+/// The text GDBEngine prepends to the format of the dprintf it sets,
+/// to tell their output apart from the rest of the console output of
+/// GDB.
+extern const char* GDBMI_DPRINTF_MARKER;
+
 //**************************
 //GDBMI parsing functions
 //**************************
@@ -354,6 +359,11 @@ public:
     void set_mode (Mode);
     Mode get_mode () const;
 
+    void set_string_intern_table (const common::StringInternTableSafePtr &);
+    const common::StringInternTableSafePtr& get_string_intern_table () const;
+
+    unsigned long get_nb_parsing_errors () const;
+
     //*********************
     //<Parsing entry points.>
     //*********************
@@ -546,6 +556,10 @@ public:
                              UString::size_type &a_to,
                              std::list<int> &a_thread_ids);
 
+    bool parse_thread_info_list (UString::size_type a_from,
+                                 UString::size_type &a_to,
+                                 std::list<IDebugger::ThreadInfo> &a_threads);
+
     /// parses the result of the gdbmi command
     /// "-thread-select"
     /// \param a_input the input string to parse
@@ -625,6 +639,10 @@ public:
                               size_t& a_start_addr,
                               std::vector<uint8_t> &a_values);
 
+    bool parse_memory_bytes (UString::size_type a_from,
+                             UString::size_type &a_to,
+                             std::list<IDebugger::MemoryBlock> &a_blocks);
+
     /// parse an asm instruction description as returned
     /// by GDB/MI
     bool parse_asm_instruction_list (UString::size_type a_from,
@@ -643,6 +661,11 @@ public:
                                   UString::size_type &a_to,
                                   vector<IDebugger::VariableSafePtr> &a_vars);
 
+    bool parse_var_list_children (UString::size_type a_from,
+                                  UString::size_type &a_to,
+                                  vector<IDebugger::VariableSafePtr> &a_vars,
+                                  bool &a_has_more);
+
     bool parse_var_changed_list (UString::size_type a_from,
                                  UString::size_type &a_to,
                                  list<VarChangePtr> &a_var_changes);
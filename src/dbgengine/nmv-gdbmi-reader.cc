@@ -0,0 +1,462 @@
+/*
+ *This file is part of the Nemiver project
+ *
+ *Nemiver is free software; you can redistribute
+ *it and/or modify it under the terms of
+ *the GNU General Public License as published by the
+ *Free Software Foundation; either version 2,
+ *or (at your option) any later version.
+ *
+ *Nemiver is distributed in the hope that it will
+ *be useful, but WITHOUT ANY WARRANTY;
+ *without even the implied warranty of
+ *MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ *See the GNU General Public License for more details.
+ *
+ *You should have received a copy of the
+ *GNU General Public License along with Nemiver;
+ *see the file COPYING.
+ *If not, write to the Free Software Foundation,
+ *Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+ *
+ *See COPYRIGHT file copyright information.
+ */
+#include "config.h"
+#include <cerrno>
+#include <cstring>
+#include <ctype.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <unistd.h>
+#include <glibmm/thread.h>
+#include "common/nmv-exception.h"
+#include "common/nmv-spsc-queue.h"
+#include "common/nmv-str-utils.h"
+#include "nmv-gdbmi-parser.h"
+#include "nmv-gdbmi-reader.h"
+
+using namespace std;
+using namespace nemiver::common;
+
+NEMIVER_BEGIN_NAMESPACE (nemiver)
+
+static const char *GDB_PROMPT = "\n(gdb)";
+static const char *OVERLOADS_MENU = "[0] cancel";
+
+// The maximum number of buffers dispatched by the main loop before
+// it gets a chance to handle its other events.
+static const unsigned MAX_DISPATCHED_BUFFERS = 16;
+
+//*********************
+//<GDBMIFramer methods>
+//*********************
+
+GDBMIFramer::GDBMIFramer () :
+    m_prompt_scanned (0),
+    m_menu_scanned (0),
+    m_saw_menu (false)
+{
+}
+
+void
+GDBMIFramer::reset_scan ()
+{
+    m_prompt_scanned = 0;
+    m_menu_scanned = 0;
+    m_saw_menu = false;
+}
+
+/// Append some output of GDB to the pending output.
+void
+GDBMIFramer::push (const char *a_data, size_t a_len)
+{
+    m_pending.append (a_data, a_len);
+}
+
+/// Remove the first complete buffer from the pending output.
+///
+/// The pending output is only searched from where the previous
+/// call stopped, so framing a huge reply that arrives in small
+/// chunks stays linear.
+///
+/// \param a_buffer output parameter.  Set to the buffer removed,
+/// terminated by a new line.
+///
+/// \return true if a buffer was removed, false if the pending
+/// output holds no complete buffer yet.
+bool
+GDBMIFramer::pop (std::string &a_buffer)
+{
+    static const string::size_type prompt_len = strlen (GDB_PROMPT);
+    static const string::size_type menu_len = strlen (OVERLOADS_MENU);
+
+    string::size_type from = m_prompt_scanned >= prompt_len
+                             ? m_prompt_scanned - prompt_len + 1
+                             : 0;
+    string::size_type i = m_pending.find (GDB_PROMPT, from);
+    if (i != string::npos) {
+        // Take the prompt and the character that follows it.
+        string::size_type size = i + prompt_len + 1;
+        a_buffer.assign (m_pending, 0, size);
+        str_utils::chomp (a_buffer);
+        a_buffer += '\n';
+        while (size < m_pending.size () && isspace (m_pending[size]))
+            ++size;
+        m_pending.erase (0, size);
+        reset_scan ();
+        return true;
+    }
+    m_prompt_scanned = m_pending.size ();
+
+    if (!m_saw_menu) {
+        from = m_menu_scanned >= menu_len ? m_menu_scanned - menu_len + 1 : 0;
+        m_saw_menu = m_pending.find (OVERLOADS_MENU, from) != string::npos;
+        m_menu_scanned = m_pending.size ();
+    }
+    if (m_saw_menu && m_pending.find ("> ") != string::npos) {
+        // This is not GDB/MI output, but rather a plain GDB prompt
+        // that lets the user choose between a list of overloaded
+        // functions.
+        a_buffer.swap (m_pending);
+        m_pending.clear ();
+        reset_scan ();
+        return true;
+    }
+    return false;
+}
+
+/// Drop the pending output.
+void
+GDBMIFramer::clear ()
+{
+    m_pending.clear ();
+    reset_scan ();
+}
+
+//**********************
+//</GDBMIFramer methods>
+//**********************
+
+struct GDBMIReader::Priv {
+    StringInternTableSafePtr string_intern_table;
+    // Owns the Records it holds.  A null element tells that GDB
+    // closed its output.
+    SPSCQueue<Records*> queue;
+    int fd;
+    int stop_pipe[2];
+    int wakeup_pipe[2];
+    // Set when a byte was written to wakeup_pipe and the main loop
+    // has not read it yet.
+    volatile int wakeup_pending;
+    volatile int is_stopping;
+    Glib::Thread *thread;
+    Glib::RefPtr<Glib::IOChannel> wakeup_channel;
+    Glib::RefPtr<Glib::IOSource> wakeup_source;
+    sigc::signal<void, Records&> records_signal;
+    sigc::signal<void> eof_signal;
+
+    Priv (const StringInternTableSafePtr &a_table) :
+        string_intern_table (a_table),
+        queue (256),
+        fd (-1),
+        wakeup_pending (0),
+        is_stopping (0),
+        thread (0)
+    {
+        stop_pipe[0] = stop_pipe[1] = -1;
+        wakeup_pipe[0] = wakeup_pipe[1] = -1;
+    }
+
+    static void close_pipe (int a_pipe[2])
+    {
+        for (int i = 0; i < 2; ++i) {
+            if (a_pipe[i] >= 0)
+                close (a_pipe[i]);
+            a_pipe[i] = -1;
+        }
+    }
+
+    /// Make the main loop call on_wakeup, unless it is already
+    /// about to.
+    void wake_up ()
+    {
+        if (__sync_bool_compare_and_swap (&wakeup_pending, 0, 1)) {
+            char c = 0;
+            if (write (wakeup_pipe[1], &c, 1) != 1)
+                LOG_ERROR ("could not wake the main loop up: "
+                           << strerror (errno));
+        }
+    }
+
+    /// Hand a_records to the main loop.  Called by the reader
+    /// thread only.
+    void push (Records *a_records)
+    {
+        while (!queue.push (a_records)) {
+            if (is_stopping) {
+                delete a_records;
+                return;
+            }
+            // The main loop is lagging behind; let it catch up.
+            wake_up ();
+            g_usleep (1000);
+        }
+        wake_up ();
+    }
+
+    /// The body of the reader thread.
+    void run ()
+    {
+        GDBMIParser parser (GDBMIParser::BROKEN_MODE);
+        parser.set_string_intern_table (string_intern_table);
+        GDBMIFramer framer;
+        string buffer;
+        char chunk[64 * 1024];
+
+        while (!is_stopping) {
+            struct pollfd fds[2];
+            fds[0].fd = fd;
+            fds[0].events = POLLIN | POLLPRI;
+            fds[0].revents = 0;
+            fds[1].fd = stop_pipe[0];
+            fds[1].events = POLLIN;
+            fds[1].revents = 0;
+            if (poll (fds, 2, -1) < 0) {
+                if (errno == EINTR)
+                    continue;
+                LOG_ERROR ("could not poll GDB output: " << strerror (errno));
+                push (0);
+                return;
+            }
+            if (fds[1].revents || is_stopping)
+                return;
+
+            ssize_t nb_read = read (fd, chunk, sizeof (chunk));
+            if (nb_read < 0 && (errno == EINTR || errno == EAGAIN))
+                continue;
+            if (nb_read <= 0) {
+                LOG_ERROR ("Connection lost from stdout channel to gdb");
+                push (0);
+                return;
+            }
+            framer.push (chunk, nb_read);
+            while (framer.pop (buffer) && !is_stopping) {
+                Records *records = new Records;
+                records->buffer = buffer;
+                NEMIVER_TRY
+                parse_output (parser, records->buffer, records->outputs);
+                NEMIVER_CATCH_NOX
+                push (records);
+            }
+        }
+    }
+
+    /// Dispatch the records queued by the reader thread.  Called by
+    /// the main loop.
+    bool on_wakeup (Glib::IOCondition)
+    {
+        char buf[64];
+        while (read (wakeup_pipe[0], buf, sizeof (buf)) > 0) {}
+        // Clear the flag before draining the queue, so that records
+        // pushed from now on wake the main loop up again.
+        __sync_lock_release (&wakeup_pending);
+        __sync_synchronize ();
+
+        Records *records = 0;
+        for (unsigned nb = 0;
+             nb < MAX_DISPATCHED_BUFFERS && queue.pop (records);
+             ++nb) {
+            NEMIVER_TRY
+            if (!records) {
+                eof_signal.emit ();
+                continue;
+            }
+            SafePtr<Records> guard (records);
+            records_signal.emit (*records);
+            NEMIVER_CATCH_NOX
+        }
+        // Let the main loop handle its other events before
+        // dispatching the rest.
+        if (thread && !queue.empty ())
+            wake_up ();
+        return true;
+    }
+};//end struct GDBMIReader::Priv
+
+//*********************
+//<GDBMIReader methods>
+//*********************
+
+GDBMIReader::GDBMIReader (const StringInternTableSafePtr &a_table) :
+    m_priv (new Priv (a_table))
+{
+}
+
+GDBMIReader::~GDBMIReader ()
+{
+    stop ();
+}
+
+/// \return true if the output of GDB can be read on a thread of its
+/// own.
+bool
+GDBMIReader::is_supported ()
+{
+    return Glib::thread_supported ();
+}
+
+/// Start reading the output of GDB on a new thread.
+///
+/// \param a_fd the file descriptor GDB writes its output to.
+///
+/// \param a_context the context of the main loop the records are
+/// dispatched from.
+///
+/// \return true upon successful completion, false otherwise.
+bool
+GDBMIReader::start (int a_fd, const Glib::RefPtr<Glib::MainContext> &a_context)
+{
+    THROW_IF_FAIL (is_supported ());
+    THROW_IF_FAIL (a_context);
+
+    stop ();
+    if (pipe (m_priv->stop_pipe) || pipe (m_priv->wakeup_pipe)) {
+        LOG_ERROR ("could not create pipes: " << strerror (errno));
+        Priv::close_pipe (m_priv->stop_pipe);
+        Priv::close_pipe (m_priv->wakeup_pipe);
+        return false;
+    }
+    // The reader thread must never block on a full wakeup pipe, and
+    // the main loop never on an empty one.
+    fcntl (m_priv->wakeup_pipe[0], F_SETFL, O_NONBLOCK);
+    fcntl (m_priv->wakeup_pipe[1], F_SETFL, O_NONBLOCK);
+
+    m_priv->fd = a_fd;
+    m_priv->is_stopping = 0;
+    m_priv->wakeup_pending = 0;
+    m_priv->wakeup_channel =
+        Glib::IOChannel::create_from_fd (m_priv->wakeup_pipe[0]);
+    m_priv->wakeup_source =
+        Glib::IOSource::create (m_priv->wakeup_channel, Glib::IO_IN);
+    m_priv->wakeup_source->connect
+        (sigc::mem_fun (*m_priv, &Priv::on_wakeup));
+    m_priv->wakeup_source->attach (a_context);
+
+    try {
+        m_priv->thread =
+            Glib::Thread::create (sigc::mem_fun (*m_priv, &Priv::run),
+                                  true /*joinable*/);
+    } catch (Glib::ThreadError &e) {
+        LOG_ERROR ("could not create the GDB output reader thread: "
+                   << e.what ());
+        m_priv->thread = 0;
+        stop ();
+        return false;
+    }
+    return true;
+}
+
+/// Stop the reader thread, and drop the records the main loop has
+/// not dispatched yet.
+void
+GDBMIReader::stop ()
+{
+    if (m_priv->thread) {
+        m_priv->is_stopping = 1;
+        __sync_synchronize ();
+        char c = 0;
+        if (write (m_priv->stop_pipe[1], &c, 1) != 1)
+            LOG_ERROR ("could not stop the GDB output reader: "
+                       << strerror (errno));
+        m_priv->thread->join ();
+        m_priv->thread = 0;
+    }
+    if (m_priv->wakeup_source) {
+        m_priv->wakeup_source->destroy ();
+        m_priv->wakeup_source.reset ();
+    }
+    m_priv->wakeup_channel.reset ();
+    Priv::close_pipe (m_priv->stop_pipe);
+    Priv::close_pipe (m_priv->wakeup_pipe);
+
+    Records *records = 0;
+    while (m_priv->queue.pop (records))
+        delete records;
+    m_priv->fd = -1;
+}
+
+/// \return true if the reader thread is running.
+bool
+GDBMIReader::is_running () const
+{
+    return m_priv->thread != 0;
+}
+
+/// Emitted from the main loop with the parsed records of each
+/// buffer GDB sent.  The Output of the records is set, but their
+/// Command is not, as only the main loop knows which commands were
+/// issued.
+sigc::signal<void, GDBMIReader::Records&>&
+GDBMIReader::records_signal () const
+{
+    return m_priv->records_signal;
+}
+
+/// Emitted from the main loop once all the records were
+/// dispatched, when GDB has closed its output.
+sigc::signal<void>&
+GDBMIReader::eof_signal () const
+{
+    return m_priv->eof_signal;
+}
+
+/// Parse all the output records of a buffer sent by GDB.
+///
+/// \param a_parser the parser to use.
+///
+/// \param a_buffer the buffer to parse, as returned by
+/// GDBMIFramer::pop.
+///
+/// \param a_outputs output parameter.  The output of each record of
+/// a_buffer is appended to it.  Records that failed to parse have
+/// their parsing_succeeded property set to false.
+void
+GDBMIReader::parse_output (GDBMIParser &a_parser,
+                           const UString &a_buffer,
+                           std::list<CommandAndOutput> &a_outputs)
+{
+    Output output (a_buffer);
+
+    UString::size_type from (0), to (0), end (a_buffer.size ());
+    a_parser.push_input (a_buffer);
+    for (; from < end;) {
+        if (!a_parser.parse_output_record (from, to, output)) {
+            LOG_ERROR ("output record parsing failed: "
+                    << a_buffer.substr (from, end - from)
+                    << "\npart of buf: " << a_buffer
+                    << "\nfrom: " << (int) from
+                    << "\nto: " << (int) to << "\n"
+                    << "\nstrlen: " << (int) a_buffer.size ());
+            a_parser.skip_output_record (from, to);
+            output.parsing_succeeded (false);
+        } else {
+            output.parsing_succeeded (true);
+        }
+
+        UString output_value;
+        output_value.assign (a_buffer, from, to - from +1);
+        output.raw_value (output_value);
+        a_outputs.push_back (CommandAndOutput ());
+        a_outputs.back ().output (output);
+
+        from = to;
+        while (from < end && isspace (a_buffer.raw ()[from])) {++from;}
+    }
+    a_parser.pop_input ();
+}
+
+//**********************
+//</GDBMIReader methods>
+//**********************
+
+NEMIVER_END_NAMESPACE (nemiver)
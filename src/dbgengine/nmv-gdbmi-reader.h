@@ -0,0 +1,108 @@
+/*
+ *This file is part of the Nemiver project
+ *
+ *Nemiver is free software; you can redistribute
+ *it and/or modify it under the terms of
+ *the GNU General Public License as published by the
+ *Free Software Foundation; either version 2,
+ *or (at your option) any later version.
+ *
+ *Nemiver is distributed in the hope that it will
+ *be useful, but WITHOUT ANY WARRANTY;
+ *without even the implied warranty of
+ *MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ *See the GNU General Public License for more details.
+ *
+ *You should have received a copy of the
+ *GNU General Public License along with Nemiver;
+ *see the file COPYING.
+ *If not, write to the Free Software Foundation,
+ *Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+ *
+ *See COPYRIGHT file copyright information.
+ */
+#ifndef __NMV_GDBMI_READER_H__
+#define __NMV_GDBMI_READER_H__
+
+#include <list>
+#include <string>
+#include <glibmm.h>
+#include "common/nmv-interned-string.h"
+#include "nmv-dbg-common.h"
+
+NEMIVER_BEGIN_NAMESPACE (nemiver)
+
+class GDBMIParser;
+
+/// Splits the output of GDB into the buffers that GDB terminates
+/// with its "(gdb)" prompt.  Each buffer holds one or more complete
+/// output records.
+class GDBMIFramer {
+    std::string m_pending;
+    // How far m_pending was searched for the prompt, and for the
+    // menu GDB shows to choose between overloaded functions.
+    std::string::size_type m_prompt_scanned;
+    std::string::size_type m_menu_scanned;
+    bool m_saw_menu;
+
+    void reset_scan ();
+
+public:
+    GDBMIFramer ();
+    void push (const char *a_data, size_t a_len);
+    bool pop (std::string &a_buffer);
+    void clear ();
+};//end class GDBMIFramer
+
+/// Reads the output of GDB on a thread of its own, frames it with a
+/// GDBMIFramer and parses the output records of each buffer.
+///
+/// The parsed records of each buffer are handed to the main loop
+/// through a lock-free single producer, single consumer queue.
+/// Only records_signal and eof_signal are emitted from the main
+/// loop.  So while a huge reply of GDB is being parsed, the main
+/// loop keeps on repainting the windows and handling the input of
+/// the user.
+///
+/// The parsed records hold reference counted objects that are
+/// handed from one thread to the other; their reference count is
+/// updated atomically.  See is_supported.
+class GDBMIReader {
+    // non copyable
+    GDBMIReader (const GDBMIReader &);
+    GDBMIReader& operator= (const GDBMIReader &);
+
+    struct Priv;
+    SafePtr<Priv> m_priv;
+
+public:
+
+    /// The output records of one buffer sent by GDB.
+    struct Records {
+        UString buffer;
+        std::list<CommandAndOutput> outputs;
+    };//end struct Records
+
+    GDBMIReader (const common::StringInternTableSafePtr &a_table);
+    ~GDBMIReader ();
+
+    static bool is_supported ();
+
+    bool start (int a_fd, const Glib::RefPtr<Glib::MainContext> &a_context);
+
+    void stop ();
+
+    bool is_running () const;
+
+    sigc::signal<void, Records&>& records_signal () const;
+
+    sigc::signal<void>& eof_signal () const;
+
+    static void parse_output (GDBMIParser &a_parser,
+                              const UString &a_buffer,
+                              std::list<CommandAndOutput> &a_outputs);
+};//end class GDBMIReader
+
+NEMIVER_END_NAMESPACE (nemiver)
+
+#endif // __NMV_GDBMI_READER_H__
@@ -36,6 +36,7 @@
 #include "common/nmv-dynamic-module.h"
 #include "common/nmv-safe-ptr-utils.h"
 #include "common/nmv-address.h"
+#include "common/nmv-interned-string.h"
 #include "common/nmv-asm-instr.h"
 #include "common/nmv-loc.h"
 #include "common/nmv-str-utils.h"
@@ -50,6 +51,7 @@ using nemiver::common::ObjectUnref;
 using nemiver::common::UString;
 using nemiver::common::Object;
 using nemiver::common::Address;
+using nemiver::common::InternedString;
 using nemiver::common::AsmInstr;
 using nemiver::common::MixedAsmInstr;
 using nemiver::common::Asm;
@@ -94,7 +96,9 @@ public:
             UNDEFINED_TYPE = 0,
             STANDARD_BREAKPOINT_TYPE,
             WATCHPOINT_TYPE,
-            COUNTPOINT_TYPE
+            COUNTPOINT_TYPE,
+            // A breakpoint that logs a message and doesn't stop.
+            DPRINTF_TYPE
         };
 
     private:
@@ -106,6 +110,9 @@ public:
         UString m_file_name;
         UString m_file_full_name;
         string m_condition;
+        // The format and the arguments a dprintf logs,
+        // e.g. "i = %d\n",i
+        UString m_dprintf_format;
         Type m_type;
         int m_line;
         int m_nb_times_hit;
@@ -116,6 +123,9 @@ public:
         int m_ignore_count;
         bool m_is_read_watchpoint;
         bool m_is_write_watchpoint;
+        // Whether the watchpoint uses the debug registers of the
+        // processor.
+        bool m_is_hardware_watchpoint;
         // The list of sub-breakpoints, in case this breakpoint is a
         // multiple breakpoint.  In that case, each sub-breakpoint
         // will be set to a real location of an overload function.
@@ -223,6 +233,9 @@ public:
 
         bool has_condition () const {return !m_condition.empty ();}
 
+        const UString& dprintf_format () const {return m_dprintf_format;}
+        void dprintf_format (const UString &a_in) {m_dprintf_format = a_in;}
+
         int nb_times_hit () const {return m_nb_times_hit;}
         void nb_times_hit (int a_nb) {m_nb_times_hit = a_nb;}
 
@@ -243,6 +256,10 @@ public:
         bool is_write_watchpoint () const {return m_is_write_watchpoint;}
         void is_write_watchpoint (bool f) {m_is_write_watchpoint = f;}
 
+        bool is_hardware_watchpoint () const
+        {return m_is_hardware_watchpoint;}
+        void is_hardware_watchpoint (bool f) {m_is_hardware_watchpoint = f;}
+
         bool is_pending () const {return m_is_pending;}
         void is_pending (bool a) {m_is_pending = a;}
 
@@ -286,11 +303,13 @@ public:
             m_file_full_name.clear ();
             m_line = 0;
             m_condition.clear ();
+            m_dprintf_format.clear ();
             m_nb_times_hit = 0;
             m_initial_ignore_count = 0;
             m_ignore_count = 0;
             m_is_read_watchpoint = false;
             m_is_write_watchpoint = false;
+            m_is_hardware_watchpoint = false;
             m_sub_breakpoints.clear ();
             m_parent_breakpoint_number = 0;
             m_is_pending = false;
@@ -369,18 +388,26 @@ public:
     typedef list<VariableSafePtr> VariableList;
 
     /// \brief a function frame as seen by the debugger.
+    /// The strings of a frame (function, file and library names)
+    /// are held as interned strings, as the same few strings are
+    /// repeated in most frames of a call stack, and from one stop to
+    /// another.
     class Frame {
+    public:
+        typedef vector<std::pair<string, string> > Args;
+
+    private:
         Address m_address;
-        string m_function_name;
-        map<string, string> m_args;
+        InternedString m_function_name;
+        Args m_args;
         int m_level;
         //present if the target has debugging info
-        UString m_file_name;
+        InternedString m_file_name;
         //present if the target has sufficient debugging info
-        UString m_file_full_name;
+        InternedString m_file_full_name;
         int m_line;
         //present if the target doesn't have debugging info
-        string m_library;
+        InternedString m_library;
     public:
 
         Frame () :
@@ -395,9 +422,9 @@ public:
         bool operator== (const Frame &a) const
         {
             return (level () == a.level ()
-                    && function_name () == a.function_name ()
-                    && file_name () == a.file_name ()
-                    && library () == a.library ());
+                    && m_function_name == a.m_function_name
+                    && m_file_name == a.m_file_name
+                    && m_library == a.m_library);
         }
 
         bool operator!= (const Frame &a) const {return !(operator== (a));}
@@ -414,26 +441,57 @@ public:
             return m_address.to_string ().empty ();
         }
 
-        const string& function_name () const {return m_function_name;}
-        void function_name (const string &a_in) {m_function_name = a_in;}
+        const string& function_name () const
+        {
+            return m_function_name.raw ();
+        }
+        void function_name (const string &a_in)
+        {
+            m_function_name = InternedString (a_in);
+        }
+        void function_name (const InternedString &a_in)
+        {
+            m_function_name = a_in;
+        }
 
-        const map<string, string>& args () const {return m_args;}
-        map<string, string>& args () {return m_args;}
+        const Args& args () const {return m_args;}
+        Args& args () {return m_args;}
 
         int level () const {return m_level;}
         void level (int a_level) {m_level = a_level;}
 
-        const UString& file_name () const {return m_file_name;}
-        void file_name (const UString &a_in) {m_file_name = a_in;}
+        const UString& file_name () const {return m_file_name.ustr ();}
+        void file_name (const UString &a_in)
+        {
+            m_file_name = InternedString (a_in.raw ());
+        }
+        void file_name (const InternedString &a_in) {m_file_name = a_in;}
 
-        const UString& file_full_name () const {return m_file_full_name;}
-        void file_full_name (const UString &a_in) {m_file_full_name = a_in;}
+        const UString& file_full_name () const
+        {
+            return m_file_full_name.ustr ();
+        }
+        void file_full_name (const UString &a_in)
+        {
+            m_file_full_name = InternedString (a_in.raw ());
+        }
+        void file_full_name (const InternedString &a_in)
+        {
+            m_file_full_name = a_in;
+        }
 
         int line () const {return m_line;}
         void line (int a_in) {m_line = a_in;}
 
-        const string& library () const {return m_library;}
-        void library (const string &a_library) {m_library = a_library;}
+        const string& library () const {return m_library.raw ();}
+        void library (const string &a_library)
+        {
+            m_library = InternedString (a_library);
+        }
+        void library (const InternedString &a_library)
+        {
+            m_library = a_library;
+        }
 
         /// @}
 
@@ -441,17 +499,171 @@ public:
         void clear ()
         {
             m_address = "";
-            m_function_name = "";
+            m_function_name.clear ();
             m_args.clear ();
             m_level = 0;
-            m_file_name = "";
-            m_file_full_name = "";
+            m_file_name.clear ();
+            m_file_full_name.clear ();
             m_line = 0;
             m_library.clear ();
-            m_args.clear ();
         }
     };//end class Frame
 
+    /// \brief the state of a thread of the inferior, as reported by
+    /// the -thread-info GDB/MI command.
+    class ThreadInfo {
+        int m_id;
+        UString m_target_id;
+        UString m_name;
+        UString m_state;
+        bool m_has_frame;
+        Frame m_frame;
+
+    public:
+
+        ThreadInfo () :
+            m_id (0),
+            m_has_frame (false)
+        {
+        }
+
+        bool operator== (const ThreadInfo &a) const
+        {
+            return (m_id == a.m_id
+                    && m_target_id == a.m_target_id
+                    && m_name == a.m_name
+                    && m_state == a.m_state
+                    && m_has_frame == a.m_has_frame
+                    && (!m_has_frame
+                        || (m_frame == a.m_frame
+                            && m_frame.line () == a.m_frame.line ())));
+        }
+
+        bool operator!= (const ThreadInfo &a) const
+        {
+            return !(operator== (a));
+        }
+
+        /// \name accessors
+
+        /// @{
+        int id () const {return m_id;}
+        void id (int a_in) {m_id = a_in;}
+
+        /// The identifier of the thread in the target,
+        /// e.g. "Thread 0xb7e14b90 (LWP 21257)".
+        const UString& target_id () const {return m_target_id;}
+        void target_id (const UString &a_in) {m_target_id = a_in;}
+
+        /// The name of the thread, if the target provides it.
+        const UString& name () const {return m_name;}
+        void name (const UString &a_in) {m_name = a_in;}
+
+        /// Either "stopped" or "running".
+        const UString& state () const {return m_state;}
+        void state (const UString &a_in) {m_state = a_in;}
+        bool is_running () const {return m_state == "running";}
+
+        /// The frame the thread is stopped in.  Running threads
+        /// have no frame.
+        bool has_frame () const {return m_has_frame;}
+        const Frame& frame () const {return m_frame;}
+        void frame (const Frame &a_in)
+        {
+            m_frame = a_in;
+            m_has_frame = true;
+        }
+        /// @}
+
+        void clear ()
+        {
+            m_id = 0;
+            m_target_id.clear ();
+            m_name.clear ();
+            m_state.clear ();
+            m_has_frame = false;
+            m_frame.clear ();
+        }
+    };//end class ThreadInfo
+
+    /// How a watchpoint can be implemented.  A hardware watchpoint
+    /// uses the debug registers of the processor and costs nothing
+    /// until it triggers.  A software watchpoint makes the debugger
+    /// single-step the program and compare the watched value after
+    /// each step, which slows the program down about a thousand
+    /// times.  The debugger silently falls back to a software
+    /// watchpoint when the watched object doesn't fit in the debug
+    /// registers.
+    class WatchpointPlan {
+    public:
+        enum Mode {
+            // The address or the size of the watched object couldn't
+            // be determined, e.g. because the expression is not an
+            // lvalue.
+            UNKNOWN_MODE = 0,
+            HARDWARE_MODE,
+            SOFTWARE_MODE
+        };
+
+        /// An aligned region of memory that one debug register can
+        /// watch.
+        struct Chunk {
+            size_t address;
+            unsigned size;
+
+            Chunk (size_t a_address = 0, unsigned a_size = 0) :
+                address (a_address),
+                size (a_size)
+            {
+            }
+        };
+
+    private:
+        Mode m_mode;
+        UString m_expression;
+        size_t m_address;
+        size_t m_size;
+        vector<Chunk> m_chunks;
+        unsigned m_nb_registers;
+
+    public:
+
+        WatchpointPlan () :
+            m_mode (UNKNOWN_MODE),
+            m_address (0),
+            m_size (0),
+            m_nb_registers (0)
+        {
+        }
+
+        /// \name accessors
+
+        /// @{
+        Mode mode () const {return m_mode;}
+        void mode (Mode a_in) {m_mode = a_in;}
+
+        const UString& expression () const {return m_expression;}
+        void expression (const UString &a_in) {m_expression = a_in;}
+
+        /// The address and the size of the watched object.
+        size_t address () const {return m_address;}
+        void address (size_t a_in) {m_address = a_in;}
+
+        size_t size () const {return m_size;}
+        void size (size_t a_in) {m_size = a_in;}
+
+        /// The aligned regions the watched object is split into; one
+        /// debug register is needed for each.
+        const vector<Chunk>& chunks () const {return m_chunks;}
+        vector<Chunk>& chunks () {return m_chunks;}
+
+        /// The number of debug registers the watchpoints already
+        /// set left free.
+        unsigned nb_registers () const {return m_nb_registers;}
+        void nb_registers (unsigned a_in) {m_nb_registers = a_in;}
+        /// @}
+    };//end class WatchpointPlan
+
     typedef sigc::slot<void> DefaultSlot;
     typedef sigc::slot<void, const vector<IDebugger::Frame>&>
         FrameVectorSlot;
@@ -460,7 +672,18 @@ public:
 
     typedef sigc::slot<void, const VariableSafePtr> ConstVariableSlot;
     typedef sigc::slot<void, const VariableList&> ConstVariableListSlot;
+    // Called with the sub-variables that changed, and with the root
+    // variable they belong to.
+    typedef sigc::slot<void, const VariableList&, const VariableSafePtr>
+        VariableChangesSlot;
     typedef sigc::slot<void, const UString&> ConstUStringSlot;
+    typedef sigc::slot<void, const WatchpointPlan&> WatchpointPlanSlot;
+
+    /// A block of memory of the inferior: its address and its bytes.
+    typedef std::pair<size_t, std::vector<uint8_t> > MemoryBlock;
+    /// Called with the blocks of memory that could be read, in
+    /// increasing order of address.
+    typedef sigc::slot<void, const list<MemoryBlock>&> MemoryBlocksSlot;
 
     class Variable : public Object {
     public:
@@ -522,6 +745,10 @@ public:
         bool m_needs_revisualizing;
         bool m_is_dynamic;
         bool m_has_more_children;
+        // The time GDB took to create the variable object and to list
+        // its children, in milliseconds.  Most of it is spent in the
+        // pretty-printers, if any.
+        unsigned int m_backend_cost_ms;
 
     public:
         explicit Variable (const UString &a_internal_name,
@@ -541,7 +768,8 @@ public:
             m_format (UNDEFINED_FORMAT),
             m_needs_revisualizing (false),
             m_is_dynamic (false),
-            m_has_more_children (false)
+            m_has_more_children (false),
+            m_backend_cost_ms (0)
         {
         }
 
@@ -560,7 +788,8 @@ public:
             m_format (UNDEFINED_FORMAT),
             m_needs_revisualizing (false),
             m_is_dynamic (false),
-            m_has_more_children (false)
+            m_has_more_children (false),
+            m_backend_cost_ms (0)
 
         {
         }
@@ -575,7 +804,8 @@ public:
             m_format (UNDEFINED_FORMAT),
             m_needs_revisualizing (false),
             m_is_dynamic (false),
-            m_has_more_children (false)
+            m_has_more_children (false),
+            m_backend_cost_ms (0)
 
         {
         }
@@ -588,7 +818,8 @@ public:
             m_format (UNDEFINED_FORMAT),
             m_needs_revisualizing (false),
                     m_is_dynamic (false),
-            m_has_more_children (false)
+            m_has_more_children (false),
+            m_backend_cost_ms (0)
         {
         }
 
@@ -1023,6 +1254,9 @@ public:
         bool has_more_children () const {return m_has_more_children;}
         void has_more_children (bool a) {m_has_more_children = a;}
 
+        unsigned int backend_cost_ms () const {return m_backend_cost_ms;}
+        void backend_cost_ms (unsigned int a) {m_backend_cost_ms = a;}
+
     };//end class Variable
 
     enum State {
@@ -1112,6 +1346,12 @@ public:
 
     virtual sigc::signal<void, const UString&>& log_message_signal () const=0;
 
+    /// Emitted with the lines logged by the dprintf set by
+    /// set_dprintf, as they come.  The lines of a burst of hits
+    /// come at once, separated by '\n'.
+    virtual sigc::signal<void, const UString&>&
+                                     dprintf_output_signal () const = 0;
+
     virtual sigc::signal<void,
                          const UString&/*command name*/,
                          const UString&/*command cookie*/>&
@@ -1166,12 +1406,25 @@ public:
                          const UString& /*cookie*/>&
                                         threads_listed_signal () const =0;
 
+    /// Emitted when the detailed list of the threads of the inferior
+    /// got fetched, e.g. as a result of IDebugger::list_threads_info.
+    virtual sigc::signal<void,
+                         const list<ThreadInfo>& /*threads*/,
+                         const UString& /*cookie*/>&
+                                    threads_info_listed_signal () const=0;
+
     virtual sigc::signal<void,
                          int/*thread id*/,
                          const IDebugger::Frame *const/*frame in thread*/,
                          const UString& /*cookie*/> &
                                              thread_selected_signal () const=0;
 
+    /// Emitted when shared libraries got loaded in, or unloaded
+    /// from, the inferior.  Anything that depends on the code mapped
+    /// in the inferior, like disassembled instructions, should be
+    /// considered stale then.
+    virtual sigc::signal<void>& libraries_changed_signal () const = 0;
+
     virtual sigc::signal<void,
                         const vector<IDebugger::Frame>&,
                         const UString&>& frames_listed_signal () const=0;
@@ -1246,6 +1499,15 @@ public:
 
     virtual sigc::signal<void>& running_signal () const=0;
 
+    /// Emitted when threads of the inferior are resumed, or stop.
+    /// The thread id is -1 when all the threads are resumed, or all
+    /// stop, at once; that is always the case unless GDB runs in
+    /// non-stop mode.
+    virtual sigc::signal<void,
+                         int/*thread id*/,
+                         bool/*is running*/>&
+                                    thread_state_changed_signal () const=0;
+
     virtual sigc::signal<void,
                          const UString&/*signal name*/,
                          const UString&/*signal description*/>&
@@ -1408,6 +1670,27 @@ public:
 
     virtual IDebugger::State get_state () const = 0;
 
+    /// Mark the commands queued from now on, and the commands queued
+    /// while their results are handled, as refreshing the views of
+    /// the current state of the inferior, or stop marking them.
+    ///
+    /// Only the commands that list the state of the inferior without
+    /// changing anything, e.g. the listing of frames or registers,
+    /// get marked.  Those are dropped, if they haven't been sent to
+    /// the backend yet, once the thread they are about is resumed:
+    /// their results would describe a state that is already gone.
+    /// The slots given along with them are not called then.
+    ///
+    /// \param a_flag true to mark the commands queued from now on.
+    virtual void set_refreshing (bool a_flag) = 0;
+
+    /// Drop the queued commands marked by IDebugger::set_refreshing
+    /// that haven't been sent to the backend yet, and which thread is
+    /// running.
+    ///
+    /// \return the number of commands dropped.
+    virtual unsigned drop_refresh_commands () = 0;
+
     virtual int get_current_frame_level () const = 0;
 
     virtual bool stop_target () = 0;
@@ -1493,11 +1776,20 @@ public:
     virtual void set_watchpoint (const UString &a_expression,
                                  bool a_write = true,
                                  bool a_read = false,
-                                 const UString &a_cookie = "") = 0;
+                                 const UString &a_cookie = "",
+                                 bool a_allow_software = false) = 0;
+
+    virtual void plan_watchpoint (const UString &a_expression,
+                                  const WatchpointPlanSlot &a_slot) = 0;
 
     virtual void set_catch (const UString &a_event,
                             const UString &a_cookie="") = 0;
 
+    virtual void set_dprintf (const common::Loc &a_loc,
+                              const UString &a_format,
+                              const UString &a_condition = "",
+                              const UString &a_cookie = "") = 0;
+
     virtual void list_breakpoints (const UString &a_cookie="") = 0;
 
     virtual const map<string, Breakpoint>& get_cached_breakpoints () = 0;
@@ -1517,11 +1809,35 @@ public:
 
     virtual void list_threads (const UString &a_cookie="") = 0;
 
+    virtual void list_threads_info (const UString &a_cookie="") = 0;
+
     virtual void select_thread (unsigned int a_thread_id,
                                 const UString &a_cookie="") = 0;
 
     virtual unsigned int get_current_thread () const = 0;
 
+    virtual bool is_non_stop_mode () const = 0;
+
+    /// Ask for the debugger to be set in non-stop mode, or not, the
+    /// next time it is launched, for this session only.
+    ///
+    /// \param a_flag true to ask for non-stop mode.
+    virtual void set_non_stop_mode (bool a_flag) = 0;
+
+    /// Enable the launch of a second debugger, kept on standby to
+    /// load the same program faster the next time, or disable it,
+    /// for this session only.
+    ///
+    /// \param a_flag true to enable the standby debugger.
+    virtual void set_standby_gdb (bool a_flag) = 0;
+
+    /// \return true if the debugger in use was the one kept on
+    /// standby, i.e. if the program was last loaded without waiting
+    /// for a debugger to start.
+    virtual bool is_using_standby_gdb () const = 0;
+
+    virtual bool is_thread_running (int a_thread_id) const = 0;
+
     virtual void select_frame (int a_frame_id,
                                const UString &a_cookie="") = 0;
 
@@ -1590,6 +1906,10 @@ public:
 
     virtual void read_memory (size_t a_start_addr, size_t a_num_bytes,
             const UString& a_cookie="") = 0;
+    virtual void read_memory_bytes (size_t a_start_addr,
+                                    size_t a_num_bytes,
+                                    const MemoryBlocksSlot &a_slot,
+                                    const UString &a_cookie="") = 0;
     virtual void set_memory (size_t a_addr,
             const std::vector<uint8_t>& a_bytes,
             const UString& a_cookie="") = 0;
@@ -1746,6 +2066,21 @@ public:
              const ConstVariableListSlot &a_slot,
              const UString &a_cookie="") = 0;
 
+    /// Like the above, but for several root variables at once, with
+    /// one command sent to the debugger rather than one per root.
+    ///
+    /// \param a_roots the variables to consider.
+    ///
+    /// \param a_slot the slot invoked for each of a_roots, with the
+    /// sub-variables of that root that have changed.
+    ///
+    /// \param a_cookie the cookie to be passed to the callback
+    /// function IDebugger::changed_variables_signal
+    virtual void list_changed_variables
+            (const VariableList &a_roots,
+             const VariableChangesSlot &a_slot,
+             const UString &a_cookie="") = 0;
+
     virtual void query_variable_path_expr (const VariableSafePtr a_var,
                                            const UString &a_cookie = "") = 0;
 
@@ -1763,6 +2098,30 @@ public:
 
     virtual void enable_pretty_printing (bool a_flag = true) = 0;
 
+    /// Set the maximum number of children of a variable to fetch
+    /// through its pretty-printer, for the rest of this debugging
+    /// session.  It also limits the number of elements of the arrays
+    /// and strings printed by the debugger.
+    ///
+    /// \param a_max the maximum number of children, or 0 for no
+    /// limit.
+    virtual void set_pretty_printing_max_children (int a_max) = 0;
+
+    virtual int get_pretty_printing_max_children () const = 0;
+
+    /// Display the variables of a given type with, or without
+    /// pretty-printer.  The setting is remembered across sessions.
+    ///
+    /// \param a_type the type to consider.
+    ///
+    /// \param a_disabled true to display the variables of type a_type
+    /// without pretty-printer.
+    virtual void disable_pretty_printing_for_type (const UString &a_type,
+                                                   bool a_disabled) = 0;
+
+    virtual bool is_pretty_printing_disabled_for_type
+                                        (const UString &a_type) const = 0;
+
 };//end IDebugger
 
 NEMIVER_END_NAMESPACE (nemiver)
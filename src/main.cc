@@ -27,6 +27,8 @@
 #include <unistd.h>
 #include <stdlib.h>
 #include <iostream>
+#include <fstream>
+#include <glibmm/timer.h>
 #include <gtkmm/window.h>
 #include <glib/gi18n.h>
 #include "nmv-str-utils.h"
@@ -43,6 +45,7 @@ using namespace std;
 using nemiver::IConfMgr;
 using nemiver::common::DynamicModuleManager;
 using nemiver::common::Initializer;
+using nemiver::common::ScopeLogger;
 using nemiver::IWorkbench;
 using nemiver::IWorkbenchSafePtr;
 using nemiver::IDBGPerspective;
@@ -66,6 +69,12 @@ static gchar *gv_solib_prefix = 0;
 static gchar *gv_gdb_binary_filepath = 0;
 static gchar *gv_core_path = 0;
 static bool gv_just_load = false;
+static bool gv_startup_timing = false;
+static gchar *gv_profile_path = 0;
+// Started when the process starts; used to report how long each
+// start up phase took.
+static Glib::Timer s_startup_timer;
+static sigc::connection s_first_draw_connection;
 
 static GOptionEntry entries[] =
 {
@@ -189,6 +198,26 @@ static GOptionEntry entries[] =
         _("Do not set a breakpoint in 'main' and do not run the inferior either"),
         0
     },
+    {
+        "startup-timing",
+        0,
+        0,
+        G_OPTION_ARG_NONE,
+        &gv_startup_timing,
+        _("Report how long each phase of the start up took"),
+        0
+    },
+    {
+        "profile",
+        0,
+        0,
+        G_OPTION_ARG_STRING,
+        &gv_profile_path,
+        _("Profile the functions of Nemiver and write the time spent in "
+          "each call path to FILE, in the folded stacks format of "
+          "flamegraph.pl"),
+        "<FILE>"
+    },
     { 
         "version",
         0,
@@ -402,6 +431,10 @@ process_non_gui_options ()
         LOG_STREAM.enable_domain ("gdbmi-output-domain");
     }
 
+    if (gv_profile_path) {
+        ScopeLogger::start_profiling ();
+    }
+
     if (gv_show_version) {
         cout << PACKAGE_VERSION << endl;
         return false;
@@ -419,6 +452,47 @@ process_non_gui_options ()
     return true;
 }
 
+/// If the user asked for it with --startup-timing, report on the
+/// standard error the time elapsed since the process started.
+/// \param a_phase the name of the start up phase that just ended.
+static void
+report_startup_phase (const char *a_phase)
+{
+    if (!gv_startup_timing)
+        return;
+    cerr << "startup: " << a_phase << ": "
+         << (int) (s_startup_timer.elapsed () * 1000) << "ms"
+         << endl;
+}
+
+/// Called when the main window is drawn for the first time, which
+/// is the end of the start up.
+static bool
+on_first_draw (const Cairo::RefPtr<Cairo::Context> &)
+{
+    report_startup_phase ("first window drawn");
+    s_first_draw_connection.disconnect ();
+    return false;
+}
+
+/// If the user asked for it with --profile, write the profile
+/// gathered since the start up to the file given, and a summary of
+/// it on the standard error.
+static void
+write_profile ()
+{
+    if (!gv_profile_path)
+        return;
+    ScopeLogger::stop_profiling ();
+    std::ofstream file (gv_profile_path);
+    if (!file) {
+        cerr << "Could not write the profile to " << gv_profile_path << endl;
+        return;
+    }
+    ScopeLogger::write_profile (file);
+    ScopeLogger::write_profile_summary (cerr);
+}
+
 /// Load the debugger perspective.
 static IDBGPerspective*
 load_debugger_perspective ()
@@ -481,7 +555,6 @@ process_gui_options (int& a_argc, char** a_argv)
     if (gv_list_sessions) {        
         IDBGPerspective *debug_persp = load_debugger_perspective ();
         if (debug_persp) {
-            debug_persp->session_manager ().load_sessions ();
             list<ISessMgr::Session>::iterator session_iter;
             list<ISessMgr::Session>& sessions =
                             debug_persp->session_manager ().sessions ();
@@ -689,6 +762,7 @@ main (int a_argc, char *a_argv[])
     if (!process_non_gui_options ()) {
         return -1;
     }
+    report_startup_phase ("command line parsed");
 
     //********************************************
     //load and init the workbench dynamic module
@@ -700,14 +774,17 @@ main (int a_argc, char *a_argv[])
     THROW_IF_FAIL (s_workbench);
     LOG_D ("workbench refcount: " <<  (int) s_workbench->get_refcount (),
            "refcount-domain");
+    report_startup_phase ("workbench loaded");
 
     s_workbench->do_init (gtk_kit);
     LOG_D ("workbench refcount: " <<  (int) s_workbench->get_refcount (),
            "refcount-domain");
+    report_startup_phase ("workbench initialized");
 
     if (!process_gui_options (a_argc, a_argv)) {
         return -1;
     }
+    report_startup_phase ("command line options processed");
 
     //intercept ctrl-c/SIGINT
     signal (SIGINT, sigint_handler);
@@ -737,7 +814,13 @@ main (int a_argc, char *a_argv[])
         setsid ();
     }
 
+    if (gv_startup_timing)
+        s_first_draw_connection =
+            s_workbench->get_root_window ().signal_draw ().connect
+                                                (&on_first_draw);
+
     gtk_kit.run (s_workbench->get_root_window ());
+    write_profile ();
 
     NEMIVER_CATCH_NOX
     s_workbench = 0;
@@ -34,6 +34,7 @@
 #include "nmv-i-workbench.h"
 #include "nmv-i-perspective.h"
 #include "nmv-debugger-utils.h"
+#include "nmv-refresh-scheduler.h"
 
 namespace nemiver {
 
@@ -109,7 +110,8 @@ public:
 
     Priv (IWorkbench& a_workbench,
           IPerspective& a_perspective,
-          IDebuggerSafePtr& a_debugger) :
+          IDebuggerSafePtr& a_debugger,
+          RefreshScheduler &a_refresh_scheduler) :
         breakpoints_menu(0),
         workbench(a_workbench),
         perspective(a_perspective),
@@ -127,7 +129,7 @@ public:
             (sigc::mem_fun (*this, &Priv::on_debugger_breakpoints_set_signal));
         debugger->breakpoints_list_signal ().connect (sigc::mem_fun
                 (*this, &Priv::on_debugger_breakpoints_list_signal));
-        debugger->stopped_signal ().connect (sigc::mem_fun
+        a_refresh_scheduler.stopped_signal ().connect (sigc::mem_fun
                 (*this, &Priv::on_debugger_stopped_signal));
         breakpoints_menu = load_menu ("breakpointspopup.xml",
                 "/BreakpointsPopup");
@@ -370,6 +372,13 @@ public:
 	case IDebugger::Breakpoint::COUNTPOINT_TYPE:
 	  (*a_iter)[get_bp_cols ().type] = _("countpoint");
 	  break;
+	case IDebugger::Breakpoint::DPRINTF_TYPE:
+	  (*a_iter)[get_bp_cols ().type] = _("dprintf");
+	  // Show what the dprintf logs where watchpoints show what
+	  // they watch.
+	  (*a_iter)[get_bp_cols ().expression] =
+	    a_breakpoint.dprintf_format ();
+	  break;
 	default:
 	  (*a_iter)[get_bp_cols ().type] = _("unknown");
         }
@@ -808,9 +817,11 @@ public:
 
 BreakpointsView::BreakpointsView (IWorkbench& a_workbench,
                                   IPerspective& a_perspective,
-                                  IDebuggerSafePtr& a_debugger)
+                                  IDebuggerSafePtr& a_debugger,
+                                  RefreshScheduler &a_refresh_scheduler)
 {
-    m_priv.reset (new Priv (a_workbench, a_perspective, a_debugger));
+    m_priv.reset (new Priv (a_workbench, a_perspective, a_debugger,
+                            a_refresh_scheduler));
 }
 
 BreakpointsView::~BreakpointsView ()
@@ -34,6 +34,7 @@
 #include "nmv-i-workbench.h"
 #include "nmv-i-perspective.h"
 #include "nmv-conf-keys.h"
+#include "nmv-refresh-scheduler.h"
 
 namespace nemiver {
 
@@ -110,6 +111,7 @@ struct CallStack::Priv {
     IConfMgrSafePtr conf_mgr;
     IWorkbench& workbench;
     IPerspective& perspective;
+    RefreshScheduler &refresh_scheduler;
     FrameArray frames;
     FrameArgsMap params;
     LevelFrameMap level_frame_map;
@@ -130,11 +132,13 @@ struct CallStack::Priv {
 
     Priv (IDebuggerSafePtr a_dbg,
           IWorkbench& a_workbench,
-          IPerspective& a_perspective) :
+          IPerspective& a_perspective,
+          RefreshScheduler &a_refresh_scheduler) :
         debugger (a_dbg),
         conf_mgr (0),
         workbench (a_workbench),
         perspective (a_perspective),
+        refresh_scheduler (a_refresh_scheduler),
         callstack_menu (0),
         cur_frame_index (-1),
         nb_frames_expansion_chunk (25),
@@ -317,12 +321,24 @@ struct CallStack::Priv {
     }
 
     void
-    on_thread_selected_signal (int /*a_thread_id*/,
+    on_thread_selected_signal (int a_thread_id,
                                const IDebugger::Frame* const /*a_frame*/,
                                const UString& a_cookie)
     {
         LOG_FUNCTION_SCOPE_NORMAL_DD;
+
+        NEMIVER_TRY
+
+        // In non-stop mode, the selected thread might be running.
+        // Its frames can't be listed before it stops.
+        THROW_IF_FAIL (debugger);
+        if (debugger->is_thread_running (a_thread_id)) {
+            clear_frame_list (true);
+            return;
+        }
         handle_update (a_cookie);
+
+        NEMIVER_CATCH
     }
 
     void
@@ -498,7 +514,7 @@ struct CallStack::Priv {
 
         THROW_IF_FAIL (debugger);
 
-        debugger->stopped_signal ().connect (sigc::mem_fun
+        refresh_scheduler.stopped_signal ().connect (sigc::mem_fun
                     (*this, &CallStack::Priv::on_debugger_stopped_signal));
         debugger->thread_selected_signal ().connect (sigc::mem_fun
                      (*this, &CallStack::Priv::on_thread_selected_signal));
@@ -732,6 +748,10 @@ struct CallStack::Priv {
         // really append the frames to the tree view now
         Gtk::TreeModel::iterator store_iter;
         unsigned nb_frames = a_frames.size ();
+        // Frames hold interned strings, so copying them is cheap;
+        // just avoid re-allocating the array over and over when
+        // large stacks are paged in.
+        frames.reserve (frames.size () + nb_frames);
         for (unsigned i = 0; i < nb_frames; ++i) {
             level_frame_map[a_frames[i].level ()] = a_frames[i];
             frames.push_back (a_frames[i]);
@@ -877,10 +897,12 @@ struct CallStack::Priv {
 
 CallStack::CallStack (IDebuggerSafePtr &a_debugger,
                       IWorkbench& a_workbench,
-                      IPerspective &a_perspective)
+                      IPerspective &a_perspective,
+                      RefreshScheduler &a_refresh_scheduler)
 {
     THROW_IF_FAIL (a_debugger);
-    m_priv.reset (new Priv (a_debugger, a_workbench, a_perspective));
+    m_priv.reset (new Priv (a_debugger, a_workbench, a_perspective,
+                            a_refresh_scheduler));
 }
 
 CallStack::~CallStack ()
@@ -98,6 +98,10 @@
 #endif // WITH_DYNAMICLAYOUT
 #include "nmv-layout-manager.h"
 #include "nmv-expr-monitor.h"
+#include "nmv-dprintf-log-view.h"
+#include "nmv-disassembly-cache.h"
+#include "nmv-source-file-index.h"
+#include "nmv-refresh-scheduler.h"
 
 using namespace std;
 using namespace nemiver::common;
@@ -121,6 +125,7 @@ const char *BREAKPOINTS_VIEW_TITLE       = _("Breakpoints");
 const char *REGISTERS_VIEW_TITLE         = _("Registers");
 const char *MEMORY_VIEW_TITLE            = _("Memory");
 const char *EXPR_MONITOR_VIEW_TITLE      = _("Expression Monitor");
+const char *DPRINTF_LOG_VIEW_TITLE       = _("Dprintf Log");
 
 const char *CAPTION_SESSION_NAME = "captionname";
 const char *SESSION_NAME = "sessionname";
@@ -130,6 +135,10 @@ const char *PROGRAM_CWD = "programcwd";
 const char *LAST_RUN_TIME = "lastruntime";
 const char *REMOTE_TARGET = "remotetarget";
 const char *SOLIB_PREFIX = "solibprefix";
+// Prefix of the session properties that record the encoding of
+// the source files that are not in UTF-8, e.g.
+// "fileencoding:/home/foo/bar.c" -> "ISO-8859-15".
+const char *FILE_ENCODING_PREFIX = "fileencoding:";
 
 const char *DBG_PERSPECTIVE_MOUSE_MOTION_DOMAIN =
                                 "dbg-perspective-mouse-motion-domain";
@@ -137,6 +146,11 @@ const char *DISASSEMBLY_TITLE = "<Disassembly>";
 
 static const int NUM_INSTR_TO_DISASSEMBLE = 20;
 
+// The maximum number of chunks of NUM_INSTR_TO_DISASSEMBLE
+// instructions to prefetch, following the instructions being
+// displayed, each time the inferior stops.
+static const int MAX_DISASSEMBLY_PREFETCHES = 8;
+
 const char *DBG_PERSPECTIVE_DEFAULT_LAYOUT = "default-layout";
 
 const Gtk::StockID STOCK_SET_BREAKPOINT (SET_BREAKPOINT);
@@ -345,6 +359,8 @@ private:
     void on_debugger_got_target_info_signal (int a_pid,
                                              const UString &a_exe_path);
 
+    void on_debugger_libraries_changed_signal ();
+
     void on_debugger_command_done_signal (const UString &a_command_name,
                                           const UString &a_cookie);
 
@@ -412,6 +428,21 @@ private:
                              const std::list<common::Asm> &instrs,
                              const Address &address);
 
+    void on_debugger_asm_to_cache_signal
+                            (const common::DisassembleInfo &a_info,
+                             const std::list<common::Asm> &a_instrs,
+                             Range a_range,
+                             bool a_pure_asm,
+                             unsigned a_cache_generation,
+                             IDebugger::DisassSlot a_what_to_do);
+
+    bool on_cached_asm_idle_signal (common::DisassembleInfo a_info,
+                                    std::list<common::Asm> a_instrs,
+                                    IDebugger::DisassSlot a_what_to_do);
+
+    bool on_disassembly_prefetch_idle_signal (Range a_range,
+                                              unsigned a_cache_generation);
+
     void on_variable_created_for_tooltip_signal
                                     (const IDebugger::VariableSafePtr);
     void on_popup_tip_hide ();
@@ -428,8 +459,10 @@ private:
     void on_activate_memory_view ();
 #endif // WITH_MEMORYVIEW
     void on_activate_expr_monitor_view ();
+    void on_activate_dprintf_log_view ();
     void on_activate_global_variables ();
     void on_default_config_read ();
+    void on_lazy_view_mapped (int a_view_index);
 
     //************
     //</signal slots>
@@ -693,6 +726,11 @@ public:
                              bool a_tight = false);
     void disassemble_around_address_and_do (const Address &adress,
                                             IDebugger::DisassSlot &what_to_do);
+    void disassemble_range_and_do (const Range &a_range,
+                                   IDebugger::DisassSlot &a_what_to_do);
+    void schedule_disassembly_prefetch (const Range &a_range,
+                                        const std::list<common::Asm> &a_instrs);
+    void invalidate_disassembly_cache ();
 
     void inspect_expression ();
     void inspect_expression (const UString &a_variable_name);
@@ -766,13 +804,19 @@ public:
     RegistersView& get_registers_view ();
 
 #ifdef WITH_MEMORYVIEW
+    Gtk::Box& get_memory_view_box ();
+
     MemoryView& get_memory_view ();
 #endif // WITH_MEMORYVIEW
 
     ExprMonitor& get_expr_monitor_view ();
 
+    DprintfLogView& get_dprintf_log_view ();
+
     ThreadList& get_thread_list ();
 
+    RefreshScheduler& get_refresh_scheduler ();
+
     bool set_where (const IDebugger::Frame &a_frame,
                     bool a_do_scroll = true,
                     bool a_try_hard = false);
@@ -908,9 +952,14 @@ struct DBGPerspective::Priv {
     SafePtr<Gtk::ScrolledWindow> registers_scrolled_win;
     SafePtr<RegistersView> registers_view;
 #ifdef WITH_MEMORYVIEW
+    SafePtr<Gtk::Box> memory_view_box;
     SafePtr<MemoryView> memory_view;
 #endif // WITH_MEMORYVIEW
     SafePtr<ExprMonitor> expr_monitor;
+    SafePtr<DprintfLogView> dprintf_log_view;
+    // Coalesces the stops of the inferior into refreshes of the
+    // panes above.
+    SafePtr<RefreshScheduler> refresh_scheduler;
 
     int current_page_num;
     IDebuggerSafePtr debugger;
@@ -919,6 +968,10 @@ struct DBGPerspective::Priv {
     map<string, IDebugger::Breakpoint> breakpoints;
     ISessMgrSafePtr session_manager;
     ISessMgr::Session session;
+    // The encodings of the source files that are not in UTF-8, as
+    // detected when they got loaded.  This is saved in the session,
+    // so that the next loads don't have to detect it again.
+    map<UString, std::string> file_encodings;
     IProcMgrSafePtr process_manager;
     bool show_dbg_errors;
     bool use_system_font;
@@ -931,6 +984,17 @@ struct DBGPerspective::Priv {
     bool use_launch_terminal;
     int num_instr_to_disassemble;
     bool asm_style_pure;
+    // Instructions disassembled so far.  Each invalidation of the
+    // cache bumps disassembly_cache_generation so that results of
+    // requests issued before the invalidation are not cached.
+    DisassemblyCache disassembly_cache;
+    unsigned disassembly_cache_generation;
+    int nb_disassembly_prefetches;
+    // The source files of the program, as shown by the "open file"
+    // dialog.  Getting them from the debugger can take a while on big
+    // programs, so they are kept until shared libraries are loaded
+    // or unloaded.
+    SourceFileIndex source_file_index;
     bool enable_pretty_printing;
     bool pretty_printing_toggled;
     Glib::RefPtr<Gsv::StyleScheme> editor_style;
@@ -988,6 +1052,8 @@ struct DBGPerspective::Priv {
         use_launch_terminal (false),
         num_instr_to_disassemble (NUM_INSTR_TO_DISASSEMBLE),
         asm_style_pure (true),
+        disassembly_cache_generation (0),
+        nb_disassembly_prefetches (0),
         enable_pretty_printing (true),
         pretty_printing_toggled (false),
         mouse_in_source_editor_x (0),
@@ -1043,9 +1109,11 @@ struct DBGPerspective::Priv {
        THROW_IF_FAIL (terminal);
        terminal->modify_font (font_desc);
 #ifdef WITH_MEMORYVIEW
-        THROW_IF_FAIL (memory_view);
-        memory_view->modify_font (font_desc);
+        if (memory_view)
+            memory_view->modify_font (font_desc);
 #endif // WITH_MEMORYVIEW
+        if (dprintf_log_view)
+            dprintf_log_view->modify_font (font_desc);
     }
 
     Glib::RefPtr<Gsv::StyleScheme>
@@ -1091,10 +1159,25 @@ struct DBGPerspective::Priv {
     {
         list<string> supported_encodings;
         get_supported_encodings (supported_encodings);
-        return SourceEditor::load_file (workbench->get_root_window (),
-                                        a_path, supported_encodings,
-                                        enable_syntax_highlight,
-                                        a_buffer);
+
+        std::string known_encoding, encoding;
+        map<UString, std::string>::const_iterator it =
+            file_encodings.find (a_path);
+        if (it != file_encodings.end ())
+            known_encoding = it->second;
+
+        if (!SourceEditor::load_file (workbench->get_root_window (),
+                                      a_path, supported_encodings,
+                                      known_encoding,
+                                      enable_syntax_highlight,
+                                      a_buffer, encoding))
+            return false;
+
+        if (encoding == "UTF-8")
+            file_encodings.erase (a_path);
+        else
+            file_encodings[a_path] = encoding;
+        return true;
     }
 
     bool
@@ -1796,6 +1879,10 @@ DBGPerspective::on_thread_list_thread_selected_signal (int a_tid)
         return;
 
     m_priv->current_thread_id = a_tid;
+    // In non-stop mode, the selected thread might be running.  Its
+    // variables can't be listed before it stops.
+    if (debugger ()->is_thread_running (a_tid))
+        return;
     get_local_vars_inspector ().show_local_variables_of_current_function
         (m_priv->current_frame);
 
@@ -2283,6 +2370,18 @@ DBGPerspective::on_debugger_got_target_info_signal (int a_pid,
     NEMIVER_CATCH
 }
 
+void
+DBGPerspective::on_debugger_libraries_changed_signal ()
+{
+    LOG_FUNCTION_SCOPE_NORMAL_DD;
+    NEMIVER_TRY
+    // The code mapped in the inferior changed, so the cached
+    // instructions and source files might not be accurate anymore.
+    invalidate_disassembly_cache ();
+    m_priv->source_file_index.clear ();
+    NEMIVER_CATCH
+}
+
 void
 DBGPerspective::on_debugger_connected_to_remote_target_signal ()
 {
@@ -2318,6 +2417,8 @@ DBGPerspective::on_debugger_detached_from_target_signal ()
     if (get_num_notebook_pages ())
         close_opened_files ();
     clear_status_notebook (true);
+    invalidate_disassembly_cache ();
+    m_priv->source_file_index.clear ();
     workbench ().set_title_extension ("");
     //****************************
     //grey out all the menu
@@ -2472,6 +2573,7 @@ DBGPerspective::on_debugger_stopped_signal (IDebugger::StopReason a_reason,
     update_src_dependant_bp_actions_sensitiveness ();
     m_priv->current_frame = a_frame;
     m_priv->current_thread_id = a_thread_id;
+    m_priv->nb_disassembly_prefetches = 0;
 
     set_where (a_frame, /*do_scroll=*/true, /*try_hard=*/true);
 
@@ -2507,6 +2609,7 @@ DBGPerspective::on_program_finished_signal ()
     //call stack
     //**********************
     clear_status_notebook (true);
+    invalidate_disassembly_cache ();
     NEMIVER_CATCH
 }
 
@@ -2761,6 +2864,98 @@ DBGPerspective::on_debugger_asm_signal4
     NEMIVER_CATCH
 }
 
+/// Called when instructions requested by
+/// DBGPerspective::disassemble_range_and_do were disassembled by the
+/// debugging engine.  Add them to the disassembly cache, hand them to
+/// the client code and schedule the prefetch of the instructions that
+/// come next.
+void
+DBGPerspective::on_debugger_asm_to_cache_signal
+                        (const common::DisassembleInfo &a_info,
+                         const std::list<common::Asm> &a_instrs,
+                         Range a_range,
+                         bool a_pure_asm,
+                         unsigned a_cache_generation,
+                         IDebugger::DisassSlot a_what_to_do)
+{
+    LOG_FUNCTION_SCOPE_NORMAL_DD;
+
+    NEMIVER_TRY
+
+    // Don't cache instructions that were disassembled before the
+    // cache got invalidated.
+    if (a_cache_generation == m_priv->disassembly_cache_generation)
+        m_priv->disassembly_cache.add (a_range, a_pure_asm,
+                                       a_info, a_instrs);
+    if (!a_what_to_do.empty ())
+        a_what_to_do (a_info, a_instrs);
+    if (a_cache_generation == m_priv->disassembly_cache_generation)
+        schedule_disassembly_prefetch (a_range, a_instrs);
+
+    NEMIVER_CATCH
+}
+
+/// Hand instructions found in the disassembly cache to the client
+/// code from the main loop, just like it would be if they had been
+/// disassembled by the debugging engine.
+bool
+DBGPerspective::on_cached_asm_idle_signal
+                                (common::DisassembleInfo a_info,
+                                 std::list<common::Asm> a_instrs,
+                                 IDebugger::DisassSlot a_what_to_do)
+{
+    LOG_FUNCTION_SCOPE_NORMAL_DD;
+
+    NEMIVER_TRY
+    a_what_to_do (a_info, a_instrs);
+    NEMIVER_CATCH
+
+    return false;
+}
+
+/// Disassemble the instructions of a_range in the background, and
+/// add them to the disassembly cache.
+bool
+DBGPerspective::on_disassembly_prefetch_idle_signal
+                                        (Range a_range,
+                                         unsigned a_cache_generation)
+{
+    LOG_FUNCTION_SCOPE_NORMAL_DD;
+
+    NEMIVER_TRY
+
+    // Don't get in the way of the user if the inferior got re-run,
+    // or if the debugger is busy.
+    if (a_cache_generation != m_priv->disassembly_cache_generation
+        || !debugger ()->is_attached_to_target ()
+        || debugger ()->get_state () != IDebugger::READY
+        || m_priv->disassembly_cache.contains (a_range,
+                                               m_priv->asm_style_pure))
+        return false;
+
+    LOG_DD ("prefetching asm in range ["
+            << a_range.min () << "," << a_range.max () << "[");
+
+    IDebugger::DisassSlot slot =
+        sigc::bind (sigc::mem_fun
+                        (*this,
+                         &DBGPerspective::on_debugger_asm_to_cache_signal),
+                    a_range,
+                    m_priv->asm_style_pure,
+                    a_cache_generation,
+                    IDebugger::DisassSlot ());
+    debugger ()->disassemble (/*start_addr=*/a_range.min (),
+                              /*start_addr_relative_to_pc=*/false,
+                              /*end_addr=*/a_range.max (),
+                              /*end_addr_relative_to_pc=*/false,
+                              slot,
+                              m_priv->asm_style_pure);
+
+    NEMIVER_CATCH
+
+    return false;
+}
+
 void
 DBGPerspective::on_variable_created_for_tooltip_signal
                                 (const IDebugger::VariableSafePtr a_var)
@@ -2948,6 +3143,19 @@ DBGPerspective::on_activate_expr_monitor_view ()
     NEMIVER_CATCH;
 }
 
+void
+DBGPerspective::on_activate_dprintf_log_view ()
+{
+    LOG_FUNCTION_SCOPE_NORMAL_DD;
+
+    NEMIVER_TRY;
+
+    THROW_IF_FAIL (m_priv);
+    m_priv->layout ().activate_view (DPRINTF_LOG_VIEW_INDEX);
+
+    NEMIVER_CATCH;
+}
+
 void
 DBGPerspective::on_activate_global_variables ()
 {
@@ -2974,9 +3182,59 @@ DBGPerspective::on_default_config_read ()
     if (!m_priv->get_source_font_name ().empty ()) {
         Pango::FontDescription font_desc (m_priv->get_source_font_name ());
 #ifdef WITH_MEMORYVIEW
-        get_memory_view ().modify_font (font_desc);
+        if (m_priv->memory_view)
+            m_priv->memory_view->modify_font (font_desc);
+#endif // WITH_MEMORYVIEW
+        if (m_priv->dprintf_log_view)
+            m_priv->dprintf_log_view->modify_font (font_desc);
+    }
+    NEMIVER_CATCH
+}
+
+/// Build the view of index a_view_index the first time its
+/// container gets mapped, i.e, the first time the user gets to see
+/// it.  The breakpoints, registers and memory views are not needed
+/// to display the first window so building them lazily makes
+/// Nemiver start up faster.
+///
+/// \param a_view_index the index of the view that got mapped.
+void
+DBGPerspective::on_lazy_view_mapped (int a_view_index)
+{
+    LOG_FUNCTION_SCOPE_NORMAL_DD;
+
+    NEMIVER_TRY
+
+    THROW_IF_FAIL (m_priv);
+
+    switch (a_view_index) {
+        case BREAKPOINTS_VIEW_INDEX:
+            if (!m_priv->breakpoints_view) {
+                get_breakpoints_scrolled_win ().add
+                                    (get_breakpoints_view ().widget ());
+                get_breakpoints_scrolled_win ().show_all ();
+            }
+            break;
+        case REGISTERS_VIEW_INDEX:
+            if (!m_priv->registers_view) {
+                get_registers_scrolled_win ().add
+                                    (get_registers_view ().widget ());
+                get_registers_scrolled_win ().show_all ();
+            }
+            break;
+#ifdef WITH_MEMORYVIEW
+        case MEMORY_VIEW_INDEX:
+            if (!m_priv->memory_view) {
+                get_memory_view_box ().pack_start
+                                    (get_memory_view ().widget ());
+                get_memory_view_box ().show_all ();
+            }
+            break;
 #endif // WITH_MEMORYVIEW
+        default:
+            break;
     }
+
     NEMIVER_CATCH
 }
 
@@ -3574,6 +3832,16 @@ DBGPerspective::init_actions ()
             "<alt>6",
             false
         },
+        {
+            "ActivateDprintfLogViewMenuAction",
+            nil_stock_id,
+            DPRINTF_LOG_VIEW_TITLE,
+            _("Switch to Dprintf Log View"),
+            sigc::mem_fun (*this, &DBGPerspective::on_activate_dprintf_log_view),
+            ActionEntry::DEFAULT,
+            "<alt>7",
+            false
+        },
         {
             "DebugMenuAction",
             nil_stock_id,
@@ -3830,8 +4098,20 @@ DBGPerspective::init_body ()
 
     get_local_vars_inspector_scrolled_win ().add
                                     (get_local_vars_inspector ().widget ());
-    get_breakpoints_scrolled_win ().add (get_breakpoints_view ().widget());
-    get_registers_scrolled_win ().add (get_registers_view ().widget());
+
+    // The content of these views is built the first time they are
+    // shown.  See on_lazy_view_mapped.
+    get_breakpoints_scrolled_win ().signal_map ().connect (sigc::bind
+        (sigc::mem_fun (*this, &DBGPerspective::on_lazy_view_mapped),
+         BREAKPOINTS_VIEW_INDEX));
+    get_registers_scrolled_win ().signal_map ().connect (sigc::bind
+        (sigc::mem_fun (*this, &DBGPerspective::on_lazy_view_mapped),
+         REGISTERS_VIEW_INDEX));
+#ifdef WITH_MEMORYVIEW
+    get_memory_view_box ().signal_map ().connect (sigc::bind
+        (sigc::mem_fun (*this, &DBGPerspective::on_lazy_view_mapped),
+         MEMORY_VIEW_INDEX));
+#endif // WITH_MEMORYVIEW
 
     m_priv->sourceviews_notebook.reset (new Gtk::Notebook);
     m_priv->sourceviews_notebook->remove_page ();
@@ -3871,10 +4151,6 @@ DBGPerspective::init_signals ()
     get_call_stack ().frame_selected_signal ().connect
         (sigc::mem_fun (*this, &DBGPerspective::on_frame_selected_signal));
 
-    get_breakpoints_view ().go_to_breakpoint_signal ().connect
-        (sigc::mem_fun (*this,
-                        &DBGPerspective::on_breakpoint_go_to_source_action));
-
     get_thread_list ().thread_selected_signal ().connect (sigc::mem_fun
         (*this, &DBGPerspective::on_thread_list_thread_selected_signal));
 
@@ -3938,6 +4214,9 @@ DBGPerspective::init_debugger_signals ()
 
     debugger ()->got_target_info_signal ().connect (sigc::mem_fun
             (*this, &DBGPerspective::on_debugger_got_target_info_signal));
+
+    debugger ()->libraries_changed_signal ().connect (sigc::mem_fun
+            (*this, &DBGPerspective::on_debugger_libraries_changed_signal));
 }
 
 void
@@ -3946,12 +4225,18 @@ DBGPerspective::clear_status_notebook (bool a_restarting)
     get_thread_list ().clear ();
     get_call_stack ().clear ();
     get_local_vars_inspector ().re_init_widget ();
-    get_breakpoints_view ().clear ();
-    get_registers_view ().clear ();
+    // Views that haven't been shown yet have nothing to clear.
+    if (m_priv->breakpoints_view)
+        m_priv->breakpoints_view->clear ();
+    if (m_priv->registers_view)
+        m_priv->registers_view->clear ();
 #ifdef WITH_MEMORYVIEW
-    get_memory_view ().clear ();
+    if (m_priv->memory_view)
+        m_priv->memory_view->clear ();
 #endif // WITH_MEMORYVIEW
     get_expr_monitor_view ().re_init_widget (a_restarting);
+    if (m_priv->dprintf_log_view)
+        m_priv->dprintf_log_view->clear ();
 }
 
 void
@@ -4166,9 +4451,14 @@ DBGPerspective::session_manager_ptr ()
 {
     THROW_IF_FAIL (m_priv);
 
+    // Opening the session database loads the module of its
+    // connection driver, so this is only done the first time the
+    // sessions are needed rather than at start up.
     if (!m_priv->session_manager) {
         m_priv->session_manager = ISessMgr::create (plugin_path ());
         THROW_IF_FAIL (m_priv->session_manager);
+        m_priv->session_manager->load_sessions
+                        (m_priv->session_manager->default_transaction ());
     }
     return m_priv->session_manager.get ();
 }
@@ -4748,12 +5038,25 @@ DBGPerspective::get_thread_list ()
     THROW_IF_FAIL (m_priv);
     THROW_IF_FAIL (debugger ());
     if (!m_priv->thread_list) {
-        m_priv->thread_list.reset  (new ThreadList (debugger ()));
+        m_priv->thread_list.reset  (new ThreadList (debugger (),
+                                                    get_refresh_scheduler ()));
     }
     THROW_IF_FAIL (m_priv->thread_list);
     return *m_priv->thread_list;
 }
 
+RefreshScheduler&
+DBGPerspective::get_refresh_scheduler ()
+{
+    THROW_IF_FAIL (m_priv);
+    THROW_IF_FAIL (debugger ());
+    if (!m_priv->refresh_scheduler) {
+        m_priv->refresh_scheduler.reset (new RefreshScheduler (debugger ()));
+    }
+    THROW_IF_FAIL (m_priv->refresh_scheduler);
+    return *m_priv->refresh_scheduler;
+}
+
 list<UString>&
 DBGPerspective::get_global_search_paths ()
 {
@@ -5122,13 +5425,18 @@ DBGPerspective::add_views_to_layout ()
                                    REGISTERS_VIEW_TITLE,
                                    REGISTERS_VIEW_INDEX);
     #ifdef WITH_MEMORYVIEW
-    m_priv->layout ().append_view (get_memory_view ().widget (),
+    m_priv->layout ().append_view (get_memory_view_box (),
                                    MEMORY_VIEW_TITLE,
                                    MEMORY_VIEW_INDEX);
     #endif // WITH_MEMORYVIEW
     m_priv->layout ().append_view (get_expr_monitor_view ().widget (),
                                    EXPR_MONITOR_VIEW_TITLE,
                                    EXPR_MONITOR_VIEW_INDEX);
+    // Not built lazily, unlike the views above: the lines logged
+    // before it's first shown must not be lost.
+    m_priv->layout ().append_view (get_dprintf_log_view ().widget (),
+                                   DPRINTF_LOG_VIEW_TITLE,
+                                   DPRINTF_LOG_VIEW_INDEX);
     m_priv->layout ().do_init ();
 
 }
@@ -5193,6 +5501,15 @@ DBGPerspective::record_and_save_session (ISessMgr::Session &a_session)
             a_session.opened_files ().push_back (path_iter->first);
     }
 
+    map<UString, std::string>::const_iterator encoding_iter;
+    for (encoding_iter = m_priv->file_encodings.begin ();
+         encoding_iter != m_priv->file_encodings.end ();
+         ++encoding_iter) {
+        a_session.properties ()[FILE_ENCODING_PREFIX
+                                + encoding_iter->first] =
+            encoding_iter->second;
+    }
+
     // Record regular breakpoints and watchpoints in the session
     a_session.breakpoints ().clear ();
     a_session.watchpoints ().clear ();
@@ -5288,8 +5605,6 @@ DBGPerspective::do_init (IWorkbench *a_workbench)
     init_signals ();
     init_debugger_signals ();
     read_default_config ();
-    session_manager ().load_sessions
-                        (session_manager ().default_transaction ());
     workbench ().shutting_down_signal ().connect (sigc::mem_fun
             (*this, &DBGPerspective::on_shutdown_signal));
     m_priv->initialized = true;
@@ -5445,6 +5760,7 @@ DBGPerspective::open_file ()
     OpenFileDialog dialog (workbench ().get_root_window (),
                            plugin_path (),
                            debugger (),
+                           m_priv->source_file_index,
                            get_current_file_path ());
 
     //file_chooser.set_current_folder (m_priv->prog_cwd);
@@ -5889,6 +6205,20 @@ DBGPerspective::execute_session (ISessMgr::Session &a_session)
 
     m_priv->prog_cwd = a_session.properties ()[PROGRAM_CWD];
 
+    // Restore the encodings of the source files before opening them.
+    m_priv->file_encodings.clear ();
+    UString encoding_prefix = FILE_ENCODING_PREFIX;
+    for (map<UString, UString>::const_iterator it =
+             a_session.properties ().begin ();
+         it != a_session.properties ().end ();
+         ++it) {
+        if (it->first.raw ().compare (0, encoding_prefix.bytes (),
+                                      encoding_prefix.raw ()) == 0)
+            m_priv->file_encodings[it->first.substr
+                                        (encoding_prefix.size ())] =
+                it->second.raw ();
+    }
+
     IDebugger::Breakpoint breakpoint;
     vector<IDebugger::Breakpoint> breakpoints;
     for (list<ISessMgr::Breakpoint>::const_iterator it =
@@ -6217,6 +6547,7 @@ DBGPerspective::execute_program
         // If we are debugging a new program,
         // clear data gathered by the old session
         clear_session_data ();
+        m_priv->source_file_index.clear ();
     }
 
     LOG_DD ("load program");
@@ -6649,7 +6980,12 @@ DBGPerspective::load_core_file (const UString &a_prog_path,
     }
 
     debugger ()->load_core_file (a_prog_path, a_core_file_path);
+    // Show the stack of the thread that crashed first.  A core can
+    // have thousands of threads; they are only listed once the
+    // thread list is shown.  Likewise the global variables and the
+    // source files are only fetched when their dialogs are opened.
     get_call_stack ().update_stack (/*select_top_most=*/true);
+    get_thread_list ().invalidate ();
 }
 
 void
@@ -6962,9 +7298,12 @@ DBGPerspective::set_breakpoint (const IDebugger::Breakpoint &a_breakpoint)
         // address or a file name associated.
     } else if (a_breakpoint.type ()
                == IDebugger::Breakpoint::WATCHPOINT_TYPE) {
+        // The watchpoint got set once already, so the user accepted
+        // it even if it is a software one.
         debugger ()->set_watchpoint (a_breakpoint.expression (),
                                      a_breakpoint.is_write_watchpoint (),
-                                     a_breakpoint.is_read_watchpoint ());
+                                     a_breakpoint.is_read_watchpoint (),
+                                     "", /*a_allow_software=*/true);
     }
 }
 
@@ -7722,6 +8061,7 @@ void
 DBGPerspective::set_breakpoint_from_dialog (SetBreakpointDialog &a_dialog)
 {
     bool is_count_point = a_dialog.count_point ();
+    bool is_dprintf = a_dialog.dprintf ();
 
     switch (a_dialog.mode ()) {
         case SetBreakpointDialog::MODE_SOURCE_LOCATION:
@@ -7742,9 +8082,14 @@ DBGPerspective::set_breakpoint_from_dialog (SetBreakpointDialog &a_dialog)
                 int line = a_dialog.line_number ();
                 LOG_DD ("setting breakpoint in file "
                         << filename << " at line " << line);
-                set_breakpoint (filename, line,
-                                a_dialog.condition (),
-                                is_count_point);
+                if (is_dprintf)
+                    debugger ()->set_dprintf (SourceLoc (filename, line),
+                                              a_dialog.dprintf_format (),
+                                              a_dialog.condition ());
+                else
+                    set_breakpoint (filename, line,
+                                    a_dialog.condition (),
+                                    is_count_point);
                 break;
             }
 
@@ -7753,8 +8098,13 @@ DBGPerspective::set_breakpoint_from_dialog (SetBreakpointDialog &a_dialog)
                 UString function = a_dialog.function ();
                 THROW_IF_FAIL (function != "");
                 LOG_DD ("setting breakpoint at function: " << function);
-                set_breakpoint (function, a_dialog.condition (),
-                                is_count_point);
+                if (is_dprintf)
+                    debugger ()->set_dprintf (FunctionLoc (function),
+                                              a_dialog.dprintf_format (),
+                                              a_dialog.condition ());
+                else
+                    set_breakpoint (function, a_dialog.condition (),
+                                    is_count_point);
                 break;
             }
 
@@ -7764,7 +8114,12 @@ DBGPerspective::set_breakpoint_from_dialog (SetBreakpointDialog &a_dialog)
                 if (!address.empty ()) {
                     LOG_DD ("setting breakpoint at address: "
                             << address);
-                    set_breakpoint (address, is_count_point);
+                    if (is_dprintf)
+                        debugger ()->set_dprintf (AddressLoc (address),
+                                                  a_dialog.dprintf_format (),
+                                                  a_dialog.condition ());
+                    else
+                        set_breakpoint (address, is_count_point);
                 }
                 break;
             }
@@ -7896,7 +8251,8 @@ DBGPerspective::set_watchpoint_using_dialog ()
     WatchpointDialog::Mode mode = dialog.mode ();
     debugger ()->set_watchpoint (expression,
                                  mode & WatchpointDialog::WRITE_MODE,
-                                 mode & WatchpointDialog::READ_MODE);
+                                 mode & WatchpointDialog::READ_MODE,
+                                 "", dialog.allow_software ());
 }
 
 void
@@ -7961,12 +8317,7 @@ DBGPerspective::disassemble_and_do (IDebugger::DisassSlot &a_what_to_do,
 
     THROW_IF_FAIL (addr_range.min () != addr_range.max ());
 
-    debugger ()->disassemble (/*start_addr=*/addr_range.min (),
-                              /*start_addr_relative_to_pc=*/false,
-                              /*end_addr=*/addr_range.max (),
-                              /*end_addr_relative_to_pc=*/false,
-                              a_what_to_do,
-                              m_priv->asm_style_pure);
+    disassemble_range_and_do (addr_range, a_what_to_do);
 }
 
 void
@@ -7999,14 +8350,116 @@ DBGPerspective::disassemble_around_address_and_do
     addr_range.max (addr_range.max () + total_instrs_size);
     THROW_IF_FAIL (addr_range.min () != addr_range.max ());
 
-    debugger ()->disassemble (/*start_addr=*/addr_range.min (),
+    disassemble_range_and_do (addr_range, a_what_to_do);
+}
+
+/// Disassemble the instructions which addresses are in the range
+/// [min, max[ a_range, and invoke a slot with them.
+///
+/// If the range was disassembled before, the instructions are taken
+/// from the disassembly cache, without hitting the debugging engine.
+/// In any case, the slot is invoked asynchronously.
+///
+/// \param a_range the address range to disassemble.
+///
+/// \param a_what_to_do the slot to invoke with the instructions.
+void
+DBGPerspective::disassemble_range_and_do (const Range &a_range,
+                                          IDebugger::DisassSlot &a_what_to_do)
+{
+    LOG_FUNCTION_SCOPE_NORMAL_DD;
+
+    common::DisassembleInfo info;
+    std::list<common::Asm> instrs;
+    if (m_priv->disassembly_cache.lookup (a_range,
+                                          m_priv->asm_style_pure,
+                                          info, instrs)) {
+        LOG_DD ("asm in range [" << a_range.min () << ","
+                << a_range.max () << "[ found in cache");
+        Glib::signal_idle ().connect
+            (sigc::bind
+             (sigc::mem_fun (*this,
+                             &DBGPerspective::on_cached_asm_idle_signal),
+              info, instrs, a_what_to_do));
+        return;
+    }
+
+    IDebugger::DisassSlot slot =
+        sigc::bind (sigc::mem_fun
+                        (*this,
+                         &DBGPerspective::on_debugger_asm_to_cache_signal),
+                    a_range,
+                    m_priv->asm_style_pure,
+                    m_priv->disassembly_cache_generation,
+                    a_what_to_do);
+    debugger ()->disassemble (/*start_addr=*/a_range.min (),
                               /*start_addr_relative_to_pc=*/false,
-                              /*end_addr=*/addr_range.max (),
+                              /*end_addr=*/a_range.max (),
                               /*end_addr_relative_to_pc=*/false,
-                              a_what_to_do,
+                              slot,
                               m_priv->asm_style_pure);
 }
 
+/// If the instructions of a_instrs, that were disassembled from
+/// a_range, end in the middle of the function of the current frame,
+/// then schedule the disassembly of the instructions that come right
+/// after a_range, so that they are in the disassembly cache by the
+/// time the user steps into them.
+///
+/// The prefetch happens from an idle callback, so that it doesn't
+/// delay the requests issued by the UI when the inferior stops.
+void
+DBGPerspective::schedule_disassembly_prefetch
+                                (const Range &a_range,
+                                 const std::list<common::Asm> &a_instrs)
+{
+    LOG_FUNCTION_SCOPE_NORMAL_DD;
+
+    if (a_instrs.empty ()
+        || a_instrs.back ().empty ()
+        || m_priv->nb_disassembly_prefetches >= MAX_DISASSEMBLY_PREFETCHES)
+        return;
+
+    const string &function = a_instrs.back ().instr ().function ();
+    if (function.empty ()
+        || function != m_priv->current_frame.function_name ())
+        return;
+
+    // The next range must start on an instruction boundary, not at
+    // a_range.max (), which can be in the middle of an instruction.
+    // AsmInstr doesn't tell the length of an instruction, so start
+    // at the last instruction decoded: the next disassembly decodes
+    // it again, then carries on right after it.
+    const Asm &last = a_instrs.back ();
+    const AsmInstr &last_instr = last.which () == Asm::TYPE_MIXED
+        ? last.mixed_instr ().instrs ().back ()
+        : last.instr ();
+    size_t start = last_instr.address ();
+    // See DBGPerspective::disassemble_around_address_and_do for the
+    // magic 17.
+    Range next (start, start + m_priv->num_instr_to_disassemble * 17);
+    if (m_priv->disassembly_cache.contains (next, m_priv->asm_style_pure))
+        return;
+
+    ++m_priv->nb_disassembly_prefetches;
+    Glib::signal_idle ().connect
+        (sigc::bind
+         (sigc::mem_fun (*this,
+                         &DBGPerspective::on_disassembly_prefetch_idle_signal),
+          next, m_priv->disassembly_cache_generation),
+         Glib::PRIORITY_LOW);
+}
+
+/// Drop the instructions held in the disassembly cache, and make sure
+/// the requests in flight don't fill it again.
+void
+DBGPerspective::invalidate_disassembly_cache ()
+{
+    m_priv->disassembly_cache.clear ();
+    ++m_priv->disassembly_cache_generation;
+    m_priv->nb_disassembly_prefetches = 0;
+}
+
 
 void
 DBGPerspective::toggle_breakpoint_enabled ()
@@ -8254,7 +8707,8 @@ DBGPerspective::get_call_stack ()
     THROW_IF_FAIL (m_priv);
     if (!m_priv->call_stack) {
         m_priv->call_stack.reset (new CallStack (debugger (),
-                                                 workbench (), *this));
+                                                 workbench (), *this,
+                                                 get_refresh_scheduler ()));
         THROW_IF_FAIL (m_priv);
     }
     return *m_priv->call_stack;
@@ -8319,7 +8773,8 @@ DBGPerspective::get_local_vars_inspector ()
         m_priv->variables_editor.reset
             (new LocalVarsInspector (debugger (),
                                      *m_priv->workbench,
-                                     *this));
+                                     *this,
+                                     get_refresh_scheduler ()));
     }
     THROW_IF_FAIL (m_priv->variables_editor);
     return *m_priv->variables_editor;
@@ -8413,7 +8868,14 @@ DBGPerspective::get_breakpoints_view ()
     THROW_IF_FAIL (m_priv);
     if (!m_priv->breakpoints_view) {
         m_priv->breakpoints_view.reset (new BreakpointsView (
-                    workbench (), *this, debugger ()));
+                    workbench (), *this, debugger (),
+                    get_refresh_scheduler ()));
+        m_priv->breakpoints_view->go_to_breakpoint_signal ().connect
+            (sigc::mem_fun
+                (*this, &DBGPerspective::on_breakpoint_go_to_source_action));
+        // The view may be built long after the breakpoints were set.
+        m_priv->breakpoints_view->set_breakpoints
+                                (debugger ()->get_cached_breakpoints ());
     }
     THROW_IF_FAIL (m_priv->breakpoints_view);
     return *m_priv->breakpoints_view;
@@ -8438,19 +8900,39 @@ DBGPerspective::get_registers_view ()
 {
     THROW_IF_FAIL (m_priv);
     if (!m_priv->registers_view) {
-        m_priv->registers_view.reset (new RegistersView (debugger ()));
+        m_priv->registers_view.reset (new RegistersView
+                                        (debugger (),
+                                         get_refresh_scheduler ()));
     }
     THROW_IF_FAIL (m_priv->registers_view);
     return *m_priv->registers_view;
 }
 
 #ifdef WITH_MEMORYVIEW
+/// Return the box containing the memory view, once it is built.
+Gtk::Box&
+DBGPerspective::get_memory_view_box ()
+{
+    THROW_IF_FAIL (m_priv);
+    if (!m_priv->memory_view_box) {
+        m_priv->memory_view_box.reset (new Gtk::VBox);
+        THROW_IF_FAIL (m_priv->memory_view_box);
+    }
+    return *m_priv->memory_view_box;
+}
+
 MemoryView&
 DBGPerspective::get_memory_view ()
 {
     THROW_IF_FAIL (m_priv);
     if (!m_priv->memory_view) {
-        m_priv->memory_view.reset (new MemoryView (debugger ()));
+        m_priv->memory_view.reset (new MemoryView (debugger (),
+                                                   get_refresh_scheduler ()));
+        if (!m_priv->get_source_font_name ().empty ()) {
+            Pango::FontDescription font_desc
+                                    (m_priv->get_source_font_name ());
+            m_priv->memory_view->modify_font (font_desc);
+        }
     }
     THROW_IF_FAIL (m_priv->memory_view);
     return *m_priv->memory_view;
@@ -8465,11 +8947,30 @@ DBGPerspective::get_expr_monitor_view ()
 
     if (!m_priv->expr_monitor)
         m_priv->expr_monitor.reset (new ExprMonitor (*debugger (),
-                                                     *this));
+                                                     *this,
+                                                     get_refresh_scheduler ()));
     THROW_IF_FAIL (m_priv->expr_monitor);
     return *m_priv->expr_monitor;
 }
 
+/// Return the view of the output of the dprintf.
+DprintfLogView&
+DBGPerspective::get_dprintf_log_view ()
+{
+    THROW_IF_FAIL (m_priv);
+
+    if (!m_priv->dprintf_log_view) {
+        m_priv->dprintf_log_view.reset (new DprintfLogView (debugger ()));
+        if (!m_priv->get_source_font_name ().empty ()) {
+            Pango::FontDescription font_desc
+                                    (m_priv->get_source_font_name ());
+            m_priv->dprintf_log_view->modify_font (font_desc);
+        }
+    }
+    THROW_IF_FAIL (m_priv->dprintf_log_view);
+    return *m_priv->dprintf_log_view;
+}
+
 struct ScrollTextViewToEndClosure {
     Gtk::TextView* text_view;
 
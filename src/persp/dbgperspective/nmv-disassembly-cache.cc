@@ -0,0 +1,207 @@
+/*
+ *This file is part of the Nemiver project
+ *
+ *Nemiver is free software; you can redistribute
+ *it and/or modify it under the terms of
+ *the GNU General Public License as published by the
+ *Free Software Foundation; either version 2,
+ *or (at your option) any later version.
+ *
+ *Nemiver is distributed in the hope that it will
+ *be useful, but WITHOUT ANY WARRANTY;
+ *without even the implied warranty of
+ *MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ *See the GNU General Public License for more details.
+ *
+ *You should have received a copy of the
+ *GNU General Public License along with Nemiver;
+ *see the file COPYING.
+ *If not, write to the Free Software Foundation,
+ *Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+ *
+ *See COPYRIGHT file copyright information.
+ */
+#include "config.h"
+#include <algorithm>
+#include <map>
+#include "nmv-disassembly-cache.h"
+
+using namespace nemiver::common;
+
+NEMIVER_BEGIN_NAMESPACE (nemiver)
+
+/// An entry of the cache, i.e. the instructions of a contiguous
+/// range of disassembled addresses, indexed by address.
+struct DisassemblyCacheEntry {
+    Range range;
+    DisassembleInfo info;
+    std::map<size_t, Asm> instrs;
+};//end struct DisassemblyCacheEntry
+
+/// The entries, indexed by the start of their address range.  The
+/// ranges of the entries never overlap nor touch each other.
+typedef std::map<size_t, DisassemblyCacheEntry> DisassemblyCacheEntries;
+
+struct DisassemblyCache::Priv {
+    DisassemblyCacheEntries pure_entries;
+    DisassemblyCacheEntries mixed_entries;
+
+    DisassemblyCacheEntries& entries (bool a_pure_asm)
+    {
+        return a_pure_asm ? pure_entries : mixed_entries;
+    }
+
+    const DisassemblyCacheEntries& entries (bool a_pure_asm) const
+    {
+        return a_pure_asm ? pure_entries : mixed_entries;
+    }
+
+    /// \return the entry which range contains a_range, or 0.
+    const DisassemblyCacheEntry* find_entry (const Range &a_range,
+                                             bool a_pure_asm) const
+    {
+        const DisassemblyCacheEntries &e = entries (a_pure_asm);
+        DisassemblyCacheEntries::const_iterator it =
+            e.upper_bound (a_range.min ());
+        if (it == e.begin ())
+            return 0;
+        --it;
+        if (it->second.range.min () <= a_range.min ()
+            && it->second.range.max () >= a_range.max ())
+            return &it->second;
+        return 0;
+    }
+
+    static void add_instrs (const std::list<Asm> &a_instrs,
+                            std::map<size_t, Asm> &a_to)
+    {
+        std::list<Asm>::const_iterator it;
+        for (it = a_instrs.begin (); it != a_instrs.end (); ++it) {
+            if (it->empty ())
+                continue;
+            size_t addr = it->instr ().address ();
+            // Newer instructions win over the ones already cached.
+            a_to.erase (addr);
+            a_to.insert (std::make_pair (addr, *it));
+        }
+    }
+};//end struct DisassemblyCache::Priv
+
+DisassemblyCache::DisassemblyCache () :
+    m_priv (new Priv)
+{
+}
+
+DisassemblyCache::~DisassemblyCache ()
+{
+}
+
+/// Look up the instructions of an address range.
+///
+/// \param a_range the range [min, max[ of addresses to look up.
+///
+/// \param a_pure_asm whether to look up pure asm instructions, or
+/// mixed source/asm instructions.
+///
+/// \param a_info output parameter.  Set to the information about the
+/// instructions found.
+///
+/// \param a_instrs output parameter.  Set to the instructions which
+/// address is in a_range, in address order.
+///
+/// \return true if a_range is entirely cached, false otherwise.
+bool
+DisassemblyCache::lookup (const Range &a_range,
+                          bool a_pure_asm,
+                          DisassembleInfo &a_info,
+                          std::list<Asm> &a_instrs) const
+{
+    const DisassemblyCacheEntry *entry =
+        m_priv->find_entry (a_range, a_pure_asm);
+    if (!entry)
+        return false;
+
+    std::map<size_t, Asm>::const_iterator from, to;
+    from = entry->instrs.lower_bound (a_range.min ());
+    to = entry->instrs.lower_bound (a_range.max ());
+    std::list<Asm> instrs;
+    for (; from != to; ++from)
+        instrs.push_back (from->second);
+
+    DisassembleInfo info;
+    info.function_name (entry->info.function_name ());
+    info.file_name (entry->info.file_name ());
+    if (!instrs.empty ()) {
+        info.start_address
+                    (instrs.front ().instr ().address ().to_string ());
+        info.end_address (instrs.back ().instr ().address ().to_string ());
+    }
+    a_info = info;
+    a_instrs.swap (instrs);
+    return true;
+}
+
+/// Add the instructions of a disassembled address range to the
+/// cache, merging them with the cached ranges they overlap or touch.
+///
+/// \param a_range the range [min, max[ of addresses that was
+/// disassembled.
+///
+/// \param a_pure_asm whether a_instrs are pure asm instructions or
+/// mixed source/asm instructions.
+///
+/// \param a_info the information about a_instrs, as returned by the
+/// debugging engine.
+///
+/// \param a_instrs the instructions disassembled in a_range.
+void
+DisassemblyCache::add (const Range &a_range,
+                       bool a_pure_asm,
+                       const DisassembleInfo &a_info,
+                       const std::list<Asm> &a_instrs)
+{
+    if (a_range.min () >= a_range.max ())
+        return;
+
+    DisassemblyCacheEntries &entries = m_priv->entries (a_pure_asm);
+    DisassemblyCacheEntry merged;
+    merged.range = a_range;
+    merged.info = a_info;
+
+    // As the cached ranges are disjoint, the ranges that overlap or
+    // touch a_range are the ones right before its end.
+    DisassemblyCacheEntries::iterator it =
+        entries.upper_bound (a_range.max ());
+    while (it != entries.begin ()) {
+        --it;
+        if (it->second.range.max () < a_range.min ())
+            break;
+        merged.range.min (std::min (merged.range.min (),
+                                    it->second.range.min ()));
+        merged.range.max (std::max (merged.range.max (),
+                                    it->second.range.max ()));
+        merged.instrs.insert (it->second.instrs.begin (),
+                              it->second.instrs.end ());
+        entries.erase (it++);
+    }
+    Priv::add_instrs (a_instrs, merged.instrs);
+    entries.insert (std::make_pair (merged.range.min (), merged));
+}
+
+/// \return true if the address range [min, max[ a_range is
+/// entirely cached.
+bool
+DisassemblyCache::contains (const Range &a_range, bool a_pure_asm) const
+{
+    return m_priv->find_entry (a_range, a_pure_asm) != 0;
+}
+
+/// Drop all the cached instructions.
+void
+DisassemblyCache::clear ()
+{
+    m_priv->pure_entries.clear ();
+    m_priv->mixed_entries.clear ();
+}
+
+NEMIVER_END_NAMESPACE (nemiver)
@@ -0,0 +1,77 @@
+/*
+ *This file is part of the Nemiver project
+ *
+ *Nemiver is free software; you can redistribute
+ *it and/or modify it under the terms of
+ *the GNU General Public License as published by the
+ *Free Software Foundation; either version 2,
+ *or (at your option) any later version.
+ *
+ *Nemiver is distributed in the hope that it will
+ *be useful, but WITHOUT ANY WARRANTY;
+ *without even the implied warranty of
+ *MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ *See the GNU General Public License for more details.
+ *
+ *You should have received a copy of the
+ *GNU General Public License along with Nemiver;
+ *see the file COPYING.
+ *If not, write to the Free Software Foundation,
+ *Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+ *
+ *See COPYRIGHT file copyright information.
+ */
+#ifndef __NMV_DISASSEMBLY_CACHE_H__
+#define __NMV_DISASSEMBLY_CACHE_H__
+
+#include <list>
+#include "common/nmv-asm-instr.h"
+#include "common/nmv-range.h"
+#include "common/nmv-safe-ptr-utils.h"
+
+NEMIVER_BEGIN_NAMESPACE (nemiver)
+
+using nemiver::common::SafePtr;
+
+/// A cache of the instructions disassembled in the inferior.
+///
+/// Each cached entry holds the instructions of an address range
+/// [min, max[ that was disassembled.  Overlapping or adjacent ranges
+/// are merged together as they are added, so stepping around code
+/// that was already disassembled never needs to hit the debugging
+/// engine again.  Pure asm and mixed source/asm instructions are
+/// kept apart, as they are not interchangeable.
+///
+/// The cache must be cleared whenever the code mapped in the
+/// inferior changes, e.g. when shared libraries are loaded or
+/// unloaded or when the inferior is re-run.
+class DisassemblyCache {
+    // non copyable
+    DisassemblyCache (const DisassemblyCache &);
+    DisassemblyCache& operator= (const DisassemblyCache &);
+
+    struct Priv;
+    SafePtr<Priv> m_priv;
+
+public:
+    DisassemblyCache ();
+    ~DisassemblyCache ();
+
+    bool lookup (const common::Range &a_range,
+                 bool a_pure_asm,
+                 common::DisassembleInfo &a_info,
+                 std::list<common::Asm> &a_instrs) const;
+
+    void add (const common::Range &a_range,
+              bool a_pure_asm,
+              const common::DisassembleInfo &a_info,
+              const std::list<common::Asm> &a_instrs);
+
+    bool contains (const common::Range &a_range, bool a_pure_asm) const;
+
+    void clear ();
+};//end class DisassemblyCache
+
+NEMIVER_END_NAMESPACE (nemiver)
+
+#endif // __NMV_DISASSEMBLY_CACHE_H__
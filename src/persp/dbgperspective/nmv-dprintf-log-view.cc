@@ -0,0 +1,275 @@
+/*
+ *This file is part of the Nemiver project
+ *
+ *Nemiver is free software; you can redistribute
+ *it and/or modify it under the terms of
+ *the GNU General Public License as published by the
+ *Free Software Foundation; either version 2,
+ *or (at your option) any later version.
+ *
+ *Nemiver is distributed in the hope that it will
+ *be useful, but WITHOUT ANY WARRANTY;
+ *without even the implied warranty of
+ *MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ *See the GNU General Public License for more details.
+ *
+ *You should have received a copy of the
+ *GNU General Public License along with Nemiver;
+ *see the file COPYING.
+ *If not, write to the Free Software Foundation,
+ *Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+ *
+ *See COPYRIGHT file copyright information.
+ */
+#include "config.h"
+#include <deque>
+#include <glib/gi18n.h>
+#include <gtkmm/box.h>
+#include <gtkmm/label.h>
+#include <gtkmm/liststore.h>
+#include <gtkmm/scrolledwindow.h>
+#include <gtkmm/treeview.h>
+#include "common/nmv-exception.h"
+#include "nmv-dprintf-log-view.h"
+
+NEMIVER_BEGIN_NAMESPACE (nemiver)
+
+// The number of lines the view keeps.  Past that, the oldest lines
+// are dropped.
+static const unsigned long MAX_NB_LINES = 100000;
+
+// Lines longer than this many bytes are truncated.
+static const std::string::size_type MAX_LINE_LENGTH = 1024;
+
+// How often, in milliseconds, the lines received get appended to the
+// view.
+static const unsigned FLUSH_INTERVAL_MS = 100;
+
+struct DprintfLogColumns : public Gtk::TreeModelColumnRecord {
+    Gtk::TreeModelColumn<Glib::ustring> line;
+
+    DprintfLogColumns ()
+    {
+        add (line);
+    }
+};//end DprintfLogColumns
+
+static DprintfLogColumns&
+get_columns ()
+{
+    static DprintfLogColumns s_cols;
+    return s_cols;
+}
+
+struct DprintfLogView::Priv {
+    IDebuggerSafePtr &debugger;
+    SafePtr<Gtk::VBox> box;
+    SafePtr<Gtk::ScrolledWindow> scrolled_win;
+    SafePtr<Gtk::TreeView> tree_view;
+    SafePtr<Gtk::Label> dropped_label;
+    Glib::RefPtr<Gtk::ListStore> list_store;
+    // The lines received since the last flush.
+    std::deque<std::string> pending_lines;
+    // What came after the last new line received.
+    std::string partial_line;
+    // The number of rows of list_store.
+    unsigned long nb_lines;
+    // The number of lines dropped to stay under MAX_NB_LINES.
+    unsigned long nb_dropped;
+    sigc::connection flush_connection;
+
+    Priv (IDebuggerSafePtr &a_debugger) :
+        debugger (a_debugger),
+        nb_lines (0),
+        nb_dropped (0)
+    {
+        build_widget ();
+        debugger->dprintf_output_signal ().connect
+            (sigc::mem_fun (*this, &Priv::on_dprintf_output_signal));
+    }
+
+    ~Priv ()
+    {
+        flush_connection.disconnect ();
+    }
+
+    void
+    build_widget ()
+    {
+        list_store = Gtk::ListStore::create (get_columns ());
+        tree_view.reset (new Gtk::TreeView (list_store));
+        tree_view->set_headers_visible (false);
+        tree_view->append_column ("", get_columns ().line);
+        Gtk::TreeViewColumn *column = tree_view->get_column (0);
+        THROW_IF_FAIL (column);
+        column->set_sizing (Gtk::TREE_VIEW_COLUMN_FIXED);
+        column->set_expand (true);
+        // All the rows have the same height, so the view doesn't
+        // have to measure each of them; it then only looks at the
+        // rows it shows.
+        tree_view->set_fixed_height_mode (true);
+
+        scrolled_win.reset (new Gtk::ScrolledWindow);
+        scrolled_win->set_policy (Gtk::POLICY_AUTOMATIC,
+                                  Gtk::POLICY_AUTOMATIC);
+        scrolled_win->set_shadow_type (Gtk::SHADOW_IN);
+        scrolled_win->add (*tree_view);
+
+        dropped_label.reset (new Gtk::Label);
+        dropped_label->set_alignment (0, 0.5);
+        dropped_label->set_no_show_all ();
+
+        box.reset (new Gtk::VBox);
+        box->pack_start (*scrolled_win);
+        box->pack_start (*dropped_label, Gtk::PACK_SHRINK);
+    }
+
+    void
+    push_line (const std::string &a_line)
+    {
+        if (a_line.size () <= MAX_LINE_LENGTH) {
+            pending_lines.push_back (a_line);
+        } else {
+            // Don't cut a UTF-8 character in the middle.
+            std::string::size_type len = MAX_LINE_LENGTH;
+            while (len && (a_line[len] & 0xC0) == 0x80)
+                --len;
+            pending_lines.push_back (a_line.substr (0, len) + "...");
+        }
+        if (pending_lines.size () > MAX_NB_LINES) {
+            pending_lines.pop_front ();
+            ++nb_dropped;
+        }
+    }
+
+    void
+    update_dropped_label ()
+    {
+        if (!nb_dropped) {
+            dropped_label->hide ();
+            return;
+        }
+        dropped_label->set_text
+            (Glib::ustring::compose (_("%1 older lines were dropped"),
+                                     nb_dropped));
+        dropped_label->show ();
+    }
+
+    /// Append the pending lines to the view, dropping the oldest
+    /// rows to make room for them.
+    bool
+    flush ()
+    {
+        NEMIVER_TRY
+
+        if (pending_lines.empty ())
+            return false;
+
+        Glib::RefPtr<Gtk::Adjustment> adj = scrolled_win->get_vadjustment ();
+        bool follow = !adj
+            || adj->get_value () + adj->get_page_size ()
+               >= adj->get_upper () - 1;
+
+        unsigned long nb_to_drop = 0;
+        if (nb_lines + pending_lines.size () > MAX_NB_LINES)
+            nb_to_drop = nb_lines + pending_lines.size () - MAX_NB_LINES;
+        if (nb_to_drop >= nb_lines) {
+            nb_to_drop = nb_lines;
+            list_store->clear ();
+        } else {
+            for (unsigned long i = 0; i < nb_to_drop; ++i)
+                list_store->erase (list_store->children ().begin ());
+        }
+        nb_lines -= nb_to_drop;
+        nb_dropped += nb_to_drop;
+
+        Gtk::TreeModel::iterator it;
+        for (std::deque<std::string>::const_iterator line =
+                 pending_lines.begin ();
+             line != pending_lines.end ();
+             ++line) {
+            it = list_store->append ();
+            (*it)[get_columns ().line] = *line;
+        }
+        nb_lines += pending_lines.size ();
+        pending_lines.clear ();
+
+        if (follow && it)
+            tree_view->scroll_to_row (list_store->get_path (it));
+        update_dropped_label ();
+
+        NEMIVER_CATCH
+
+        return false;
+    }
+
+    void
+    clear ()
+    {
+        flush_connection.disconnect ();
+        pending_lines.clear ();
+        partial_line.clear ();
+        list_store->clear ();
+        nb_lines = 0;
+        nb_dropped = 0;
+        update_dropped_label ();
+    }
+
+    void
+    on_dprintf_output_signal (const UString &a_output)
+    {
+        NEMIVER_TRY
+
+        const std::string &output = a_output.raw ();
+        std::string::size_type from = 0, to;
+        while ((to = output.find ('\n', from)) != std::string::npos) {
+            partial_line.append (output, from, to - from);
+            push_line (partial_line);
+            partial_line.clear ();
+            from = to + 1;
+        }
+        partial_line.append (output, from, std::string::npos);
+        if (partial_line.size () > MAX_LINE_LENGTH) {
+            push_line (partial_line);
+            partial_line.clear ();
+        }
+
+        if (!pending_lines.empty () && !flush_connection.connected ())
+            flush_connection = Glib::signal_timeout ().connect
+                (sigc::mem_fun (*this, &Priv::flush), FLUSH_INTERVAL_MS);
+
+        NEMIVER_CATCH
+    }
+};//end struct DprintfLogView::Priv
+
+DprintfLogView::DprintfLogView (IDebuggerSafePtr &a_debugger)
+{
+    m_priv.reset (new Priv (a_debugger));
+}
+
+DprintfLogView::~DprintfLogView ()
+{
+}
+
+Gtk::Widget&
+DprintfLogView::widget () const
+{
+    THROW_IF_FAIL (m_priv && m_priv->box);
+    return *m_priv->box;
+}
+
+void
+DprintfLogView::modify_font (const Pango::FontDescription &a_font_desc)
+{
+    THROW_IF_FAIL (m_priv && m_priv->tree_view);
+    m_priv->tree_view->override_font (a_font_desc);
+}
+
+void
+DprintfLogView::clear ()
+{
+    THROW_IF_FAIL (m_priv);
+    m_priv->clear ();
+}
+
+NEMIVER_END_NAMESPACE (nemiver)
@@ -0,0 +1,63 @@
+/*
+ *This file is part of the Nemiver project
+ *
+ *Nemiver is free software; you can redistribute
+ *it and/or modify it under the terms of
+ *the GNU General Public License as published by the
+ *Free Software Foundation; either version 2,
+ *or (at your option) any later version.
+ *
+ *Nemiver is distributed in the hope that it will
+ *be useful, but WITHOUT ANY WARRANTY;
+ *without even the implied warranty of
+ *MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ *See the GNU General Public License for more details.
+ *
+ *You should have received a copy of the
+ *GNU General Public License along with Nemiver;
+ *see the file COPYING.
+ *If not, write to the Free Software Foundation,
+ *Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+ *
+ *See COPYRIGHT file copyright information.
+ */
+#ifndef __NMV_DPRINTF_LOG_VIEW_H__
+#define __NMV_DPRINTF_LOG_VIEW_H__
+
+#include <gtkmm/widget.h>
+#include <pangomm/fontdescription.h>
+#include "common/nmv-object.h"
+#include "common/nmv-safe-ptr-utils.h"
+#include "nmv-i-debugger.h"
+
+NEMIVER_BEGIN_NAMESPACE (nemiver)
+
+/// Shows the lines logged by the dprintf set in the inferior, as
+/// emitted by IDebugger::dprintf_output_signal.
+///
+/// The lines received are appended to the view a few times per
+/// second rather than one by one, and only the most recent ones are
+/// kept, so that a dprintf in a hot loop can't make the memory
+/// consumption or the main loop latency grow without bounds.  Only
+/// the rows that are scrolled into view are ever rendered.
+class NEMIVER_API DprintfLogView : public nemiver::common::Object {
+    //non copyable
+    DprintfLogView (const DprintfLogView&);
+    DprintfLogView& operator= (const DprintfLogView&);
+
+    struct Priv;
+    SafePtr<Priv> m_priv;
+
+public:
+
+    DprintfLogView (IDebuggerSafePtr &a_debugger);
+    virtual ~DprintfLogView ();
+    Gtk::Widget& widget () const;
+    void modify_font (const Pango::FontDescription &a_font_desc);
+    void clear ();
+
+};//end DprintfLogView
+
+NEMIVER_END_NAMESPACE (nemiver)
+
+#endif //__NMV_DPRINTF_LOG_VIEW_H__
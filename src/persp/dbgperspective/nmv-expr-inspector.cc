@@ -125,6 +125,7 @@ class ExprInspector::Priv : public sigc::trackable {
         LOG_FUNCTION_SCOPE_NORMAL_DD;
         THROW_IF_FAIL (tree_store);
         tree_store->clear ();
+        tree_view->clear_variable_rows_index ();
     }
 
     void init_actions ()
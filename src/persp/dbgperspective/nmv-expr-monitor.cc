@@ -32,6 +32,7 @@
 #include "nmv-debugger-utils.h"
 #include "nmv-i-workbench.h"
 #include "nmv-expr-inspector-dialog.h"
+#include "nmv-refresh-scheduler.h"
 
 using namespace nemiver::common;
 namespace vutils = nemiver::variables_utils2;
@@ -46,6 +47,7 @@ struct ExprMonitor::Priv
     Glib::RefPtr<Gtk::UIManager> ui_manager;
     IDebugger &debugger;
     IPerspective &perspective;
+    RefreshScheduler &refresh_scheduler;
     SafePtr<VarsTreeView> tree_view;
     Glib::RefPtr<Gtk::TreeStore> tree_store;
     SafePtr<Gtk::TreeRowReference> in_scope_exprs_row_ref;
@@ -59,6 +61,10 @@ struct ExprMonitor::Priv
     IDebugger::VariableList killed_expressions;
     map<IDebugger::VariableSafePtr, bool> in_scope_exprs;
     map<IDebugger::VariableSafePtr, bool> revived_exprs;
+    // For each out of scope expression we tried to re-create, the
+    // function the inferior was stopped in at the time.  Trying again
+    // while the inferior is still in that function would fail again.
+    map<IDebugger::VariableSafePtr, UString> creation_scopes;
     vector<Gtk::TreeModel::Path> selected_paths;
     Glib::RefPtr<Gtk::ActionGroup> action_group;
     Gtk::Widget *contextual_menu;
@@ -70,9 +76,11 @@ struct ExprMonitor::Priv
     bool is_up2date;
 
     Priv (IDebugger &a_debugger,
-          IPerspective &a_perspective)
+          IPerspective &a_perspective,
+          RefreshScheduler &a_refresh_scheduler)
         : debugger (a_debugger),
           perspective (a_perspective),
+          refresh_scheduler (a_refresh_scheduler),
           contextual_menu (0),
           saved_reason (IDebugger::UNDEFINED_REASON),
           saved_has_frame (false),
@@ -161,6 +169,7 @@ struct ExprMonitor::Priv
         clear_in_scope_exprs_rows ();
         clear_out_of_scope_exprs_rows ();
         revived_exprs.clear ();
+        creation_scopes.clear ();
     }
 
     /// Clear the rows under the "in scope variables" node.
@@ -191,7 +200,7 @@ struct ExprMonitor::Priv
     {
         LOG_FUNCTION_SCOPE_NORMAL_DD;
 
-        debugger.stopped_signal ().connect
+        refresh_scheduler.stopped_signal ().connect
             (sigc::mem_fun (*this, &Priv::on_stopped_signal));
         debugger.inferior_re_run_signal ()
             .connect (sigc::mem_fun
@@ -464,6 +473,7 @@ struct ExprMonitor::Priv
                 break;
             }
         }
+        creation_scopes.erase (a_expr);
 
         if (found) {
             LOG_DD ("variable found and erased");
@@ -502,6 +512,31 @@ struct ExprMonitor::Priv
             (*i)->in_scope (false);
             killed_expressions.push_back (*i);
         }
+        // The inferior is going to start again, so everything is
+        // worth trying again, whatever the function.
+        creation_scopes.clear ();
+    }
+
+    /// Return true iff it is worth trying to create a variable object
+    /// for the out of scope expression a_expr at the current stop,
+    /// i.e, if we did not try already since the inferior entered the
+    /// function it is stopped in.  If so, remember that we are trying
+    /// in that function.
+    ///
+    /// \param a_expr the out of scope expression to consider.
+    bool
+    should_try_creating_expr (const IDebugger::VariableSafePtr a_expr)
+    {
+        map<IDebugger::VariableSafePtr, UString>::iterator it =
+            creation_scopes.find (a_expr);
+        if (it != creation_scopes.end ()
+            && it->second == saved_frame.function_name ()) {
+            LOG_DD ("not re-creating " << a_expr->id ()
+                    << " in " << saved_frame.function_name ());
+            return false;
+        }
+        creation_scopes[a_expr] = saved_frame.function_name ();
+        return true;
     }
 
     /// Re-monitor a killed expression.
@@ -520,7 +555,7 @@ struct ExprMonitor::Priv
         Gtk::TreeModel::iterator var_it, parent_it;
         update_expr_in_scope_or_not (a_expr, var_it, parent_it);
 
-        if (!a_expr->in_scope ())
+        if (!a_expr->in_scope () && should_try_creating_expr (a_expr))
             add_expression
                 (a_expr->name (),
                  sigc::bind (sigc::mem_fun
@@ -559,16 +594,15 @@ struct ExprMonitor::Priv
                  revived_exprs.begin ();
              i != revived_exprs.end ();
              ++i) {
-            if (!i->first->in_scope ())
+            if (i->first->in_scope ())
+                to_delete.push_back (i->first);
+            else if (should_try_creating_expr (i->first))
                 debugger.create_variable
                     (i->first->name (),
                      sigc::bind
                      (sigc::mem_fun
                       (*this, &Priv::on_tentatively_create_revived_expr),
                       i->first));
-            else
-                to_delete.push_back (i->first);
-                
         }
 
         for (IDebugger::VariableList::iterator i = to_delete.begin ();
@@ -774,18 +808,11 @@ struct ExprMonitor::Priv
         // highlighted during previous step.
         update_exprs_changed_at_prev_step ();
 
-        // Walk the monitored expressions and list those that have
-        // changed.
-        IDebugger::VariableList::const_iterator it;
-        for (it = monitored_expressions.begin ();
-             it != monitored_expressions.end ();
-             ++it) {
-            debugger.list_changed_variables (*it,
-                                             sigc::bind
-                                             (sigc::mem_fun
-                                              (*this, &Priv::on_vars_changed),
-                                              *it));
-        }
+        // List the monitored expressions that have changed, all in
+        // one go.
+        debugger.list_changed_variables
+            (monitored_expressions,
+             sigc::mem_fun (*this, &Priv::on_vars_changed));
 
         // Walk the killed expressions and try to re-monitor them.
         // killed expressions are those that went out of scope because
@@ -1236,9 +1263,10 @@ struct ExprMonitor::Priv
 }; // end struct ExprMonitor
 
 ExprMonitor::ExprMonitor (IDebugger &a_dbg,
-                          IPerspective &a_perspective)
+                          IPerspective &a_perspective,
+                          RefreshScheduler &a_refresh_scheduler)
 {
-    m_priv.reset (new Priv (a_dbg, a_perspective));
+    m_priv.reset (new Priv (a_dbg, a_perspective, a_refresh_scheduler));
 }
 
 ExprMonitor::~ExprMonitor ()
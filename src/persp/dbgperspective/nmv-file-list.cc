@@ -28,23 +28,32 @@
 #include <gtkmm/treeview.h>
 #include <gtkmm/treestore.h>
 #include <gtkmm/scrolledwindow.h>
+#include <gtkmm/entry.h>
 #include "common/nmv-exception.h"
 #include "nmv-file-list.h"
+#include "nmv-source-file-index.h"
 #include "nmv-ui-utils.h"
 #include "nmv-i-debugger.h"
 
 namespace nemiver {
 
+static const char *FILE_LIST_COOKIE = "file-list";
+
+/// The maximum number of files shown when the list is filtered.
+static const unsigned MAX_FILTER_MATCHES = 500;
+
 struct FileListColumns : public Gtk::TreeModel::ColumnRecord {
     Gtk::TreeModelColumn<Glib::ustring> display_name;
     Gtk::TreeModelColumn<Glib::ustring> path;
     Gtk::TreeModelColumn<Gtk::StockID> stock_icon;
+    Gtk::TreeModelColumn<bool> is_dir;
 
     FileListColumns ()
     {
         add (display_name);
         add (path);
         add (stock_icon);
+        add (is_dir);
     }
 };
 
@@ -53,7 +62,9 @@ public:
     FileListView ();
     virtual ~FileListView ();
 
-    void set_files (const std::vector<UString> &a_files);
+    void set_index (const SourceFileIndex &a_index);
+    void show_tree ();
+    void show_matches (const vector<string> &a_paths);
     void get_selected_filenames (vector<string> &a_filenames) const;
     void expand_to_filename (const UString &a_filename);
 
@@ -62,22 +73,15 @@ public:
     sigc::signal<void> files_selected_signal;
 
 protected:
-    typedef std::pair<UString, Gtk::TreeModel::iterator> StringTreeIterPair;
-    struct ComparePathMap :
-        public std::binary_function<const StringTreeIterPair,
-                                    const UString, bool> {
-        bool
-        operator() (const StringTreeIterPair &a_map,
-                    const UString &a_path_component)
-        {
-            return a_path_component == a_map.first;
-        }
-    };//end struct ComparePathMap
-
-    Gtk::TreeModel::iterator find_filename_recursive
-                                (const Gtk::TreeModel::iterator &a_iter,
-                                 const UString &a_filename);
-
+    void append_entry (const Gtk::TreeModel::Children &a_parent,
+                       const SourceFileIndex::Entry &a_entry);
+    void populate_children (const Gtk::TreeModel::iterator &a_iter);
+    Gtk::TreeModel::iterator find_child
+                                (const Gtk::TreeModel::iterator &a_parent,
+                                 const UString &a_path);
+
+    virtual bool on_test_expand_row (const Gtk::TreeModel::iterator &a_iter,
+                                     const Gtk::TreeModel::Path &a_path);
     virtual void on_row_activated (const Gtk::TreeModel::Path& path,
                                    Gtk::TreeViewColumn* column);
     virtual void on_file_list_selection_changed ();
@@ -91,15 +95,27 @@ protected:
 
     FileListColumns m_columns;
 
+    const SourceFileIndex *m_index;
+
+    // The directory tree of the files.  The children of a directory
+    // row are only added when the row is expanded; until then, the
+    // row has a single placeholder child which path is empty.
     Glib::RefPtr<Gtk::TreeStore> m_tree_model;
 
+    // The flat list of files matching the filter, if any.
+    Glib::RefPtr<Gtk::TreeStore> m_match_model;
+    bool m_showing_matches;
+
     Gtk::Menu m_menu_popup;
 }; // end class FileListView
 
-FileListView::FileListView ()
+FileListView::FileListView () :
+    m_index (0),
+    m_showing_matches (false)
 {
-    // create the tree model:
+    // create the tree models:
     m_tree_model = Gtk::TreeStore::create (m_columns);
+    m_match_model = Gtk::TreeStore::create (m_columns);
     set_model (m_tree_model);
 
     set_headers_visible (false);
@@ -154,91 +170,137 @@ FileListView::~FileListView ()
 {
 }
 
+/// Show the files of an index.  Only the root directory is added
+/// to the tree; sub-directories are filled as they get expanded.
 void
-FileListView::set_files (const std::vector<UString> &a_files)
+FileListView::set_index (const SourceFileIndex &a_index)
 {
-    // NOTE: This assumes a sorted file list.  If the file list is not
-    // sorted, this function will not work as expected
-
     THROW_IF_FAIL (m_tree_model);
-    if (!(m_tree_model->children ().empty ())) {
-        m_tree_model->clear();
+
+    m_index = &a_index;
+    m_tree_model->clear ();
+    m_match_model->clear ();
+    show_tree ();
+
+    if (a_index.files ().empty ())
+        return;
+
+    SourceFileIndex::Entry root;
+    root.name = "/";
+    root.path = "/";
+    root.is_dir = true;
+    append_entry (m_tree_model->children (), root);
+}
+
+/// Show the directory tree again, after a filtered list of files
+/// was shown.
+void
+FileListView::show_tree ()
+{
+    if (m_showing_matches) {
+        set_model (m_tree_model);
+        m_showing_matches = false;
     }
+}
 
-    // a map vector to keep track of what directory levels we have most
-    // recently added so that its easier to figure out where new paths need
-    // to be added to the tree structure
-    typedef std::pair<UString, Gtk::TreeModel::iterator> folder_map_t;
-    typedef vector<folder_map_t> folder_map_list_t;
-    folder_map_list_t folder_map;
-
-    std::vector<UString>::const_iterator file_iter;
-    for (file_iter = a_files.begin ();
-         file_iter != a_files.end ();
-         ++file_iter) {
-        vector<UString> path_components;
-        // only add absolute paths to the treeview
-        if (Glib::path_is_absolute (*file_iter)) {
-            path_components = (*file_iter).split (G_DIR_SEPARATOR_S);
-            // find the first point where the last added path and the new
-            // path do not match
-            pair<folder_map_list_t::iterator, vector<UString>::iterator>
-                mismatch_iter =
-                std::mismatch(folder_map.begin (),
-                              folder_map.end (), path_components.begin (),
-                              ComparePathMap());
-            // ASSUMPTION: there will always be a mismatch found before we
-            // run out of components of the new path since all paths in the
-            // list should be unique
-            THROW_IF_FAIL(mismatch_iter.second != path_components.end ());
-            // truncate the folder_map vector at the point of the mismatch
-            folder_map.erase (mismatch_iter.first, folder_map.end ());
-
-            // loop through any remaining new path elements and add them to
-            // the tree
-            for (vector<UString>::iterator iter =
-                     mismatch_iter.second; iter !=
-                     path_components.end (); ++iter) {
-                Gtk::TreeModel::iterator tree_iter;
-                if (folder_map.empty ()) {
-                    // add as children of the root level
-                    tree_iter = m_tree_model->append ();
-                } else {
-                    // add as children of the last matched item
-                    // in the folder map
-                    tree_iter = m_tree_model->append (
-                        folder_map.rbegin ()->second->children ());
-                }
-                // build the full path name up to this element
-                Glib::ustring path = "/" + // add back the root element
-                    Glib::build_filename
-                            (std::vector<UString> (path_components.begin(),
-                                                   iter + 1));// we want
-                                                              // to include
-                                                              // this iter
-                                                              // element in
-                                                              // the array,
-                                                              // so + 1
-                (*tree_iter)[m_columns.path] = path;
-                Glib::ustring display_name =
-                    Glib::filename_display_name
-                                            (Glib::locale_to_utf8 (*iter));
-                (*tree_iter)[m_columns.display_name] =
-                    display_name.empty () ? "/" : display_name;
-                if (Glib::file_test(path, Glib::FILE_TEST_IS_REGULAR)) {
-                    (*tree_iter)[m_columns.stock_icon] = Gtk::Stock::FILE;
-                } else if (Glib::file_test(path, Glib::FILE_TEST_IS_DIR)) {
-                    (*tree_iter)[m_columns.stock_icon] =
-                                                        Gtk::Stock::DIRECTORY;
-                }
-                // store the element in the folder
-                // map for use next time around
-                folder_map.push_back (folder_map_t(*iter, tree_iter));
-            }
-        }
+/// Show a flat list of files, e.g. the files matching a filter.
+void
+FileListView::show_matches (const vector<string> &a_paths)
+{
+    THROW_IF_FAIL (m_match_model);
+
+    // Detach the model while it is filled so that the view doesn't
+    // get notified of each row.
+    unset_model ();
+    m_match_model->clear ();
+    for (vector<string>::const_iterator it = a_paths.begin ();
+         it != a_paths.end ();
+         ++it) {
+        Gtk::TreeModel::iterator row = m_match_model->append ();
+        (*row)[m_columns.path] = *it;
+        (*row)[m_columns.display_name] = Glib::filename_display_name (*it);
+        (*row)[m_columns.stock_icon] = Gtk::Stock::FILE;
+        (*row)[m_columns.is_dir] = false;
+    }
+    set_model (m_match_model);
+    m_showing_matches = true;
+}
+
+void
+FileListView::append_entry (const Gtk::TreeModel::Children &a_parent,
+                            const SourceFileIndex::Entry &a_entry)
+{
+    Gtk::TreeModel::iterator row = m_tree_model->append (a_parent);
+    (*row)[m_columns.path] = Glib::filename_to_utf8 (a_entry.path);
+    (*row)[m_columns.display_name] = a_entry.name;
+    (*row)[m_columns.is_dir] = a_entry.is_dir;
+    if (a_entry.is_dir) {
+        (*row)[m_columns.stock_icon] = Gtk::Stock::DIRECTORY;
+        // The placeholder makes the row expandable.
+        m_tree_model->append (row->children ());
+    } else {
+        (*row)[m_columns.stock_icon] = Gtk::Stock::FILE;
     }
 }
 
+/// Replace the placeholder child of a directory row by the actual
+/// content of the directory.
+void
+FileListView::populate_children (const Gtk::TreeModel::iterator &a_iter)
+{
+    THROW_IF_FAIL (m_index);
+
+    if (!(*a_iter)[m_columns.is_dir]) {return;}
+    Gtk::TreeModel::Children children = a_iter->children ();
+    if (children.size () != 1
+        || !Glib::ustring ((*children.begin ())[m_columns.path]).empty ())
+        return;
+
+    m_tree_model->erase (children.begin ());
+    vector<SourceFileIndex::Entry> entries;
+    m_index->get_children
+        (Glib::filename_from_utf8 (Glib::ustring ((*a_iter)[m_columns.path])),
+         entries);
+    for (vector<SourceFileIndex::Entry>::const_iterator it = entries.begin ();
+         it != entries.end ();
+         ++it)
+        append_entry (a_iter->children (), *it);
+}
+
+/// \return the child row of a_parent which path is a_path, or an
+/// invalid iterator if there is none.  If a_parent is invalid, the
+/// top level rows are searched.
+Gtk::TreeModel::iterator
+FileListView::find_child (const Gtk::TreeModel::iterator &a_parent,
+                          const UString &a_path)
+{
+    Gtk::TreeModel::Children children = a_parent
+        ? a_parent->children ()
+        : m_tree_model->children ();
+    for (Gtk::TreeModel::iterator it = children.begin ();
+         it != children.end ();
+         ++it) {
+        if ((*it)[m_columns.path] == a_path)
+            return it;
+    }
+    return Gtk::TreeModel::iterator ();
+}
+
+bool
+FileListView::on_test_expand_row (const Gtk::TreeModel::iterator &a_iter,
+                                  const Gtk::TreeModel::Path &)
+{
+    NEMIVER_TRY
+
+    if (!m_showing_matches)
+        populate_children (a_iter);
+
+    NEMIVER_CATCH
+
+    // Let the row expand.
+    return false;
+}
+
 void
 FileListView::get_selected_filenames (vector<string> &a_filenames) const
 {
@@ -250,7 +312,7 @@ FileListView::get_selected_filenames (vector<string> &a_filenames) const
          path_iter != paths.end ();
          ++path_iter) {
         Gtk::TreeModel::iterator tree_iter =
-            (m_tree_model->get_iter(*path_iter));
+            (get_model ()->get_iter(*path_iter));
         a_filenames.push_back (UString((*tree_iter)[m_columns.path]));
     }
 }
@@ -262,7 +324,7 @@ FileListView::on_row_activated (const Gtk::TreeModel::Path &a_path,
     NEMIVER_TRY
 
     if (!a_col) {return;}
-    Gtk::TreeIter it = m_tree_model->get_iter (a_path);
+    Gtk::TreeIter it = get_model ()->get_iter (a_path);
 
     if (!it) {return;}
     Glib::ustring path = (*it)[m_columns.path];
@@ -350,10 +412,9 @@ FileListView::expand_selected (bool recursive, bool collapse_if_expanded)
              path_iter != paths.end ();
              ++path_iter) {
             Gtk::TreeModel::iterator tree_iter =
-                (m_tree_model->get_iter (*path_iter));
+                (get_model ()->get_iter (*path_iter));
 
-            if (Glib::file_test (UString ((*tree_iter)[m_columns.path]),
-                                 Glib::FILE_TEST_IS_DIR)) {
+            if ((*tree_iter)[m_columns.is_dir]) {
                 if ((row_expanded(*path_iter)) && collapse_if_expanded) {
                     collapse_row(*path_iter);
                 } else {
@@ -364,50 +425,36 @@ FileListView::expand_selected (bool recursive, bool collapse_if_expanded)
     }
 }
 
+/// Expand the directory tree down to a file, and scroll to the
+/// directory that contains it.  Only the directories that lead to the
+/// file get populated.
 void
 FileListView::expand_to_filename (const UString &a_filename)
 {
-    Gtk::TreeModel::iterator tree_iter;
-    for (tree_iter = m_tree_model->children ().begin ();
-         tree_iter != m_tree_model->children ().end ();
-         ++tree_iter) {
-        Gtk::TreeModel::iterator iter =
-                    find_filename_recursive (tree_iter, a_filename);
-        if (iter) {
-            Gtk::TreeModel::Path path(iter);
-            expand_to_path (path);
-            // Scroll to the directory that contains the file
-            path.up ();
-            scroll_to_row (path);
-            break;
-        }
-    }
-}
+    if (!m_index || m_showing_matches
+        || !Glib::path_is_absolute (a_filename))
+        return;
 
-Gtk::TreeModel::iterator
-FileListView::find_filename_recursive (const Gtk::TreeModel::iterator &a_iter,
-                                       const UString &a_filename)
-{
-    Gtk::TreeModel::iterator tree_iter;
-    // first check the iter we were passed
-    if ((*a_iter)[m_columns.path] == a_filename) {
-        return a_iter;
-    }
-    // then check all of its children
-    if (!a_iter->children ().empty ()) {
-        for (tree_iter = a_iter->children ().begin ();
-             tree_iter != a_iter->children ().end ();
-             ++tree_iter) {
-            Gtk::TreeModel::iterator child_iter =
-                        find_filename_recursive (tree_iter, a_filename);
-            if (child_iter) {
-                return child_iter;
-            }
-            // else continue on to the next child
+    Gtk::TreeModel::iterator iter = find_child (Gtk::TreeModel::iterator (),
+                                                "/");
+    vector<UString> path_components = a_filename.split (G_DIR_SEPARATOR_S);
+    UString path;
+    for (vector<UString>::const_iterator it = path_components.begin ();
+         iter && it != path_components.end ();
+         ++it) {
+        if (it->empty ()) {continue;}
+        path += G_DIR_SEPARATOR_S + *it;
+        populate_children (iter);
+        iter = find_child (iter, path);
+        if (iter && !(*iter)[m_columns.is_dir]) {
+            Gtk::TreeModel::Path tree_path (iter);
+            expand_to_path (tree_path);
+            // Scroll to the directory that contains the file
+            tree_path.up ();
+            scroll_to_row (tree_path);
+            return;
         }
     }
-    // if we get to this point without having found it, return an invalid iter
-    return Gtk::TreeModel::iterator();
 }
 
 struct FileList::Priv : public sigc::trackable {
@@ -415,21 +462,34 @@ public:
     SafePtr<Gtk::VBox> vbox;
     SafePtr<Gtk::ScrolledWindow> scrolled_window;
     SafePtr<Gtk::Label> loading_indicator;
+    SafePtr<Gtk::Entry> filter_entry;
     SafePtr<FileListView> tree_view;
 
     Glib::RefPtr<Gtk::ActionGroup> file_list_action_group;
     IDebuggerSafePtr debugger;
+    SourceFileIndex &index;
     UString start_path;
 
-    Priv (IDebuggerSafePtr &a_debugger, const UString &a_starting_path) :
+    Priv (IDebuggerSafePtr &a_debugger,
+          SourceFileIndex &a_index,
+          const UString &a_starting_path) :
         vbox (new Gtk::VBox()),
         scrolled_window (new Gtk::ScrolledWindow ()),
         loading_indicator (new Gtk::Label (_("Loading files from target executable..."))),
+        filter_entry (new Gtk::Entry ()),
         debugger (a_debugger),
+        index (a_index),
         start_path (a_starting_path)
     {
         build_tree_view ();
         vbox->pack_start (*loading_indicator, Gtk::PACK_SHRINK, 3 /*padding*/);
+        filter_entry->set_tooltip_text
+                            (_("Type part of a file name to filter"));
+        filter_entry->set_sensitive (false);
+        filter_entry->show ();
+        filter_entry->signal_changed ().connect
+            (sigc::mem_fun (*this, &FileList::Priv::on_filter_changed_signal));
+        vbox->pack_start (*filter_entry, Gtk::PACK_SHRINK, 3 /*padding*/);
         vbox->pack_start (*scrolled_window);
         scrolled_window->set_policy (Gtk::POLICY_AUTOMATIC,
                                      Gtk::POLICY_AUTOMATIC);
@@ -458,31 +518,70 @@ public:
         loading_indicator->hide ();
     }
 
+    /// Show the content of the index, which must be up to date.
+    void show_files ()
+    {
+        THROW_IF_FAIL (tree_view);
+
+        stop_loading_indicator ();
+        tree_view->set_index (index);
+        filter_entry->set_sensitive (true);
+        if (!filter_entry->get_text ().empty ())
+            on_filter_changed_signal ();
+        else
+            tree_view->expand_to_filename (start_path);
+    }
+
     void on_files_listed_signal (const vector<UString> &a_files,
-                                 const UString &/*a_cookie*/)
+                                 const UString &a_cookie)
+    {
+        NEMIVER_TRY
+
+        if (a_cookie != FILE_LIST_COOKIE) {return;}
+
+        index.set_files (debugger->get_target_path (), a_files);
+        show_files ();
+
+        NEMIVER_CATCH
+    }
+
+    void on_filter_changed_signal ()
     {
         NEMIVER_TRY
 
         THROW_IF_FAIL (tree_view);
 
-        stop_loading_indicator ();
-        tree_view->set_files (a_files);
-        // this signal should only be called once per dialog
-        // -- the first time
-        // it loads up the list of files from the debugger.
-        // So it should be OK
-        // to expand to the 'starting path' in this handler
-        tree_view->expand_to_filename (start_path);
+        UString filter = filter_entry->get_text ();
+        if (filter.empty ()) {
+            tree_view->show_tree ();
+            tree_view->expand_to_filename (start_path);
+            return;
+        }
+        vector<string> matches;
+        index.find (filter, MAX_FILTER_MATCHES, matches);
+        tree_view->show_matches (matches);
 
         NEMIVER_CATCH
     }
 
 };//end class FileList::Priv
 
+/// Constructor of the FileList type.
+///
+/// \param a_debugger the IDebugger interface to use.
+///
+/// \param a_index the index that caches the source files of the
+/// program being debugged.  It is shared between instances of
+/// FileList, and it is filled from the IDebugger interface only if it
+/// doesn't hold the files of the current program yet.
+///
+/// \param a_starting_path the file to expand the tree to, once it
+/// is loaded.
 FileList::FileList (IDebuggerSafePtr &a_debugger,
+                    SourceFileIndex &a_index,
                     const UString &a_starting_path)
 {
-    m_priv.reset (new Priv (a_debugger, a_starting_path));
+    m_priv.reset (new Priv (a_debugger, a_index, a_starting_path));
 }
 
 FileList::~FileList ()
@@ -503,9 +602,15 @@ FileList::update_content ()
 {
     THROW_IF_FAIL (m_priv);
     THROW_IF_FAIL (m_priv->debugger);
+
+    if (m_priv->index.is_valid_for (m_priv->debugger->get_target_path ())) {
+        LOG_DD ("using the cached file list");
+        m_priv->show_files ();
+        return;
+    }
     // set some placeholder text to indicate that we're loading files
     m_priv->show_loading_indicator ();
-    m_priv->debugger->list_files ();
+    m_priv->debugger->list_files (FILE_LIST_COOKIE);
 }
 
 sigc::signal<void, const UString&>&
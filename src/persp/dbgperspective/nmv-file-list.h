@@ -41,7 +41,9 @@ using nemiver::common::UString;
 /// When the widget is instanciated, it doesn't show anything.
 /// The client code has to invoke FileList::update_content() to
 /// have the FileList query the IDebugger interface for the source
-///file list.
+///file list, unless it is cached in the SourceFileIndex already.
+class SourceFileIndex;
+
 class NEMIVER_API FileList : public nemiver::common::Object {
     //non copyable
     FileList (const FileList&);
@@ -52,7 +54,9 @@ class NEMIVER_API FileList : public nemiver::common::Object {
 
 public:
 
-    FileList (IDebuggerSafePtr &a_debugger, const UString &a_starting_path);
+    FileList (IDebuggerSafePtr &a_debugger,
+              SourceFileIndex &a_index,
+              const UString &a_starting_path);
     virtual ~FileList ();
     Gtk::Widget& widget () const;
     sigc::signal<void, const UString&>& file_activated_signal () const;
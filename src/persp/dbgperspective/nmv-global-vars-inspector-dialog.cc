@@ -178,6 +178,7 @@ public:
 
         THROW_IF_FAIL (tree_view && tree_store);
         tree_store->clear ();
+        tree_view->clear_variable_rows_index ();
         std::list<IDebugger::VariableSafePtr>::const_iterator it;
         for (it = a_vars.begin (); it != a_vars.end (); ++it) {
             THROW_IF_FAIL ((*it)->name () != "");
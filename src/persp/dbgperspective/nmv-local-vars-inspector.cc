@@ -38,6 +38,7 @@
 #include "nmv-vars-treeview.h"
 #include "nmv-debugger-utils.h"
 #include "nmv-conf-keys.h"
+#include "nmv-refresh-scheduler.h"
 
 using namespace nemiver::common;
 namespace vutil = nemiver::variables_utils2;
@@ -53,6 +54,7 @@ public:
     IDebuggerSafePtr debugger;
     IWorkbench &workbench;
     IPerspective &perspective;
+    RefreshScheduler &refresh_scheduler;
     VarsTreeView *tree_view;
     Glib::RefPtr<Gtk::TreeStore> tree_store;
     Gtk::TreeModel::iterator cur_selected_row;
@@ -81,9 +83,11 @@ public:
 
     Priv (IDebuggerSafePtr &a_debugger,
           IWorkbench &a_workbench,
-          IPerspective& a_perspective) :
+          IPerspective& a_perspective,
+          RefreshScheduler &a_refresh_scheduler) :
         workbench (a_workbench),
         perspective (a_perspective),
+        refresh_scheduler (a_refresh_scheduler),
         tree_view (Gtk::manage (VarsTreeView::create ())),
         is_new_frame (false),
         is_up2date (true),
@@ -114,6 +118,7 @@ public:
         clear_local_variables ();
         clear_function_arguments ();
         tree_store->clear ();
+        tree_view->clear_variable_rows_index ();
         previous_function_name = "";
         is_new_frame = true;
 
@@ -211,7 +216,7 @@ public:
         LOG_FUNCTION_SCOPE_NORMAL_DD;
 
         THROW_IF_FAIL (debugger);
-        debugger->stopped_signal ().connect
+        refresh_scheduler.stopped_signal ().connect
             (sigc::mem_fun (*this, &Priv::on_stopped_signal));
     }
 
@@ -288,6 +293,19 @@ public:
                 "",
                 false
             },
+            {
+                "TogglePrettyPrintingOfTypeMenuItemAction",
+                Gtk::Stock::CONVERT,
+                _("_Toggle Pretty-Printing of This Type"),
+                _("Display the variables of this type with, or without, "
+                  "their pretty-printer"),
+                sigc::mem_fun
+                    (*this,
+                     &Priv::on_toggle_pretty_printing_of_type_action),
+                ui_utils::ActionEntry::DEFAULT,
+                "",
+                false
+            },
         };
 
         local_vars_inspector_action_group =
@@ -1338,13 +1356,48 @@ public:
 
         NEMIVER_CATCH
     }
+
+    void
+    on_toggle_pretty_printing_of_type_action ()
+    {
+        LOG_FUNCTION_SCOPE_NORMAL_DD;
+
+        NEMIVER_TRY
+
+        THROW_IF_FAIL (cur_selected_row);
+
+        IDebugger::VariableSafePtr variable =
+            cur_selected_row->get_value
+                (vutil::get_variable_columns ().variable);
+        THROW_IF_FAIL (variable);
+        if (variable->type ().empty ())
+            return;
+
+        bool disabled =
+            debugger->is_pretty_printing_disabled_for_type
+                                                (variable->type ());
+        debugger->disable_pretty_printing_for_type (variable->type (),
+                                                    !disabled);
+
+        // Display the local variables again, with the new setting.
+        IDebugger::VariableList::const_iterator it;
+        for (it = local_vars.begin (); it != local_vars.end (); ++it)
+            debugger->revisualize_variable
+                (*it,
+                 sigc::mem_fun (*this,
+                                &Priv::on_local_var_visualized_signal));
+
+        NEMIVER_CATCH
+    }
 };//end LocalVarsInspector::Priv
 
 LocalVarsInspector::LocalVarsInspector (IDebuggerSafePtr &a_debugger,
                                           IWorkbench &a_workbench,
-                                          IPerspective &a_perspective)
+                                          IPerspective &a_perspective,
+                                          RefreshScheduler &a_refresh_scheduler)
 {
-    m_priv.reset (new Priv (a_debugger, a_workbench, a_perspective));
+    m_priv.reset (new Priv (a_debugger, a_workbench, a_perspective,
+                            a_refresh_scheduler));
 }
 
 LocalVarsInspector::~LocalVarsInspector ()
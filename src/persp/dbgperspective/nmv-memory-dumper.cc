@@ -0,0 +1,417 @@
+/*
+ *This file is part of the Nemiver project
+ *
+ *Nemiver is free software; you can redistribute
+ *it and/or modify it under the terms of
+ *the GNU General Public License as published by the
+ *Free Software Foundation; either version 2,
+ *or (at your option) any later version.
+ *
+ *Nemiver is distributed in the hope that it will
+ *be useful, but WITHOUT ANY WARRANTY;
+ *without even the implied warranty of
+ *MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ *See the GNU General Public License for more details.
+ *
+ *You should have received a copy of the
+ *GNU General Public License along with Nemiver;
+ *see the file COPYING.
+ *If not, write to the Free Software Foundation,
+ *Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+ *
+ *See COPYRIGHT file copyright information.
+ */
+#include "config.h"
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <cerrno>
+#include <algorithm>
+#include <cstring>
+#include <deque>
+#include "common/nmv-exception.h"
+#include "nmv-memory-dumper.h"
+
+namespace nemiver {
+
+// The number of bytes asked to GDB at once.
+static const size_t CHUNK_SIZE = 1024 * 1024;
+
+// The number of chunks queued to the debugger ahead of the one
+// being handled.
+static const size_t NB_CHUNKS_AHEAD = 4;
+
+// Changed bytes that are less than that many bytes apart are in
+// the same range of find_changed_ranges.
+static const size_t CHANGED_RANGE_MERGE_GAP = 8;
+
+MemorySearcher::MemorySearcher () :
+    m_tail_end_addr (0)
+{
+}
+
+/// Start a new search.
+///
+/// \param a_pattern the bytes to search for.  If empty, nothing is
+/// searched.
+void
+MemorySearcher::reset (const std::string &a_pattern)
+{
+    m_pattern = a_pattern;
+    m_tail.clear ();
+    m_tail_end_addr = 0;
+}
+
+/// Search the next chunk of memory.  The occurrences that start in
+/// the previous chunk searched are found too, if that chunk ends
+/// where this one starts.
+///
+/// \param a_addr the address of the chunk.
+///
+/// \param a_values the bytes of the chunk.
+///
+/// \param a_hits the addresses of the occurrences found are appended
+/// to it, in increasing order.
+void
+MemorySearcher::search (size_t a_addr,
+                        const std::vector<uint8_t> &a_values,
+                        std::vector<size_t> &a_hits)
+{
+    if (m_pattern.empty () || a_values.empty ())
+        return;
+    const size_t pattern_len = m_pattern.size ();
+    const char *data = reinterpret_cast<const char*> (&a_values[0]);
+    const size_t size = a_values.size ();
+
+    // The occurrences that start in the tail of the previous chunk,
+    // if that chunk is contiguous to this one.
+    if (!m_tail.empty () && m_tail_end_addr == a_addr) {
+        std::string boundary = m_tail;
+        boundary.append (data, std::min (size, pattern_len - 1));
+        size_t tail_addr = a_addr - m_tail.size ();
+        for (std::string::size_type i = boundary.find (m_pattern);
+             i != std::string::npos && i < m_tail.size ();
+             i = boundary.find (m_pattern, i + 1))
+            a_hits.push_back (tail_addr + i);
+    }
+
+    // memmem is vectorized by the C library.
+    const char *cur = data, *end = data + size;
+    while (cur + pattern_len <= end) {
+        const char *hit = static_cast<const char*>
+            (memmem (cur, end - cur, m_pattern.data (), pattern_len));
+        if (!hit)
+            break;
+        a_hits.push_back (a_addr + (hit - data));
+        cur = hit + 1;
+    }
+
+    if (size >= pattern_len - 1) {
+        m_tail.assign (end - (pattern_len - 1), pattern_len - 1);
+    } else {
+        if (m_tail_end_addr != a_addr)
+            m_tail.clear ();
+        m_tail.append (data, size);
+        if (m_tail.size () > pattern_len - 1)
+            m_tail.erase (0, m_tail.size () - (pattern_len - 1));
+    }
+    m_tail_end_addr = a_addr + size;
+}
+
+/// Find the bytes that differ between two buffers of the same size.
+/// The buffers are compared a 64 bits word at a time, which the
+/// compiler can vectorize; only the words that differ are looked at
+/// byte per byte.
+/// \param a_old the previous content of the memory.
+/// \param a_new the new content of the memory.
+/// \param a_ranges the resulting list of [offset, offset + length)
+/// ranges of changed bytes, in increasing offset order.
+/// \return the number of bytes that changed.
+size_t
+find_changed_ranges (const std::vector<uint8_t> &a_old,
+                     const std::vector<uint8_t> &a_new,
+                     std::vector<ByteRange> &a_ranges)
+{
+    THROW_IF_FAIL (a_old.size () == a_new.size ());
+    a_ranges.clear ();
+
+    const size_t size = a_new.size ();
+    if (!size)
+        return 0;
+    const uint8_t *old_bytes = &a_old[0], *new_bytes = &a_new[0];
+    size_t i = 0, nb_changed = 0;
+    while (i < size) {
+        for (; i + sizeof (guint64) <= size; i += sizeof (guint64)) {
+            guint64 old_word, new_word;
+            memcpy (&old_word, old_bytes + i, sizeof (old_word));
+            memcpy (&new_word, new_bytes + i, sizeof (new_word));
+            if (old_word != new_word)
+                break;
+        }
+        while (i < size && old_bytes[i] == new_bytes[i])
+            ++i;
+        if (i == size)
+            break;
+
+        size_t start = i;
+        while (i < size && old_bytes[i] != new_bytes[i])
+            ++i;
+        nb_changed += i - start;
+
+        if (!a_ranges.empty ()
+            && start - a_ranges.back ().second < CHANGED_RANGE_MERGE_GAP) {
+            a_ranges.back ().second = i;
+        } else {
+            a_ranges.push_back (ByteRange (start, i));
+        }
+    }
+    return nb_changed;
+}
+
+struct MemoryDumper::Priv : public sigc::trackable {
+    IDebuggerSafePtr debugger;
+    sigc::signal<void, size_t, size_t> progress_signal;
+    sigc::signal<void, size_t> hit_signal;
+    sigc::signal<void, size_t, size_t, bool> finished_signal;
+
+    // Each dump gets its own number, so that the chunks still
+    // queued by a cancelled dump are ignored.
+    unsigned run;
+    bool running;
+    size_t start_addr;
+    size_t end_addr;
+    size_t next_addr;
+    size_t nb_handled;
+    size_t nb_read;
+    int fd;
+    MemorySearcher searcher;
+    // The address and size of the chunks queued to the debugger,
+    // in the order they were queued.
+    std::deque<std::pair<size_t, size_t> > pending;
+
+    Priv (IDebuggerSafePtr &a_debugger) :
+        debugger (a_debugger),
+        run (0),
+        running (false),
+        start_addr (0),
+        end_addr (0),
+        next_addr (0),
+        nb_handled (0),
+        nb_read (0),
+        fd (-1)
+    {
+        THROW_IF_FAIL (debugger);
+        debugger->engine_died_signal ().connect
+            (sigc::mem_fun (*this, &Priv::on_engine_died_signal));
+    }
+
+    ~Priv ()
+    {
+        close_dump_file ();
+    }
+
+    void close_dump_file ()
+    {
+        if (fd >= 0) {
+            close (fd);
+            fd = -1;
+        }
+    }
+
+    void queue_chunks ()
+    {
+        while (pending.size () < NB_CHUNKS_AHEAD && next_addr < end_addr) {
+            size_t size = std::min (CHUNK_SIZE, end_addr - next_addr);
+            pending.push_back (std::make_pair (next_addr, size));
+            debugger->read_memory_bytes
+                (next_addr, size,
+                 sigc::bind (sigc::mem_fun (*this, &Priv::on_chunk_read),
+                             run));
+            next_addr += size;
+        }
+    }
+
+    void finish (bool a_cancelled)
+    {
+        running = false;
+        pending.clear ();
+        searcher.reset ("");
+        close_dump_file ();
+        finished_signal.emit (nb_read, nb_handled - nb_read, a_cancelled);
+    }
+
+    void write_chunk (size_t a_addr, const std::vector<uint8_t> &a_values)
+    {
+        if (fd < 0 || a_values.empty ())
+            return;
+        const uint8_t *buf = &a_values[0];
+        size_t left = a_values.size ();
+        off_t offset = a_addr - start_addr;
+        while (left) {
+            ssize_t written = pwrite (fd, buf, left, offset);
+            if (written < 0) {
+                if (errno == EINTR)
+                    continue;
+                UString msg = strerror (errno);
+                finish (true);
+                THROW (msg);
+            }
+            buf += written;
+            offset += written;
+            left -= written;
+        }
+    }
+
+    void search_chunk (size_t a_addr, const std::vector<uint8_t> &a_values)
+    {
+        std::vector<size_t> hits;
+        searcher.search (a_addr, a_values, hits);
+        for (std::vector<size_t>::const_iterator it = hits.begin ();
+             it != hits.end () && running;
+             ++it)
+            hit_signal.emit (*it);
+    }
+
+    void on_chunk_read (const std::list<IDebugger::MemoryBlock> &a_blocks,
+                        unsigned a_run)
+    {
+        NEMIVER_TRY
+
+        if (!running || a_run != run || pending.empty ())
+            return;
+
+        size_t chunk_size = pending.front ().second;
+        pending.pop_front ();
+        nb_handled += chunk_size;
+
+        // GDB only returns the blocks of the chunk it could read.
+        // The searcher doesn't look for the pattern across the holes
+        // between them.
+        std::list<IDebugger::MemoryBlock>::const_iterator it;
+        for (it = a_blocks.begin (); it != a_blocks.end () && running; ++it) {
+            nb_read += it->second.size ();
+            write_chunk (it->first, it->second);
+            search_chunk (it->first, it->second);
+        }
+        if (!running)
+            return;
+
+        progress_signal.emit (nb_handled, end_addr - start_addr);
+        if (!running)
+            return;
+
+        queue_chunks ();
+        if (pending.empty ())
+            finish (false);
+
+        NEMIVER_CATCH
+    }
+
+    void on_engine_died_signal ()
+    {
+        NEMIVER_TRY
+        if (running)
+            finish (true);
+        NEMIVER_CATCH
+    }
+};//end struct MemoryDumper::Priv
+
+MemoryDumper::MemoryDumper (IDebuggerSafePtr &a_debugger) :
+    m_priv (new Priv (a_debugger))
+{
+}
+
+MemoryDumper::~MemoryDumper ()
+{
+}
+
+/// Start reading a range of memory.  A dump that is already running
+/// is cancelled first.
+///
+/// \param a_start_addr the address of the first byte of the range.
+/// \param a_num_bytes the size of the range.
+/// \param a_dump_path the file to write the range to, at the offset
+/// of each byte from a_start_addr.  If empty, nothing is written.
+/// \param a_pattern the bytes to search the range for.  If empty,
+/// nothing is searched.
+void
+MemoryDumper::start (size_t a_start_addr,
+                     size_t a_num_bytes,
+                     const UString &a_dump_path,
+                     const std::string &a_pattern)
+{
+    LOG_FUNCTION_SCOPE_NORMAL_DD;
+    THROW_IF_FAIL (m_priv);
+
+    if (m_priv->running)
+        cancel ();
+
+    THROW_IF_FAIL (a_num_bytes);
+    if (a_start_addr + a_num_bytes < a_start_addr)
+        a_num_bytes = (size_t) -1 - a_start_addr;
+
+    if (!a_dump_path.empty ()) {
+        int fd = open (a_dump_path.c_str (),
+                       O_WRONLY | O_CREAT | O_TRUNC, 0644);
+        if (fd < 0)
+            THROW (UString (a_dump_path) + ": " + strerror (errno));
+        // Size the file up front; the memory that can't be read is
+        // left as holes.
+        if (ftruncate (fd, a_num_bytes)) {
+            UString msg = UString (a_dump_path) + ": " + strerror (errno);
+            close (fd);
+            THROW (msg);
+        }
+        m_priv->fd = fd;
+    }
+
+    ++m_priv->run;
+    m_priv->running = true;
+    m_priv->start_addr = m_priv->next_addr = a_start_addr;
+    m_priv->end_addr = a_start_addr + a_num_bytes;
+    m_priv->nb_handled = m_priv->nb_read = 0;
+    m_priv->searcher.reset (a_pattern);
+    m_priv->queue_chunks ();
+}
+
+/// Stop the running dump.  The chunks already queued to the
+/// debugger are still read, but are ignored.
+void
+MemoryDumper::cancel ()
+{
+    LOG_FUNCTION_SCOPE_NORMAL_DD;
+    THROW_IF_FAIL (m_priv);
+    if (m_priv->running)
+        m_priv->finish (true);
+}
+
+bool
+MemoryDumper::is_running () const
+{
+    THROW_IF_FAIL (m_priv);
+    return m_priv->running;
+}
+
+sigc::signal<void, size_t, size_t>&
+MemoryDumper::progress_signal () const
+{
+    THROW_IF_FAIL (m_priv);
+    return m_priv->progress_signal;
+}
+
+sigc::signal<void, size_t>&
+MemoryDumper::hit_signal () const
+{
+    THROW_IF_FAIL (m_priv);
+    return m_priv->hit_signal;
+}
+
+sigc::signal<void, size_t, size_t, bool>&
+MemoryDumper::finished_signal () const
+{
+    THROW_IF_FAIL (m_priv);
+    return m_priv->finished_signal;
+}
+
+} // namespace nemiver
@@ -0,0 +1,115 @@
+/*
+ *This file is part of the Nemiver project
+ *
+ *Nemiver is free software; you can redistribute
+ *it and/or modify it under the terms of
+ *the GNU General Public License as published by the
+ *Free Software Foundation; either version 2,
+ *or (at your option) any later version.
+ *
+ *Nemiver is distributed in the hope that it will
+ *be useful, but WITHOUT ANY WARRANTY;
+ *without even the implied warranty of
+ *MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ *See the GNU General Public License for more details.
+ *
+ *You should have received a copy of the
+ *GNU General Public License along with Nemiver;
+ *see the file COPYING.
+ *If not, write to the Free Software Foundation,
+ *Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+ *
+ *See COPYRIGHT file copyright information.
+ */
+#ifndef __NMV_MEMORY_DUMPER_H__
+#define __NMV_MEMORY_DUMPER_H__
+
+#include <string>
+#include <vector>
+#include "common/nmv-object.h"
+#include "common/nmv-safe-ptr-utils.h"
+#include "nmv-i-debugger.h"
+
+using nemiver::common::SafePtr;
+
+namespace nemiver {
+
+/// Searches memory that is read in chunks for a pattern of bytes.
+/// The occurrences that straddle two contiguous chunks are found too:
+/// the last bytes of each chunk are kept until the next one arrives.
+class NEMIVER_API MemorySearcher {
+    std::string m_pattern;
+    // The last m_pattern.size () - 1 bytes searched.
+    std::string m_tail;
+    size_t m_tail_end_addr;
+
+public:
+    MemorySearcher ();
+
+    void reset (const std::string &a_pattern);
+
+    const std::string& pattern () const {return m_pattern;}
+
+    void search (size_t a_addr,
+                 const std::vector<uint8_t> &a_values,
+                 std::vector<size_t> &a_hits);
+};//end class MemorySearcher
+
+/// A range of bytes, as [offset, offset + length).
+typedef std::pair<size_t, size_t> ByteRange;
+
+NEMIVER_API size_t find_changed_ranges (const std::vector<uint8_t> &a_old,
+                                        const std::vector<uint8_t> &a_new,
+                                        std::vector<ByteRange> &a_ranges);
+
+/// Reads a range of the memory of the inferior that is too big to be
+/// read in one go, and dumps it to a file and/or searches it for a
+/// pattern of bytes.
+///
+/// The range is read in chunks, with IDebugger::read_memory_bytes.
+/// A few chunks are queued ahead, so that GDB always has the next
+/// chunk to read while the previous one is being handled.  Each chunk
+/// is written to the dump file and searched as soon as it arrives,
+/// so the range is never held in memory.
+///
+/// Memory that can't be read is skipped: it is left as a hole in
+/// the dump file and is reported by finished_signal.
+class NEMIVER_API MemoryDumper : public nemiver::common::Object {
+    // non-copyable
+    MemoryDumper (const MemoryDumper&);
+    MemoryDumper& operator= (const MemoryDumper&);
+
+    struct Priv;
+    SafePtr<Priv> m_priv;
+
+public:
+    MemoryDumper (IDebuggerSafePtr &a_debugger);
+    virtual ~MemoryDumper ();
+
+    void start (size_t a_start_addr,
+                size_t a_num_bytes,
+                const UString &a_dump_path,
+                const std::string &a_pattern);
+
+    void cancel ();
+
+    bool is_running () const;
+
+    /// Emitted each time a chunk has been handled.  The parameters
+    /// are the number of bytes handled so far and the size of the
+    /// range.
+    sigc::signal<void, size_t, size_t>& progress_signal () const;
+
+    /// Emitted for each occurrence of the pattern.  The parameter is
+    /// the address of the occurrence.
+    sigc::signal<void, size_t>& hit_signal () const;
+
+    /// Emitted when the whole range has been handled, or when the
+    /// dump has been cancelled.  The parameters are the number of
+    /// bytes read, the number of bytes that couldn't be read and
+    /// whether the dump was cancelled.
+    sigc::signal<void, size_t, size_t, bool>& finished_signal () const;
+};//end class MemoryDumper
+
+}   // namespace nemiver
+#endif // __NMV_MEMORY_DUMPER_H__
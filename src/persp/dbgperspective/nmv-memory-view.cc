@@ -23,6 +23,9 @@
  *See COPYRIGHT file copyright information.
  */
 #include "config.h"
+#include <cstdlib>
+#include <cstring>
+#include <algorithm>
 #include <sstream>
 #include <bitset>
 #include <iomanip>
@@ -31,13 +34,56 @@
 #include <gtkmm/box.h>
 #include <glib/gi18n.h>
 #include <gtkmm/scrolledwindow.h>
+#include <gtkmm/checkbutton.h>
+#include <gtkmm/progressbar.h>
+#include <gtkmm/filechooserdialog.h>
+#include <gtkmm/stock.h>
 #include "nmv-ui-utils.h"
 #include "nmv-memory-view.h"
 #include "nmv-i-debugger.h"
+#include "nmv-refresh-scheduler.h"
+#include "nmv-memory-dumper.h"
 #include "uicommon/nmv-hex-editor.h"
 
 namespace nemiver {
 
+// The number of occurrences of a search that can be stepped through;
+// the others are only counted.
+static const size_t MAX_KEPT_HITS = 100000;
+
+/// Turn the text of the search entry into the bytes to search for.
+/// If a_is_hex is true, a_text is a sequence of hexadecimal bytes,
+/// like "de ad be ef" or "deadbeef"; otherwise it is searched as is.
+/// \return false if a_text isn't a valid sequence of hexadecimal
+/// bytes.
+static bool
+search_pattern_from_text (const UString &a_text,
+                          bool a_is_hex,
+                          std::string &a_pattern)
+{
+    a_pattern.clear ();
+    if (!a_is_hex) {
+        a_pattern = a_text.raw ();
+        return true;
+    }
+    const std::string &text = a_text.raw ();
+    int hi = -1;
+    for (std::string::size_type i = 0; i < text.size (); ++i) {
+        if (isspace (text[i]))
+            continue;
+        int digit = g_ascii_xdigit_value (text[i]);
+        if (digit < 0)
+            return false;
+        if (hi < 0) {
+            hi = digit;
+        } else {
+            a_pattern += (char) ((hi << 4) | digit);
+            hi = -1;
+        }
+    }
+    return hi < 0;
+}
+
 class GroupingComboBox : public Gtk::ComboBox
 {
     public:
@@ -79,7 +125,7 @@ class GroupingComboBox : public Gtk::ComboBox
 
 };
 
-struct MemoryView::Priv {
+struct MemoryView::Priv : public sigc::trackable {
 public:
     SafePtr<Gtk::Label> m_address_label;
     SafePtr<Gtk::Entry> m_address_entry;
@@ -87,24 +133,73 @@ public:
     SafePtr<Gtk::HBox> m_hbox;
     SafePtr<Gtk::VBox> m_vbox;
     SafePtr<Gtk::Label> m_group_label;
+    SafePtr<Gtk::Label> m_changes_label;
+    SafePtr<Gtk::HBox> m_range_hbox;
+    SafePtr<Gtk::Label> m_length_label;
+    SafePtr<Gtk::Entry> m_length_entry;
+    SafePtr<Gtk::Label> m_search_label;
+    SafePtr<Gtk::Entry> m_search_entry;
+    SafePtr<Gtk::CheckButton> m_search_hex_check;
+    SafePtr<Gtk::Button> m_search_button;
+    SafePtr<Gtk::Button> m_dump_button;
+    SafePtr<Gtk::Button> m_cancel_button;
+    SafePtr<Gtk::Button> m_prev_hit_button;
+    SafePtr<Gtk::Button> m_next_hit_button;
+    SafePtr<Gtk::ProgressBar> m_progress_bar;
     GroupingComboBox m_grouping_combo;
     SafePtr<Gtk::ScrolledWindow> m_container;
     Hex::DocumentSafePtr m_document;
     Hex::EditorSafePtr m_editor;
     IDebuggerSafePtr m_debugger;
     sigc::connection signal_document_changed_connection;
-
-    Priv (IDebuggerSafePtr& a_debugger) :
+    // The memory shown by the hex document, as last read from the
+    // debugger.  It is compared to the memory read at the next stop
+    // to only update, and highlight, the bytes that changed.
+    size_t m_snapshot_addr;
+    std::vector<uint8_t> m_snapshot;
+    // False if the inferior stopped since the memory was last read,
+    // while the view was hidden.
+    bool m_is_up2date;
+    // Reads, and dumps or searches, the range of memory that starts
+    // at the address entered and whose size is in m_length_entry.
+    SafePtr<MemoryDumper> m_dumper;
+    // The addresses of the occurrences found by the last search, the
+    // first MAX_KEPT_HITS of them, the number of occurrences found
+    // and the index of the one shown in the hex view.
+    std::vector<size_t> m_hits;
+    size_t m_nb_hits;
+    size_t m_cur_hit;
+
+    Priv (IDebuggerSafePtr& a_debugger,
+          RefreshScheduler &a_refresh_scheduler) :
         m_address_label (new Gtk::Label (_("Address:"))),
         m_address_entry (new Gtk::Entry ()),
         m_jump_button (new Gtk::Button (_("Show"))),
         m_hbox (new Gtk::HBox ()),
         m_vbox (new Gtk::VBox ()),
         m_group_label (new Gtk::Label (_("Group By:"))),
+        m_changes_label (new Gtk::Label ()),
+        m_range_hbox (new Gtk::HBox ()),
+        m_length_label (new Gtk::Label (_("Length:"))),
+        m_length_entry (new Gtk::Entry ()),
+        m_search_label (new Gtk::Label (_("Find:"))),
+        m_search_entry (new Gtk::Entry ()),
+        m_search_hex_check (new Gtk::CheckButton (_("Hex"))),
+        m_search_button (new Gtk::Button (_("Search"))),
+        m_dump_button (new Gtk::Button (_("Dump..."))),
+        m_cancel_button (new Gtk::Button (Gtk::Stock::CANCEL)),
+        m_prev_hit_button (new Gtk::Button (_("Previous"))),
+        m_next_hit_button (new Gtk::Button (_("Next"))),
+        m_progress_bar (new Gtk::ProgressBar ()),
         m_container (new Gtk::ScrolledWindow ()),
         m_document (Hex::Document::create ()),
         m_editor (Hex::Editor::create (m_document)),
-        m_debugger (a_debugger)
+        m_debugger (a_debugger),
+        m_snapshot_addr (0),
+        m_is_up2date (true),
+        m_dumper (new MemoryDumper (a_debugger)),
+        m_nb_hits (0),
+        m_cur_hit (0)
     {
         // For a reason, the hex editor (instance of m_editor) won't
         // properly render itself if it's not put inside a scrolled
@@ -124,7 +219,37 @@ public:
         m_hbox->pack_start (*m_group_label, Gtk::PACK_SHRINK);
         m_hbox->pack_start (m_grouping_combo, Gtk::PACK_SHRINK);
         m_hbox->pack_start (*m_jump_button, Gtk::PACK_SHRINK);
+        m_hbox->pack_start (*m_changes_label, Gtk::PACK_SHRINK);
         m_vbox->pack_start (*m_hbox, Gtk::PACK_SHRINK);
+
+        m_length_entry->set_width_chars (12);
+        m_length_entry->set_tooltip_text
+            (_("The number of bytes to search or to dump, "
+               "from the address above"));
+        m_search_entry->set_tooltip_text
+            (_("The string to search for, or the bytes if Hex is checked"));
+        m_cancel_button->set_sensitive (false);
+        m_prev_hit_button->set_tooltip_text
+            (_("Show the previous occurrence found"));
+        m_prev_hit_button->set_sensitive (false);
+        m_next_hit_button->set_tooltip_text
+            (_("Show the next occurrence found"));
+        m_next_hit_button->set_sensitive (false);
+        m_progress_bar->set_show_text (true);
+        m_range_hbox->set_spacing (6);
+        m_range_hbox->set_border_width (3);
+        m_range_hbox->pack_start (*m_length_label, Gtk::PACK_SHRINK);
+        m_range_hbox->pack_start (*m_length_entry, Gtk::PACK_SHRINK);
+        m_range_hbox->pack_start (*m_search_label, Gtk::PACK_SHRINK);
+        m_range_hbox->pack_start (*m_search_entry, Gtk::PACK_SHRINK);
+        m_range_hbox->pack_start (*m_search_hex_check, Gtk::PACK_SHRINK);
+        m_range_hbox->pack_start (*m_search_button, Gtk::PACK_SHRINK);
+        m_range_hbox->pack_start (*m_dump_button, Gtk::PACK_SHRINK);
+        m_range_hbox->pack_start (*m_cancel_button, Gtk::PACK_SHRINK);
+        m_range_hbox->pack_start (*m_prev_hit_button, Gtk::PACK_SHRINK);
+        m_range_hbox->pack_start (*m_next_hit_button, Gtk::PACK_SHRINK);
+        m_range_hbox->pack_start (*m_progress_bar);
+        m_vbox->pack_start (*m_range_hbox, Gtk::PACK_SHRINK);
         m_vbox->pack_start (*w);
 
         // So the whole memory view widget is going to live inside a
@@ -137,15 +262,22 @@ public:
         m_container->set_shadow_type (Gtk::SHADOW_IN);
         m_container->add (*m_vbox);
 
-        connect_signals ();
+        connect_signals (a_refresh_scheduler);
+
+        // The view is built the first time it's shown, which can be
+        // long after the inferior stopped.  In that case, read the
+        // memory as soon as the view gets mapped.
+        if (m_debugger->is_attached_to_target ()
+            && m_debugger->get_state () == IDebugger::READY)
+            m_is_up2date = false;
     }
 
-    void connect_signals ()
+    void connect_signals (RefreshScheduler &a_refresh_scheduler)
     {
         THROW_IF_FAIL (m_debugger);
         m_debugger->state_changed_signal ().connect
                     (sigc::mem_fun (this, &Priv::on_debugger_state_changed));
-        m_debugger->stopped_signal ().connect (sigc::mem_fun
+        a_refresh_scheduler.stopped_signal ().connect (sigc::mem_fun
                 (this, &Priv::on_debugger_stopped));
         m_debugger->read_memory_signal ().connect
                     (sigc::mem_fun (this, &Priv::on_memory_read_response));
@@ -161,6 +293,27 @@ public:
         signal_document_changed_connection =
             m_document->signal_document_changed ().connect
                         (sigc::mem_fun (this, &Priv::on_document_changed));
+        m_search_button->signal_clicked ().connect
+                        (sigc::mem_fun (this, &Priv::on_search_clicked));
+        m_search_entry->signal_activate ().connect
+                        (sigc::mem_fun (this, &Priv::on_search_clicked));
+        m_dump_button->signal_clicked ().connect
+                        (sigc::mem_fun (this, &Priv::on_dump_clicked));
+        m_cancel_button->signal_clicked ().connect
+                        (sigc::mem_fun (this, &Priv::on_cancel_clicked));
+        m_prev_hit_button->signal_clicked ().connect
+                        (sigc::mem_fun (this, &Priv::on_prev_hit_clicked));
+        m_next_hit_button->signal_clicked ().connect
+                        (sigc::mem_fun (this, &Priv::on_next_hit_clicked));
+        THROW_IF_FAIL (m_dumper);
+        m_dumper->progress_signal ().connect
+                        (sigc::mem_fun (this, &Priv::on_dump_progress));
+        m_dumper->hit_signal ().connect
+                        (sigc::mem_fun (this, &Priv::on_dump_hit));
+        m_dumper->finished_signal ().connect
+                        (sigc::mem_fun (this, &Priv::on_dump_finished));
+        m_container->signal_map ().connect
+                        (sigc::mem_fun (this, &Priv::on_map));
     }
 
     void on_debugger_state_changed (IDebugger::State a_state)
@@ -218,11 +371,29 @@ public:
             || a_reason == IDebugger::EXITED) {
             return;
         }
-        do_memory_read ();
+        // Don't read memory nobody looks at; it is read when the
+        // view gets shown again.
+        if (m_editor->get_widget ().get_is_drawable ())
+            do_memory_read ();
+        else
+            m_is_up2date = false;
 
         NEMIVER_CATCH
     }
 
+    void on_map ()
+    {
+        LOG_FUNCTION_SCOPE_NORMAL_DD;
+        NEMIVER_TRY
+        THROW_IF_FAIL (m_debugger);
+        if (!m_is_up2date
+            && m_debugger->get_state () == IDebugger::READY) {
+            m_is_up2date = true;
+            do_memory_read ();
+        }
+        NEMIVER_CATCH
+    }
+
     size_t get_address ()
     {
         THROW_IF_FAIL (m_address_entry);
@@ -249,6 +420,204 @@ public:
         m_address_entry->set_sensitive (a_enable);
         m_jump_button->set_sensitive (a_enable);
         m_editor->get_widget ().set_sensitive (a_enable);
+        set_range_widgets_sensitive (a_enable);
+    }
+
+    void set_range_widgets_sensitive (bool a_enable)
+    {
+        THROW_IF_FAIL (m_dumper && m_search_button && m_dump_button);
+        bool is_running = m_dumper->is_running ();
+        m_search_button->set_sensitive (a_enable && !is_running);
+        m_dump_button->set_sensitive (a_enable && !is_running);
+        m_cancel_button->set_sensitive (is_running);
+        THROW_IF_FAIL (m_prev_hit_button && m_next_hit_button);
+        m_prev_hit_button->set_sensitive (a_enable && m_cur_hit > 0);
+        m_next_hit_button->set_sensitive (a_enable
+                                          && m_cur_hit + 1 < m_hits.size ());
+    }
+
+    /// Start reading the range of memory given by the address and
+    /// length entries.
+    /// \param a_dump_path the file to dump the range to, or an empty
+    /// string to not dump it.
+    /// \param a_pattern the bytes to search for, if any.
+    void start_range_read (const UString &a_dump_path,
+                           const std::string &a_pattern)
+    {
+        LOG_FUNCTION_SCOPE_NORMAL_DD;
+        THROW_IF_FAIL (m_dumper && m_length_entry && m_progress_bar);
+        size_t addr = get_address ();
+        if (!validate_address (addr)) {
+            ui_utils::display_error_not_transient
+                                        (_("Please enter a valid address"));
+            return;
+        }
+        // Accept decimal as well as "0x" prefixed lengths.
+        size_t length =
+            strtoull (m_length_entry->get_text ().c_str (), 0, 0);
+        if (!length) {
+            ui_utils::display_error_not_transient
+                                        (_("Please enter a valid length"));
+            return;
+        }
+        m_hits.clear ();
+        m_nb_hits = 0;
+        m_cur_hit = 0;
+        m_progress_bar->set_fraction (0);
+        m_progress_bar->set_text ("");
+        m_dumper->start (addr, length, a_dump_path, a_pattern);
+        set_range_widgets_sensitive (m_address_entry->get_sensitive ());
+    }
+
+    void on_search_clicked ()
+    {
+        LOG_FUNCTION_SCOPE_NORMAL_DD;
+        NEMIVER_TRY
+        THROW_IF_FAIL (m_search_entry && m_search_hex_check);
+        std::string pattern;
+        if (!search_pattern_from_text (m_search_entry->get_text (),
+                                       m_search_hex_check->get_active (),
+                                       pattern)) {
+            ui_utils::display_error_not_transient
+                (_("Please enter the bytes to search for as hexadecimal "
+                   "digits, like 'de ad be ef'"));
+            return;
+        }
+        if (pattern.empty ())
+            return;
+        start_range_read ("", pattern);
+        NEMIVER_CATCH
+    }
+
+    void on_dump_clicked ()
+    {
+        LOG_FUNCTION_SCOPE_NORMAL_DD;
+        NEMIVER_TRY
+        Gtk::FileChooserDialog file_chooser
+                                (_("Dump Memory to File"),
+                                 Gtk::FILE_CHOOSER_ACTION_SAVE);
+        file_chooser.add_button (Gtk::Stock::CANCEL, Gtk::RESPONSE_CANCEL);
+        file_chooser.add_button (Gtk::Stock::SAVE, Gtk::RESPONSE_OK);
+        file_chooser.set_do_overwrite_confirmation (true);
+
+        if (file_chooser.run () != Gtk::RESPONSE_OK) {
+            LOG_DD ("cancelled");
+            return;
+        }
+        UString path = file_chooser.get_filename ();
+        if (path.empty ())
+            return;
+        file_chooser.hide ();
+
+        // Search while dumping, if there is something to search for.
+        std::string pattern;
+        search_pattern_from_text (m_search_entry->get_text (),
+                                  m_search_hex_check->get_active (),
+                                  pattern);
+        start_range_read (path, pattern);
+        NEMIVER_CATCH
+    }
+
+    void on_cancel_clicked ()
+    {
+        LOG_FUNCTION_SCOPE_NORMAL_DD;
+        NEMIVER_TRY
+        THROW_IF_FAIL (m_dumper);
+        m_dumper->cancel ();
+        NEMIVER_CATCH
+    }
+
+    void on_dump_progress (size_t a_nb_handled, size_t a_nb_total)
+    {
+        NEMIVER_TRY
+        THROW_IF_FAIL (m_progress_bar);
+        m_progress_bar->set_fraction ((double) a_nb_handled / a_nb_total);
+        UString text;
+        text.printf (ngettext ("%d%% (%d hit)", "%d%% (%d hits)", m_nb_hits),
+                     (int) (100.0 * a_nb_handled / a_nb_total),
+                     (int) m_nb_hits);
+        m_progress_bar->set_text (text);
+        NEMIVER_CATCH
+    }
+
+    /// Show the first occurrence of the pattern found in the hex
+    /// view.  The others are kept, to be stepped through with the
+    /// previous and next buttons.
+    void on_dump_hit (size_t a_addr)
+    {
+        NEMIVER_TRY
+        if (m_hits.size () < MAX_KEPT_HITS)
+            m_hits.push_back (a_addr);
+        if (m_nb_hits++)
+            set_range_widgets_sensitive (m_address_entry->get_sensitive ());
+        else
+            show_hit (0);
+        NEMIVER_CATCH
+    }
+
+    /// Show the occurrence number a_index of the last search in the
+    /// hex view.
+    void show_hit (size_t a_index)
+    {
+        THROW_IF_FAIL (a_index < m_hits.size ());
+        THROW_IF_FAIL (m_address_entry && m_progress_bar);
+        m_cur_hit = a_index;
+        ostringstream addr;
+        addr << std::showbase << std::hex << m_hits[a_index];
+        m_address_entry->set_text (addr.str ());
+        do_memory_read ();
+        // While the search runs, the progress is shown instead.
+        if (!m_dumper->is_running ()) {
+            UString text;
+            text.printf (_("Hit %d of %d"),
+                         (int) a_index + 1, (int) m_nb_hits);
+            m_progress_bar->set_text (text);
+        }
+        set_range_widgets_sensitive (m_address_entry->get_sensitive ());
+    }
+
+    void on_prev_hit_clicked ()
+    {
+        LOG_FUNCTION_SCOPE_NORMAL_DD;
+        NEMIVER_TRY
+        if (m_cur_hit > 0)
+            show_hit (m_cur_hit - 1);
+        NEMIVER_CATCH
+    }
+
+    void on_next_hit_clicked ()
+    {
+        LOG_FUNCTION_SCOPE_NORMAL_DD;
+        NEMIVER_TRY
+        if (m_cur_hit + 1 < m_hits.size ())
+            show_hit (m_cur_hit + 1);
+        NEMIVER_CATCH
+    }
+
+    void on_dump_finished (size_t a_nb_read,
+                           size_t a_nb_unreadable,
+                           bool a_cancelled)
+    {
+        NEMIVER_TRY
+        THROW_IF_FAIL (m_progress_bar);
+        UString text;
+        if (a_cancelled) {
+            text = _("Cancelled");
+        } else if (a_nb_unreadable) {
+            text.printf (_("%lu bytes read, %lu unreadable, %d hits"),
+                         (unsigned long) a_nb_read,
+                         (unsigned long) a_nb_unreadable,
+                         (int) m_nb_hits);
+        } else {
+            text.printf (_("%lu bytes read, %d hits"),
+                         (unsigned long) a_nb_read,
+                         (int) m_nb_hits);
+        }
+        if (!a_cancelled)
+            m_progress_bar->set_fraction (1);
+        m_progress_bar->set_text (text);
+        set_range_widgets_sensitive (m_address_entry->get_sensitive ());
+        NEMIVER_CATCH
     }
 
     void on_memory_read_response (size_t a_addr,
@@ -269,15 +638,62 @@ public:
     {
         LOG_FUNCTION_SCOPE_NORMAL_DD;
         THROW_IF_FAIL (m_document);
+        THROW_IF_FAIL (m_editor);
         // don't want to set memory in gdb in response to data read from gdb
         signal_document_changed_connection.block ();
-        m_document->clear ();
-        m_editor->set_starting_offset (a_start_addr);
-        m_document->set_data (0 /*offset*/,
-                              a_data.size (),
-                              0 /*rep_len*/,
-                              &a_data[0]);
+        std::vector<ByteRange> changed_ranges;
+        size_t nb_changed = 0;
+        if (!m_snapshot.empty ()
+            && a_start_addr == m_snapshot_addr
+            && a_data.size () == m_snapshot.size ()) {
+            // Same memory as before: only push the bytes that
+            // changed, so the hex editor doesn't redraw everything.
+            nb_changed = find_changed_ranges (m_snapshot, a_data,
+                                              changed_ranges);
+            for (std::vector<ByteRange>::const_iterator it =
+                     changed_ranges.begin ();
+                 it != changed_ranges.end ();
+                 ++it) {
+                size_t len = it->second - it->first;
+                m_document->set_data (it->first, len, len /*rep_len*/,
+                                      &a_data[it->first]);
+            }
+        } else {
+            m_document->clear ();
+            m_editor->set_starting_offset (a_start_addr);
+            if (!a_data.empty ())
+                m_document->set_data (0 /*offset*/,
+                                      a_data.size (),
+                                      0 /*rep_len*/,
+                                      &a_data[0]);
+        }
+        m_snapshot_addr = a_start_addr;
+        m_snapshot = a_data;
         signal_document_changed_connection.unblock ();
+        show_changes (changed_ranges, nb_changed);
+    }
+
+    /// Highlight the bytes that changed since the previous stop.
+    /// GtkHex only has one highlighted range, its selection, so
+    /// that's the span of the changed bytes; the label next to the
+    /// address entry tells how many bytes actually changed.
+    void show_changes (const std::vector<ByteRange> &a_ranges,
+                       size_t a_nb_changed)
+    {
+        THROW_IF_FAIL (m_editor && m_changes_label);
+        if (a_ranges.empty ()) {
+            m_editor->clear_selection ();
+            m_changes_label->set_text ("");
+            return;
+        }
+        m_editor->set_selection (a_ranges.front ().first,
+                                 a_ranges.back ().second - 1);
+        UString msg;
+        msg.printf (ngettext ("%d byte changed",
+                              "%d bytes changed",
+                              a_nb_changed),
+                    (int) a_nb_changed);
+        m_changes_label->set_text (msg);
     }
 
     void on_document_changed (HexChangeData* a_change_data)
@@ -288,6 +704,11 @@ public:
                 m_document->get_data (a_change_data->start, length);
         if (new_data) {
             std::vector<uint8_t> data(new_data, new_data + length);
+            // Keep the snapshot in sync with what the user typed, so
+            // that if the write fails, the next read shows it.
+            if (a_change_data->start + length <= m_snapshot.size ())
+                std::copy (data.begin (), data.end (),
+                           m_snapshot.begin () + a_change_data->start);
             // set data in the debugger
             m_debugger->set_memory
                 (static_cast<size_t> (get_address () + a_change_data->start),
@@ -297,8 +718,9 @@ public:
 
 };
 
-MemoryView::MemoryView (IDebuggerSafePtr& a_debugger) :
-    m_priv (new Priv(a_debugger))
+MemoryView::MemoryView (IDebuggerSafePtr& a_debugger,
+                        RefreshScheduler &a_refresh_scheduler) :
+    m_priv (new Priv(a_debugger, a_refresh_scheduler))
 {
 }
 
@@ -318,6 +740,14 @@ MemoryView::clear ()
     THROW_IF_FAIL (m_priv && m_priv->m_document && m_priv->m_address_entry);
     m_priv->m_document->set_data (0, 0, 0, 0, false);
     m_priv->m_address_entry->set_text ("");
+    m_priv->m_snapshot.clear ();
+    m_priv->m_snapshot_addr = 0;
+    THROW_IF_FAIL (m_priv->m_dumper && m_priv->m_progress_bar);
+    m_priv->m_dumper->cancel ();
+    m_priv->m_progress_bar->set_fraction (0);
+    m_priv->m_progress_bar->set_text ("");
+    THROW_IF_FAIL (m_priv->m_changes_label);
+    m_priv->m_changes_label->set_text ("");
 }
 
 void
@@ -35,6 +35,8 @@ using nemiver::common::SafePtr;
 
 namespace nemiver {
 
+class RefreshScheduler;
+
 class NEMIVER_API MemoryView : public nemiver::common::Object {
     // non-copyable
     MemoryView (const MemoryView&);
@@ -44,7 +46,8 @@ class NEMIVER_API MemoryView : public nemiver::common::Object {
     SafePtr<Priv> m_priv;
 
     public:
-    MemoryView (IDebuggerSafePtr& a_debugger);
+    MemoryView (IDebuggerSafePtr& a_debugger,
+                RefreshScheduler &a_refresh_scheduler);
     virtual ~MemoryView ();
     Gtk::Widget& widget () const;
     void clear ();
@@ -50,12 +50,14 @@ class OpenFileDialog::Priv {
 public:
 
     Priv (const Glib::RefPtr<Gtk::Builder> &a_gtkbuilder,
-          IDebuggerSafePtr &a_debugger, const UString &a_working_dir) :
+          IDebuggerSafePtr &a_debugger,
+          SourceFileIndex &a_index,
+          const UString &a_working_dir) :
         vbox_file_list (0),
         radio_button_file_list (0),
         radio_button_chooser (0),
         file_chooser(Gtk::FILE_CHOOSER_ACTION_OPEN),
-        file_list(a_debugger, a_working_dir),
+        file_list(a_debugger, a_index, a_working_dir),
         okbutton (0),
         debugger (a_debugger.get ())
     {
@@ -237,16 +239,21 @@ public:
 ///
 /// \param a_debugger the IDebugger interface to use.
 ///
+/// \param a_index the cache of the source files of the program
+/// being debugged.
+///
 /// \param a_working_dir the directory to consider as the current
 /// working directory.
 OpenFileDialog::OpenFileDialog (Gtk::Window &a_parent,
                                 const UString &a_root_path,
                                 IDebuggerSafePtr &a_debugger,
+                                SourceFileIndex &a_index,
                                 const UString  &a_working_dir) :
     Dialog (a_root_path, "openfiledialog.ui",
             "dialog_open_source_file", a_parent)
 {
-    m_priv.reset (new Priv (gtkbuilder (), a_debugger, a_working_dir));
+    m_priv.reset (new Priv (gtkbuilder (), a_debugger,
+                            a_index, a_working_dir));
 }
 
 OpenFileDialog::~OpenFileDialog ()
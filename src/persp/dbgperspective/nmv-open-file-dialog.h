@@ -38,6 +38,8 @@ class UString;
 using nemiver::common::UString;
 using nemiver::common::SafePtr;
 
+class SourceFileIndex;
+
 class OpenFileDialog : public Dialog {
     class Priv;
     SafePtr<Priv> m_priv;
@@ -46,6 +48,7 @@ public:
     OpenFileDialog (Gtk::Window &a_parent,
                     const UString &a_resource_root_path,
                     IDebuggerSafePtr& a_debugger,
+                    SourceFileIndex &a_index,
                     const UString &a_working_dir);
     virtual ~OpenFileDialog ();
 
@@ -98,6 +98,8 @@ public:
     Gtk::SpinButton  *default_num_asm_instrs_spin_button;
     Gtk::FileChooserButton *gdb_binary_path_chooser_button;
     Gtk::CheckButton *pretty_printing_check_button;
+    Gtk::SpinButton *pretty_printing_max_children_spin_button;
+    Gtk::CheckButton *non_stop_mode_check_button;
     Glib::RefPtr<Gtk::Builder> gtkbuilder;
     SafePtr<LayoutSelector> layout_selector;
 
@@ -126,6 +128,8 @@ public:
         default_num_asm_instrs_spin_button (0),
         gdb_binary_path_chooser_button (0),
         pretty_printing_check_button (0),
+        pretty_printing_max_children_spin_button (0),
+        non_stop_mode_check_button (0),
         gtkbuilder (a_gtkbuilder)
     {
         init ();
@@ -269,6 +273,18 @@ public:
         update_pretty_printing_key ();
     }
 
+    void
+    on_pretty_printing_max_children_value_changed_signal ()
+    {
+        update_pretty_printing_max_children_key ();
+    }
+
+    void
+    on_non_stop_mode_toggled_signal ()
+    {
+        update_non_stop_mode_key ();
+    }
+
     void
     init ()
     {
@@ -505,6 +521,28 @@ public:
              (*this,
               &PreferencesDialog::Priv::on_pretty_printing_toggled_signal));
 
+        pretty_printing_max_children_spin_button =
+            ui_utils::get_widget_from_gtkbuilder<Gtk::SpinButton>
+            (gtkbuilder,
+             "prettyprintingmaxchildrenspin");
+        THROW_IF_FAIL (pretty_printing_max_children_spin_button);
+        pretty_printing_max_children_spin_button->set_range (0, G_MAXINT);
+        pretty_printing_max_children_spin_button->set_increments (100, 1000);
+        pretty_printing_max_children_spin_button->signal_value_changed ().connect
+            (sigc::mem_fun
+             (*this,
+              &PreferencesDialog::Priv::
+                  on_pretty_printing_max_children_value_changed_signal));
+
+        non_stop_mode_check_button =
+            ui_utils::get_widget_from_gtkbuilder<Gtk::CheckButton>
+            (gtkbuilder,
+             "nonstopmodecheckbutton");
+        THROW_IF_FAIL (non_stop_mode_check_button);
+        non_stop_mode_check_button->signal_toggled ().connect
+            (sigc::mem_fun
+             (*this,
+              &PreferencesDialog::Priv::on_non_stop_mode_toggled_signal));
 
         // *************************************
         // Handle the "Layout" preferences tab
@@ -749,6 +787,25 @@ public:
         conf_manager ().set_key_value (CONF_KEY_PRETTY_PRINTING, is_on);
     }
 
+    void
+    update_pretty_printing_max_children_key ()
+    {
+        THROW_IF_FAIL (pretty_printing_max_children_spin_button);
+
+        int num = pretty_printing_max_children_spin_button->get_value_as_int ();
+        conf_manager ().set_key_value (CONF_KEY_PRETTY_PRINTING_MAX_CHILDREN,
+                                       num);
+    }
+
+    void
+    update_non_stop_mode_key ()
+    {
+        THROW_IF_FAIL (non_stop_mode_check_button);
+
+        bool is_on = non_stop_mode_check_button->get_active ();
+        conf_manager ().set_key_value (CONF_KEY_NON_STOP_MODE, is_on);
+    }
+
     void
     update_widget_from_editor_keys ()
     {
@@ -906,6 +963,23 @@ public:
                        << CONF_KEY_PRETTY_PRINTING);
         }
         pretty_printing_check_button->set_active (is_on);
+
+        int max_children = 1000;
+        if (!conf_manager ().get_key_value
+                                (CONF_KEY_PRETTY_PRINTING_MAX_CHILDREN,
+                                 max_children)) {
+            LOG_ERROR ("failed to get conf key "
+                       << CONF_KEY_PRETTY_PRINTING_MAX_CHILDREN);
+        }
+        pretty_printing_max_children_spin_button->set_value (max_children);
+
+        is_on = false;
+        if (!conf_manager ().get_key_value (CONF_KEY_NON_STOP_MODE,
+                                            is_on)) {
+            LOG_ERROR ("failed to get conf key "
+                       << CONF_KEY_NON_STOP_MODE);
+        }
+        non_stop_mode_check_button->set_active (is_on);
     }
 
     void
@@ -0,0 +1,257 @@
+/*
+ *This file is part of the Nemiver project
+ *
+ *Nemiver is free software; you can redistribute
+ *it and/or modify it under the terms of
+ *the GNU General Public License as published by the
+ *Free Software Foundation; either version 2,
+ *or (at your option) any later version.
+ *
+ *Nemiver is distributed in the hope that it will
+ *be useful, but WITHOUT ANY WARRANTY;
+ *without even the implied warranty of
+ *MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ *See the GNU General Public License for more details.
+ *
+ *You should have received a copy of the
+ *GNU General Public License along with Nemiver;
+ *see the file COPYING.
+ *If not, write to the Free Software Foundation,
+ *Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+ *
+ *See COPYRIGHT file copyright information.
+ */
+#include "config.h"
+#include <glibmm/main.h>
+#include "common/nmv-exception.h"
+#include "nmv-refresh-scheduler.h"
+
+NEMIVER_BEGIN_NAMESPACE (nemiver)
+
+// The period of the refresh tick, in milliseconds.  That's about the
+// period of a frame of the display.
+static const unsigned REFRESH_TICK_PERIOD = 16;
+
+struct RefreshScheduler::Priv : public sigc::trackable {
+    IDebuggerSafePtr debugger;
+    mutable StoppedSignal stopped_signal;
+    sigc::connection tick_connection;
+
+    // The last stop, that is waiting for the next refresh tick.
+    IDebugger::StopReason reason;
+    bool has_frame;
+    IDebugger::Frame frame;
+    int thread_id;
+    string bp_num;
+    UString cookie;
+
+    unsigned long nb_stops;
+    unsigned long nb_refreshes;
+    unsigned long nb_superseded_stops;
+    unsigned long nb_dropped_commands;
+
+    Priv (IDebuggerSafePtr &a_debugger) :
+        debugger (a_debugger),
+        reason (IDebugger::UNDEFINED_REASON),
+        has_frame (false),
+        thread_id (-1),
+        nb_stops (0),
+        nb_refreshes (0),
+        nb_superseded_stops (0),
+        nb_dropped_commands (0)
+    {
+        THROW_IF_FAIL (debugger);
+        debugger->stopped_signal ().connect
+            (sigc::mem_fun (*this, &Priv::on_debugger_stopped_signal));
+        debugger->running_signal ().connect
+            (sigc::mem_fun (*this, &Priv::on_debugger_running_signal));
+    }
+
+    ~Priv ()
+    {
+        tick_connection.disconnect ();
+    }
+
+    bool is_pending () const
+    {
+        return tick_connection.connected ();
+    }
+
+    void on_debugger_stopped_signal (IDebugger::StopReason a_reason,
+                                     bool a_has_frame,
+                                     const IDebugger::Frame &a_frame,
+                                     int a_thread_id,
+                                     const string &a_bp_num,
+                                     const UString &a_cookie)
+    {
+        LOG_FUNCTION_SCOPE_NORMAL_DD;
+
+        NEMIVER_TRY
+
+        ++nb_stops;
+
+        if (IDebugger::is_exited (a_reason)) {
+            cancel ();
+            stopped_signal.emit (a_reason, a_has_frame, a_frame,
+                                 a_thread_id, a_bp_num, a_cookie);
+            return;
+        }
+
+        if (is_pending ())
+            ++nb_superseded_stops;
+
+        reason = a_reason;
+        has_frame = a_has_frame;
+        frame = a_frame;
+        thread_id = a_thread_id;
+        bp_num = a_bp_num;
+        cookie = a_cookie;
+
+        if (!is_pending ())
+            tick_connection = Glib::signal_timeout ().connect
+                (sigc::mem_fun (*this, &Priv::on_tick),
+                 REFRESH_TICK_PERIOD);
+
+        NEMIVER_CATCH
+    }
+
+    void on_debugger_running_signal ()
+    {
+        LOG_FUNCTION_SCOPE_NORMAL_DD;
+
+        // The inferior got resumed before the panes were refreshed
+        // for the last stop.  No need to refresh them for that stop
+        // anymore.
+        if (is_pending ()) {
+            ++nb_superseded_stops;
+            cancel ();
+        }
+
+        // Nor to send the commands the panes queued for the previous
+        // refresh after the inferior was resumed.  The engine already
+        // dropped those that were queued before.
+        nb_dropped_commands += debugger->drop_refresh_commands ();
+    }
+
+    bool on_tick ()
+    {
+        LOG_FUNCTION_SCOPE_NORMAL_DD;
+
+        NEMIVER_TRY
+
+        // Let the refresh wait for the commands the user just issued,
+        // if any.  The inferior may be resumed by them, in which case
+        // the refresh is going to be dropped.
+        if (debugger->get_state () != IDebugger::READY)
+            return true;
+
+        flush ();
+
+        NEMIVER_CATCH
+
+        return false;
+    }
+
+    void flush ()
+    {
+        if (!is_pending ())
+            return;
+        cancel ();
+        ++nb_refreshes;
+        LOG_DD ("refreshing for the last of "
+                << nb_stops << " stops, "
+                << nb_refreshes << " refreshes, "
+                << nb_superseded_stops << " superseded stops so far");
+        // Have the commands the panes queue to refresh themselves
+        // marked as such, so that they get dropped if the inferior
+        // is resumed before they are sent.
+        debugger->set_refreshing (true);
+        try {
+            stopped_signal.emit (reason, has_frame, frame,
+                                 thread_id, bp_num, cookie);
+        } catch (...) {
+            debugger->set_refreshing (false);
+            throw;
+        }
+        debugger->set_refreshing (false);
+    }
+
+    void cancel ()
+    {
+        tick_connection.disconnect ();
+    }
+};//end struct RefreshScheduler::Priv
+
+RefreshScheduler::RefreshScheduler (IDebuggerSafePtr &a_debugger)
+{
+    m_priv.reset (new Priv (a_debugger));
+}
+
+RefreshScheduler::~RefreshScheduler ()
+{
+}
+
+/// The signal emitted, at most once per refresh tick, for the last
+/// stop of the inferior.  Its parameters are the same as those of
+/// IDebugger::stopped_signal.
+RefreshScheduler::StoppedSignal&
+RefreshScheduler::stopped_signal () const
+{
+    THROW_IF_FAIL (m_priv);
+    return m_priv->stopped_signal;
+}
+
+/// Emit the pending refresh right away, if any.
+void
+RefreshScheduler::flush ()
+{
+    THROW_IF_FAIL (m_priv);
+    m_priv->flush ();
+}
+
+/// Drop the pending refresh, if any.
+void
+RefreshScheduler::cancel ()
+{
+    THROW_IF_FAIL (m_priv);
+    m_priv->cancel ();
+}
+
+/// \return the number of stops of the inferior seen so far.
+unsigned long
+RefreshScheduler::nb_stops () const
+{
+    THROW_IF_FAIL (m_priv);
+    return m_priv->nb_stops;
+}
+
+/// \return the number of refreshes emitted so far.
+unsigned long
+RefreshScheduler::nb_refreshes () const
+{
+    THROW_IF_FAIL (m_priv);
+    return m_priv->nb_refreshes;
+}
+
+/// \return the number of stops for which no refresh was emitted
+/// because they got superseded by another stop, or by the inferior
+/// being resumed.
+unsigned long
+RefreshScheduler::nb_superseded_stops () const
+{
+    THROW_IF_FAIL (m_priv);
+    return m_priv->nb_superseded_stops;
+}
+
+/// \return the number of commands queued by the panes to refresh
+/// themselves that were dropped because the inferior got resumed
+/// before they were sent.  Those dropped by the engine as the
+/// inferior was resumed are not counted.
+unsigned long
+RefreshScheduler::nb_dropped_commands () const
+{
+    THROW_IF_FAIL (m_priv);
+    return m_priv->nb_dropped_commands;
+}
+
+NEMIVER_END_NAMESPACE (nemiver)
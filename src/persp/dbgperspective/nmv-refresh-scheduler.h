@@ -0,0 +1,82 @@
+/*
+ *This file is part of the Nemiver project
+ *
+ *Nemiver is free software; you can redistribute
+ *it and/or modify it under the terms of
+ *the GNU General Public License as published by the
+ *Free Software Foundation; either version 2,
+ *or (at your option) any later version.
+ *
+ *Nemiver is distributed in the hope that it will
+ *be useful, but WITHOUT ANY WARRANTY;
+ *without even the implied warranty of
+ *MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ *See the GNU General Public License for more details.
+ *
+ *You should have received a copy of the
+ *GNU General Public License along with Nemiver;
+ *see the file COPYING.
+ *If not, write to the Free Software Foundation,
+ *Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+ *
+ *See COPYRIGHT file copyright information.
+ */
+#ifndef __NMV_REFRESH_SCHEDULER_H__
+#define __NMV_REFRESH_SCHEDULER_H__
+
+#include "common/nmv-object.h"
+#include "common/nmv-safe-ptr-utils.h"
+#include "nmv-i-debugger.h"
+
+NEMIVER_BEGIN_NAMESPACE (nemiver)
+
+/// Coalesces the stops of the inferior into refreshes of the panes
+/// of the perspective.
+///
+/// Rather than reacting to each IDebugger::stopped_signal, the panes
+/// (call stack, variables, registers, etc.) react to the
+/// RefreshScheduler::stopped_signal.  That signal is emitted at most
+/// once per refresh tick, for the last stop that happened during the
+/// tick.  If the inferior is resumed before the tick, e.g. because
+/// the user keeps stepping, the refresh for the superseded stop is
+/// just dropped, so the panes don't send GDB commands for states of
+/// the inferior nobody will ever look at.  Likewise, the commands the
+/// panes queued for a refresh are dropped if the inferior is resumed
+/// before they could be sent.
+///
+/// Stops due to the inferior exiting are forwarded right away.
+class NEMIVER_API RefreshScheduler : public common::Object {
+    //non copyable
+    RefreshScheduler (const RefreshScheduler&);
+    RefreshScheduler& operator= (const RefreshScheduler&);
+
+    struct Priv;
+    SafePtr<Priv> m_priv;
+
+public:
+
+    typedef sigc::signal<void,
+                         IDebugger::StopReason /*reason*/,
+                         bool /*has frame*/,
+                         const IDebugger::Frame&/*the frame*/,
+                         int /*thread id*/,
+                         const string& /*breakpoint number*/,
+                         const UString& /*cookie*/> StoppedSignal;
+
+    RefreshScheduler (IDebuggerSafePtr &a_debugger);
+    virtual ~RefreshScheduler ();
+
+    StoppedSignal& stopped_signal () const;
+
+    void flush ();
+    void cancel ();
+
+    unsigned long nb_stops () const;
+    unsigned long nb_refreshes () const;
+    unsigned long nb_superseded_stops () const;
+    unsigned long nb_dropped_commands () const;
+};//end class RefreshScheduler
+
+NEMIVER_END_NAMESPACE (nemiver)
+
+#endif //__NMV_REFRESH_SCHEDULER_H__
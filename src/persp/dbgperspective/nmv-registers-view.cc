@@ -31,14 +31,19 @@
 #include "nmv-ui-utils.h"
 #include "nmv-i-workbench.h"
 #include "nmv-i-perspective.h"
+#include "nmv-refresh-scheduler.h"
 
 namespace nemiver {
 
+// The cookie of the register values requests issued by this view.
+static const char* REGISTERS_VIEW_COOKIE = "registers-view";
+
 struct RegisterColumns : public Gtk::TreeModelColumnRecord {
     Gtk::TreeModelColumn<IDebugger::register_id_t> id;
     Gtk::TreeModelColumn<Glib::ustring> name;
     Gtk::TreeModelColumn<Glib::ustring> value;
     Gtk::TreeModelColumn<Gdk::Color> fg_color;
+    Gtk::TreeModelColumn<bool> is_highlighted;
 
     RegisterColumns ()
     {
@@ -46,6 +51,7 @@ struct RegisterColumns : public Gtk::TreeModelColumnRecord {
         add (name);
         add (value);
         add (fg_color);
+        add (is_highlighted);
     }
 };//end Cols
 
@@ -63,10 +69,24 @@ public:
     IDebuggerSafePtr& debugger;
     bool is_up2date;
     bool first_run;
-    Priv (IDebuggerSafePtr& a_debugger) :
+    // Incremented each time the inferior stops.
+    int stop_serial;
+    // For each register, the serial of the stop at which its value
+    // was last requested.  Registers which value has not been
+    // requested since the last stop are fetched when they get
+    // scrolled into view.
+    std::map<IDebugger::register_id_t, int> fetch_serials;
+    // Measures the time elapsed between a stop and the moment the
+    // registers shown got refreshed.
+    Glib::Timer stop_timer;
+    bool stop_timer_pending;
+    Priv (IDebuggerSafePtr& a_debugger,
+          RefreshScheduler &a_refresh_scheduler) :
         debugger(a_debugger),
         is_up2date (true),
-        first_run (true)
+        first_run (true),
+        stop_serial (0),
+        stop_timer_pending (false)
     {
         build_tree_view ();
 
@@ -75,18 +95,22 @@ public:
         debugger->register_names_listed_signal ().connect
             (sigc::mem_fun
                     (*this, &Priv::on_debugger_registers_listed));
-        debugger->changed_registers_listed_signal ().connect
-            (sigc::mem_fun
-                    (*this, &Priv::on_debugger_changed_registers_listed));
         debugger->register_values_listed_signal ().connect
             (sigc::mem_fun
                     (*this, &Priv::on_debugger_register_values_listed));
         debugger->register_value_changed_signal ().connect
             (sigc::mem_fun
                     (*this, &Priv::on_debugger_register_value_changed));
-        debugger->stopped_signal ().connect
+        a_refresh_scheduler.stopped_signal ().connect
             (sigc::mem_fun
                     (*this, &Priv::on_debugger_stopped));
+
+        // The view is built the first time it's shown, which can be
+        // long after the inferior stopped.  In that case, fetch the
+        // registers as soon as the view gets drawn.
+        if (debugger->is_attached_to_target ()
+            && debugger->get_state () == IDebugger::READY)
+            is_up2date = false;
     }
 
     void build_tree_view ()
@@ -128,9 +152,57 @@ public:
         LOG_FUNCTION_SCOPE_NORMAL_DD;
         if (first_run) {
             first_run = false;
+            // The debugger caches the register names, so this only
+            // costs a round trip the first time around.
             debugger->list_register_names ();
         } else {
-            debugger->list_changed_registers ();
+            fetch_visible_registers ();
+        }
+    }
+
+    /// Request the values of the registers which rows are currently
+    /// visible and haven't been requested since the last stop, using
+    /// a single -data-list-register-values command.
+    ///
+    /// The registers that are not visible are not fetched at all;
+    /// they are fetched when they get scrolled into view.  That way,
+    /// the hundreds of (wide) vector registers of some architectures
+    /// don't cost anything unless the user looks at them.
+    void fetch_visible_registers ()
+    {
+        LOG_FUNCTION_SCOPE_NORMAL_DD;
+        THROW_IF_FAIL (tree_view && list_store);
+
+        // GDB can't read the registers while the inferior runs.  The
+        // visible ones are fetched once it stops.
+        if (debugger->get_state () != IDebugger::READY)
+            return;
+
+        Gtk::TreeModel::Path start, end;
+        if (!tree_view->get_visible_range (start, end)) {
+            // The rows are not laid out yet; we'll get called again
+            // from the draw handler.
+            return;
+        }
+
+        std::list<IDebugger::register_id_t> regs;
+        Gtk::TreeModel::iterator it = list_store->get_iter (start);
+        Gtk::TreeModel::iterator end_it = list_store->get_iter (end);
+        for (; it; ++it) {
+            IDebugger::register_id_t id = (*it)[get_columns ().id];
+            std::map<IDebugger::register_id_t, int>::iterator serial_it =
+                fetch_serials.find (id);
+            if (serial_it == fetch_serials.end ()
+                || serial_it->second != stop_serial) {
+                fetch_serials[id] = stop_serial;
+                regs.push_back (id);
+            }
+            if (it == end_it)
+                break;
+        }
+        if (!regs.empty ()) {
+            LOG_DD ("fetching " << (int) regs.size () << " registers");
+            debugger->list_register_values (regs, REGISTERS_VIEW_COOKIE);
         }
     }
 
@@ -147,6 +219,9 @@ public:
             || a_reason == IDebugger::EXITED) {
             return;
         }
+        ++stop_serial;
+        stop_timer.start ();
+        stop_timer_pending = true;
         if (should_process_now ()) {
             finish_handling_debugger_stopped_event ();
         } else {
@@ -164,6 +239,7 @@ public:
         THROW_IF_FAIL (list_store);
         if (a_cookie.empty ()) {}
         list_store->clear ();
+        fetch_serials.clear ();
         LOG_DD ("got num registers: " << (int)a_regs.size ());
         std::map<IDebugger::register_id_t, UString>::const_iterator reg_iter;
         for (reg_iter = a_regs.begin ();
@@ -172,23 +248,12 @@ public:
             Gtk::TreeModel::iterator tree_iter = list_store->append ();
             (*tree_iter)[get_columns ().id] = reg_iter->first;
             (*tree_iter)[get_columns ().name] = reg_iter->second;
+            (*tree_iter)[get_columns ().fg_color] = get_normal_fg_color ();
             LOG_DD ("got register: " << reg_iter->second);
         }
-        debugger->list_register_values ("first-time");
-        NEMIVER_CATCH
-    }
-
-    void on_debugger_changed_registers_listed
-            (std::list<IDebugger::register_id_t> a_regs,
-             const UString &a_cookie)
-    {
-        LOG_FUNCTION_SCOPE_NORMAL_DD;
-        NEMIVER_TRY
-        if (a_cookie.empty()) {}
-        if (!a_regs.empty ()) {
-            debugger->list_register_values (a_regs);
-        }
-
+        // If the debugger is still busy answering, this fetches
+        // nothing; the draw of the new rows does, once it's ready.
+        fetch_visible_registers ();
         NEMIVER_CATCH
     }
 
@@ -205,17 +270,27 @@ public:
             IDebugger::register_id_t id = (*tree_iter)[get_columns ().id];
             std::map<IDebugger::register_id_t, UString>::const_iterator
                                         value_iter = a_reg_values.find (id);
-            if (value_iter != a_reg_values.end ()) {
+            if (value_iter == a_reg_values.end ())
+                continue;
+            // Only touch the rows which value actually changed, and
+            // highlight them unless this is the first value we get
+            // for the register.
+            UString prev_value =
+                (Glib::ustring) (*tree_iter)[get_columns ().value];
+            if (prev_value != value_iter->second) {
                 (*tree_iter)[get_columns ().value] = value_iter->second;
-                if (a_cookie != "first-time") {
-                    set_changed (tree_iter);
-                } else {
-                    set_changed (tree_iter, false);
-                }
+                set_changed (tree_iter, !prev_value.empty ());
             } else {
                 set_changed (tree_iter, false);
             }
         }
+
+        if (a_cookie == REGISTERS_VIEW_COOKIE && stop_timer_pending) {
+            stop_timer_pending = false;
+            LOG_DD ("registers refreshed "
+                    << stop_timer.elapsed () * 1000
+                    << "ms after the stop");
+        }
         NEMIVER_CATCH
     }
 
@@ -268,9 +343,16 @@ public:
         LOG_FUNCTION_SCOPE_NORMAL_DD;
 
         NEMIVER_TRY
+        // Scrolling while the inferior runs must not send anything
+        // to GDB.
+        if (debugger->get_state () != IDebugger::READY)
+            return;
         if (!is_up2date) {
             finish_handling_debugger_stopped_event ();
             is_up2date = true;
+        } else if (!first_run) {
+            // Registers might have been scrolled into view.
+            fetch_visible_registers ();
         }
         NEMIVER_CATCH
     }
@@ -279,25 +361,35 @@ public:
     // normal color to indicate whether it has changed since last update
     void set_changed (Gtk::TreeModel::iterator& iter, bool changed = true)
     {
+        bool is_highlighted = (*iter)[get_columns ().is_highlighted];
+        if (is_highlighted == changed)
+            return;
+        (*iter)[get_columns ().is_highlighted] = changed;
         if (changed) {
             (*iter)[get_columns ().fg_color]  = Gdk::Color ("red");
         } else {
-            Gdk::RGBA rgba =
-                tree_view->get_style_context ()->get_color
-                                                    (Gtk::STATE_FLAG_NORMAL);
-            Gdk::Color color;
-            color.set_rgb (rgba.get_red (),
-                           rgba.get_green (),
-                           rgba.get_blue ());
-            (*iter)[get_columns ().fg_color] = color;
+            (*iter)[get_columns ().fg_color] = get_normal_fg_color ();
         }
     }
 
+    Gdk::Color get_normal_fg_color ()
+    {
+        Gdk::RGBA rgba =
+            tree_view->get_style_context ()->get_color
+                                                (Gtk::STATE_FLAG_NORMAL);
+        Gdk::Color color;
+        color.set_rgb (rgba.get_red (),
+                       rgba.get_green (),
+                       rgba.get_blue ());
+        return color;
+    }
+
 };//end class RegistersView::Priv
 
-RegistersView::RegistersView (IDebuggerSafePtr& a_debugger)
+RegistersView::RegistersView (IDebuggerSafePtr& a_debugger,
+                              RefreshScheduler &a_refresh_scheduler)
 {
-    m_priv.reset (new Priv (a_debugger));
+    m_priv.reset (new Priv (a_debugger, a_refresh_scheduler));
 }
 
 RegistersView::~RegistersView ()
@@ -320,6 +412,7 @@ RegistersView::clear ()
     THROW_IF_FAIL (m_priv && m_priv->list_store);
 
     m_priv->list_store->clear ();
+    m_priv->fetch_serials.clear ();
     // next time the wiget is used, we'll need to initialize it
     // again. So mark it as such.
     m_priv->first_run = true;
@@ -69,6 +69,8 @@ public:
     Gtk::RadioButton *radio_binary_location;
     Gtk::RadioButton *radio_event;
     Gtk::CheckButton *check_countpoint;
+    Gtk::CheckButton *check_dprintf;
+    Gtk::Entry *entry_dprintf;
     Gtk::Button *okbutton;
 
 public:
@@ -84,6 +86,8 @@ public:
         radio_binary_location (0),
         radio_event (0),
         check_countpoint (0),
+        check_dprintf (0),
+        entry_dprintf (0),
         okbutton (0)
     {
         a_dialog.set_default_response (Gtk::RESPONSE_OK);
@@ -196,6 +200,19 @@ public:
             ui_utils::get_widget_from_gtkbuilder<Gtk::CheckButton>
             (a_gtkbuilder, "countpointcheck");
 
+        check_dprintf =
+            ui_utils::get_widget_from_gtkbuilder<Gtk::CheckButton>
+            (a_gtkbuilder, "dprintfcheck");
+        check_dprintf->signal_toggled ().connect (sigc::mem_fun
+                (*this, &Priv::on_radiobutton_changed));
+
+        entry_dprintf =
+            ui_utils::get_widget_from_gtkbuilder<Gtk::Entry>
+            (a_gtkbuilder, "dprintfentry");
+        entry_dprintf->signal_changed ().connect (sigc::mem_fun
+                (*this, &Priv::on_text_changed_signal));
+        entry_dprintf->set_activates_default ();
+
         // set the 'function name' mode active by default
         mode (MODE_FUNCTION_NAME);
         // hack to ensure that the correct text entry fields
@@ -244,6 +261,14 @@ public:
 
         SetBreakpointDialog::Mode a_mode = mode ();
 
+        // A dprintf without a message to log would be useless.
+        if (a_mode != MODE_EVENT
+            && check_dprintf->get_active ()
+            && entry_dprintf->get_text ().empty ()) {
+            okbutton->set_sensitive (false);
+            return;
+        }
+
         switch (a_mode) {
         case MODE_SOURCE_LOCATION: {
             // make sure there's something in the line number entry,
@@ -305,7 +330,11 @@ public:
         entry_address->set_sensitive (a_mode == MODE_BINARY_ADDRESS);
         combo_event->set_sensitive (a_mode == MODE_EVENT);
         entry_condition->set_sensitive (a_mode != MODE_EVENT);
-        check_countpoint->set_sensitive (a_mode != MODE_EVENT);
+        check_dprintf->set_sensitive (a_mode != MODE_EVENT);
+        bool is_dprintf = a_mode != MODE_EVENT && check_dprintf->get_active ();
+        entry_dprintf->set_sensitive (is_dprintf);
+        // A dprintf never stops, so it can't count the stops either.
+        check_countpoint->set_sensitive (a_mode != MODE_EVENT && !is_dprintf);
         update_ok_button_sensitivity ();
         NEMIVER_CATCH
     }
@@ -526,6 +555,41 @@ SetBreakpointDialog::count_point (bool a_flag)
     m_priv->check_countpoint->set_active (a_flag);
 }
 
+bool
+SetBreakpointDialog::dprintf () const
+{
+    THROW_IF_FAIL (m_priv);
+    THROW_IF_FAIL (m_priv->check_dprintf);
+    return m_priv->check_dprintf->get_active ();
+}
+
+void
+SetBreakpointDialog::dprintf (bool a_flag)
+{
+    THROW_IF_FAIL (m_priv);
+    THROW_IF_FAIL (m_priv->check_dprintf);
+    m_priv->check_dprintf->set_active (a_flag);
+}
+
+/// The message a dprintf logs each time it is hit: a printf format
+/// string, in double quotes, followed by the expressions it refers
+/// to.  For instance "i = %d\n", i
+UString
+SetBreakpointDialog::dprintf_format () const
+{
+    THROW_IF_FAIL (m_priv);
+    THROW_IF_FAIL (m_priv->entry_dprintf);
+    return m_priv->entry_dprintf->get_text ();
+}
+
+void
+SetBreakpointDialog::dprintf_format (const UString &a_format)
+{
+    THROW_IF_FAIL (m_priv);
+    THROW_IF_FAIL (m_priv->entry_dprintf);
+    m_priv->entry_dprintf->set_text (a_format);
+}
+
 SetBreakpointDialog::Mode
 SetBreakpointDialog::mode () const
 {
@@ -80,6 +80,12 @@ public:
     bool count_point () const;
     void count_point (bool a_flag);
 
+    bool dprintf () const;
+    void dprintf (bool a_flag);
+
+    UString dprintf_format () const;
+    void dprintf_format (const UString &a_format);
+
     Mode mode () const;
     void mode (Mode);
 
@@ -0,0 +1,375 @@
+/*
+ *This file is part of the Nemiver project
+ *
+ *Nemiver is free software; you can redistribute
+ *it and/or modify it under the terms of
+ *the GNU General Public License as published by the
+ *Free Software Foundation; either version 2,
+ *or (at your option) any later version.
+ *
+ *Nemiver is distributed in the hope that it will
+ *be useful, but WITHOUT ANY WARRANTY;
+ *without even the implied warranty of
+ *MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ *See the GNU General Public License for more details.
+ *
+ *You should have received a copy of the
+ *GNU General Public License along with Nemiver;
+ *see the file COPYING.
+ *If not, write to the Free Software Foundation,
+ *Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+ *
+ *See COPYRIGHT file copyright information.
+ */
+#include "config.h"
+#include <algorithm>
+#include <iterator>
+#include <map>
+#include <glibmm/convert.h>
+#include <glibmm/miscutils.h>
+#include "common/nmv-exception.h"
+#include "nmv-source-file-index.h"
+
+NEMIVER_BEGIN_NAMESPACE (nemiver)
+
+typedef std::map<guint32, std::vector<unsigned> > TrigramMap;
+
+/// Fold the ASCII letters of a string to lower case.  This is what
+/// makes looking files up case insensitive.
+static std::string
+fold_case (const std::string &a_str)
+{
+    std::string result (a_str);
+    for (std::string::iterator it = result.begin (); it != result.end (); ++it)
+        *it = g_ascii_tolower (*it);
+    return result;
+}
+
+/// \return the trigram made of the three bytes starting at a_str.
+static guint32
+trigram_at (const char *a_str)
+{
+    return ((guint32) (unsigned char) a_str[0] << 16)
+            | ((guint32) (unsigned char) a_str[1] << 8)
+            | (guint32) (unsigned char) a_str[2];
+}
+
+/// \return true if the characters of a_needle appear in a_haystack,
+/// in the same order, though not necessarily next to each other.
+static bool
+is_subsequence (const std::string &a_needle, const std::string &a_haystack)
+{
+    std::string::size_type pos = 0;
+    for (std::string::const_iterator it = a_needle.begin ();
+         it != a_needle.end ();
+         ++it) {
+        pos = a_haystack.find (*it, pos);
+        if (pos == std::string::npos)
+            return false;
+        ++pos;
+    }
+    return true;
+}
+
+/// Orders indexes of base names by the base names they designate.
+struct BaseNameLess {
+    const std::vector<std::string> &names;
+
+    BaseNameLess (const std::vector<std::string> &a_names) :
+        names (a_names)
+    {
+    }
+
+    bool operator() (unsigned a_lhs, unsigned a_rhs) const
+    {
+        return names[a_lhs] < names[a_rhs];
+    }
+
+    bool operator() (unsigned a_lhs, const std::string &a_rhs) const
+    {
+        return names[a_lhs] < a_rhs;
+    }
+};//end struct BaseNameLess
+
+struct SourceFileIndex::Priv {
+    UString binary_path;
+    bool has_files;
+    // The absolute paths of the source files, sorted byte-wise so
+    // that the files of a given directory are contiguous.
+    std::vector<std::string> files;
+    // The case folded base names of the files, the indexes of the
+    // files sorted by those names, and the trigram index built from
+    // them.  They are built lazily by the first look up.
+    std::vector<std::string> folded_base_names;
+    std::vector<unsigned> sorted_base_names;
+    TrigramMap trigrams;
+    bool search_index_built;
+
+    Priv () :
+        has_files (false),
+        search_index_built (false)
+    {
+    }
+
+    void build_search_index ()
+    {
+        if (search_index_built)
+            return;
+
+        folded_base_names.reserve (files.size ());
+        sorted_base_names.reserve (files.size ());
+        for (unsigned i = 0; i < files.size (); ++i) {
+            sorted_base_names.push_back (i);
+            std::string::size_type slash = files[i].rfind ('/');
+            std::string base_name = (slash == std::string::npos)
+                ? files[i]
+                : files[i].substr (slash + 1);
+            folded_base_names.push_back (fold_case (base_name));
+
+            const std::string &name = folded_base_names.back ();
+            for (std::string::size_type j = 0; j + 3 <= name.size (); ++j) {
+                std::vector<unsigned> &postings =
+                    trigrams[trigram_at (name.c_str () + j)];
+                // A base name can contain the same trigram twice.
+                if (postings.empty () || postings.back () != i)
+                    postings.push_back (i);
+            }
+        }
+        std::sort (sorted_base_names.begin (), sorted_base_names.end (),
+                   BaseNameLess (folded_base_names));
+        search_index_built = true;
+        LOG_DD ("indexed " << (int) files.size () << " files with "
+                << (int) trigrams.size () << " trigrams");
+    }
+
+    /// \return the first of sorted_base_names which base name
+    /// starts with a_prefix, if any.  The others follow it.
+    ///
+    /// \param a_prefix the case folded prefix.
+    std::vector<unsigned>::const_iterator
+    first_with_prefix (const std::string &a_prefix) const
+    {
+        return std::lower_bound (sorted_base_names.begin (),
+                                 sorted_base_names.end (),
+                                 a_prefix,
+                                 BaseNameLess (folded_base_names));
+    }
+
+    /// \return true if the base name of the file a_file starts with
+    /// a_prefix.
+    bool has_prefix (unsigned a_file, const std::string &a_prefix) const
+    {
+        return folded_base_names[a_file].compare (0, a_prefix.size (),
+                                                  a_prefix) == 0;
+    }
+
+    /// Get the indexes of the files which base name might contain
+    /// a_query, i.e. which base name contains all the trigrams of
+    /// a_query.
+    ///
+    /// \param a_query the case folded query.  It must be at least
+    /// three bytes long.
+    ///
+    /// \param a_candidates the resulting indexes, sorted.
+    void get_trigram_candidates (const std::string &a_query,
+                                 std::vector<unsigned> &a_candidates) const
+    {
+        a_candidates.clear ();
+        bool first = true;
+        for (std::string::size_type i = 0; i + 3 <= a_query.size (); ++i) {
+            TrigramMap::const_iterator it =
+                trigrams.find (trigram_at (a_query.c_str () + i));
+            if (it == trigrams.end ()) {
+                a_candidates.clear ();
+                return;
+            }
+            if (first) {
+                a_candidates = it->second;
+                first = false;
+                continue;
+            }
+            std::vector<unsigned> intersection;
+            std::set_intersection (a_candidates.begin (), a_candidates.end (),
+                                   it->second.begin (), it->second.end (),
+                                   std::back_inserter (intersection));
+            a_candidates.swap (intersection);
+            if (a_candidates.empty ())
+                return;
+        }
+    }
+};//end struct SourceFileIndex::Priv
+
+SourceFileIndex::SourceFileIndex () :
+    m_priv (new Priv)
+{
+}
+
+SourceFileIndex::~SourceFileIndex ()
+{
+}
+
+/// Fill the index with the source files of a binary.
+///
+/// \param a_binary_path the path of the binary the files belong to.
+///
+/// \param a_files the source files, as reported by the debugging
+/// engine.  Only the absolute paths are kept.
+void
+SourceFileIndex::set_files (const UString &a_binary_path,
+                            const std::vector<UString> &a_files)
+{
+    clear ();
+    m_priv->binary_path = a_binary_path;
+    m_priv->files.reserve (a_files.size ());
+    for (std::vector<UString>::const_iterator it = a_files.begin ();
+         it != a_files.end ();
+         ++it) {
+        if (Glib::path_is_absolute (*it))
+            m_priv->files.push_back (it->raw ());
+    }
+    std::sort (m_priv->files.begin (), m_priv->files.end ());
+    m_priv->files.erase (std::unique (m_priv->files.begin (),
+                                      m_priv->files.end ()),
+                         m_priv->files.end ());
+    m_priv->has_files = true;
+}
+
+/// \return true if the index holds the source files of the binary
+/// a_binary_path.
+bool
+SourceFileIndex::is_valid_for (const UString &a_binary_path) const
+{
+    return m_priv->has_files && m_priv->binary_path == a_binary_path;
+}
+
+/// \return the absolute paths of the files of the index, sorted.
+const std::vector<std::string>&
+SourceFileIndex::files () const
+{
+    return m_priv->files;
+}
+
+/// Get the immediate children of a directory.
+///
+/// This only walks the files that are below a_dir, and skips the
+/// content of its sub-directories altogether, so listing a directory
+/// doesn't depend on how many files it contains recursively.
+///
+/// \param a_dir the absolute path of the directory.
+///
+/// \param a_children the resulting children, sub-directories and
+/// files, sorted by name.
+void
+SourceFileIndex::get_children (const std::string &a_dir,
+                               std::vector<Entry> &a_children) const
+{
+    std::string prefix = a_dir;
+    if (prefix.empty () || prefix[prefix.size () - 1] != '/')
+        prefix += '/';
+
+    const std::vector<std::string> &files = m_priv->files;
+    std::vector<std::string>::const_iterator it =
+        std::lower_bound (files.begin (), files.end (), prefix);
+    while (it != files.end ()
+           && it->compare (0, prefix.size (), prefix) == 0) {
+        std::string::size_type slash = it->find ('/', prefix.size ());
+        Entry entry;
+        if (slash == std::string::npos) {
+            entry.path = *it;
+            ++it;
+        } else {
+            entry.path = it->substr (0, slash);
+            entry.is_dir = true;
+            // Skip the content of that sub-directory: '0' is the
+            // character that comes right after '/'.
+            it = std::lower_bound (it, files.end (), entry.path + '0');
+        }
+        entry.name = Glib::filename_display_basename (entry.path);
+        a_children.push_back (entry);
+    }
+}
+
+/// Look files up by base name.
+///
+/// Files which base name starts with a_query come first, then those
+/// which base name contains a_query.  If that is not enough, files
+/// which base name starts with the first character of a_query, and
+/// contains the others in order, are added.  The look up is case
+/// insensitive.
+///
+/// Only the files the name index or the trigram index point to are
+/// looked at, never all of them.  So a query shorter than a trigram
+/// doesn't match in the middle of base names.
+///
+/// \param a_query the string to look for.
+///
+/// \param a_max_results the maximum number of files to return.
+///
+/// \param a_matches the absolute paths of the matching files.
+void
+SourceFileIndex::find (const UString &a_query,
+                       unsigned a_max_results,
+                       std::vector<std::string> &a_matches) const
+{
+    std::string query = fold_case (a_query.raw ());
+    if (query.empty () || !m_priv->has_files || !a_max_results)
+        return;
+
+    m_priv->build_search_index ();
+    const std::vector<std::string> &names = m_priv->folded_base_names;
+    const std::vector<unsigned> &sorted = m_priv->sorted_base_names;
+    std::vector<unsigned>::const_iterator it;
+
+    std::vector<unsigned> results;
+    for (it = m_priv->first_with_prefix (query);
+         it != sorted.end ()
+         && m_priv->has_prefix (*it, query)
+         && results.size () < a_max_results;
+         ++it)
+        results.push_back (*it);
+
+    if (query.size () >= 3 && results.size () < a_max_results) {
+        std::vector<unsigned> candidates;
+        m_priv->get_trigram_candidates (query, candidates);
+        for (it = candidates.begin ();
+             it != candidates.end () && results.size () < a_max_results;
+             ++it) {
+            std::string::size_type pos = names[*it].find (query);
+            if (pos != 0 && pos != std::string::npos)
+                results.push_back (*it);
+        }
+    }
+
+    // The files found so far, sorted, to not add them twice.  There
+    // are at most a_max_results of them.
+    std::vector<unsigned> found (results);
+    std::sort (found.begin (), found.end ());
+    std::string first_char = query.substr (0, 1);
+    for (it = m_priv->first_with_prefix (first_char);
+         it != sorted.end ()
+         && m_priv->has_prefix (*it, first_char)
+         && results.size () < a_max_results;
+         ++it) {
+        if (is_subsequence (query, names[*it])
+            && !std::binary_search (found.begin (), found.end (), *it))
+            results.push_back (*it);
+    }
+
+    for (it = results.begin (); it != results.end (); ++it)
+        a_matches.push_back (m_priv->files[*it]);
+}
+
+/// Empty the index.
+void
+SourceFileIndex::clear ()
+{
+    m_priv->binary_path.clear ();
+    m_priv->has_files = false;
+    m_priv->files.clear ();
+    m_priv->folded_base_names.clear ();
+    m_priv->sorted_base_names.clear ();
+    m_priv->trigrams.clear ();
+    m_priv->search_index_built = false;
+}
+
+NEMIVER_END_NAMESPACE (nemiver)
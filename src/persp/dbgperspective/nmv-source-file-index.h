@@ -0,0 +1,92 @@
+/*
+ *This file is part of the Nemiver project
+ *
+ *Nemiver is free software; you can redistribute
+ *it and/or modify it under the terms of
+ *the GNU General Public License as published by the
+ *Free Software Foundation; either version 2,
+ *or (at your option) any later version.
+ *
+ *Nemiver is distributed in the hope that it will
+ *be useful, but WITHOUT ANY WARRANTY;
+ *without even the implied warranty of
+ *MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ *See the GNU General Public License for more details.
+ *
+ *You should have received a copy of the
+ *GNU General Public License along with Nemiver;
+ *see the file COPYING.
+ *If not, write to the Free Software Foundation,
+ *Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+ *
+ *See COPYRIGHT file copyright information.
+ */
+#ifndef __NMV_SOURCE_FILE_INDEX_H__
+#define __NMV_SOURCE_FILE_INDEX_H__
+
+#include <string>
+#include <vector>
+#include "common/nmv-ustring.h"
+#include "common/nmv-safe-ptr-utils.h"
+
+NEMIVER_BEGIN_NAMESPACE (nemiver)
+
+using nemiver::common::SafePtr;
+using nemiver::common::UString;
+
+/// An index of the source files that make up the program being
+/// debugged.
+///
+/// The list of source files of a big binary can be very expensive to
+/// get from the debugging engine, so it is fetched once and kept
+/// here, tagged with the path of the binary it belongs to.  It must
+/// be cleared when the set of source files of the inferior can change,
+/// i.e. when shared libraries are loaded or unloaded.
+///
+/// The index lets its clients browse the files one directory at a
+/// time -- without having to build the whole directory tree -- and
+/// look files up by (part of) their base name, through a sorted index
+/// of the base names and a trigram index, built on the first look
+/// up.
+class SourceFileIndex {
+    // non copyable
+    SourceFileIndex (const SourceFileIndex &);
+    SourceFileIndex& operator= (const SourceFileIndex &);
+
+    struct Priv;
+    SafePtr<Priv> m_priv;
+
+public:
+
+    /// An immediate child of a directory of the index.
+    struct Entry {
+        UString name;
+        std::string path;
+        bool is_dir;
+
+        Entry () : is_dir (false) {}
+    };//end struct Entry
+
+    SourceFileIndex ();
+    ~SourceFileIndex ();
+
+    void set_files (const UString &a_binary_path,
+                    const std::vector<UString> &a_files);
+
+    bool is_valid_for (const UString &a_binary_path) const;
+
+    const std::vector<std::string>& files () const;
+
+    void get_children (const std::string &a_dir,
+                       std::vector<Entry> &a_children) const;
+
+    void find (const UString &a_query,
+               unsigned a_max_results,
+               std::vector<std::string> &a_matches) const;
+
+    void clear ();
+};//end class SourceFileIndex
+
+NEMIVER_END_NAMESPACE (nemiver)
+
+#endif // __NMV_SOURCE_FILE_INDEX_H__
@@ -23,6 +23,7 @@
  *See COPYRIGHT file copyright information.
  */
 #include "config.h"
+#include <map>
 #include <glib/gi18n.h>
 #include <gtkmm/treeview.h>
 #include <gtkmm/treestore.h>
@@ -30,15 +31,24 @@
 #include "nmv-thread-list.h"
 #include "nmv-i-debugger.h"
 #include "nmv-ui-utils.h"
+#include "nmv-refresh-scheduler.h"
 
 NEMIVER_BEGIN_NAMESPACE (nemiver)
 
 struct ThreadListColumns : public Gtk::TreeModelColumnRecord {
     Gtk::TreeModelColumn<int> thread_id;
+    Gtk::TreeModelColumn<Glib::ustring> target_id;
+    Gtk::TreeModelColumn<Glib::ustring> name;
+    Gtk::TreeModelColumn<Glib::ustring> state;
+    Gtk::TreeModelColumn<Glib::ustring> location;
 
     ThreadListColumns ()
     {
         add (thread_id);
+        add (target_id);
+        add (name);
+        add (state);
+        add (location);
     }
 };//end class ThreadListColumns
 
@@ -49,9 +59,31 @@ thread_list_columns ()
     return s_thread_list_columns;
 }
 
+/// \return a human readable location of the frame of a thread.
+static UString
+thread_location (const IDebugger::ThreadInfo &a_thread)
+{
+    if (!a_thread.has_frame ())
+        return "";
+
+    const IDebugger::Frame &frame = a_thread.frame ();
+    UString location = frame.function_name ();
+    if (!frame.file_name ().empty ()) {
+        location += " (" + frame.file_name () + ":"
+                    + UString::from_int (frame.line ()) + ")";
+    } else if (!frame.library ().empty ()) {
+        location += " (" + frame.library () + ")";
+    }
+    return location;
+}
+
 struct ThreadList::Priv {
     IDebuggerSafePtr debugger;
     std::list<int> thread_ids;
+    // The threads currently shown, and their rows.  List store
+    // iterators stay valid as long as their row exists.
+    std::map<int, IDebugger::ThreadInfo> threads;
+    std::map<int, Gtk::TreeModel::iterator> rows;
     int current_thread;
     SafePtr<Gtk::TreeView> tree_view;
     Glib::RefPtr<Gtk::ListStore> list_store;
@@ -60,21 +92,22 @@ struct ThreadList::Priv {
     sigc::connection tree_view_selection_changed_connection;
     bool is_up2date;
 
-    Priv (IDebuggerSafePtr &a_debugger) :
+    Priv (IDebuggerSafePtr &a_debugger,
+          RefreshScheduler &a_refresh_scheduler) :
         debugger (a_debugger),
         current_thread (0),
         current_thread_id (0),
         is_up2date (true)
     {
         build_widget ();
-        connect_to_debugger_signals ();
+        connect_to_debugger_signals (a_refresh_scheduler);
         connect_to_widget_signals ();
     }
 
     void finish_handling_debugger_stopped_event ()
     {
         LOG_FUNCTION_SCOPE_NORMAL_DD;
-        debugger->list_threads ();
+        debugger->list_threads_info ();
     }
 
     bool should_process_now ()
@@ -109,22 +142,53 @@ struct ThreadList::Priv {
         NEMIVER_CATCH
     }
 
-    void on_debugger_threads_listed_signal (const std::list<int> &a_threads,
-                                            const UString &a_cookie)
+    void on_debugger_threads_info_listed_signal
+                            (const std::list<IDebugger::ThreadInfo> &a_threads,
+                             const UString &/*a_cookie*/)
     {
         LOG_FUNCTION_SCOPE_NORMAL_DD;
 
-        if (a_cookie.empty ()) {}
-
         NEMIVER_TRY
 
-        clear_threads ();
-        set_thread_id_list (a_threads);
+        update_threads (a_threads);
         select_thread_id (current_thread_id, false);
 
         NEMIVER_CATCH
     }
 
+    /// Show the new state of threads that got resumed or stopped,
+    /// without listing the threads again.  In non-stop mode, that's
+    /// how the stops of threads other than the current one show up.
+    void on_debugger_thread_state_changed_signal (int a_thread_id,
+                                                  bool a_is_running)
+    {
+        LOG_FUNCTION_SCOPE_NORMAL_DD;
+
+        NEMIVER_TRY
+
+        // Outside of non-stop mode, all the threads are resumed and
+        // stop together, and they are listed again at each stop
+        // anyway.  Don't touch thousands of rows at each step.
+        THROW_IF_FAIL (debugger);
+        if (!debugger->is_non_stop_mode ())
+            return;
+
+        UString state = a_is_running ? "running" : "stopped";
+        std::map<int, IDebugger::ThreadInfo>::iterator it;
+        for (it = threads.begin (); it != threads.end (); ++it) {
+            if (a_thread_id >= 0 && it->first != a_thread_id)
+                continue;
+            it->second.state (state);
+            std::map<int, Gtk::TreeModel::iterator>::iterator row =
+                rows.find (it->first);
+            if (row != rows.end ())
+                row->second->set_value (thread_list_columns ().state,
+                                        Glib::ustring (state));
+        }
+
+        NEMIVER_CATCH
+    }
+
     void on_debugger_thread_selected_signal
                             (int a_tid,
                              const IDebugger::Frame * const,
@@ -183,24 +247,38 @@ struct ThreadList::Priv {
         tree_view->get_selection ()->set_mode (Gtk::SELECTION_SINGLE);
         tree_view->append_column (_("Thread ID"),
                                   thread_list_columns ().thread_id);
-        Gtk::TreeViewColumn *column = tree_view->get_column (0);
-        THROW_IF_FAIL (column);
-        column->set_clickable (false);
-        column->set_reorderable (false);
+        tree_view->append_column (_("Target ID"),
+                                  thread_list_columns ().target_id);
+        tree_view->append_column (_("Name"),
+                                  thread_list_columns ().name);
+        tree_view->append_column (_("State"),
+                                  thread_list_columns ().state);
+        tree_view->append_column (_("Location"),
+                                  thread_list_columns ().location);
+        for (unsigned i = 0; i < tree_view->get_columns ().size (); ++i) {
+            Gtk::TreeViewColumn *column = tree_view->get_column (i);
+            THROW_IF_FAIL (column);
+            column->set_clickable (false);
+            column->set_reorderable (false);
+            column->set_resizable (true);
+        }
     }
 
-    void connect_to_debugger_signals ()
+    void connect_to_debugger_signals (RefreshScheduler &a_refresh_scheduler)
     {
         THROW_IF_FAIL (debugger);
 
-        debugger->stopped_signal ().connect (sigc::mem_fun
+        a_refresh_scheduler.stopped_signal ().connect (sigc::mem_fun
             (*this, &Priv::on_debugger_stopped_signal));
 
-        debugger->threads_listed_signal ().connect (sigc::mem_fun
-            (*this, &Priv::on_debugger_threads_listed_signal));
+        debugger->threads_info_listed_signal ().connect (sigc::mem_fun
+            (*this, &Priv::on_debugger_threads_info_listed_signal));
 
         debugger->thread_selected_signal ().connect (sigc::mem_fun
             (*this, &Priv::on_debugger_thread_selected_signal));
+
+        debugger->thread_state_changed_signal ().connect (sigc::mem_fun
+            (*this, &Priv::on_debugger_thread_state_changed_signal));
     }
 
     void connect_to_widget_signals ()
@@ -215,53 +293,96 @@ struct ThreadList::Priv {
                     (sigc::mem_fun (*this, &Priv::on_draw_signal));
     }
 
-    void set_a_thread_id (int a_id)
+    void set_thread_row (const Gtk::TreeModel::iterator &a_row,
+                         const IDebugger::ThreadInfo &a_thread)
     {
-        THROW_IF_FAIL (list_store);
-        Gtk::TreeModel::iterator iter = list_store->append ();
-        iter->set_value (thread_list_columns ().thread_id, a_id);
+        ThreadListColumns &columns = thread_list_columns ();
+        a_row->set_value (columns.thread_id, a_thread.id ());
+        a_row->set_value (columns.target_id,
+                          Glib::ustring (a_thread.target_id ()));
+        a_row->set_value (columns.name, Glib::ustring (a_thread.name ()));
+        a_row->set_value (columns.state, Glib::ustring (a_thread.state ()));
+        a_row->set_value (columns.location,
+                          Glib::ustring (thread_location (a_thread)));
     }
 
-    void set_thread_id_list (const std::list<int> &a_list)
+    /// Update the list store so that it shows a_threads.  Only the
+    /// rows of threads that appeared, vanished or changed since the
+    /// previous update are touched, so that stopping a program which
+    /// has thousands of threads doesn't rebuild the whole list.
+    void update_threads (const std::list<IDebugger::ThreadInfo> &a_threads)
     {
-        std::list<int>::const_iterator it;
-        for (it = a_list.begin (); it != a_list.end (); ++it) {
-            set_a_thread_id (*it);
+        THROW_IF_FAIL (list_store);
+
+        std::map<int, IDebugger::ThreadInfo> new_threads;
+        thread_ids.clear ();
+        unsigned nb_changed = 0;
+        std::list<IDebugger::ThreadInfo>::const_iterator it;
+        for (it = a_threads.begin (); it != a_threads.end (); ++it) {
+            new_threads[it->id ()] = *it;
+            thread_ids.push_back (it->id ());
+
+            std::map<int, Gtk::TreeModel::iterator>::iterator row =
+                rows.find (it->id ());
+            if (row == rows.end ()) {
+                Gtk::TreeModel::iterator new_row = list_store->append ();
+                set_thread_row (new_row, *it);
+                rows[it->id ()] = new_row;
+                ++nb_changed;
+            } else if (threads[it->id ()] != *it) {
+                set_thread_row (row->second, *it);
+                ++nb_changed;
+            }
         }
+
+        // Remove the rows of the threads that exited.
+        std::map<int, IDebugger::ThreadInfo>::const_iterator old_it;
+        for (old_it = threads.begin (); old_it != threads.end (); ++old_it) {
+            if (new_threads.find (old_it->first) != new_threads.end ())
+                continue;
+            std::map<int, Gtk::TreeModel::iterator>::iterator row =
+                rows.find (old_it->first);
+            if (row != rows.end ()) {
+                list_store->erase (row->second);
+                rows.erase (row);
+                ++nb_changed;
+            }
+        }
+        threads.swap (new_threads);
+        LOG_DD ("threads: " << (int) threads.size ()
+                << ", rows touched: " << nb_changed);
     }
 
     void clear_threads ()
     {
         THROW_IF_FAIL (list_store);
         list_store->clear ();
+        threads.clear ();
+        rows.clear ();
+        thread_ids.clear ();
     }
 
     void select_thread_id (int a_tid, bool a_emit_signal)
     {
         THROW_IF_FAIL (list_store);
 
-        Gtk::TreeModel::iterator it;
-        for (it = list_store->children ().begin ();
-             it != list_store->children ().end ();
-             ++it) {
-            LOG_DD ("testing list row");
-            if ((int)(*it)->get_value
-                    (thread_list_columns ().thread_id) == a_tid) {
-                if (!a_emit_signal) {
-                    tree_view_selection_changed_connection.block (true);
-                }
-                tree_view->get_selection ()->select (it);
-                tree_view_selection_changed_connection.block (false);
+        std::map<int, Gtk::TreeModel::iterator>::const_iterator it =
+            rows.find (a_tid);
+        if (it != rows.end ()) {
+            if (!a_emit_signal) {
+                tree_view_selection_changed_connection.block (true);
             }
-            LOG_DD ("tested list row");
+            tree_view->get_selection ()->select (it->second);
+            tree_view_selection_changed_connection.block (false);
         }
         current_thread_id = a_tid;
     }
 };//end ThreadList::Priv
 
-ThreadList::ThreadList (IDebuggerSafePtr &a_debugger)
+ThreadList::ThreadList (IDebuggerSafePtr &a_debugger,
+                        RefreshScheduler &a_refresh_scheduler)
 {
-    m_priv.reset (new ThreadList::Priv (a_debugger));
+    m_priv.reset (new ThreadList::Priv (a_debugger, a_refresh_scheduler));
 }
 
 ThreadList::~ThreadList ()
@@ -302,11 +423,25 @@ ThreadList::clear ()
 
     THROW_IF_FAIL (m_priv);
     if (m_priv->list_store) {
-        m_priv->list_store->clear ();
+        m_priv->clear_threads ();
     }
     m_priv->current_thread_id = -1;
 }
 
+/// Have the list of threads fetched again the next time the thread
+/// list is drawn, rather than right away.  This is used when the
+/// threads change without the inferior stopping, e.g. when a core
+/// file is loaded.
+void
+ThreadList::invalidate ()
+{
+    LOG_FUNCTION_SCOPE_NORMAL_DD;
+
+    THROW_IF_FAIL (m_priv && m_priv->tree_view);
+    m_priv->is_up2date = false;
+    m_priv->tree_view->queue_draw ();
+}
+
 sigc::signal<void, int>&
 ThreadList::thread_selected_signal () const
 {
@@ -37,6 +37,8 @@ using nemiver::IDebuggerSafePtr;
 
 NEMIVER_BEGIN_NAMESPACE (nemiver)
 
+class RefreshScheduler;
+
 class NEMIVER_API ThreadList : public Object {
     //non copyable
     ThreadList (const ThreadList &);
@@ -50,12 +52,13 @@ protected:
 
 public:
 
-    ThreadList (IDebuggerSafePtr &);
+    ThreadList (IDebuggerSafePtr &, RefreshScheduler &);
     virtual ~ThreadList ();
     const std::list<int>& thread_ids () const;
     int current_thread_id () const;
     Gtk::Widget& widget () const;
     void clear ();
+    void invalidate ();
     sigc::signal<void, int>& thread_selected_signal () const;
 };//end class ThreadList
 
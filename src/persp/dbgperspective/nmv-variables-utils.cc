@@ -28,6 +28,7 @@
 #include "nmv-variables-utils.h"
 #include "common/nmv-exception.h"
 #include "nmv-ui-utils.h"
+#include "nmv-vars-treeview.h"
 
 NEMIVER_BEGIN_NAMESPACE (nemiver)
 NEMIVER_BEGIN_NAMESPACE (variables_utils2)
@@ -42,6 +43,11 @@ static void update_a_variable_real (const IDebugger::VariableSafePtr a_var,
 
 static bool is_empty_row (const Gtk::TreeModel::iterator &a_row_it);
 
+static void append_more_children_marker
+                            (const IDebugger::VariableSafePtr a_var,
+                             Gtk::TreeView &a_tree_view,
+                             Gtk::TreeModel::iterator &a_row_it);
+
 static UString get_row_name (const Gtk::TreeModel::iterator &a_row_it);
 
 /// Return a copy of the name of a variable's row, as presented to the
@@ -163,6 +169,9 @@ update_a_variable_node (const IDebugger::VariableSafePtr a_var,
     }
 
     (*a_iter)[get_variable_columns ().variable] = a_var;
+    VarsTreeView *vars_tree_view = dynamic_cast<VarsTreeView*> (&a_tree_view);
+    if (vars_tree_view)
+        vars_tree_view->index_variable_row (a_var, a_iter);
     UString var_name = a_var->name_caption ();
     if (var_name.empty ()) {var_name = a_var->name ();}
     var_name.chomp ();
@@ -240,6 +249,7 @@ update_unfolded_variable (const IDebugger::VariableSafePtr a_var,
                            result_var_row_it,
                            a_truncate_type);
     }
+    append_more_children_marker (a_var, a_tree_view, a_var_it);
 }
 
 /// Finds a variable in the tree view of variables.
@@ -471,12 +481,28 @@ update_a_variable (const IDebugger::VariableSafePtr a_var,
     THROW_IF_FAIL (a_parent_row_it);
 
     Gtk::TreeModel::iterator row_it;
-    // First lets try to see if a_var is already graphically
+    bool found_variable = false;
+
+    // If the tree view keeps an index of its variable rows, ask it
+    // first.  That spares us from walking the tree from the root
+    // variable of a_var down to its row.
+    VarsTreeView *vars_tree_view = dynamic_cast<VarsTreeView*> (&a_tree_view);
+    if (vars_tree_view
+        && vars_tree_view->find_variable_row (a_var, row_it)
+        && vars_tree_view->get_tree_store ()->is_ancestor (a_parent_row_it,
+                                                           row_it)) {
+        LOG_DD ("found variable " << a_var->internal_name ()
+                << " in the rows index");
+        found_variable = true;
+    }
+
+    // Otherwise lets try to see if a_var is already graphically
     // represented as a descendent of the graphical node
     // a_parent_row_it.
-    bool found_variable = find_a_variable_descendent (a_var,
-                                                      a_parent_row_it,
-                                                      row_it);
+    if (!found_variable)
+        found_variable = find_a_variable_descendent (a_var,
+                                                     a_parent_row_it,
+                                                     row_it);
 
     IDebugger::VariableSafePtr var = a_var;
     if (!found_variable) {
@@ -528,6 +554,36 @@ is_empty_row (const Gtk::TreeModel::iterator &a_row_it)
     return false;
 }
 
+/// If only the first children of a variable were fetched through its
+/// pretty-printer, append an empty row named "..." after the rows of
+/// these children, to show that there are more of them.
+///
+/// \param a_var the variable to consider.
+///
+/// \param a_tree_view the tree view containing the row of a_var.
+///
+/// \param a_row_it the row of a_var.
+static void
+append_more_children_marker (const IDebugger::VariableSafePtr a_var,
+                             Gtk::TreeView &a_tree_view,
+                             Gtk::TreeModel::iterator &a_row_it)
+{
+    if (!a_var
+        || !a_row_it
+        || !a_var->is_dynamic ()
+        || !a_var->has_more_children ()
+        || a_var->members ().empty ())
+        return;
+
+    Glib::RefPtr<Gtk::TreeStore> tree_store =
+        Glib::RefPtr<Gtk::TreeStore>::cast_dynamic (a_tree_view.get_model ());
+    THROW_IF_FAIL (tree_store);
+
+    Gtk::TreeModel::iterator row_it =
+        tree_store->append (a_row_it->children ());
+    (*row_it)[get_variable_columns ().name] = "...";
+}
+
 // Subroutine of update_a_variable. See that function comments to learn
 // more.
 // \param a_var the symbolic representation of the variable we are interested in.
@@ -572,6 +628,16 @@ update_a_variable_real (const IDebugger::VariableSafePtr a_var,
     list<IDebugger::VariableSafePtr>::const_iterator var_it;
     Gtk::TreeModel::Children rows = a_row_it->children ();
 
+    if (a_update_members
+        && (*a_row_it)[get_variable_columns ().members_pending]) {
+        // The member rows haven't been created yet.  They will be
+        // created from the (now updated) variable of a_row_it when it
+        // gets expanded, so there is nothing to walk here.
+        LOG_DD ("members of " << a_var->internal_name ()
+                << " are not materialized yet");
+        a_update_members = false;
+    }
+
     if (a_update_members) {
         LOG_DD ("Updating members of" << a_var->internal_name ());
         for (row_it = rows.begin (), var_it = a_var->members ().begin ();
@@ -706,7 +772,7 @@ set_a_variable (const IDebugger::VariableSafePtr a_var,
     update_a_variable_node (a_var, a_tree_view, a_row_it,
                             a_truncate_type, true, true);
 
-    list<IDebugger::VariableSafePtr>::const_iterator it;
+    (*a_row_it)[get_variable_columns ().members_pending] = false;
     if (a_var->needs_unfolding ()) {
         // Mark *row_it as needing unfolding, and add an empty
         // child node to it
@@ -714,13 +780,83 @@ set_a_variable (const IDebugger::VariableSafePtr a_var,
         IDebugger::VariableSafePtr empty_var;
         append_a_variable (empty_var, a_tree_view,
                            a_row_it, a_truncate_type);
-    } else {
-        for (it = a_var->members ().begin ();
-             it != a_var->members ().end ();
-             ++it) {
-            append_a_variable (*it, a_tree_view, a_row_it, a_truncate_type);
+    } else if (!a_var->members ().empty ()) {
+        // Do not create the rows of the members right away.  Big
+        // structs or arrays can have thousands of members, most of
+        // which are never looked at.  Just add an empty child node
+        // so that the row is expandable; the member rows are created
+        // by materialize_pending_members when the row is expanded.
+        (*a_row_it)[get_variable_columns ().members_pending] = true;
+        (*a_row_it)[get_variable_columns ().members_truncate_type] =
+                                                        a_truncate_type;
+        if (a_row_it->children ().empty ()) {
+            IDebugger::VariableSafePtr empty_var;
+            append_a_variable (empty_var, a_tree_view,
+                               a_row_it, a_truncate_type);
         }
+        // If the row is already expanded, its members are visible
+        // so they have to be shown right away.
+        if (a_tree_view.row_expanded
+                (a_tree_view.get_model ()->get_path (a_row_it)))
+            materialize_pending_members (a_tree_view, a_row_it);
+    }
+    return true;
+}
+
+/// Create the rows of the members of a variable which rows creation
+/// was deferred by set_a_variable.  This is meant to be called right
+/// before the row of the variable gets expanded.
+///
+/// The types of the members are truncated if set_a_variable was
+/// asked to truncate the type of the variable.
+///
+/// \param a_tree_view the tree view containing the row.
+///
+/// \param a_row_it the row of the variable which members rows to
+/// create.
+///
+/// \return true if member rows were created, false if there was
+/// nothing to do.
+bool
+materialize_pending_members (Gtk::TreeView &a_tree_view,
+                             Gtk::TreeModel::iterator &a_row_it)
+{
+    LOG_FUNCTION_SCOPE_NORMAL_DD;
+
+    if (!a_row_it
+        || !(*a_row_it)[get_variable_columns ().members_pending])
+        return false;
+
+    (*a_row_it)[get_variable_columns ().members_pending] = false;
+    IDebugger::VariableSafePtr var =
+        (*a_row_it)[get_variable_columns ().variable];
+    if (!var)
+        return false;
+
+    Glib::RefPtr<Gtk::TreeStore> tree_store =
+        Glib::RefPtr<Gtk::TreeStore>::cast_dynamic (a_tree_view.get_model ());
+    THROW_IF_FAIL (tree_store);
+
+    bool truncate_type =
+        (*a_row_it)[get_variable_columns ().members_truncate_type];
+
+    LOG_DD ("materializing " << (int) var->members ().size ()
+            << " members of " << var->internal_name ());
+
+    list<IDebugger::VariableSafePtr>::const_iterator it;
+    for (it = var->members ().begin (); it != var->members ().end (); ++it)
+        append_a_variable (*it, a_tree_view, a_row_it, truncate_type);
+
+    // Now that the row has real children, remove the empty child
+    // node set_a_variable added to keep it expandable.
+    Gtk::TreeModel::iterator row_it = a_row_it->children ().begin ();
+    while (row_it != a_row_it->children ().end ()) {
+        if (is_empty_row (row_it))
+            row_it = tree_store->erase (row_it);
+        else
+            ++row_it;
     }
+    append_more_children_marker (var, a_tree_view, a_row_it);
     return true;
 }
 
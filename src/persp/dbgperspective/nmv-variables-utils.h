@@ -46,7 +46,9 @@ struct VariableColumns : public Gtk::TreeModelColumnRecord {
         IS_HIGHLIGHTED_OFFSET,
         NEEDS_UNFOLDING,
         FG_COLOR_OFFSET,
-        VARIABLE_VALUE_EDITABLE_OFFSET
+        VARIABLE_VALUE_EDITABLE_OFFSET,
+        MEMBERS_PENDING_OFFSET,
+        MEMBERS_TRUNCATE_TYPE_OFFSET
     };
 
     Gtk::TreeModelColumn<Glib::ustring> name;
@@ -58,6 +60,12 @@ struct VariableColumns : public Gtk::TreeModelColumnRecord {
     Gtk::TreeModelColumn<bool> needs_unfolding;
     Gtk::TreeModelColumn<Gdk::Color> fg_color;
     Gtk::TreeModelColumn<bool> variable_value_editable;
+    // True when the variable of the row has members that have not
+    // been turned into rows yet.
+    Gtk::TreeModelColumn<bool> members_pending;
+    // Whether the types of those members are to be truncated when
+    // their rows get created.
+    Gtk::TreeModelColumn<bool> members_truncate_type;
 
     VariableColumns ()
     {
@@ -70,6 +78,8 @@ struct VariableColumns : public Gtk::TreeModelColumnRecord {
         add (needs_unfolding);
         add (fg_color);
         add (variable_value_editable);
+        add (members_pending);
+        add (members_truncate_type);
     }
 };//end VariableColumns
 
@@ -128,6 +138,9 @@ bool set_a_variable (const IDebugger::VariableSafePtr a_var,
 		     Gtk::TreeModel::iterator a_row_it,
 		     bool a_truncate_type);
 
+bool materialize_pending_members (Gtk::TreeView &a_tree_view,
+                                  Gtk::TreeModel::iterator &a_row_it);
+
 bool unlink_a_variable_row (const IDebugger::VariableSafePtr &a_var,
 			    const Glib::RefPtr<Gtk::TreeStore> &a_store,
 			    const Gtk::TreeModel::iterator &a_parent_row_it);
@@ -27,10 +27,58 @@
 #include "nmv-vars-treeview.h"
 #include "nmv-variables-utils.h"
 
+#if defined(HAVE_TR1_UNORDERED_MAP)
+#include <tr1/unordered_map>
+#elif defined(HAVE_BOOST_TR1_UNORDERED_MAP_HPP)
+#include <boost/tr1/unordered_map.hpp>
+#else
+#include <map>
+#endif
+
 namespace vutil = nemiver::variables_utils2;
 
 NEMIVER_BEGIN_NAMESPACE (nemiver)
 
+// Variables that took GDB longer than that to create or to unfold
+// get a tooltip saying so; their pretty-printer is likely to be slow.
+static const unsigned int SLOW_VARIABLE_MS = 100;
+
+#if defined(HAVE_TR1_UNORDERED_MAP) || defined(HAVE_BOOST_TR1_UNORDERED_MAP_HPP)
+typedef std::tr1::unordered_map<std::string,
+                                Gtk::TreeRowReference> VariableRowsIndex;
+#else
+typedef std::map<std::string, Gtk::TreeRowReference> VariableRowsIndex;
+#endif
+
+/// The index of the rows of the variables shown in the tree view,
+/// keyed by the internal (varobj) name of the variables.  Entries are
+/// row references so that they silently become invalid when the rows
+/// they point to get erased from the tree store; invalid entries are
+/// pruned lazily.
+struct VarsTreeView::Priv {
+    VariableRowsIndex rows_index;
+    // The size the index had after the last time it was pruned.
+    VariableRowsIndex::size_type size_at_last_prune;
+
+    Priv () :
+        size_at_last_prune (0)
+    {
+    }
+
+    void
+    prune_rows_index ()
+    {
+        VariableRowsIndex::iterator it = rows_index.begin ();
+        while (it != rows_index.end ()) {
+            if (!it->second.is_valid ())
+                rows_index.erase (it++);
+            else
+                ++it;
+        }
+        size_at_last_prune = rows_index.size ();
+    }
+};//end struct VarsTreeView::Priv
+
 VarsTreeView*
 VarsTreeView::create ()
 {
@@ -42,6 +90,7 @@ VarsTreeView::create ()
 
 VarsTreeView::VarsTreeView (Glib::RefPtr<Gtk::TreeStore>& model) :
     Gtk::TreeView (model),
+    m_priv (new Priv),
     m_tree_store (model)
 {
     set_headers_clickable (true);
@@ -72,6 +121,51 @@ VarsTreeView::VarsTreeView (Glib::RefPtr<Gtk::TreeStore>& model) :
     col = get_column (VARIABLE_TYPE_COLUMN_INDEX);
     THROW_IF_FAIL (col);
     col->set_resizable (true);
+
+    set_has_tooltip (true);
+}
+
+VarsTreeView::~VarsTreeView ()
+{
+}
+
+/// Show how long GDB took to create, and to unfold, the variables
+/// that are slow to display.
+bool
+VarsTreeView::on_query_tooltip (int a_x, int a_y, bool a_keyboard_tooltip,
+                                const Glib::RefPtr<Gtk::Tooltip> &a_tooltip)
+{
+    Gtk::TreeModel::Path path;
+    int x = a_x, y = a_y;
+    if (!get_tooltip_context_path (x, y, a_keyboard_tooltip, path))
+        return false;
+    Gtk::TreeModel::iterator it = m_tree_store->get_iter (path);
+    if (!it)
+        return false;
+    IDebugger::VariableSafePtr var =
+        (*it)[vutil::get_variable_columns ().variable];
+    if (!var) {
+        // The row that follows the children of a variable, when only
+        // the first ones were fetched through its pretty-printer.
+        Glib::ustring name = (*it)[vutil::get_variable_columns ().name];
+        if (name != "..." || !it->parent ())
+            return false;
+        a_tooltip->set_text (_("Only the first children of this variable "
+                               "were fetched.  Their maximum number can "
+                               "be changed in the preferences"));
+        set_tooltip_row (a_tooltip, path);
+        return true;
+    }
+    if (var->backend_cost_ms () < SLOW_VARIABLE_MS)
+        return false;
+
+    a_tooltip->set_text
+        (Glib::ustring::compose (_("The debugger took %1 ms to display "
+                                   "this variable of type %2"),
+                                 var->backend_cost_ms (),
+                                 var->type ().raw ()));
+    set_tooltip_row (a_tooltip, path);
+    return true;
 }
 
 Glib::RefPtr<Gtk::TreeStore>&
@@ -80,5 +174,99 @@ VarsTreeView::get_tree_store ()
     return m_tree_store;
 }
 
+/// Record that a given row holds the graphical representation of a
+/// variable, so that find_variable_row can later get back to that
+/// row without walking the tree.
+///
+/// Variables that have no internal name (i.e, that are not backed by
+/// a GDB variable object) are not indexed.
+///
+/// \param a_var the variable to index.
+///
+/// \param a_row_it the row that holds a_var.
+void
+VarsTreeView::index_variable_row (const IDebugger::VariableSafePtr a_var,
+                                  const Gtk::TreeModel::iterator &a_row_it)
+{
+    if (!a_var || !a_row_it || a_var->internal_name ().empty ())
+        return;
+
+    m_priv->rows_index[a_var->internal_name ().raw ()] =
+        Gtk::TreeRowReference (m_tree_store, m_tree_store->get_path (a_row_it));
+
+    // Rows keep being erased under our feet when the inferior
+    // changes frames, so drop the stale entries once the index has
+    // grown twice as big as it was after the last cleanup.
+    if (m_priv->rows_index.size () > 2 * m_priv->size_at_last_prune + 256)
+        m_priv->prune_rows_index ();
+}
+
+/// Find the row holding the graphical representation of a variable
+/// in constant time, using the index built by index_variable_row.
+///
+/// \param a_var the variable to look for.
+///
+/// \param a_row_it the resulting row.  It is set if and only if the
+/// function returns true.
+///
+/// \return true if a row holding a_var was found, false otherwise.
+bool
+VarsTreeView::find_variable_row (const IDebugger::VariableSafePtr a_var,
+                                 Gtk::TreeModel::iterator &a_row_it)
+{
+    if (!a_var || a_var->internal_name ().empty ())
+        return false;
+
+    VariableRowsIndex::iterator it =
+        m_priv->rows_index.find (a_var->internal_name ().raw ());
+    if (it == m_priv->rows_index.end ())
+        return false;
+
+    if (!it->second.is_valid ()) {
+        m_priv->rows_index.erase (it);
+        return false;
+    }
+
+    Gtk::TreeModel::iterator row_it =
+        m_tree_store->get_iter (it->second.get_path ());
+    IDebugger::VariableSafePtr var =
+        (*row_it)[vutil::get_variable_columns ().variable];
+    if (!var || var->internal_name () != a_var->internal_name ()) {
+        // The row has been recycled for another variable.
+        m_priv->rows_index.erase (it);
+        return false;
+    }
+    a_row_it = row_it;
+    return true;
+}
+
+/// Forget about all the rows recorded by index_variable_row.
+void
+VarsTreeView::clear_variable_rows_index ()
+{
+    m_priv->rows_index.clear ();
+    m_priv->size_at_last_prune = 0;
+}
+
+/// Default handler of the "test-expand-row" signal.
+///
+/// The member rows of a variable are only created when the row of
+/// that variable is about to be expanded for the first time, so that
+/// huge variables don't cost a row per member until the user actually
+/// looks at them.
+bool
+VarsTreeView::on_test_expand_row (const Gtk::TreeModel::iterator &a_it,
+                                  const Gtk::TreeModel::Path &a_path)
+{
+    NEMIVER_TRY
+
+    Gtk::TreeModel::iterator it = a_it;
+    vutil::materialize_pending_members (*this, it);
+
+    NEMIVER_CATCH
+
+    return Gtk::TreeView::on_test_expand_row (a_it, a_path);
+}
+
 NEMIVER_END_NAMESPACE (nemiver)
 
@@ -29,6 +29,7 @@
 #include <gtkmm/treestore.h>
 #include "common/nmv-safe-ptr.h"
 #include "nmv-ui-utils.h"
+#include "nmv-i-debugger.h"
 
 using nemiver::common::SafePtr;
 
@@ -48,13 +49,30 @@ class NEMIVER_API VarsTreeView : public Gtk::TreeView
             VARIABLE_TYPE_COLUMN_INDEX
         };
         static VarsTreeView* create ();
+        virtual ~VarsTreeView ();
         Glib::RefPtr<Gtk::TreeStore>& get_tree_store ();
 
+        void index_variable_row (const IDebugger::VariableSafePtr a_var,
+                                 const Gtk::TreeModel::iterator &a_row_it);
+
+        bool find_variable_row (const IDebugger::VariableSafePtr a_var,
+                                Gtk::TreeModel::iterator &a_row_it);
+
+        void clear_variable_rows_index ();
+
     protected:
         VarsTreeView ();
         VarsTreeView (Glib::RefPtr<Gtk::TreeStore>& model);
 
+        bool on_test_expand_row (const Gtk::TreeModel::iterator &a_it,
+                                 const Gtk::TreeModel::Path &a_path);
+
+        bool on_query_tooltip (int a_x, int a_y, bool a_keyboard_tooltip,
+                               const Glib::RefPtr<Gtk::Tooltip> &a_tooltip);
+
     private:
+        struct Priv;
+        SafePtr<Priv> m_priv;
         Glib::RefPtr<Gtk::TreeStore> m_tree_store;
 };
 NEMIVER_END_NAMESPACE (nemiver)
@@ -33,7 +33,11 @@
 
 NEMIVER_BEGIN_NAMESPACE (nemiver)
 
-struct WatchpointDialog::Priv {
+// How long to wait after the last change of the expression before
+// asking the debugger how the watchpoint would be implemented.
+static const unsigned PLAN_DELAY_MS = 300;
+
+struct WatchpointDialog::Priv : public sigc::trackable {
 
     Gtk::Dialog &dialog;
     Glib::RefPtr<Gtk::Builder> gtkbuilder;
@@ -41,9 +45,13 @@ struct WatchpointDialog::Priv {
     Gtk::Button *inspect_button;
     Gtk::CheckButton *read_check_button;
     Gtk::CheckButton *write_check_button;
+    Gtk::Label *mode_label;
+    Gtk::CheckButton *software_check_button;
     Gtk::Button *ok_button;
     Gtk::Button *cancel_button;
     SafePtr<ExprInspector> var_inspector;
+    IDebugger::WatchpointPlan::Mode plan_mode;
+    sigc::connection plan_timeout;
     IDebugger &debugger;
     IPerspective &perspective;
 
@@ -57,6 +65,9 @@ struct WatchpointDialog::Priv {
         inspect_button (0),
         read_check_button (0),
         write_check_button (0),
+        mode_label (0),
+        software_check_button (0),
+        plan_mode (IDebugger::WatchpointPlan::UNKNOWN_MODE),
         debugger (a_debugger),
         perspective (a_perspective)
     {
@@ -95,6 +106,17 @@ struct WatchpointDialog::Priv {
                                             (gtkbuilder, "writecheckbutton");
         THROW_IF_FAIL (write_check_button);
 
+        mode_label =
+            ui_utils::get_widget_from_gtkbuilder<Gtk::Label>
+                                            (gtkbuilder, "modelabel");
+        THROW_IF_FAIL (mode_label);
+
+        software_check_button =
+            ui_utils::get_widget_from_gtkbuilder<Gtk::CheckButton>
+                                            (gtkbuilder,
+                                             "softwarecheckbutton");
+        THROW_IF_FAIL (software_check_button);
+
         ok_button =
             ui_utils::get_widget_from_gtkbuilder<Gtk::Button>
                                             (gtkbuilder, "okbutton");
@@ -138,6 +160,8 @@ struct WatchpointDialog::Priv {
                (*this, &Priv::on_inspect_button_clicked));
         expression_entry->signal_changed ().connect (sigc::mem_fun
                (*this, &Priv::on_expression_entry_changed_signal));
+        software_check_button->signal_toggled ().connect (sigc::mem_fun
+               (*this, &Priv::update_ok_button_sensitivity));
     }
 
     void
@@ -157,6 +181,81 @@ struct WatchpointDialog::Priv {
             write_check_button->set_active (true);
     }
 
+    /// Only let the user set a software watchpoint on purpose.
+    void
+    update_ok_button_sensitivity ()
+    {
+        THROW_IF_FAIL (ok_button);
+        THROW_IF_FAIL (expression_entry);
+        THROW_IF_FAIL (software_check_button);
+
+        bool is_sensitive = !expression_entry->get_text ().empty ();
+        if (plan_mode == IDebugger::WatchpointPlan::SOFTWARE_MODE
+            && !software_check_button->get_active ())
+            is_sensitive = false;
+        ok_button->set_sensitive (is_sensitive);
+    }
+
+    bool
+    on_plan_timeout ()
+    {
+        NEMIVER_TRY
+
+        THROW_IF_FAIL (expression_entry);
+
+        UString expression = expression_entry->get_text ();
+        if (!expression.empty ()
+            && debugger.get_state () == IDebugger::READY)
+            debugger.plan_watchpoint
+                (expression,
+                 sigc::mem_fun (*this, &Priv::on_watchpoint_planned));
+
+        NEMIVER_CATCH
+        return false;
+    }
+
+    void
+    on_watchpoint_planned (const IDebugger::WatchpointPlan &a_plan)
+    {
+        NEMIVER_TRY
+
+        THROW_IF_FAIL (expression_entry);
+        THROW_IF_FAIL (mode_label);
+        THROW_IF_FAIL (software_check_button);
+
+        // The expression changed since we asked.
+        if (a_plan.expression () != expression_entry->get_text ())
+            return;
+
+        plan_mode = a_plan.mode ();
+        UString text;
+        switch (plan_mode) {
+        case IDebugger::WatchpointPlan::HARDWARE_MODE:
+            text.printf (_("Hardware watchpoint, using %d of the %d "
+                           "debug registers left free by the other "
+                           "watchpoints."),
+                         (int) a_plan.chunks ().size (),
+                         (int) a_plan.nb_registers ());
+            break;
+        case IDebugger::WatchpointPlan::SOFTWARE_MODE:
+            text.printf (_("Software watchpoint: the %d bytes watched "
+                           "don't fit in the debug registers, so the "
+                           "program would run about a thousand times "
+                           "slower."),
+                         (int) a_plan.size ());
+            break;
+        case IDebugger::WatchpointPlan::UNKNOWN_MODE:
+            text = _("The debugger will choose the kind of watchpoint.");
+            break;
+        }
+        mode_label->set_text (text);
+        software_check_button->set_sensitive
+            (plan_mode == IDebugger::WatchpointPlan::SOFTWARE_MODE);
+        update_ok_button_sensitivity ();
+
+        NEMIVER_CATCH
+    }
+
     void
     on_inspect_button_clicked ()
     {
@@ -182,19 +281,36 @@ struct WatchpointDialog::Priv {
 
         THROW_IF_FAIL (expression_entry);
         THROW_IF_FAIL (inspect_button);
+        THROW_IF_FAIL (mode_label);
+        THROW_IF_FAIL (software_check_button);
 
         UString expression = expression_entry->get_text ();
         if (expression == "") {
             inspect_button->set_sensitive (false);
-            ok_button->set_sensitive (false);
         } else {
             inspect_button->set_sensitive (true);
-            ok_button->set_sensitive (true);
         }
 
+        plan_mode = IDebugger::WatchpointPlan::UNKNOWN_MODE;
+        mode_label->set_text ("");
+        software_check_button->set_active (false);
+        software_check_button->set_sensitive (false);
+        update_ok_button_sensitivity ();
+
+        plan_timeout.disconnect ();
+        if (expression != "")
+            plan_timeout = Glib::signal_timeout ().connect
+                (sigc::mem_fun (*this, &Priv::on_plan_timeout),
+                 PLAN_DELAY_MS);
+
         NEMIVER_CATCH
     }
 
+    ~Priv ()
+    {
+        plan_timeout.disconnect ();
+    }
+
 }; // end struct WatchpointDialog
 
 /// Constructor of the WatchpointDialog type.
@@ -243,6 +359,16 @@ WatchpointDialog::expression (const UString &a_text)
     return m_priv->expression_entry->set_text (a_text);
 }
 
+/// \return true if the user accepted that the watchpoint be a
+/// software one, which makes the program very slow.
+bool
+WatchpointDialog::allow_software () const
+{
+    THROW_IF_FAIL (m_priv);
+    THROW_IF_FAIL (m_priv->software_check_button);
+    return m_priv->software_check_button->get_active ();
+}
+
 WatchpointDialog::Mode
 WatchpointDialog::mode () const
 {
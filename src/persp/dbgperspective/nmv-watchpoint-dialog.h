@@ -70,6 +70,8 @@ public:
 
     Mode mode () const;
     void mode (Mode);
+
+    bool allow_software () const;
 };// end class WatchpointDialog
 
 WatchpointDialog::Mode operator| (WatchpointDialog::Mode,
@@ -144,6 +144,20 @@ Editor::get_geometry (int& cpl, int& vis_lines) const
 }
 
 
+void
+Editor::set_selection (int a_start, int a_end)
+{
+    THROW_IF_FAIL (m_priv && m_priv->hex);
+    gtk_hex_set_selection (m_priv->hex.get (), a_start, a_end);
+}
+
+void
+Editor::clear_selection ()
+{
+    THROW_IF_FAIL (m_priv && m_priv->hex);
+    gtk_hex_clear_selection (m_priv->hex.get ());
+}
+
 Gtk::Container&
 Editor::get_widget () const
 {
@@ -337,9 +337,9 @@ struct SourceEditor::Priv {
                                     
     {
         Gtk::TextBuffer::iterator it = a_buf->begin ();
-        size_t  i;
         std::string addr;
         AddrLine lower_bound, upper_bound;
+        size_t addr_value = an_addr;
 
         THROW_IF_FAIL (it.starts_line ());
 
@@ -347,23 +347,25 @@ struct SourceEditor::Priv {
             // We must always be at the beginning of a line here.
             THROW_IF_FAIL (it.starts_line ());
             addr.clear ();
-            for (i = 0;
-                 !isspace (it.get_char ()) && it.ends_line () != true
-                     && i < an_addr.string_size ();
-                 ++it, ++i) {
+            for (;
+                 !isspace (it.get_char ()) && it.ends_line () != true;
+                 ++it) {
                 addr += it.get_char ();
             }
 
-            int match = (addr.compare (an_addr.to_string ()));
+            // Compare the addresses as integers, not as strings, so
+            // that addresses of different widths compare right.
+            bool is_addr = str_utils::string_is_hexa_number (addr);
+            size_t value = is_addr ? str_utils::hexa_to_int (addr) : 0;
+            int match = !is_addr ? 1
+                : (value < addr_value ? -1 : (value > addr_value ? 1 : 0));
 
-            if (match < 0
-                && str_utils::string_is_hexa_number (addr)) {
+            if (match < 0) {
                 lower_bound.first = addr;
                 lower_bound.second = it.get_line () + 1;
             }
 
-            if (match > 0
-                && str_utils::string_is_hexa_number (addr)) {
+            if (match > 0 && is_addr) {
                 if (lower_bound.first.empty ()) {
                     // So we are seing an @ that is greater than
                     // an_addr without having ever seen an @ that is
@@ -1436,6 +1438,43 @@ SourceEditor::load_file (Gtk::Window &a_parent,
                          const std::list<std::string> &a_supported_encodings,
                          bool a_enable_syntax_highlight,
                          Glib::RefPtr<Buffer> &a_source_buffer)
+{
+    std::string encoding;
+    return load_file (a_parent, a_path, a_supported_encodings, "",
+                      a_enable_syntax_highlight, a_source_buffer,
+                      encoding);
+}
+
+/// Load a file into a source buffer, converting it to UTF-8 if
+/// needed.
+///
+/// \param a_parent the parent window of the error dialogs.
+///
+/// \param a_path the path of the file to load.
+///
+/// \param a_supported_encodings the encodings the user listed.
+///
+/// \param a_known_encoding the encoding the file was found to be in
+/// the last time it got loaded, or an empty string.  It is tried
+/// first, to avoid detecting the encoding again.
+///
+/// \param a_enable_syntax_highlight whether to highlight the syntax
+/// of the file.
+///
+/// \param a_source_buffer the buffer to load the file into.
+///
+/// \param a_encoding out parameter.  The encoding the file turned
+/// out to be in.
+///
+/// \return true upon successful loading, false otherwise.
+bool
+SourceEditor::load_file (Gtk::Window &a_parent,
+                         const UString &a_path,
+                         const std::list<std::string> &a_supported_encodings,
+                         const std::string &a_known_encoding,
+                         bool a_enable_syntax_highlight,
+                         Glib::RefPtr<Buffer> &a_source_buffer,
+                         std::string &a_encoding)
 {
     NEMIVER_TRY;
 
@@ -1485,7 +1524,9 @@ SourceEditor::load_file (Gtk::Window &a_parent,
     std::string cur_charset;
     if (!str_utils::ensure_buffer_is_in_utf8 (content,
                                               a_supported_encodings,
-                                              utf8_content)) {
+                                              a_known_encoding,
+                                              utf8_content,
+                                              cur_charset)) {
         UString msg;
         msg.printf (_("Could not load file %s because its encoding "
                       "is different from %s"),
@@ -1494,8 +1535,10 @@ SourceEditor::load_file (Gtk::Window &a_parent,
         ui_utils::display_error (a_parent, msg);
         return false;
     }
+    a_encoding = cur_charset;
     a_source_buffer->set_text (utf8_content);
-    LOG_DD ("file loaded. Read " << (int)nb_bytes << " bytes");
+    LOG_DD ("file loaded. Read " << (int)nb_bytes << " bytes, encoding: "
+            << a_encoding);
 
     a_source_buffer->set_highlight_syntax (a_enable_syntax_highlight);
 
@@ -134,6 +134,14 @@ public:
 			   bool a_enable_syntaxt_highlight,
 			   Glib::RefPtr<Buffer> &a_source_buffer);
 
+    static bool load_file (Gtk::Window &a_parent,
+                           const UString &a_path,
+                           const std::list<std::string> &a_supported_encodings,
+                           const std::string &a_known_encoding,
+                           bool a_enable_syntaxt_highlight,
+                           Glib::RefPtr<Buffer> &a_source_buffer,
+                           std::string &a_encoding);
+
     /// \name Assembly source buffer handling.
     /// @{
 
@@ -0,0 +1,27 @@
+#include <cstdlib>
+#include <new>
+#include "alloc-counter.h"
+
+static unsigned long gv_nb_allocations = 0;
+
+void*
+operator new (std::size_t a_size) throw (std::bad_alloc)
+{
+    ++gv_nb_allocations;
+    void *result = malloc (a_size ? a_size : 1);
+    if (!result)
+        throw std::bad_alloc ();
+    return result;
+}
+
+void
+operator delete (void *a_ptr) throw ()
+{
+    free (a_ptr);
+}
+
+unsigned long
+get_nb_allocations ()
+{
+    return gv_nb_allocations;
+}
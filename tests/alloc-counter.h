@@ -0,0 +1,13 @@
+#ifndef __NMV_ALLOC_COUNTER_H__
+#define __NMV_ALLOC_COUNTER_H__
+
+// Linking alloc-counter.cc into a test program replaces the global
+// operator new and operator delete by ones that count the
+// allocations, so that the test can report, or bound, how many
+// allocations an operation costs.
+
+/// \return the number of calls to operator new since the program
+/// started.
+unsigned long get_nb_allocations ();
+
+#endif // __NMV_ALLOC_COUNTER_H__
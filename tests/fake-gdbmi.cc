@@ -0,0 +1,595 @@
+// A fake GDB that speaks just enough GDB/MI to drive GDBEngine,
+// without debugging any real program.
+//
+// It reads MI commands on its standard input and answers them on its
+// standard output, with synthetic results whose size and latency
+// are set by environment variables:
+//
+//  NMV_FAKE_GDB_LATENCY_MS   time to wait before answering each
+//                            command (default: 0).
+//  NMV_FAKE_GDB_STARTUP_MS   time to wait before printing the first
+//                            prompt, as GDB does while it loads the
+//                            symbols of the program (default: 0).
+//  NMV_FAKE_GDB_STACK_DEPTH  number of frames of the call stack
+//                            (default: 100).
+//  NMV_FAKE_GDB_NUM_THREADS  number of threads of the inferior
+//                            (default: 1).
+//  NMV_FAKE_GDB_NUM_CHILDREN number of children of each variable
+//                            (default: 10).
+//  NMV_FAKE_GDB_DYNAMIC      if non-zero, variables look like they
+//                            have a pretty-printer: their children
+//                            are only listed in the range given to
+//                            -var-list-children, if any (default: 0).
+//  NMV_FAKE_GDB_CHILD_COST_US time it takes to list each child, as
+//                            a slow pretty-printer would (default: 0).
+//  NMV_FAKE_GDB_NUM_STOPS    number of times the inferior stops
+//                            before exiting (default: 10).
+//  NMV_FAKE_GDB_NO_MI_ASYNC  if non-zero, refuse "-gdb-set mi-async",
+//                            as GDB older than 7.8 does (default: 0).
+//  NMV_FAKE_GDB_VAR_CHANGES  if non-zero, each variable changes at
+//                            each stop, and -var-update reports it
+//                            once, as GDB does (default: 0).  See
+//                            var_change.
+//  NMV_FAKE_GDB_SCENARIO     path to a file of canned answers.  Each
+//                            line is a command prefix, a tab, and the
+//                            answer to commands that start with that
+//                            prefix; "\n" in the answer stands for a
+//                            new line.  Canned answers take precedence
+//                            over the synthetic ones.
+//  NMV_FAKE_GDB_TRANSCRIPT   path to a transcript of GDB/MI output,
+//                            either as logged by nemiver
+//                            --log-debugger-output or raw.  It is
+//                            cut after each GDB prompt, and each
+//                            part answers in turn a -thread-list-ids
+//                            command, whatever the part holds; a part
+//                            without a result record is followed by
+//                            ^done.  Once every part has been served,
+//                            the synthetic answers take over.  See
+//                            load_transcript.
+//
+// If it is given a program and a core file on its command line, it
+// behaves as if it had loaded the core: the inferior is stopped from
+// the start.
+//
+// Once set in non-stop mode, the threads stop on their own: -exec-run
+// stops thread 1 on a breakpoint while the others keep running.
+// Resuming a thread makes the first other running thread hit a
+// breakpoint; stepping it also stops it again first.  The execution
+// commands must then be given --thread.
+//
+// To make GDBEngine use it, point NMV_GDB_PROGRAM at it, or pass it
+// to IDebugger::set_non_persistent_debugger_path.
+
+#include <unistd.h>
+#include <cctype>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <utility>
+#include <vector>
+
+using namespace std;
+
+static int latency_ms = 0;
+static int startup_ms = 0;
+static int stack_depth = 100;
+static int num_threads = 1;
+static int num_children = 10;
+static bool dynamic_vars = false;
+static int child_cost_us = 0;
+static int num_stops = 10;
+static int num_breakpoints = 0;
+static int num_variables = 0;
+static bool no_mi_async = false;
+static bool non_stop = false;
+static bool report_var_changes = false;
+// The number of stops so far, when report_var_changes is set.
+static int generation = 0;
+// The generation at which each variable was last reported, by
+// variable number, or -1 once it is deleted.
+static vector<int> var_generations (1, -1);
+static vector<bool> thread_running;
+static vector<pair<string, string> > canned_answers;
+static vector<string> transcript_answers;
+static vector<string>::size_type nb_transcript_answers_served = 0;
+
+static const char *FRAME_FUNC = "recurse";
+static const char *FRAME_FILE = "fake.c";
+static const char *FRAME_FULLNAME = "/tmp/fake.c";
+
+static int
+env_int (const char *a_name, int a_default)
+{
+    const char *value = getenv (a_name);
+    if (!value || !*value)
+        return a_default;
+    return atoi (value);
+}
+
+static string
+int_to_string (long a_value)
+{
+    ostringstream os;
+    os << a_value;
+    return os.str ();
+}
+
+static string
+frame (int a_level)
+{
+    return "{level=\"" + int_to_string (a_level) + "\",addr=\"0x"
+        + int_to_string (400000 + a_level) + "\",func=\""
+        + (a_level == stack_depth - 1 ? "main" : FRAME_FUNC)
+        + "\",file=\"" + FRAME_FILE + "\",fullname=\"" + FRAME_FULLNAME
+        + "\",line=\"" + int_to_string (10 + a_level % 20) + "\"}";
+}
+
+static void
+load_scenario (const char *a_path)
+{
+    ifstream file (a_path);
+    string line;
+    while (getline (file, line)) {
+        string::size_type tab = line.find ('\t');
+        if (line.empty () || line[0] == '#' || tab == string::npos)
+            continue;
+        string answer = line.substr (tab + 1), unescaped;
+        for (string::size_type i = 0; i < answer.size (); ++i) {
+            if (answer[i] == '\\' && i + 1 < answer.size ()
+                && answer[i + 1] == 'n') {
+                unescaped += '\n';
+                ++i;
+            } else {
+                unescaped += answer[i];
+            }
+        }
+        canned_answers.push_back (make_pair (line.substr (0, tab),
+                                             unescaped));
+    }
+}
+
+static bool
+starts_with (const string &a_str, const char *a_prefix)
+{
+    return a_str.compare (0, string (a_prefix).size (), a_prefix) == 0;
+}
+
+/// Load the transcript at a_path into transcript_answers: the output
+/// GDB wrote, cut after each prompt, without the prompt as main
+/// prints it.  If the transcript is a nemiver log, only the content
+/// of its <debuggeroutput> elements is GDB output.
+static void
+load_transcript (const char *a_path)
+{
+    static const string OUTPUT_START = "<debuggeroutput>\n";
+    static const string OUTPUT_END = "\n</debuggeroutput>";
+
+    ifstream file (a_path);
+    ostringstream content;
+    content << file.rdbuf ();
+    string log = content.str (), output;
+    if (log.find (OUTPUT_START) == string::npos) {
+        output = log;
+    } else {
+        string::size_type start = 0, end = 0;
+        while ((start = log.find (OUTPUT_START, end)) != string::npos) {
+            start += OUTPUT_START.size ();
+            end = log.find (OUTPUT_END, start);
+            if (end == string::npos)
+                break;
+            output += log.substr (start, end - start);
+        }
+    }
+
+    istringstream lines (output);
+    string line, answer;
+    bool has_result = false;
+    for (;;) {
+        bool at_end = !getline (lines, line);
+        if (!at_end && line.empty ())
+            continue;
+        if (!at_end && line != "(gdb) " && line != "(gdb)") {
+            string::size_type i = 0;
+            while (i < line.size () && isdigit (line[i]))
+                ++i;
+            if (i < line.size () && line[i] == '^')
+                has_result = true;
+            answer += line + "\n";
+            continue;
+        }
+        if (!answer.empty ()) {
+            if (!has_result)
+                answer += "^done\n";
+            transcript_answers.push_back (answer);
+        }
+        if (at_end)
+            break;
+        answer.clear ();
+        has_result = false;
+    }
+}
+
+/// Return the a_index-th integer argument of a_command, or a_default.
+static int
+int_arg (const string &a_command, unsigned a_index, int a_default)
+{
+    istringstream is (a_command);
+    string word;
+    vector<int> ints;
+    while (is >> word) {
+        if (!word.empty () && isdigit (word[0]))
+            ints.push_back (atoi (word.c_str ()));
+    }
+    return a_index < ints.size () ? ints[a_index] : a_default;
+}
+
+static string
+stopped (const char *a_reason)
+{
+    return "*stopped,reason=\"" + string (a_reason) + "\",frame="
+        + frame (0) + ",thread-id=\"1\",stopped-threads=\"all\"\n";
+}
+
+/// Return the id given to the --thread option of a_command, or 0.
+static int
+thread_option (const string &a_command)
+{
+    string::size_type pos = a_command.find ("--thread ");
+    if (pos == string::npos)
+        return 0;
+    return atoi (a_command.c_str () + pos + 9);
+}
+
+static string
+thread_stopped (int a_thread_id, const char *a_reason)
+{
+    string id = int_to_string (a_thread_id);
+    thread_running[a_thread_id] = false;
+    return "*stopped,reason=\"" + string (a_reason) + "\","
+        + (string (a_reason) == "breakpoint-hit"
+           ? "disp=\"keep\",bkptno=\"1\","
+           : "")
+        + "frame=" + frame (0) + ",thread-id=\"" + id
+        + "\",stopped-threads=[\"" + id + "\"]\n";
+}
+
+/// Resume the thread given to the --thread option of a_command, in
+/// non-stop mode.
+static string
+resume_thread (const string &a_command, bool a_is_step)
+{
+    int thread_id = thread_option (a_command);
+    if (thread_id <= 0 || thread_id > num_threads)
+        return "^error,msg=\"Cannot execute this command without "
+            "a live selected thread.\"\n";
+    string result = "^running\n*running,thread-id=\""
+        + int_to_string (thread_id) + "\"\n(gdb) \n";
+    thread_running[thread_id] = true;
+    if (a_is_step)
+        result += thread_stopped (thread_id, "end-stepping-range")
+            + "(gdb) \n";
+    for (int i = 1; i <= num_threads; ++i) {
+        if (i != thread_id && thread_running[i])
+            return result + thread_stopped (i, "breakpoint-hit");
+    }
+    return result;
+}
+
+static string
+resume ()
+{
+    string result = "^running\n*running,thread-id=\"all\"\n(gdb) \n";
+    if (--num_stops <= 0)
+        return result + "*stopped,reason=\"exited-normally\"\n";
+    ++generation;
+    return result + stopped ("end-stepping-range");
+}
+
+/// Return the change of the variable number a_var at the current
+/// generation: its value and its type become the generation number,
+/// and it gains a child, as a container that grows at each stop
+/// would.  That is, if it wasn't reported yet.
+static string
+var_change (int a_var)
+{
+    if (a_var <= 0
+        || a_var >= (int) var_generations.size ()
+        || var_generations[a_var] < 0
+        || var_generations[a_var] == generation)
+        return "";
+    var_generations[a_var] = generation;
+    string name = "var" + int_to_string (a_var);
+    string gen = int_to_string (generation);
+    string child = int_to_string (generation - 1);
+    return "{name=\"" + name + "\",value=\"" + gen + "\","
+        "in_scope=\"true\",type_changed=\"true\","
+        "new_type=\"Container<" + gen + ">\",new_num_children=\"" + gen
+        + "\",new_children=[{name=\"" + name + "." + child + "\",exp=\"["
+        + child + "]\",numchild=\"0\",value=\"" + child + "\","
+        "type=\"int\"}],has_more=\"0\"}";
+}
+
+/// Answer a -var-update of a single variable object, or of all of
+/// them.
+static string
+var_update (const string &a_command)
+{
+    string target = a_command.substr (a_command.rfind (' ') + 1);
+    string changes;
+    for (int i = 1; i < (int) var_generations.size (); ++i) {
+        if (target != "*" && target != "var" + int_to_string (i))
+            continue;
+        string change = var_change (i);
+        if (change.empty ())
+            continue;
+        if (!changes.empty ())
+            changes += ",";
+        changes += change;
+    }
+    return "^done,changelist=[" + changes + "]\n";
+}
+
+static string
+answer (const string &a_command, bool &a_exit)
+{
+    for (vector<pair<string, string> >::const_iterator it =
+             canned_answers.begin ();
+         it != canned_answers.end ();
+         ++it) {
+        if (starts_with (a_command, it->first.c_str ()))
+            return it->second;
+    }
+
+    if (starts_with (a_command, "-thread-list-ids")
+        && nb_transcript_answers_served < transcript_answers.size ())
+        return transcript_answers[nb_transcript_answers_served++];
+
+    if (starts_with (a_command, "-gdb-exit")
+        || starts_with (a_command, "quit")) {
+        a_exit = true;
+        return "^exit\n";
+    }
+    if (starts_with (a_command, "-gdb-set mi-async") && no_mi_async)
+        return "^error,msg=\"No symbol \\\"mi-async\\\" in current "
+            "context.\"\n";
+    if (starts_with (a_command, "-gdb-set non-stop on")) {
+        non_stop = true;
+        return "^done\n";
+    }
+    if (starts_with (a_command, "-thread-select")) {
+        int thread_id = int_arg (a_command, 0, 1);
+        return "^done,new-thread-id=\"" + int_to_string (thread_id)
+            + "\",frame=" + frame (0) + "\n";
+    }
+    if (starts_with (a_command, "-break-insert")) {
+        ++num_breakpoints;
+        return "^done,bkpt={number=\"" + int_to_string (num_breakpoints)
+            + "\",type=\"breakpoint\",disp=\"keep\",enabled=\"y\","
+            "addr=\"0x0000000000400500\",func=\"main\",file=\""
+            + FRAME_FILE + "\",fullname=\"" + FRAME_FULLNAME
+            + "\",line=\"10\",times=\"0\",original-location=\"main\"}\n";
+    }
+    if ((starts_with (a_command, "-exec-run")
+         || starts_with (a_command, "run"))
+        && non_stop) {
+        thread_running.assign (num_threads + 1, true);
+        return "^running\n*running,thread-id=\"all\"\n(gdb) \n"
+            + thread_stopped (1, "breakpoint-hit");
+    }
+    if (starts_with (a_command, "-exec-run")
+        || starts_with (a_command, "run")) {
+        return "^running\n*running,thread-id=\"all\"\n(gdb) \n"
+            "*stopped,reason=\"breakpoint-hit\",disp=\"keep\","
+            "bkptno=\"1\",frame=" + frame (0)
+            + ",thread-id=\"1\",stopped-threads=\"all\"\n";
+    }
+    if (starts_with (a_command, "-exec-continue")
+        || starts_with (a_command, "-exec-next")
+        || starts_with (a_command, "-exec-step")
+        || starts_with (a_command, "-exec-finish")
+        || starts_with (a_command, "-exec-until")) {
+        if (non_stop)
+            return resume_thread
+                (a_command, !starts_with (a_command, "-exec-continue"));
+        return resume ();
+    }
+    if (starts_with (a_command, "-exec-interrupt") && non_stop) {
+        int thread_id = thread_option (a_command);
+        if (thread_id <= 0 || thread_id > num_threads)
+            return "^error,msg=\"Cannot execute this command without "
+                "a live selected thread.\"\n";
+        return "^done\n(gdb) \n"
+            + thread_stopped (thread_id, "signal-received");
+    }
+    if (starts_with (a_command, "-stack-info-depth"))
+        return "^done,depth=\"" + int_to_string (stack_depth) + "\"\n";
+    if (starts_with (a_command, "-stack-list-frames")) {
+        int low = int_arg (a_command, 0, 0);
+        int high = int_arg (a_command, 1, stack_depth - 1);
+        string result = "^done,stack=[";
+        for (int i = low; i <= high && i < stack_depth; ++i) {
+            if (i != low)
+                result += ",";
+            result += "frame=" + frame (i);
+        }
+        return result + "]\n";
+    }
+    if (starts_with (a_command, "-stack-list-arguments")) {
+        int low = int_arg (a_command, 1, 0);
+        int high = int_arg (a_command, 2, stack_depth - 1);
+        string result = "^done,stack-args=[";
+        for (int i = low; i <= high && i < stack_depth; ++i) {
+            if (i != low)
+                result += ",";
+            result += "frame={level=\"" + int_to_string (i)
+                + "\",args=[{name=\"n\",value=\"" + int_to_string (i)
+                + "\"}]}";
+        }
+        return result + "]\n";
+    }
+    if (starts_with (a_command, "-stack-list-locals"))
+        return "^done,locals=[{name=\"c\",value=\"{...}\"}]\n";
+    if (starts_with (a_command, "-thread-list-ids")) {
+        string result = "^done,thread-ids={";
+        for (int i = 1; i <= num_threads; ++i) {
+            if (i > 1)
+                result += ",";
+            result += "thread-id=\"" + int_to_string (i) + "\"";
+        }
+        return result + "},current-thread-id=\"1\",number-of-threads=\""
+            + int_to_string (num_threads) + "\"\n";
+    }
+    if (starts_with (a_command, "-thread-info")) {
+        string result = "^done,threads=[";
+        for (int i = 1; i <= num_threads; ++i) {
+            if (i > 1)
+                result += ",";
+            result += "{id=\"" + int_to_string (i) + "\",target-id=\"Thread "
+                + int_to_string (i) + " (LWP " + int_to_string (4242 + i)
+                + ")\",frame=" + frame (0) + ",state=\"stopped\"}";
+        }
+        return result + "],current-thread-id=\"1\"\n";
+    }
+    if (starts_with (a_command, "-var-create")) {
+        ++num_variables;
+        var_generations.push_back (generation);
+        if (dynamic_vars)
+            return "^done,name=\"var" + int_to_string (num_variables)
+                + "\",numchild=\"0\",value=\"{...}\",type=\"Container\","
+                "thread-id=\"1\",dynamic=\"1\",has_more=\"1\"\n";
+        return "^done,name=\"var" + int_to_string (num_variables)
+            + "\",numchild=\"" + int_to_string (num_children)
+            + "\",value=\"{...}\",type=\"Container\",thread-id=\"1\","
+            "has_more=\"0\"\n";
+    }
+    if (starts_with (a_command, "-var-list-children")) {
+        istringstream is (a_command);
+        string word, name;
+        while (is >> word) {
+            if (starts_with (word, "var"))
+                name = word;
+        }
+        int from = 0, to = num_children;
+        if (dynamic_vars) {
+            from = int_arg (a_command, 0, 0);
+            to = int_arg (a_command, 1, num_children);
+            if (to > num_children)
+                to = num_children;
+        }
+        if (child_cost_us > 0 && to > from)
+            usleep ((to - from) * child_cost_us);
+        string result = "^done,numchild=\"" + int_to_string (to - from)
+            + "\",children=[";
+        for (int i = from; i < to; ++i) {
+            if (i > from)
+                result += ",";
+            result += "child={name=\"" + name + "." + int_to_string (i)
+                + "\",exp=\"[" + int_to_string (i) + "]\",numchild=\"0\","
+                "value=\"" + int_to_string (i) + "\",type=\"int\","
+                "thread-id=\"1\"}";
+        }
+        return result + "],has_more=\""
+            + (to < num_children ? "1" : "0") + "\"\n";
+    }
+    if (starts_with (a_command, "-var-update")) {
+        if (report_var_changes)
+            return var_update (a_command);
+        return "^done,changelist=[]\n";
+    }
+    if (starts_with (a_command, "-var-delete")) {
+        int var = atoi (a_command.c_str () + a_command.rfind ("var") + 3);
+        if (var > 0 && var < (int) var_generations.size ())
+            var_generations[var] = -1;
+        return "^done,ndeleted=\"1\"\n";
+    }
+    if (starts_with (a_command, "-data-list-register-names"))
+        return "^done,register-names=[\"rax\",\"rbx\",\"rcx\",\"rdx\","
+            "\"rsi\",\"rdi\",\"rbp\",\"rsp\",\"rip\",\"eflags\"]\n";
+    if (starts_with (a_command, "-data-list-changed-registers"))
+        return "^done,changed-registers=[\"8\"]\n";
+    if (starts_with (a_command, "-data-list-register-values")) {
+        string result = "^done,register-values=[";
+        for (int i = 0; i < 10; ++i) {
+            if (i)
+                result += ",";
+            result += "{number=\"" + int_to_string (i) + "\",value=\"0x"
+                + int_to_string (i) + "\"}";
+        }
+        return result + "]\n";
+    }
+    if (starts_with (a_command, "info proc"))
+        return "~\"process 4242\\n\"\n~\"exe = '/tmp/fake'\\n\"\n^done\n";
+    return "^done\n";
+}
+
+int
+main (int argc, char *argv[])
+{
+    latency_ms = env_int ("NMV_FAKE_GDB_LATENCY_MS", latency_ms);
+    startup_ms = env_int ("NMV_FAKE_GDB_STARTUP_MS", startup_ms);
+    stack_depth = env_int ("NMV_FAKE_GDB_STACK_DEPTH", stack_depth);
+    num_threads = env_int ("NMV_FAKE_GDB_NUM_THREADS", num_threads);
+    num_children = env_int ("NMV_FAKE_GDB_NUM_CHILDREN", num_children);
+    dynamic_vars = env_int ("NMV_FAKE_GDB_DYNAMIC", 0) != 0;
+    child_cost_us = env_int ("NMV_FAKE_GDB_CHILD_COST_US", child_cost_us);
+    num_stops = env_int ("NMV_FAKE_GDB_NUM_STOPS", num_stops);
+    no_mi_async = env_int ("NMV_FAKE_GDB_NO_MI_ASYNC", 0) != 0;
+    report_var_changes = env_int ("NMV_FAKE_GDB_VAR_CHANGES", 0) != 0;
+    if (stack_depth < 1)
+        stack_depth = 1;
+    if (getenv ("NMV_FAKE_GDB_SCENARIO"))
+        load_scenario (getenv ("NMV_FAKE_GDB_SCENARIO"));
+    if (getenv ("NMV_FAKE_GDB_TRANSCRIPT"))
+        load_transcript (getenv ("NMV_FAKE_GDB_TRANSCRIPT"));
+
+    // Count the files given on the command line, skipping the
+    // options and the commands given to -iex and -ex.
+    int nb_files = 0;
+    for (int i = 1; i < argc; ++i) {
+        string arg = argv[i];
+        if (arg == "-iex" || arg == "-ex")
+            ++i;
+        else if (arg[0] != '-')
+            ++nb_files;
+    }
+
+    if (startup_ms > 0)
+        usleep (startup_ms * 1000);
+
+    cout << "~\"fake GDB/MI server\\n\"\n";
+    if (nb_files > 1)
+        cout << "~\"Core was generated by `/tmp/fake'.\\n\"\n"
+                "~\"Program terminated with signal SIGSEGV, "
+                "Segmentation fault.\\n\"\n"
+                "~\"#0  0x0000000000400500 in " << FRAME_FUNC
+             << " () at " << FRAME_FILE << ":10\\n\"\n";
+    cout << "(gdb) \n" << flush;
+
+    string command;
+    bool do_exit = false;
+    while (!do_exit && getline (cin, command)) {
+        // Strip the optional command token.
+        string::size_type i = 0;
+        while (i < command.size () && isdigit (command[i]))
+            ++i;
+        string token = command.substr (0, i);
+        command.erase (0, i);
+        if (command.empty ())
+            continue;
+
+        if (latency_ms > 0)
+            usleep (latency_ms * 1000);
+
+        string result = answer (command, do_exit);
+        if (!token.empty () && result[0] == '^')
+            result = token + result;
+        cout << result;
+        if (!do_exit)
+            cout << "(gdb) \n";
+        cout << flush;
+    }
+    return 0;
+}
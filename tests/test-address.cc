@@ -0,0 +1,154 @@
+#include "config.h"
+#include <algorithm>
+#include <cstdlib>
+#include <iostream>
+#include <map>
+#include <vector>
+#include <boost/test/minimal.hpp>
+#include <glibmm/timer.h>
+#include "common/nmv-initializer.h"
+#include "common/nmv-exception.h"
+#include "common/nmv-address.h"
+#include "common/nmv-str-utils.h"
+
+// Checks the semantics of common::Address, and measures how fast
+// addresses are sorted and looked up in a map, compared to the
+// textual addresses that were converted with str_utils::hexa_to_int
+// at each comparison.
+//
+// Usage: runtestaddress [number-of-addresses]
+
+using namespace std;
+using namespace nemiver;
+using namespace nemiver::common;
+
+/// Compare textual addresses the way Address used to: by parsing
+/// them at each comparison.
+struct TextualAddressLess {
+    bool operator() (const string &a_lhs, const string &a_rhs) const
+    {
+        return (size_t) str_utils::hexa_to_int (a_lhs)
+            < (size_t) str_utils::hexa_to_int (a_rhs);
+    }
+};
+
+static void
+test_semantics ()
+{
+    Address empty;
+    BOOST_REQUIRE (empty.empty ());
+    BOOST_REQUIRE ((size_t) empty == 0);
+
+    // Addresses compare as integers, whatever their width.
+    Address a ("0x9"), b ("0x10"), c ("0x0000000000000010");
+    BOOST_REQUIRE (a < b);
+    BOOST_REQUIRE (b == c);
+    BOOST_REQUIRE (b <= c && b >= c);
+    BOOST_REQUIRE (!(b < c) && !(b > c));
+    BOOST_REQUIRE (c == (size_t) 16);
+    BOOST_REQUIRE (c.to_string () == "0x0000000000000010");
+    BOOST_REQUIRE (c == string ("0x0000000000000010"));
+    BOOST_REQUIRE (c.size () == 16);
+
+    // The textual form of an address built from an integer.
+    Address d ((size_t) 0x400500);
+    BOOST_REQUIRE (!d.empty ());
+    BOOST_REQUIRE (d.to_string () == "0x400500");
+    BOOST_REQUIRE (d.string_size () == 8);
+    BOOST_REQUIRE (d[2] == '4');
+    BOOST_REQUIRE (d == Address ("0x400500"));
+
+    d.clear ();
+    BOOST_REQUIRE (d.empty ());
+    d = "0x20";
+    BOOST_REQUIRE ((size_t) d == 0x20);
+
+    bool thrown = false;
+    try {
+        Address bad ("not an address");
+    } catch (Exception &) {
+        thrown = true;
+    }
+    BOOST_REQUIRE (thrown);
+}
+
+static void
+bench (unsigned a_nb_addresses)
+{
+    vector<string> texts;
+    vector<Address> addresses;
+    for (unsigned i = 0; i < a_nb_addresses; ++i) {
+        // Spread the addresses around, in no particular order.
+        size_t value = 0x400000 + (i * 2654435761UL) % (16 * a_nb_addresses);
+        texts.push_back (Address (value).to_string ());
+        addresses.push_back (Address (texts.back ()));
+    }
+
+    Glib::Timer timer;
+    vector<string> sorted_texts = texts;
+    timer.start ();
+    std::sort (sorted_texts.begin (), sorted_texts.end (),
+               TextualAddressLess ());
+    timer.stop ();
+    double textual_sort = timer.elapsed ();
+
+    vector<Address> sorted_addresses = addresses;
+    timer.start ();
+    std::sort (sorted_addresses.begin (), sorted_addresses.end ());
+    timer.stop ();
+    double numeric_sort = timer.elapsed ();
+
+    for (unsigned i = 0; i < a_nb_addresses; ++i)
+        BOOST_REQUIRE (sorted_addresses[i]
+                       == Address (sorted_texts[i]));
+
+    map<string, unsigned, TextualAddressLess> textual_map;
+    map<Address, unsigned> numeric_map;
+    for (unsigned i = 0; i < a_nb_addresses; ++i) {
+        textual_map[texts[i]] = i;
+        numeric_map[addresses[i]] = i;
+    }
+
+    unsigned long nb_found = 0;
+    timer.start ();
+    for (unsigned i = 0; i < a_nb_addresses; ++i)
+        nb_found += textual_map.count (texts[i]);
+    timer.stop ();
+    double textual_lookup = timer.elapsed ();
+
+    timer.start ();
+    for (unsigned i = 0; i < a_nb_addresses; ++i)
+        nb_found += numeric_map.count (addresses[i]);
+    timer.stop ();
+    double numeric_lookup = timer.elapsed ();
+    BOOST_REQUIRE (nb_found == 2 * (unsigned long) a_nb_addresses);
+
+    cout << "addresses: " << a_nb_addresses << "\n"
+         << "sort, parsed at each comparison: "
+         << textual_sort * 1000 << "ms\n"
+         << "sort, parsed once: " << numeric_sort * 1000 << "ms\n"
+         << "map lookups, parsed at each comparison: "
+         << textual_lookup * 1000 << "ms\n"
+         << "map lookups, parsed once: "
+         << numeric_lookup * 1000 << "ms" << endl;
+}
+
+NEMIVER_API int
+test_main (int argc, char *argv[])
+{
+    NEMIVER_TRY;
+
+    Initializer::do_init ();
+
+    test_semantics ();
+
+    unsigned nb_addresses = 100000;
+    if (argc > 1)
+        nb_addresses = atoi (argv[1]);
+    BOOST_REQUIRE (nb_addresses > 0);
+    bench (nb_addresses);
+
+    NEMIVER_CATCH_NOX;
+
+    return 0;
+}
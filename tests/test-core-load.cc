@@ -0,0 +1,133 @@
+#include "config.h"
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <boost/test/minimal.hpp>
+#include <glibmm/timer.h>
+#include "common/nmv-initializer.h"
+#include "common/nmv-safe-ptr-utils.h"
+#include "common/nmv-exception.h"
+#include "nmv-debugger-utils.h"
+
+// Opens a core file the way the debugging perspective does, with
+// GDBEngine driving the fake GDB/MI server (fakegdbmi), and measures
+// the time to first frame: the time from IDebugger::load_core_file
+// to the first window of frames of the crashing thread being shown
+// with their arguments.
+//
+// Like DBGPerspective::load_core_file, the program only asks for the
+// stack, through the same calls as CallStack::update_stack: the
+// frames are listed with a slot, then their arguments.  It doesn't
+// subscribe to the signals of the engine, so that anything else the
+// engine would do on its own on a core is accounted for.  The threads
+// are only listed after that, as the thread list does when it is
+// drawn.
+//
+// Usage: runtestcoreload [--max-ms=N] [number-of-threads]
+//
+// The program fails if the time to first frame exceeds the value
+// given by --max-ms (default: 2000).
+
+using namespace nemiver;
+using namespace nemiver::common;
+
+static Glib::RefPtr<Glib::MainLoop> loop =
+    Glib::MainLoop::create (Glib::MainContext::get_default ());
+
+// The number of frames CallStack lists at once, by default.
+static const int FRAME_WINDOW = 25;
+
+static Glib::Timer load_timer;
+static double time_to_first_frame = -1;
+static unsigned nb_threads = 0;
+
+static void
+on_engine_died_signal ()
+{
+    MESSAGE ("engine died");
+    loop->quit ();
+}
+
+static void
+on_frames_args_listed (const map<int, IDebugger::VariableList> &/*a_args*/,
+                       IDebuggerSafePtr &a_debugger)
+{
+    if (time_to_first_frame >= 0)
+        return;
+    load_timer.stop ();
+    time_to_first_frame = load_timer.elapsed ();
+    a_debugger->list_threads_info ();
+}
+
+/// Like CallStack::Priv::on_frames_listed: ask for the arguments of
+/// the frames just listed.
+static void
+on_frames_listed (const vector<IDebugger::Frame> &a_frames,
+                  IDebuggerSafePtr &a_debugger)
+{
+    BOOST_REQUIRE (!a_frames.empty ());
+    a_debugger->list_frames_arguments
+        (a_frames[0].level (),
+         a_frames[a_frames.size () - 1].level (),
+         sigc::bind (&on_frames_args_listed, a_debugger),
+         "");
+}
+
+static void
+on_threads_info_listed_signal
+                        (const std::list<IDebugger::ThreadInfo> &a_threads,
+                         const UString &/*a_cookie*/)
+{
+    nb_threads = a_threads.size ();
+    loop->quit ();
+}
+
+NEMIVER_API int
+test_main (int argc, char *argv[])
+{
+    NEMIVER_TRY;
+
+    Initializer::do_init ();
+
+    THROW_IF_FAIL (loop);
+
+    double max_ms = 2000;
+    for (int i = 1; i < argc; ++i) {
+        if (!strncmp (argv[i], "--max-ms=", 9))
+            max_ms = atof (argv[i] + 9);
+        else
+            g_setenv ("NMV_FAKE_GDB_NUM_THREADS", argv[i], TRUE);
+    }
+    if (!g_getenv ("NMV_FAKE_GDB_NUM_THREADS"))
+        g_setenv ("NMV_FAKE_GDB_NUM_THREADS", "2000", TRUE);
+
+    IDebuggerSafePtr debugger =
+        debugger_utils::load_debugger_iface_with_confmgr ();
+
+    debugger->set_event_loop_context (loop->get_context ());
+    debugger->set_non_persistent_debugger_path
+                                (NEMIVER_BUILDDIR "/fakegdbmi");
+
+    debugger->engine_died_signal ().connect (&on_engine_died_signal);
+
+    debugger->threads_info_listed_signal ().connect
+        (&on_threads_info_listed_signal);
+
+    load_timer.start ();
+    debugger->load_core_file ("fooprog", "core");
+    debugger->list_frames (0, FRAME_WINDOW,
+                           sigc::bind (&on_frames_listed, debugger),
+                           "");
+    loop->run ();
+
+    BOOST_REQUIRE (time_to_first_frame >= 0);
+    BOOST_REQUIRE (nb_threads > 0);
+    std::cout << "time to first frame: " << time_to_first_frame * 1000
+              << "ms\n"
+              << "threads listed afterwards: " << nb_threads << std::endl;
+    BOOST_REQUIRE (time_to_first_frame * 1000 <= max_ms);
+
+    NEMIVER_CATCH_NOX;
+
+    return 0;
+}
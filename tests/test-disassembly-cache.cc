@@ -0,0 +1,137 @@
+#include "config.h"
+#include <list>
+#include <string>
+#include <boost/test/minimal.hpp>
+#include "common/nmv-initializer.h"
+#include "common/nmv-exception.h"
+#include "common/nmv-address.h"
+#include "nmv-disassembly-cache.h"
+
+// Checks that DisassemblyCache, that the debugger perspective uses to
+// avoid disassembling the same code again, merges the ranges that
+// overlap or touch as they are added, but not the ones that are
+// apart; that contains and lookup only succeed for ranges that are
+// entirely cached; and that pure asm and mixed source/asm
+// instructions are kept apart.
+
+using namespace std;
+using namespace nemiver;
+using namespace nemiver::common;
+
+/// \return the pure asm instructions of [a_min, a_max[, one every 4
+/// bytes.
+static list<Asm>
+instrs (size_t a_min, size_t a_max)
+{
+    list<Asm> result;
+    for (size_t addr = a_min; addr < a_max; addr += 4) {
+        result.push_back (AsmInstr (Address (addr).to_string (),
+                                    "main", "0", "nop"));
+    }
+    return result;
+}
+
+static void
+add (DisassemblyCache &a_cache, size_t a_min, size_t a_max,
+     bool a_pure_asm = true)
+{
+    a_cache.add (Range (a_min, a_max), a_pure_asm, DisassembleInfo (),
+                 instrs (a_min, a_max));
+}
+
+static list<size_t>
+lookup (const DisassemblyCache &a_cache, size_t a_min, size_t a_max)
+{
+    DisassembleInfo info;
+    list<Asm> found;
+    list<size_t> addresses;
+    if (!a_cache.lookup (Range (a_min, a_max), true, info, found))
+        return addresses;
+    for (list<Asm>::const_iterator it = found.begin ();
+         it != found.end ();
+         ++it)
+        addresses.push_back (it->instr ().address ());
+    return addresses;
+}
+
+static void
+test_merge ()
+{
+    DisassemblyCache cache;
+    BOOST_REQUIRE (!cache.contains (Range (0x100, 0x104), true));
+
+    add (cache, 0x100, 0x110);
+    BOOST_REQUIRE (cache.contains (Range (0x100, 0x110), true));
+    BOOST_REQUIRE (cache.contains (Range (0x104, 0x108), true));
+    BOOST_REQUIRE (!cache.contains (Range (0x100, 0x111), true));
+    BOOST_REQUIRE (!cache.contains (Range (0xfc, 0x104), true));
+
+    // A range that touches the end of a cached one is merged with it.
+    add (cache, 0x110, 0x120);
+    BOOST_REQUIRE (cache.contains (Range (0x100, 0x120), true));
+    list<size_t> found = lookup (cache, 0x10c, 0x118);
+    BOOST_REQUIRE (found.size () == 3);
+    BOOST_REQUIRE (found.front () == 0x10c);
+    BOOST_REQUIRE (found.back () == 0x114);
+
+    // One that is apart isn't, so the gap isn't cached.
+    add (cache, 0x200, 0x210);
+    BOOST_REQUIRE (cache.contains (Range (0x200, 0x210), true));
+    BOOST_REQUIRE (!cache.contains (Range (0x100, 0x210), true));
+    BOOST_REQUIRE (!cache.contains (Range (0x120, 0x124), true));
+    BOOST_REQUIRE (lookup (cache, 0x11c, 0x204).empty ());
+
+    // Filling the gap, and overlapping both of its ends, merges
+    // everything.
+    add (cache, 0x118, 0x204);
+    BOOST_REQUIRE (cache.contains (Range (0x100, 0x210), true));
+    found = lookup (cache, 0x100, 0x210);
+    BOOST_REQUIRE (found.size () == (0x210 - 0x100) / 4);
+    // Each instruction is there once, in address order.
+    size_t expected = 0x100;
+    for (list<size_t>::const_iterator it = found.begin ();
+         it != found.end ();
+         ++it, expected += 4)
+        BOOST_REQUIRE (*it == expected);
+
+    // A range included in a cached one changes nothing.
+    add (cache, 0x140, 0x150);
+    BOOST_REQUIRE (lookup (cache, 0x100, 0x210).size () == found.size ());
+
+    // Neither does an empty one.
+    add (cache, 0x300, 0x300);
+    BOOST_REQUIRE (!cache.contains (Range (0x300, 0x301), true));
+
+    cache.clear ();
+    BOOST_REQUIRE (!cache.contains (Range (0x100, 0x104), true));
+    BOOST_REQUIRE (lookup (cache, 0x100, 0x104).empty ());
+}
+
+static void
+test_pure_and_mixed ()
+{
+    DisassemblyCache cache;
+    add (cache, 0x100, 0x110, true);
+    BOOST_REQUIRE (cache.contains (Range (0x100, 0x110), true));
+    BOOST_REQUIRE (!cache.contains (Range (0x100, 0x110), false));
+
+    add (cache, 0x108, 0x120, false);
+    BOOST_REQUIRE (cache.contains (Range (0x108, 0x120), false));
+    BOOST_REQUIRE (!cache.contains (Range (0x100, 0x120), false));
+    BOOST_REQUIRE (!cache.contains (Range (0x100, 0x120), true));
+}
+
+NEMIVER_API int
+test_main (int, char **)
+{
+    NEMIVER_TRY;
+
+    Initializer::do_init ();
+
+    test_merge ();
+    test_pure_and_mixed ();
+
+    NEMIVER_CATCH_NOX;
+
+    return 0;
+}
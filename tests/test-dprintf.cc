@@ -0,0 +1,201 @@
+#include "config.h"
+#include <fstream>
+#include <boost/test/minimal.hpp>
+#include <glib/gstdio.h>
+#include "common/nmv-initializer.h"
+#include "common/nmv-safe-ptr-utils.h"
+#include "common/nmv-exception.h"
+#include "nmv-debugger-utils.h"
+#include "nmv-gdbmi-parser.h"
+
+// Checks the splitting of the message of a dprintf, as typed by the
+// user, into its format and its arguments.
+//
+// Then has the fake GDB/MI server (fakegdbmi) print console stream
+// records, as GDB does when dprintf are hit, and checks that
+// GDBEngine emits the output of the dprintf on dprintf_output_signal
+// and nothing else: the records that don't start with the marker
+// GDBEngine puts in the formats go to the console, unless they are
+// the rest of the message of a hit that GDB split across records.
+
+using namespace std;
+using namespace nemiver;
+using namespace nemiver::common;
+
+static Glib::RefPtr<Glib::MainLoop> loop =
+    Glib::MainLoop::create (Glib::MainContext::get_default ());
+
+static const char *WARM_UP_COOKIE = "dprintf-warm-up";
+static const char *OUTPUT_COOKIE = "dprintf-output";
+
+static void
+test_split_dprintf_message ()
+{
+    UString format;
+    vector<UString> args;
+
+    BOOST_REQUIRE (debugger_utils::split_dprintf_message
+                        ("\"i = %d, j = %d\\n\", i, f (i, j)", format, args));
+    BOOST_REQUIRE (format == "i = %d, j = %d\\n");
+    BOOST_REQUIRE (args.size () == 2);
+    BOOST_REQUIRE (args[0] == "i");
+    BOOST_REQUIRE (args[1] == "f (i, j)");
+
+    // No argument.
+    BOOST_REQUIRE (debugger_utils::split_dprintf_message
+                                    ("  \"hello\"", format, args));
+    BOOST_REQUIRE (format == "hello");
+    BOOST_REQUIRE (args.empty ());
+
+    // The commas and quotes of the format and of the arguments that
+    // are in a string literal, or in brackets, don't split anything.
+    BOOST_REQUIRE (debugger_utils::split_dprintf_message
+                        ("\"a \\\"q\\\", %s %c %d\", \"b,c\", ',', t[1, 2]",
+                         format, args));
+    BOOST_REQUIRE (format == "a \\\"q\\\", %s %c %d");
+    BOOST_REQUIRE (args.size () == 3);
+    BOOST_REQUIRE (args[0] == "\"b,c\"");
+    BOOST_REQUIRE (args[1] == "','");
+    BOOST_REQUIRE (args[2] == "t[1, 2]");
+
+    // The format must come first, in double quotes.
+    BOOST_REQUIRE (!debugger_utils::split_dprintf_message
+                                        ("i, \"%d\"", format, args));
+    BOOST_REQUIRE (!debugger_utils::split_dprintf_message
+                                        ("\"i = %d, i", format, args));
+    BOOST_REQUIRE (!debugger_utils::split_dprintf_message ("", format, args));
+}
+
+struct Output {
+    UString dprintf;
+    UString console;
+    bool done;
+
+    Output () :
+        done (false)
+    {}
+};
+
+static void
+on_dprintf_output_signal (const UString &a_output, Output *a_out)
+{
+    a_out->dprintf += a_output;
+}
+
+static void
+on_console_message_signal (const UString &a_output, Output *a_out)
+{
+    a_out->console += a_output;
+}
+
+static void
+on_command_done_signal (const UString &a_name,
+                        const UString &a_cookie,
+                        IDebuggerSafePtr &a_debugger,
+                        Output *a_out)
+{
+    if (a_cookie == WARM_UP_COOKIE) {
+        // Forget about what GDB printed as it started.
+        a_out->dprintf.clear ();
+        a_out->console.clear ();
+        // fakegdbmi answers -thread-list-ids from the transcript.
+        a_debugger->list_threads (OUTPUT_COOKIE);
+    } else if (a_cookie == OUTPUT_COOKIE && a_name == "list-threads") {
+        a_out->done = true;
+        loop->quit ();
+    }
+}
+
+static void
+on_engine_died_signal ()
+{
+    MESSAGE ("engine died");
+    loop->quit ();
+}
+
+static bool
+on_timeout ()
+{
+    MESSAGE ("timed out");
+    loop->quit ();
+    return false;
+}
+
+static void
+test_dprintf_output ()
+{
+    const string marker = GDBMI_DPRINTF_MARKER;
+    const string transcript_path = "dprintf-transcript";
+    {
+        ofstream transcript (transcript_path.c_str ());
+        // A hit; a console record without marker; a hit which
+        // message got split across two records; and two hits in
+        // one record.
+        transcript << "~\"" << marker << "i = 1\\n\"\n"
+                   << "~\"hello\\n\"\n"
+                   << "~\"" << marker << "i = \"\n"
+                   << "~\"2\\n\"\n"
+                   << "~\"" << marker << "i = 3\\n"
+                   << marker << "i = 4\\n\"\n"
+                   << "~\"bye\\n\"\n"
+                   << "^done,thread-ids={thread-id=\"1\"},"
+                      "current-thread-id=\"1\",number-of-threads=\"1\"\n"
+                   << "(gdb) \n";
+    }
+    g_setenv ("NMV_FAKE_GDB_TRANSCRIPT", transcript_path.c_str (), TRUE);
+
+    IDebuggerSafePtr debugger =
+        debugger_utils::load_debugger_iface_with_confmgr ();
+    debugger->set_event_loop_context (loop->get_context ());
+    debugger->set_non_persistent_debugger_path
+                                (NEMIVER_BUILDDIR "/fakegdbmi");
+
+    Output out;
+    debugger->dprintf_output_signal ().connect
+        (sigc::bind (&on_dprintf_output_signal, &out));
+    debugger->console_message_signal ().connect
+        (sigc::bind (&on_console_message_signal, &out));
+    debugger->command_done_signal ().connect
+        (sigc::bind (&on_command_done_signal, debugger, &out));
+    debugger->engine_died_signal ().connect (&on_engine_died_signal);
+
+    // The fake server doesn't look at the program; it just has to
+    // exist for the engine to accept it.
+    std::vector<UString> args, source_search_dir;
+    source_search_dir.push_back (".");
+    debugger->load_program ("fooprog", args, ".",
+                            source_search_dir, "", -1, false);
+    debugger->list_register_names (WARM_UP_COOKIE);
+
+    sigc::connection timeout =
+        Glib::signal_timeout ().connect (&on_timeout, 10000);
+    loop->run ();
+    timeout.disconnect ();
+    debugger->exit_engine ();
+
+    g_unsetenv ("NMV_FAKE_GDB_TRANSCRIPT");
+    g_unlink (transcript_path.c_str ());
+
+    BOOST_REQUIRE (out.done);
+    MESSAGE ("dprintf output: '" << out.dprintf << "'");
+    MESSAGE ("console output: '" << out.console << "'");
+    BOOST_REQUIRE (out.dprintf == "i = 1\ni = 2\ni = 3\ni = 4\n");
+    BOOST_REQUIRE (out.console == "hello\nbye\n");
+}
+
+NEMIVER_API int
+test_main (int, char **)
+{
+    NEMIVER_TRY;
+
+    Initializer::do_init ();
+
+    THROW_IF_FAIL (loop);
+
+    test_split_dprintf_message ();
+    test_dprintf_output ();
+
+    NEMIVER_CATCH_NOX;
+
+    return 0;
+}
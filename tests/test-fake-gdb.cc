@@ -0,0 +1,227 @@
+#include "config.h"
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <boost/test/minimal.hpp>
+#include <glibmm/timer.h>
+#include "common/nmv-initializer.h"
+#include "common/nmv-safe-ptr-utils.h"
+#include "common/nmv-exception.h"
+#include "nmv-debugger-utils.h"
+
+// Drives GDBEngine against the fake GDB/MI server (fakegdbmi) rather
+// than against a real GDB, and measures how long it takes, after
+// each stop of the inferior, to get its call stack and its threads.
+// As the fake server answers instantly (unless
+// NMV_FAKE_GDB_LATENCY_MS says otherwise), what is measured is the
+// cost of the engine itself: queueing the commands, parsing their
+// output and emitting the signals.
+//
+// The size of what the fake server answers is set by the
+// NMV_FAKE_GDB_* environment variables; see fake-gdbmi.cc.
+//
+// It also measures how long the main loop stays unable to handle
+// user input: a timeout fires every PROBE_INTERVAL_MS milliseconds
+// and records how late it is.  Flooding the engine with thousands
+// of threads shows whether parsing the replies stalls the main loop.
+// Set NMV_SYNCHRONOUS_MI_READER to parse them on the main loop
+// rather than on the reader thread, to compare.
+//
+// Usage: runtestfakegdb [--max-stall-ms=N] [number-of-frames
+//                        [number-of-threads]]
+//
+// The program fails if the 99th percentile of the main loop stalls
+// exceeds the value given by --max-stall-ms (default:
+// DEFAULT_MAX_STALL_MS).
+
+using namespace nemiver;
+using namespace nemiver::common;
+
+static Glib::RefPtr<Glib::MainLoop> loop =
+    Glib::MainLoop::create (Glib::MainContext::get_default ());
+
+static unsigned num_stops = 0;
+static bool got_frames = false;
+static bool got_threads = false;
+static Glib::Timer stop_timer;
+static Glib::Timer total_timer;
+static std::vector<double> stop_latencies;
+
+static const unsigned PROBE_INTERVAL_MS = 5;
+static Glib::Timer probe_timer;
+static std::vector<double> probe_delays;
+static double stall_p99_ms = -1;
+
+// Generous, so that a loaded machine doesn't make the test fail; a
+// main loop that parses big replies itself stalls for longer.
+static const double DEFAULT_MAX_STALL_MS = 250;
+
+/// Record how late the main loop called us.
+static bool
+on_probe_timeout ()
+{
+    double delay = probe_timer.elapsed () * 1000 - PROBE_INTERVAL_MS;
+    probe_delays.push_back (delay > 0 ? delay : 0);
+    probe_timer.start ();
+    return true;
+}
+
+static void
+on_engine_died_signal ()
+{
+    MESSAGE ("engine died");
+    loop->quit ();
+}
+
+static void
+on_program_finished_signal ()
+{
+    total_timer.stop ();
+    MESSAGE ("program finished");
+    BOOST_REQUIRE (num_stops > 0);
+    BOOST_REQUIRE (stop_latencies.size () == num_stops);
+
+    std::sort (stop_latencies.begin (), stop_latencies.end ());
+    std::sort (probe_delays.begin (), probe_delays.end ());
+    if (probe_delays.empty ())
+        probe_delays.push_back (total_timer.elapsed () * 1000);
+    stall_p99_ms = probe_delays[probe_delays.size () * 99 / 100];
+    std::cout << "stops: " << num_stops << "\n"
+              << "total: " << total_timer.elapsed () << "s\n"
+              << "stop to frames and threads, p50: "
+              << stop_latencies[stop_latencies.size () / 2] * 1000
+              << "ms\n"
+              << "stop to frames and threads, max: "
+              << stop_latencies.back () * 1000 << "ms\n"
+              << "main loop stall, p99: "
+              << stall_p99_ms << "ms\n"
+              << "main loop stall, max: "
+              << probe_delays.back () << "ms" << std::endl;
+    loop->quit ();
+}
+
+static void
+maybe_step (IDebuggerSafePtr &a_debugger)
+{
+    if (!got_frames || !got_threads)
+        return;
+    stop_timer.stop ();
+    stop_latencies.push_back (stop_timer.elapsed ());
+    a_debugger->step_over ();
+}
+
+static void
+on_stopped_signal (IDebugger::StopReason a_reason,
+                   bool /*a_has_frame*/,
+                   const IDebugger::Frame &/*a_frame*/,
+                   int /*a_thread_id*/,
+                   const string &/*a_bp_num*/,
+                   const UString &/*a_cookie*/,
+                   IDebuggerSafePtr &a_debugger)
+{
+    if (a_reason == IDebugger::EXITED_SIGNALLED
+        || a_reason == IDebugger::EXITED_NORMALLY
+        || a_reason == IDebugger::EXITED)
+        return;
+    ++num_stops;
+    got_frames = got_threads = false;
+    stop_timer.start ();
+    a_debugger->list_frames ();
+    a_debugger->list_threads_info ();
+}
+
+static void
+on_frames_listed_signal (const vector<IDebugger::Frame> &a_frames,
+                         const UString &/*a_cookie*/,
+                         IDebuggerSafePtr &a_debugger)
+{
+    BOOST_REQUIRE (!a_frames.empty ());
+    got_frames = true;
+    maybe_step (a_debugger);
+}
+
+static void
+on_threads_info_listed_signal
+                        (const std::list<IDebugger::ThreadInfo> &a_threads,
+                         const UString &/*a_cookie*/,
+                         IDebuggerSafePtr &a_debugger)
+{
+    BOOST_REQUIRE (!a_threads.empty ());
+    got_threads = true;
+    maybe_step (a_debugger);
+}
+
+NEMIVER_API int
+test_main (int argc, char *argv[])
+{
+    NEMIVER_TRY;
+
+    Initializer::do_init ();
+
+    THROW_IF_FAIL (loop);
+
+    double max_stall_ms = DEFAULT_MAX_STALL_MS;
+    int nb_positional_args = 0;
+    for (int i = 1; i < argc; ++i) {
+        if (!strncmp (argv[i], "--max-stall-ms=", 15))
+            max_stall_ms = atof (argv[i] + 15);
+        else if (nb_positional_args++ == 0)
+            g_setenv ("NMV_FAKE_GDB_STACK_DEPTH", argv[i], TRUE);
+        else
+            g_setenv ("NMV_FAKE_GDB_NUM_THREADS", argv[i], TRUE);
+    }
+
+    IDebuggerSafePtr debugger =
+        debugger_utils::load_debugger_iface_with_confmgr ();
+
+    debugger->set_event_loop_context (loop->get_context ());
+    debugger->set_non_persistent_debugger_path
+                                (NEMIVER_BUILDDIR "/fakegdbmi");
+
+    //*****************************
+    //<connect to IDebugger events>
+    //*****************************
+
+    debugger->engine_died_signal ().connect (&on_engine_died_signal);
+
+    debugger->program_finished_signal ().connect
+        (&on_program_finished_signal);
+
+    debugger->stopped_signal ().connect
+        (sigc::bind (&on_stopped_signal, debugger));
+
+    debugger->frames_listed_signal ().connect
+        (sigc::bind (&on_frames_listed_signal, debugger));
+
+    debugger->threads_info_listed_signal ().connect
+        (sigc::bind (&on_threads_info_listed_signal, debugger));
+
+    //*****************************
+    //</connect to IDebugger events>
+    //*****************************
+
+    // The fake server doesn't look at the program; it just has to
+    // exist for the engine to accept it.
+    std::vector<UString> args, source_search_dir;
+    debugger->enable_pretty_printing (false);
+    source_search_dir.push_back (".");
+    debugger->load_program ("fooprog", args, ".",
+                            source_search_dir, "",
+                            false);
+    debugger->set_breakpoint ("main");
+
+    Glib::signal_timeout ().connect (sigc::ptr_fun (&on_probe_timeout),
+                                     PROBE_INTERVAL_MS);
+    probe_timer.start ();
+    total_timer.start ();
+    debugger->run ();
+    loop->run ();
+
+    BOOST_REQUIRE (stall_p99_ms >= 0);
+    BOOST_REQUIRE (stall_p99_ms <= max_stall_ms);
+
+    NEMIVER_CATCH_NOX;
+
+    return 0;
+}
@@ -0,0 +1,620 @@
+#include "config.h"
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <boost/test/minimal.hpp>
+#include <glibmm/main.h>
+#include <glibmm/timer.h>
+#include <glib/gstdio.h>
+#include "common/nmv-initializer.h"
+#include "common/nmv-exception.h"
+#include "common/nmv-interned-string.h"
+#include "dbgengine/nmv-dbg-common.h"
+#include "dbgengine/nmv-gdbmi-parser.h"
+#include "nmv-debugger-utils.h"
+#include "alloc-counter.h"
+
+// Replays GDB/MI output through GDBMIParser, the way
+// GDBEngine::Priv::on_gdb_stdout_signal feeds it, and reports the
+// throughput of the parser.
+//
+// The output replayed is either the content of the transcripts given
+// on the command line, as written by nemiver --log-debugger-output,
+// or, if there are none, a set of synthetic transcripts that are
+// known to be expensive to parse: deep backtraces, big memory reads,
+// pretty-printed containers with a lot of children and thousands of
+// threads.
+//
+// Each transcript is then replayed through GDBEngine, which drives
+// the fake GDB/MI server (fakegdbmi) serving the transcript: each
+// answer of the transcript, i.e. what GDB wrote up to a prompt, is
+// the answer to a command the engine sends.  This measures the
+// whole path of the output of GDB: the pipe, the reader thread, the
+// parser and the dispatch to the output handlers.  The latencies
+// reported are those of the answers, from the command being queued
+// to the engine being done with its answer.
+//
+// Usage: runtestgdbmireplay [--rounds=N] [--max-p99-us=N]
+//                           [--parser-only] [transcript ...]
+//
+// The program fails if any output record fails to parse, if the
+// parser logs any parsing error, even one it recovered from, if the
+// content of a synthetic record is not parsed entirely, or if the
+// 99th percentile of the time taken to parse a record exceeds the
+// value given by --max-p99-us (default: DEFAULT_MAX_P99_US, as set by
+// tests/Makefile.am, or no limit).  --max-p99-us=0 removes the limit.
+
+using namespace std;
+using namespace nemiver;
+using namespace nemiver::common;
+
+
+// Return true iff the result record of a_output holds everything
+// the synthetic record it was parsed from holds.
+typedef bool (*ResultCheck) (const Output::ResultRecord &a_record);
+
+struct Transcript {
+    string name;
+    // The buffers GDB wrote on its standard output, one per
+    // <debuggeroutput> element of the log.
+    vector<UString> buffers;
+    // Checks the result records of the transcript, if it is not 0.
+    ResultCheck check;
+
+    Transcript () :
+        check (0)
+    {}
+};
+
+struct Stats {
+    unsigned long nb_records;
+    unsigned long nb_failures;
+    // The errors the parser logged, including those of the parsing
+    // functions it recovered from.
+    unsigned long nb_parsing_errors;
+    // The result records which content was not entirely parsed.
+    unsigned long nb_mismatches;
+    unsigned long nb_bytes;
+    unsigned long nb_allocations;
+    double elapsed;
+    // The time taken to parse each record, in microseconds.
+    vector<double> latencies;
+
+    Stats () :
+        nb_records (0),
+        nb_failures (0),
+        nb_parsing_errors (0),
+        nb_mismatches (0),
+        nb_bytes (0),
+        nb_allocations (0),
+        elapsed (0)
+    {}
+};
+
+static Glib::RefPtr<Glib::MainLoop> loop =
+    Glib::MainLoop::create (Glib::MainContext::get_default ());
+
+static const char *DEBUGGER_OUTPUT_START = "<debuggeroutput>\n";
+static const char *DEBUGGER_OUTPUT_END = "\n</debuggeroutput>";
+
+/// Extract the GDB output buffers logged in the transcript at a_path.
+static bool
+load_transcript (const string &a_path, Transcript &a_transcript)
+{
+    ifstream file (a_path.c_str ());
+    if (!file)
+        return false;
+    stringstream content;
+    content << file.rdbuf ();
+    string log = content.str ();
+
+    a_transcript.name = a_path;
+    string::size_type start = 0, end = 0;
+    for (;;) {
+        start = log.find (DEBUGGER_OUTPUT_START, end);
+        if (start == string::npos)
+            break;
+        start += strlen (DEBUGGER_OUTPUT_START);
+        end = log.find (DEBUGGER_OUTPUT_END, start);
+        if (end == string::npos)
+            break;
+        a_transcript.buffers.push_back (log.substr (start, end - start));
+    }
+    return !a_transcript.buffers.empty ();
+}
+
+static bool
+check_backtrace (const Output::ResultRecord &a_record)
+{
+    return a_record.has_call_stack ()
+        && a_record.call_stack ().size () == 1000;
+}
+
+static void
+make_backtrace_transcript (Transcript &a_transcript)
+{
+    a_transcript.name = "backtrace (10000 frames)";
+    a_transcript.check = &check_backtrace;
+    for (unsigned n = 0; n < 10; ++n) {
+        string buf = "^done,stack=[";
+        for (unsigned i = 0; i < 1000; ++i) {
+            if (i)
+                buf += ",";
+            buf += "frame={level=\"" + UString::from_int (n * 1000 + i)
+                + "\",addr=\"0x0000000000400" + UString::from_int (i % 10)
+                + "7e\",func=\"overflow_after_n_recursions\","
+                "file=\"do-stack-overflow.cc\","
+                "fullname=\"/home/dodji/devel/git/nemiver.git/tests/"
+                "do-stack-overflow.cc\",line=\"8\"}";
+        }
+        buf += "]\n(gdb) \n";
+        a_transcript.buffers.push_back (buf);
+    }
+}
+
+static bool
+check_memory (const Output::ResultRecord &a_record)
+{
+    return a_record.has_memory_values ()
+        && a_record.memory_values ().size () == 64 * 1024;
+}
+
+static void
+make_memory_transcript (Transcript &a_transcript)
+{
+    a_transcript.name = "memory reads (16 x 64KB)";
+    a_transcript.check = &check_memory;
+    static const char *digits = "0123456789abcdef";
+    const unsigned nb_bytes = 64 * 1024;
+    for (unsigned n = 0; n < 16; ++n) {
+        string buf = "^done,addr=\"0x00601000\",nr-bytes=\"65536\","
+            "total-bytes=\"65536\",next-row=\"0x00611000\","
+            "prev-row=\"0x005f1000\",next-page=\"0x00611000\","
+            "prev-page=\"0x005f1000\",memory=[{addr=\"0x00601000\",data=[";
+        string ascii;
+        for (unsigned i = 0; i < nb_bytes; ++i) {
+            unsigned char byte = (i * 7 + n) & 0xff;
+            if (i)
+                buf += ",";
+            buf += "\"0x";
+            buf += digits[byte >> 4];
+            buf += digits[byte & 0xf];
+            buf += "\"";
+            ascii += (byte >= 'a' && byte <= 'z') ? (char) byte : 'x';
+        }
+        buf += "],ascii=\"" + ascii + "\"}]\n(gdb) \n";
+        a_transcript.buffers.push_back (buf);
+    }
+}
+
+static bool
+check_container (const Output::ResultRecord &a_record)
+{
+    return a_record.has_variable_children ()
+        && a_record.variable_children ().size () == 5000;
+}
+
+static void
+make_container_transcript (Transcript &a_transcript)
+{
+    a_transcript.name = "pretty-printed containers (10 x 5000 children)";
+    a_transcript.check = &check_container;
+    for (unsigned n = 0; n < 10; ++n) {
+        string buf = "^done,numchild=\"5000\",displayhint=\"array\","
+            "children=[";
+        for (unsigned i = 0; i < 5000; ++i) {
+            string index = UString::from_int (i);
+            if (i)
+                buf += ",";
+            buf += "child={name=\"var1.[" + index + "]\",exp=\"[" + index
+                + "]\",numchild=\"0\",value=\"\\\"element " + index
+                + "\\\"\",type=\"std::basic_string<char, "
+                "std::char_traits<char>, std::allocator<char> >\","
+                "thread-id=\"1\",displayhint=\"string\",dynamic=\"1\"}";
+        }
+        buf += "],has_more=\"0\"\n(gdb) \n";
+        a_transcript.buffers.push_back (buf);
+    }
+}
+
+static bool
+check_threads (const Output::ResultRecord &a_record)
+{
+    return a_record.has_thread_info_list ()
+        && a_record.thread_info_list ().size () == 5000;
+}
+
+static void
+make_threads_transcript (Transcript &a_transcript)
+{
+    a_transcript.name = "thread lists (5 x 5000 threads)";
+    a_transcript.check = &check_threads;
+    for (unsigned n = 0; n < 5; ++n) {
+        string buf = "^done,threads=[";
+        for (unsigned i = 1; i <= 5000; ++i) {
+            string id = UString::from_int (i);
+            if (i > 1)
+                buf += ",";
+            buf += "{id=\"" + id + "\",target-id=\"Thread 0x7ffff" + id
+                + " (LWP " + UString::from_int (20000 + i) + ")\","
+                "name=\"threads\",frame={level=\"0\",addr=\"0x00007ffff7bc"
+                "c38d\",func=\"pthread_cond_wait@@GLIBC_2.3.2\",args=[],"
+                "from=\"/lib64/libpthread.so.0\"},state=\"stopped\","
+                "core=\"" + UString::from_int (i % 8) + "\"}";
+        }
+        buf += "],current-thread-id=\"1\"\n(gdb) \n";
+        a_transcript.buffers.push_back (buf);
+    }
+
+    // Lots of small asynchronous records too.
+    string buf;
+    for (unsigned i = 1; i <= 5000; ++i) {
+        buf += "=thread-created,id=\"" + UString::from_int (i)
+            + "\",group-id=\"i1\"\n";
+        buf += "~\"[New Thread 0x7ffff" + UString::from_int (i)
+            + " (LWP " + UString::from_int (20000 + i) + ")]\\n\"\n";
+    }
+    buf += "(gdb) \n";
+    a_transcript.buffers.push_back (buf);
+}
+
+/// Parse all the output records of a_transcript, the way GDBEngine
+/// does, and accumulate the measures into a_stats.
+static void
+replay_transcript (const Transcript &a_transcript, Stats &a_stats)
+{
+    GDBMIParser parser;
+    StringInternTableSafePtr table (new StringInternTable);
+    parser.set_string_intern_table (table);
+
+    Glib::Timer timer;
+    for (vector<UString>::const_iterator it = a_transcript.buffers.begin ();
+         it != a_transcript.buffers.end ();
+         ++it) {
+        const UString &buf = *it;
+        UString::size_type from = 0, to = 0, end = buf.size ();
+        a_stats.nb_bytes += buf.bytes ();
+        parser.push_input (buf);
+        while (from < end) {
+            Output output (buf);
+            unsigned long nb_allocations = get_nb_allocations ();
+            timer.start ();
+            bool is_ok = parser.parse_output_record (from, to, output);
+            timer.stop ();
+            if (!is_ok) {
+                parser.skip_output_record (from, to);
+                ++a_stats.nb_failures;
+            } else if (a_transcript.check
+                       && output.has_result_record ()
+                       && !a_transcript.check (output.result_record ())) {
+                ++a_stats.nb_mismatches;
+            }
+            a_stats.nb_allocations += get_nb_allocations () - nb_allocations;
+            a_stats.elapsed += timer.elapsed ();
+            a_stats.latencies.push_back (timer.elapsed () * 1000000);
+            ++a_stats.nb_records;
+            if (to <= from)
+                break;
+            from = to;
+            while (from < end && isspace (buf.raw ()[from]))
+                ++from;
+        }
+        parser.pop_input ();
+    }
+    a_stats.nb_parsing_errors += parser.get_nb_parsing_errors ();
+}
+
+static double
+percentile (vector<double> &a_values, double a_percent)
+{
+    if (a_values.empty ())
+        return 0;
+    vector<double>::size_type n =
+        (vector<double>::size_type) (a_percent / 100 * (a_values.size () - 1));
+    nth_element (a_values.begin (), a_values.begin () + n, a_values.end ());
+    return a_values[n];
+}
+
+/// \return the number of answers fakegdbmi cuts a_transcript into:
+/// the number of prompts, plus one if there is some output after the
+/// last one.
+static unsigned
+count_answers (const Transcript &a_transcript)
+{
+    string output;
+    for (vector<UString>::const_iterator it = a_transcript.buffers.begin ();
+         it != a_transcript.buffers.end ();
+         ++it)
+        output += it->raw ();
+    istringstream lines (output);
+    string line;
+    unsigned nb_answers = 0;
+    bool has_output = false;
+    while (getline (lines, line)) {
+        if (line == "(gdb) " || line == "(gdb)") {
+            if (has_output)
+                ++nb_answers;
+            has_output = false;
+        } else if (!line.empty ()) {
+            has_output = true;
+        }
+    }
+    return has_output ? nb_answers + 1 : nb_answers;
+}
+
+// The replay of a transcript through GDBEngine.
+struct EngineReplay {
+    IDebuggerSafePtr debugger;
+    unsigned nb_answers;
+    unsigned nb_received;
+    // True once the engine is done setting GDB up.
+    bool started;
+    bool timed_out;
+    // Started when the command of the answer awaited is queued.
+    Glib::Timer timer;
+    Stats *stats;
+
+    EngineReplay () :
+        nb_answers (0),
+        nb_received (0),
+        started (false),
+        timed_out (false),
+        stats (0)
+    {}
+};
+
+static const char *WARM_UP_COOKIE = "replay-warm-up";
+static const char *REPLAY_COOKIE = "replay";
+
+static void
+request_next_answer (EngineReplay *a_replay)
+{
+    if (a_replay->nb_received == a_replay->nb_answers) {
+        loop->quit ();
+        return;
+    }
+    a_replay->timer.start ();
+    // fakegdbmi answers -thread-list-ids from the transcript.
+    a_replay->debugger->list_threads (REPLAY_COOKIE);
+}
+
+static void
+on_answer_handled (EngineReplay *a_replay)
+{
+    a_replay->timer.stop ();
+    double elapsed = a_replay->timer.elapsed ();
+    a_replay->stats->elapsed += elapsed;
+    a_replay->stats->latencies.push_back (elapsed * 1000000);
+    ++a_replay->nb_received;
+    request_next_answer (a_replay);
+}
+
+static void
+on_command_done_signal (const UString &a_name,
+                        const UString &a_cookie,
+                        EngineReplay *a_replay)
+{
+    if (a_cookie == WARM_UP_COOKIE) {
+        a_replay->started = true;
+        request_next_answer (a_replay);
+    } else if (a_cookie == REPLAY_COOKIE && a_name == "list-threads") {
+        on_answer_handled (a_replay);
+    }
+}
+
+static void
+on_error_signal (const UString &, EngineReplay *a_replay)
+{
+    // Recorded transcripts can hold errors too.
+    if (a_replay->started
+        && a_replay->nb_received < a_replay->nb_answers)
+        on_answer_handled (a_replay);
+}
+
+static void
+on_engine_died_signal ()
+{
+    loop->quit ();
+}
+
+static bool
+on_replay_timeout (EngineReplay *a_replay)
+{
+    a_replay->timed_out = true;
+    loop->quit ();
+    return false;
+}
+
+/// Replay a_transcript through GDBEngine and fakegdbmi, and set the
+/// measures into a_stats.
+///
+/// \param a_nb_records the number of records of a_transcript.
+///
+/// \return the number of answers handled by the engine; all of them
+/// are unless the replay timed out.
+static unsigned
+replay_transcript_through_engine (const Transcript &a_transcript,
+                                  unsigned long a_nb_records,
+                                  Stats &a_stats)
+{
+    static const char *TRANSCRIPT_PATH = "gdbmi-replay-transcript";
+    {
+        ofstream file (TRANSCRIPT_PATH);
+        for (vector<UString>::const_iterator it =
+                 a_transcript.buffers.begin ();
+             it != a_transcript.buffers.end ();
+             ++it) {
+            file << it->raw ();
+            a_stats.nb_bytes += it->bytes ();
+        }
+    }
+    g_setenv ("NMV_FAKE_GDB_TRANSCRIPT", TRANSCRIPT_PATH, TRUE);
+
+    EngineReplay replay;
+    replay.nb_answers = count_answers (a_transcript);
+    replay.stats = &a_stats;
+    replay.debugger = debugger_utils::load_debugger_iface_with_confmgr ();
+    IDebuggerSafePtr &debugger = replay.debugger;
+    debugger->set_event_loop_context (loop->get_context ());
+    debugger->set_non_persistent_debugger_path
+                                (NEMIVER_BUILDDIR "/fakegdbmi");
+    debugger->enable_pretty_printing (false);
+    debugger->command_done_signal ().connect
+        (sigc::bind (&on_command_done_signal, &replay));
+    debugger->error_signal ().connect
+        (sigc::bind (&on_error_signal, &replay));
+    debugger->engine_died_signal ().connect (&on_engine_died_signal);
+
+    std::vector<UString> args, source_search_dir;
+    source_search_dir.push_back (".");
+    debugger->load_program ("fooprog", args, ".",
+                            source_search_dir, "", -1, false);
+    debugger->list_register_names (WARM_UP_COOKIE);
+
+    sigc::connection timeout = Glib::signal_timeout ().connect
+        (sigc::bind (&on_replay_timeout, &replay), 60000);
+    loop->run ();
+    timeout.disconnect ();
+    debugger->exit_engine ();
+
+    g_unsetenv ("NMV_FAKE_GDB_TRANSCRIPT");
+    g_unlink (TRANSCRIPT_PATH);
+
+    if (replay.timed_out)
+        std::cerr << a_transcript.name << ": timed out" << std::endl;
+    a_stats.nb_records += a_nb_records;
+    return replay.nb_received;
+}
+
+static void
+report (const string &a_name, Stats &a_stats)
+{
+    double elapsed = a_stats.elapsed > 0 ? a_stats.elapsed : 1e-9;
+    cout << a_name << ":\n"
+         << "  records: " << a_stats.nb_records
+         << " (" << a_stats.nb_failures << " failed, "
+         << a_stats.nb_mismatches << " incomplete)\n"
+         << "  parsing errors: " << a_stats.nb_parsing_errors << "\n"
+         << "  records/s: " << (unsigned long) (a_stats.nb_records / elapsed)
+         << "\n"
+         << "  bytes/s: " << (unsigned long) (a_stats.nb_bytes / elapsed)
+         << "\n"
+         << "  allocations/record: "
+         << (a_stats.nb_records
+             ? a_stats.nb_allocations / a_stats.nb_records : 0)
+         << "\n"
+         << "  p50: " << percentile (a_stats.latencies, 50) << "us\n"
+         << "  p99: " << percentile (a_stats.latencies, 99) << "us\n";
+}
+
+static void
+report_engine (const string &a_name, Stats &a_stats)
+{
+    double elapsed = a_stats.elapsed > 0 ? a_stats.elapsed : 1e-9;
+    cout << a_name << " through GDBEngine:\n"
+         << "  records: " << a_stats.nb_records
+         << " in " << a_stats.latencies.size () << " answers\n"
+         << "  records/s: " << (unsigned long) (a_stats.nb_records / elapsed)
+         << "\n"
+         << "  bytes/s: " << (unsigned long) (a_stats.nb_bytes / elapsed)
+         << "\n"
+         << "  p50 per answer: " << percentile (a_stats.latencies, 50)
+         << "us\n"
+         << "  p99 per answer: " << percentile (a_stats.latencies, 99)
+         << "us\n";
+}
+
+NEMIVER_API int
+test_main (int argc, char *argv[])
+{
+    NEMIVER_TRY;
+
+    Initializer::do_init ();
+
+    unsigned nb_rounds = 3;
+#ifdef DEFAULT_MAX_P99_US
+    double max_p99 = DEFAULT_MAX_P99_US;
+#else
+    double max_p99 = 0;
+#endif
+    bool parser_only = false;
+    vector<Transcript> transcripts;
+    for (int i = 1; i < argc; ++i) {
+        string arg = argv[i];
+        if (arg.compare (0, 9, "--rounds=") == 0) {
+            nb_rounds = atoi (arg.c_str () + 9);
+        } else if (arg == "--parser-only") {
+            parser_only = true;
+        } else if (arg.compare (0, 13, "--max-p99-us=") == 0) {
+            max_p99 = atof (arg.c_str () + 13);
+        } else {
+            Transcript transcript;
+            BOOST_REQUIRE (load_transcript (arg, transcript));
+            transcripts.push_back (transcript);
+        }
+    }
+
+    if (transcripts.empty ()) {
+        transcripts.resize (4);
+        make_backtrace_transcript (transcripts[0]);
+        make_memory_transcript (transcripts[1]);
+        make_container_transcript (transcripts[2]);
+        make_threads_transcript (transcripts[3]);
+    }
+    BOOST_REQUIRE (nb_rounds > 0);
+
+    THROW_IF_FAIL (loop);
+
+    Stats total, engine_total;
+    unsigned long nb_answers = 0, nb_answers_handled = 0;
+    for (vector<Transcript>::const_iterator it = transcripts.begin ();
+         it != transcripts.end ();
+         ++it) {
+        Stats stats;
+        for (unsigned round = 0; round < nb_rounds; ++round)
+            replay_transcript (*it, stats);
+        total.nb_records += stats.nb_records;
+        total.nb_failures += stats.nb_failures;
+        total.nb_parsing_errors += stats.nb_parsing_errors;
+        total.nb_mismatches += stats.nb_mismatches;
+        total.nb_bytes += stats.nb_bytes;
+        total.nb_allocations += stats.nb_allocations;
+        total.elapsed += stats.elapsed;
+        total.latencies.insert (total.latencies.end (),
+                                stats.latencies.begin (),
+                                stats.latencies.end ());
+        report (it->name, stats);
+        if (!parser_only) {
+            Stats engine_stats;
+            nb_answers += count_answers (*it);
+            nb_answers_handled += replay_transcript_through_engine
+                (*it, stats.nb_records / nb_rounds, engine_stats);
+            engine_total.nb_records += engine_stats.nb_records;
+            engine_total.nb_bytes += engine_stats.nb_bytes;
+            engine_total.elapsed += engine_stats.elapsed;
+            engine_total.latencies.insert (engine_total.latencies.end (),
+                                           engine_stats.latencies.begin (),
+                                           engine_stats.latencies.end ());
+            report_engine (it->name, engine_stats);
+        }
+    }
+    report ("total", total);
+    if (!parser_only)
+        report_engine ("total", engine_total);
+
+    BOOST_REQUIRE (total.nb_records > 0);
+    BOOST_REQUIRE (total.nb_failures == 0);
+    BOOST_REQUIRE (total.nb_parsing_errors == 0);
+    BOOST_REQUIRE (total.nb_mismatches == 0);
+    if (max_p99 > 0)
+        BOOST_REQUIRE (percentile (total.latencies, 99) <= max_p99);
+    // The engine handled every answer of the transcripts.
+    BOOST_REQUIRE (nb_answers_handled == nb_answers);
+
+    NEMIVER_CATCH_NOX;
+
+    return 0;
+}
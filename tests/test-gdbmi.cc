@@ -1,11 +1,15 @@
 #include <iostream>
+#include <cstring>
 #include <list>
 #include <map>
 #include <boost/test/unit_test.hpp>
+#include <glibmm/timer.h>
 #include "dbgengine/nmv-gdbmi-parser.h"
 #include "common/nmv-exception.h"
 #include "common/nmv-initializer.h"
 #include "common/nmv-asm-utils.h"
+#include "common/nmv-interned-string.h"
+#include "alloc-counter.h"
 
 using namespace std;
 using namespace nemiver;
@@ -32,6 +36,8 @@ static const char *gv_running_async_output1 =
 
 static const char *gv_var_list_children0="numchild=\"2\",displayhint=\"string\",children=[child={name=\"var1.public.m_first_name.public\",exp=\"public\",numchild=\"1\",value=\"\",thread-id=\"1\"},child={name=\"var1.public.m_first_name.private\",exp=\"private\",numchild=\"1\",value=\"\",thread-id=\"1\"}]";
 
+static const char *gv_var_list_children1="numchild=\"1\",displayhint=\"array\",children=[child={name=\"var2.[0]\",exp=\"[0]\",numchild=\"0\",value=\"42\",type=\"int\",thread-id=\"1\"}],has_more=\"1\"";
+
 static const char *gv_output_record0 =
 "&\"Failed to read a valid object file image from memory.\\n\"\n"
 "~\"[Thread debugging using libthread_db enabled]\\n\"\n"
@@ -48,6 +54,12 @@ static const char *gv_output_record1 =
 "*running,thread-id=\"1\"n"
 "(gdb)";
 
+// In non-stop mode, the threads are resumed and stop one by one.
+static const char *gv_output_record_non_stop =
+"*running,thread-id=\"2\"\n"
+"*stopped,reason=\"breakpoint-hit\",disp=\"keep\",bkptno=\"1\",frame={addr=\"0x0000000000400a12\",func=\"worker\",args=[],file=\"threads.cc\",fullname=\"/home/jdoe/nemiver/tests/threads.cc\",line=\"12\"},thread-id=\"3\",stopped-threads=[\"3\"],core=\"1\"\n"
+"(gdb)";
+
 static const char *gv_output_record2=
 "^done,value=\"{tree (int, int, int, tree, tree)} 0x483c2f <build_template_parm_index>\"\n"
 "(gdb)";
@@ -65,6 +77,12 @@ static const char *gv_output_record8="^done,changelist=[]\n";
 
 static const char *gv_output_record9="^done,changelist=[{name=\"var1\",value=\"{...}\",in_scope=\"true\",type_changed=\"false\",new_num_children=\"2\",displayhint=\"array\",dynamic=\"1\",has_more=\"0\",new_children=[{name=\"var1.[1]\",exp=\"[1]\",numchild=\"0\",value=\" \\\"fila\\\"\",type=\"std::basic_string<char, std::char_traits<char>, std::allocator<char> >\",thread-id=\"1\",displayhint=\"string\",dynamic=\"1\"}]},{name=\"var1.[0]\",value=\"\\\"k\\303\\251l\\303\\251\\\"\",in_scope=\"true\",type_changed=\"false\",displayhint=\"array\",dynamic=\"1\",has_more=\"0\"}]\n";
 
+static const char *gv_thread_info_list =
+"^done,threads=[{id=\"2\",target-id=\"Thread 0x7ffff6fd5700 (LWP 4242)\",name=\"worker\",frame={level=\"0\",addr=\"0x00007ffff7bc7f0d\",func=\"__lll_lock_wait\",args=[],from=\"/lib64/libpthread.so.0\"},state=\"stopped\",core=\"1\"},{id=\"1\",target-id=\"Thread 0x7ffff7fd6740 (LWP 4241)\",frame={level=\"0\",addr=\"0x0000000000400a52\",func=\"main\",args=[],file=\"threads.cc\",fullname=\"/home/jdoe/nemiver/tests/threads.cc\",line=\"42\"},state=\"stopped\",core=\"0\"},{id=\"3\",target-id=\"Thread 0x7ffff67d4700 (LWP 4243)\",state=\"running\"}],current-thread-id=\"1\"\n(gdb)";
+
+static const char *gv_library_loaded_record =
+"=library-loaded,id=\"/lib/libc.so.6\",target-name=\"/lib/libc.so.6\",host-name=\"/lib/libc.so.6\",symbols-loaded=\"0\",thread-group=\"i1\"\n(gdb)";
+
 static const char *gv_stack0 =
 "stack=[frame={level=\"0\",addr=\"0x000000330f832f05\",func=\"raise\",file=\"../nptl/sysdeps/unix/sysv/linux/raise.c\",fullname=\"/usr/src/debug/glibc-20081113T2206/nptl/sysdeps/unix/sysv/linux/raise.c\",line=\"64\"},frame={level=\"1\",addr=\"0x000000330f834a73\",func=\"abort\",file=\"abort.c\",fullname=\"/usr/src/debug/glibc-20081113T2206/stdlib/abort.c\",line=\"88\"},frame={level=\"2\",addr=\"0x0000000000400872\",func=\"overflow_after_n_recursions\",file=\"do-stack-overflow.cc\",fullname=\"/home/dodji/devel/git/nemiver.git/tests/do-stack-overflow.cc\",line=\"7\"},frame={level=\"3\",addr=\"0x000000000040087e\",func=\"overflow_after_n_recursions\",file=\"do-stack-overflow.cc\",fullname=\"/home/dodji/devel/git/nemiver.git/tests/do-stack-overflow.cc\",line=\"8\"},frame={level=\"4\",addr=\"0x000000000040087e\",func=\"overflow_after_n_recursions\",file=\"do-stack-overflow.cc\",fullname=\"/home/dodji/devel/git/nemiver.git/tests/do-stack-overflow.cc\",line=\"8\"},frame={level=\"5\",addr=\"0x000000000040087e\",func=\"overflow_after_n_recursions\",file=\"do-stack-overflow.cc\",fullname=\"/home/dodji/devel/git/nemiver.git/tests/do-stack-overflow.cc\",line=\"8\"},frame={level=\"6\",addr=\"0x000000000040087e\",func=\"overflow_after_n_recursions\",file=\"do-stack-overflow.cc\",fullname=\"/home/dodji/devel/git/nemiver.git/tests/do-stack-overflow.cc\",line=\"8\"},frame={level=\"7\",addr=\"0x000000000040087e\",func=\"overflow_after_n_recursions\",file=\"do-stack-overflow.cc\",fullname=\"/home/dodji/devel/git/nemiver.git/tests/do-stack-overflow.cc\",line=\"8\"},frame={level=\"8\",addr=\"0x000000000040087e\",func=\"overflow_after_n_recursions\",file=\"do-stack-overflow.cc\",fullname=\"/home/dodji/devel/git/nemiver.git/tests/do-stack-overflow.cc\",line=\"8\"},frame={level=\"9\",addr=\"0x000000000040087e\",func=\"overflow_after_n_recursions\",file=\"do-stack-overflow.cc\",fullname=\"/home/dodji/devel/git/nemiver.git/tests/do-stack-overflow.cc\",line=\"8\"},frame={level=\"10\",addr=\"0x000000000040087e\",func=\"overflow_after_n_recursions\",file=\"do-stack-overflow.cc\",fullname=\"/home/dodji/devel/git/nemiver.git/tests/do-stack-overflow.cc\",line=\"8\"},frame={level=\"11\",addr=\"0x000000000040087e\",func=\"overflow_after_n_recursions\",file=\"do-stack-overflow.cc\",fullname=\"/home/dodji/devel/git/nemiver.git/tests/do-stack-overflow.cc\",line=\"8\"},frame={level=\"12\",addr=\"0x000000000040087e\",func=\"overflow_after_n_recursions\",file=\"do-stack-overflow.cc\",fullname=\"/home/dodji/devel/git/nemiver.git/tests/do-stack-overflow.cc\",line=\"8\"},frame={level=\"13\",addr=\"0x000000000040087e\",func=\"overflow_after_n_recursions\",file=\"do-stack-overflow.cc\",fullname=\"/home/dodji/devel/git/nemiver.git/tests/do-stack-overflow.cc\",line=\"8\"},frame={level=\"14\",addr=\"0x000000000040087e\",func=\"overflow_after_n_recursions\",file=\"do-stack-overflow.cc\",fullname=\"/home/dodji/devel/git/nemiver.git/tests/do-stack-overflow.cc\",line=\"8\"},frame={level=\"15\",addr=\"0x000000000040087e\",func=\"overflow_after_n_recursions\",file=\"do-stack-overflow.cc\",fullname=\"/home/dodji/devel/git/nemiver.git/tests/do-stack-overflow.cc\",line=\"8\"},frame={level=\"16\",addr=\"0x000000000040087e\",func=\"overflow_after_n_recursions\",file=\"do-stack-overflow.cc\",fullname=\"/home/dodji/devel/git/nemiver.git/tests/do-stack-overflow.cc\",line=\"8\"},frame={level=\"17\",addr=\"0x000000000040087e\",func=\"overflow_after_n_recursions\",file=\"do-stack-overflow.cc\",fullname=\"/home/dodji/devel/git/nemiver.git/tests/do-stack-overflow.cc\",line=\"8\"},frame={level=\"18\",addr=\"0x000000000040087e\",func=\"overflow_after_n_recursions\",file=\"do-stack-overflow.cc\",fullname=\"/home/dodji/devel/git/nemiver.git/tests/do-stack-overflow.cc\",line=\"8\"},frame={level=\"19\",addr=\"0x000000000040087e\",func=\"overflow_after_n_recursions\",file=\"do-stack-overflow.cc\",fullname=\"/home/dodji/devel/git/nemiver.git/tests/do-stack-overflow.cc\",line=\"8\"},frame={level=\"20\",addr=\"0x000000000040087e\",func=\"overflow_after_n_recursions\",file=\"do-stack-overflow.cc\",fullname=\"/home/dodji/devel/git/nemiver.git/tests/do-stack-overflow.cc\",line=\"8\"},frame={level=\"21\",addr=\"0x000000000040087e\",func=\"overflow_after_n_recursions\",file=\"do-stack-overflow.cc\",fullname=\"/home/dodji/devel/git/nemiver.git/tests/do-stack-overflow.cc\",line=\"8\"},frame={level=\"22\",addr=\"0x000000000040087e\",func=\"overflow_after_n_recursions\",file=\"do-stack-overflow.cc\",fullname=\"/home/dodji/devel/git/nemiver.git/tests/do-stack-overflow.cc\",line=\"8\"},frame={level=\"23\",addr=\"0x000000000040087e\",func=\"overflow_after_n_recursions\",file=\"do-stack-overflow.cc\",fullname=\"/home/dodji/devel/git/nemiver.git/tests/do-stack-overflow.cc\",line=\"8\"},frame={level=\"24\",addr=\"0x000000000040087e\",func=\"overflow_after_n_recursions\",file=\"do-stack-overflow.cc\",fullname=\"/home/dodji/devel/git/nemiver.git/tests/do-stack-overflow.cc\",line=\"8\"},frame={level=\"25\",addr=\"0x000000000040087e\",func=\"overflow_after_n_recursions\",file=\"do-stack-overflow.cc\",fullname=\"/home/dodji/devel/git/nemiver.git/tests/do-stack-overflow.cc\",line=\"8\"}]";
 
@@ -133,6 +151,10 @@ static const char* gv_register_values =
 static const char* gv_memory_values =
 "addr=\"0x000013a0\",nr-bytes=\"32\",total-bytes=\"32\",next-row=\"0x000013c0\",prev-row=\"0x0000139c\",next-page=\"0x000013c0\",prev-page=\"0x00001380\",memory=[{addr=\"0x000013a0\",data=[\"0x10\",\"0x11\",\"0x12\",\"0x13\"],ascii=\"xxxx\"}]";
 
+// Two contiguous blocks, then a hole before the third one.
+static const char* gv_memory_bytes =
+"memory=[{begin=\"0x00601040\",offset=\"0x00000000\",end=\"0x00601042\",contents=\"10ff\"},{begin=\"0x00601042\",offset=\"0x00000000\",end=\"0x00601044\",contents=\"A0b1\"},{begin=\"0x00602000\",offset=\"0x00000000\",end=\"0x00602001\",contents=\"42\"}]";
+
 static const char* gv_gdbmi_result0 = "variable=[\"foo\", \"bar\"]";
 static const char* gv_gdbmi_result1 = "variable";
 static const char* gv_gdbmi_result2 = "\"variable\"";
@@ -168,6 +190,15 @@ static const char* gv_breakpoint2 =
 static const char* gv_breakpoint3 =
     "bkpt={number=\"2\",type=\"breakpoint\",disp=\"keep\",enabled=\"y\",addr=\"<MULTIPLE>\",times=\"0\",original-location=\"error\"},{number=\"2.1\",enabled=\"y\",addr=\"0x000000000132d2f7\",func=\"error(char const*,...)\",file=\"/home/dodji/git/gcc/PR56782/gcc/diagnostic.c\",fullname=\"/home/dodji/git/gcc/PR56782/gcc/diagnostic.c\",line=\"1038\"},{number=\"2.2\",enabled=\"y\",addr=\"0x00000032026f1490\",at=\"<error>\"}";
 
+static const char* gv_dprintf0 =
+    "bkpt={number=\"4\",type=\"dprintf\",disp=\"keep\",enabled=\"y\",addr=\"0x00000000004004f8\",func=\"main\",file=\"test.c\",fullname=\"/tmp/test.c\",line=\"6\",thread-groups=[\"i1\"],times=\"0\",script={\"printf \\\"[nmv-dprintf] i = %d\\\\n\\\",i\"},original-location=\"test.c:6\"}";
+
+static const char* gv_hw_watchpoint0 =
+    "bkpt={number=\"5\",type=\"hw watchpoint\",disp=\"keep\",enabled=\"y\",addr=\"\",what=\"i\",times=\"0\",original-location=\"i\"}";
+
+static const char* gv_sw_watchpoint0 =
+    "bkpt={number=\"6\",type=\"watchpoint\",disp=\"keep\",enabled=\"y\",addr=\"\",what=\"buf\",times=\"0\",original-location=\"buf\"}";
+
 static const char* gv_breakpoint_modified_async_output0 =
     "=breakpoint-modified,bkpt={number=\"2\",type=\"breakpoint\",disp=\"keep\",enabled=\"y\",addr=\"<MULTIPLE>\",times=\"0\",original-location=\"/home/dodji/git/libabigail/abi-diff/include/abg-diff-utils.h:1322\"},{number=\"2.1\",enabled=\"y\",addr=\"0x00007ffff7d70922\",func=\"abigail::diff_utils::compute_diff<__gnu_cxx::__normal_iterator<std::tr1::shared_ptr<abigail::class_decl::base_spec> const*, std::vector<std::tr1::shared_ptr<abigail::class_decl::base_spec>, std::allocator<std::tr1::shared_ptr<abigail::class_decl::base_spec> > > > >(__gnu_cxx::__normal_iterator<std::tr1::shared_ptr<abigail::class_decl::base_spec> const*, std::vector<std::tr1::shared_ptr<abigail::class_decl::base_spec>, std::allocator<std::tr1::shared_ptr<abigail::class_decl::base_spec> > > >, __gnu_cxx::__normal_iterator<std::tr1::shared_ptr<abigail::class_decl::base_spec> const*, std::vector<std::tr1::shared_ptr<abigail::class_decl::base_spec>, std::allocator<std::tr1::shared_ptr<abigail::class_decl::base_spec> > > >, __gnu_cxx::__normal_iterator<std::tr1::shared_ptr<abigail::class_decl::base_spec> const*, std::vector<std::tr1::shared_ptr<abigail::class_decl::base_spec>, std::allocator<std::tr1::shared_ptr<abigail::class_decl::base_spec> > > >, __gnu_cxx::__normal_iterator<std::tr1::shared_ptr<abigail::class_decl::base_spec> const*, std::vector<std::tr1::shared_ptr<abigail::class_decl::base_spec>, std::allocator<std::tr1::shared_ptr<abigail::class_decl::base_spec> > > >, __gnu_cxx::__normal_iterator<std::tr1::shared_ptr<abigail::class_decl::base_spec> const*, std::vector<std::tr1::shared_ptr<abigail::class_decl::base_spec>, std::allocator<std::tr1::shared_ptr<abigail::class_decl::base_spec> > > >, __gnu_cxx::__normal_iterator<std::tr1::shared_ptr<abigail::class_decl::base_spec> const*, std::vector<std::tr1::shared_ptr<abigail::class_decl::base_spec>, std::allocator<std::tr1::shared_ptr<abigail::class_decl::base_spec> > > >, std::vector<abigail::diff_utils::point, std::allocator<abigail::diff_utils::point> >&, abigail::diff_utils::edit_script&, int&)\",file=\"/home/dodji/git/libabigail/abi-diff/build/../include/abg-diff-utils.h\",fullname=\"/home/dodji/git/libabigail/abi-diff/include/abg-diff-utils.h\",line=\"1322\"},{number=\"2.2\",enabled=\"y\",addr=\"0x00007ffff7d71536\",func=\"abigail::diff_utils::compute_diff<__gnu_cxx::__normal_iterator<std::tr1::shared_ptr<abigail::class_decl::member_type> const*, std::vector<std::tr1::shared_ptr<abigail::class_decl::member_type>, std::allocator<std::tr1::shared_ptr<abigail::class_decl::member_type> > > > >(__gnu_cxx::__normal_iterator<std::tr1::shared_ptr<abigail::class_decl::member_type> const*, std::vector<std::tr1::shared_ptr<abigail::class_decl::member_type>, std::allocator<std::tr1::shared_ptr<abigail::class_decl::member_type> > > >, __gnu_cxx::__normal_iterator<std::tr1::shared_ptr<abigail::class_decl::member_type> const*, std::vector<std::tr1::shared_ptr<abigail::class_decl::member_type>, std::allocator<std::tr1::shared_ptr<abigail::class_decl::member_type> > > >, __gnu_cxx::__normal_iterator<std::tr1::shared_ptr<abigail::class_decl::member_type> const*, std::vector<std::tr1::shared_ptr<abigail::class_decl::member_type>, std::allocator<std::tr1::shared_ptr<abigail::class_decl::member_type> > > >, __gnu_cxx::__normal_iterator<std::tr1::shared_ptr<abigail::class_decl::member_type> const*, std::vector<std::tr1::shared_ptr<abigail::class_decl::member_type>, std::allocator<std::tr1::shared_ptr<abigail::class_decl::member_type> > > >, __gnu_cxx::__normal_iterator<std::tr1::shared_ptr<abigail::class_decl::member_type> const*, std::vector<std::tr1::shared_ptr<abigail::class_decl::member_type>, std::allocator<std::tr1::shared_ptr<abigail::class_decl::member_type> > > >, __gnu_cxx::__normal_iterator<std::tr1::shared_ptr<abigail::class_decl::member_type> const*, std::vector<std::tr1::shared_ptr<abigail::class_decl::member_type>, std::allocator<std::tr1::shared_ptr<abigail::class_decl::member_type> > > >, std::vector<abigail::diff_utils::point, std::allocator<abigail::diff_utils::point> >&, abigail::diff_utils::edit_script&, int&)\",file=\"/home/dodji/git/libabigail/abi-diff/build/../include/abg-diff-utils.h\",fullname=\"/home/dodji/git/libabigail/abi-diff/include/abg-diff-utils.h\",line=\"1322\"},{number=\"2.3\",enabled=\"y\",addr=\"0x00007ffff7d7214a\",func=\"abigail::diff_utils::compute_diff<__gnu_cxx::__normal_iterator<std::tr1::shared_ptr<abigail::class_decl::data_member> const*, std::vector<std::tr1::shared_ptr<abigail::class_decl::data_member>, std::allocator<std::tr1::shared_ptr<abigail::class_decl::data_member> > > > >(__gnu_cxx::__normal_iterator<std::tr1::shared_ptr<abigail::class_decl::data_member> const*, std::vector<std::tr1::shared_ptr<abigail::class_decl::data_member>, std::allocator<std::tr1::shared_ptr<abigail::class_decl::data_member> > > >, __gnu_cxx::__normal_iterator<std::tr1::shared_ptr<abigail::class_decl::data_member> const*, std::vector<std::tr1::shared_ptr<abigail::class_decl::data_member>, std::allocator<std::tr1::shared_ptr<abigail::class_decl::data_member> > > >, __gnu_cxx::__normal_iterator<std::tr1::shared_ptr<abigail::class_decl::data_member> const*, std::vector<std::tr1::shared_ptr<abigail::class_decl::data_member>, std::allocator<std::tr1::shared_ptr<abigail::class_decl::data_member> > > >, __gnu_cxx::__normal_iterator<std::tr1::shared_ptr<abigail::class_decl::data_member> const*, std::vector<std::tr1::shared_ptr<abigail::class_decl::data_member>, std::allocator<std::tr1::shared_ptr<abigail::class_decl::data_member> > > >, __gnu_cxx::__normal_iterator<std::tr1::shared_ptr<abigail::class_decl::data_member> const*, std::vector<std::tr1::shared_ptr<abigail::class_decl::data_member>, std::allocator<std::tr1::shared_ptr<abigail::class_decl::data_member> > > >, __gnu_cxx::__normal_iterator<std::tr1::shared_ptr<abigail::class_decl::data_member> const*, std::vector<std::tr1::shared_ptr<abigail::class_decl::data_member>, std::allocator<std::tr1::shared_ptr<abigail::class_decl::data_member> > > >, std::vector<abigail::diff_utils::point, std::allocator<abigail::diff_utils::point> >&, abigail::diff_utils::edit_script&, int&)\",file=\"/home/dodji/git/libabigail/abi-diff/build/../include/abg-diff-utils.h\",fullname=\"/home/dodji/git/libabigail/abi-diff/include/abg-diff-utils.h\",line=\"1322\"},{number=\"2.4\",enabled=\"y\",addr=\"0x00007ffff7d72d5e\",func=\"abigail::diff_utils::compute_diff<__gnu_cxx::__normal_iterator<std::tr1::shared_ptr<abigail::class_decl::member_function> const*, std::vector<std::tr1::shared_ptr<abigail::class_decl::member_function>, std::allocator<std::tr1::shared_ptr<abigail::class_decl::member_function> > > > >(__gnu_cxx::__normal_iterator<std::tr1::shared_ptr<abigail::class_decl::member_function> const*, std::vector<std::tr1::shared_ptr<abigail::class_decl::member_function>, std::allocator<std::tr1::shared_ptr<abigail::class_decl::member_function> > > >, __gnu_cxx::__normal_iterator<std::tr1::shared_ptr<abigail::class_decl::member_function> const*, std::vector<std::tr1::shared_ptr<abigail::class_decl::member_function>, std::allocator<std::tr1::shared_ptr<abigail::class_decl::member_function> > > >, __gnu_cxx::__normal_iterator<std::tr1::shared_ptr<abigail::class_decl::member_function> const*, std::vector<std::tr1::shared_ptr<abigail::class_decl::member_function>, std::allocator<std::tr1::shared_ptr<abigail::class_decl::member_function> > > >, __gnu_cxx::__normal_iterator<std::tr1::shared_ptr<abigail::class_decl::member_function> const*, std::vector<std::tr1::shared_ptr<abigail::class_decl::member_function>, std::allocator<std::tr1::shared_ptr<abigail::class_decl::member_function> > > >, __gnu_cxx::__normal_iterator<std::tr1::shared_ptr<abigail::class_decl::member_function> const*, std::vector<std::tr1::shared_ptr<abigail::class_decl::member_function>, std::allocator<std::tr1::shared_ptr<abigail::class_decl::member_function> > > >, __gnu_cxx::__normal_iterator<std::tr1::shared_ptr<abigail::class_decl::member_function> const*, std::vector<std::tr1::shared_ptr<abigail::class_decl::member_function>, std::allocator<std::tr1::shared_ptr<abigail::class_decl::member_function> > > >, std::vector<abigail::diff_utils::point, std::allocator<abigail::diff_utils::point> >&, abigail::diff_utils::edit_script&, int&)\",file=\"/home/dodji/git/libabigail/abi-diff/build/../include/abg-diff-utils.h\",fullname=\"/home/dodji/git/libabigail/abi-diff/include/abg-diff-utils.h\",line=\"1322\"},{number=\"2.5\",enabled=\"y\",addr=\"0x00007ffff7d73972\",func=\"abigail::diff_utils::compute_diff<__gnu_cxx::__normal_iterator<std::tr1::shared_ptr<abigail::class_decl::member_function_template> const*, std::vector<std::tr1::shared_ptr<abigail::class_decl::member_function_template>, std::allocator<std::tr1::shared_ptr<abigail::class_decl::member_function_template> > > > >(__gnu_cxx::__normal_iterator<std::tr1::shared_ptr<abigail::class_decl::member_function_template> const*, std::vector<std::tr1::shared_ptr<abigail::class_decl::member_function_template>, std::allocator<std::tr1::shared_ptr<abigail::class_decl::member_function_template> > > >, __gnu_cxx::__normal_iterator<std::tr1::shared_ptr<abigail::class_decl::member_function_template> const*, std::vector<std::tr1::shared_ptr<abigail::class_decl::member_function_template>, std::allocator<std::tr1::shared_ptr<abigail::class_decl::member_function_template> > > >, __gnu_cxx::__normal_iterator<std::tr1::shared_ptr<abigail::class_decl::member_function_template> const*, std::vector<std::tr1::shared_ptr<abigail::class_decl::member_function_template>, std::allocator<std::tr1::shared_ptr<abigail::class_decl::member_function_template> > > >, __gnu_cxx::__normal_iterator<std::tr1::shared_ptr<abigail::class_decl::member_function_template> const*, std::vector<std::tr1::shared_ptr<abigail::class_decl::member_function_template>, std::allocator<std::tr1::shared_ptr<abigail::class_decl::member_function_template> > > >, __gnu_cxx::__normal_iterator<std::tr1::shared_ptr<abigail::class_decl::member_function_template> const*, std::vector<std::tr1::shared_ptr<abigail::class_decl::member_function_template>, std::allocator<std::tr1::shared_ptr<abigail::class_decl::member_function_template> > > >, __gnu_cxx::__normal_iterator<std::tr1::shared_ptr<abigail::class_decl::member_function_template> const*, std::vector<std::tr1::shared_ptr<abigail::class_decl::member_function_template>, std::allocator<std::tr1::shared_ptr<abigail::class_decl::member_function_template> > > >, std::vector<abigail::diff_utils::point, std::allocator<abigail::diff_utils::point> >&, abigail::diff_utils::edit_script&, int&)\",file=\"/home/dodji/git/libabigail/abi-diff/build/../include/abg-diff-utils.h\",fullname=\"/home/dodji/git/libabigail/abi-diff/include/abg-diff-utils.h\",line=\"1322\"},{number=\"2.6\",enabled=\"y\",addr=\"0x00007ffff7d74586\",func=\"abigail::diff_utils::compute_diff<__gnu_cxx::__normal_iterator<std::tr1::shared_ptr<abigail::class_decl::member_class_template> const*, std::vector<std::tr1::shared_ptr<abigail::class_decl::member_class_template>, std::allocator<std::tr1::shared_ptr<abigail::class_decl::member_class_template> > > > >(__gnu_cxx::__normal_iterator<std::tr1::shared_ptr<abigail::class_decl::member_class_template> const*, std::vector<std::tr1::shared_ptr<abigail::class_decl::member_class_template>, std::allocator<std::tr1::shared_ptr<abigail::class_decl::member_class_template> > > >, __gnu_cxx::__normal_iterator<std::tr1::shared_ptr<abigail::class_decl::member_class_template> const*, std::vector<std::tr1::shared_ptr<abigail::class_decl::member_class_template>, std::allocator<std::tr1::shared_ptr<abigail::class_decl::member_class_template> > > >, __gnu_cxx::__normal_iterator<std::tr1::shared_ptr<abigail::class_decl::member_class_template> const*, std::vector<std::tr1::shared_ptr<abigail::class_decl::member_class_template>, std::allocator<std::tr1::shared_ptr<abigail::class_decl::member_class_template> > > >, __gnu_cxx::__normal_iterator<std::tr1::shared_ptr<abigail::class_decl::member_class_template> const*, std::vector<std::tr1::shared_ptr<abigail::class_decl::member_class_template>, std::allocator<std::tr1::shared_ptr<abigail::class_decl::member_class_template> > > >, __gnu_cxx::__normal_iterator<std::tr1::shared_ptr<abigail::class_decl::member_class_template> const*, std::vector<std::tr1::shared_ptr<abigail::class_decl::member_class_template>, std::allocator<std::tr1::shared_ptr<abigail::class_decl::member_class_template> > > >, __gnu_cxx::__normal_iterator<std::tr1::shared_ptr<abigail::class_decl::member_class_template> const*, std::vector<std::tr1::shared_ptr<abigail::class_decl::member_class_template>, std::allocator<std::tr1::shared_ptr<abigail::class_decl::member_class_template> > > >, std::vector<abigail::diff_utils::point, std::allocator<abigail::diff_utils::point> >&, abigail::diff_utils::edit_script&, int&)\",file=\"/home/dodji/git/libabigail/abi-diff/build/../include/abg-diff-utils.h\",fullname=\"/home/dodji/git/libabigail/abi-diff/include/abg-diff-utils.h\",line=\"1322\"},{number=\"2.7\",enabled=\"y\",addr=\"0x00007ffff7d75928\",func=\"abigail::diff_utils::compute_diff<__gnu_cxx::__normal_iterator<std::tr1::shared_ptr<abigail::decl_base> const*, std::vector<std::tr1::shared_ptr<abigail::decl_base>, std::allocator<std::tr1::shared_ptr<abigail::decl_base> > > > >(__gnu_cxx::__normal_iterator<std::tr1::shared_ptr<abigail::decl_base> const*, std::vector<std::tr1::shared_ptr<abigail::decl_base>, std::allocator<std::tr1::shared_ptr<abigail::decl_base> > > >, __gnu_cxx::__normal_iterator<std::tr1::shared_ptr<abigail::decl_base> const*, std::vector<std::tr1::shared_ptr<abigail::decl_base>, std::allocator<std::tr1::shared_ptr<abigail::decl_base> > > >, __gnu_cxx::__normal_iterator<std::tr1::shared_ptr<abigail::decl_base> const*, std::vector<std::tr1::shared_ptr<abigail::decl_base>, std::allocator<std::tr1::shared_ptr<abigail::decl_base> > > >, __gnu_cxx::__normal_iterator<std::tr1::shared_ptr<abigail::decl_base> const*, std::vector<std::tr1::shared_ptr<abigail::decl_base>, std::allocator<std::tr1::shared_ptr<abigail::decl_base> > > >, __gnu_cxx::__normal_iterator<std::tr1::shared_ptr<abigail::decl_base> const*, std::vector<std::tr1::shared_ptr<abigail::decl_base>, std::allocator<std::tr1::shared_ptr<abigail::decl_base> > > >, __gnu_cxx::__normal_iterator<std::tr1::shared_ptr<abigail::decl_base> const*, std::vector<std::tr1::shared_ptr<abigail::decl_base>, std::allocator<std::tr1::shared_ptr<abigail::decl_base> > > >, std::vector<abigail::diff_utils::point, std::allocator<abigail::diff_utils::point> >&, abigail::diff_utils::edit_script&, int&)\",file=\"/home/dodji/git/libabigail/abi-diff/build/../include/abg-diff-utils.h\",fullname=\"/home/dodji/git/libabigail/abi-diff/include/abg-diff-utils.h\",line=\"1322\"},{number=\"2.8\",enabled=\"y\",addr=\"0x00007ffff7d76f1a\",func=\"abigail::diff_utils::compute_diff<__gnu_cxx::__normal_iterator<std::tr1::shared_ptr<abigail::function_decl::parameter> const*, std::vector<std::tr1::shared_ptr<abigail::function_decl::parameter>, std::allocator<std::tr1::shared_ptr<abigail::function_decl::parameter> > > > >(__gnu_cxx::__normal_iterator<std::tr1::shared_ptr<abigail::function_decl::parameter> const*, std::vector<std::tr1::shared_ptr<abigail::function_decl::parameter>, std::allocator<std::tr1::shared_ptr<abigail::function_decl::parameter> > > >, __gnu_cxx::__normal_iterator<std::tr1::shared_ptr<abigail::function_decl::parameter> const*, std::vector<std::tr1::shared_ptr<abigail::function_decl::parameter>, std::allocator<std::tr1::shared_ptr<abigail::function_decl::parameter> > > >, __gnu_cxx::__normal_iterator<std::tr1::shared_ptr<abigail::function_decl::parameter> const*, std::vector<std::tr1::shared_ptr<abigail::function_decl::parameter>, std::allocator<std::tr1::shared_ptr<abigail::function_decl::parameter> > > >, __gnu_cxx::__normal_iterator<std::tr1::shared_ptr<abigail::function_decl::parameter> const*, std::vector<std::tr1::shared_ptr<abigail::function_decl::parameter>, std::allocator<std::tr1::shared_ptr<abigail::function_decl::parameter> > > >, __gnu_cxx::__normal_iterator<std::tr1::shared_ptr<abigail::function_decl::parameter> const*, std::vector<std::tr1::shared_ptr<abigail::function_decl::parameter>, std::allocator<std::tr1::shared_ptr<abigail::function_decl::parameter> > > >, __gnu_cxx::__normal_iterator<std::tr1::shared_ptr<abigail::function_decl::parameter> const*, std::vector<std::tr1::shared_ptr<abigail::function_decl::parameter>, std::allocator<std::tr1::shared_ptr<abigail::function_decl::parameter> > > >, std::vector<abigail::diff_utils::point, std::allocator<abigail::diff_utils::point> >&, abigail::diff_utils::edit_script&, int&)\",file=\"/home/dodji/git/libabigail/abi-diff/build/../include/abg-diff-utils.h\",fullname=\"/home/dodji/git/libabigail/abi-diff/include/abg-diff-utils.h\",line=\"1322\"},{number=\"2.9\",enabled=\"y\",addr=\"0x00007ffff7d77b2e\",func=\"abigail::diff_utils::compute_diff<__gnu_cxx::__normal_iterator<char*, std::vector<char, std::allocator<char> > > >(__gnu_cxx::__normal_iterator<char*, std::vector<char, std::allocator<char> > >, __gnu_cxx::__normal_iterator<char*, std::vector<char, std::allocator<char> > >, __gnu_cxx::__normal_iterator<char*, std::vector<char, std::allocator<char> > >, __gnu_cxx::__normal_iterator<char*, std::vector<char, std::allocator<char> > >, __gnu_cxx::__normal_iterator<char*, std::vector<char, std::allocator<char> > >, __gnu_cxx::__normal_iterator<char*, std::vector<char, std::allocator<char> > >, std::vector<abigail::diff_utils::point, std::allocator<abigail::diff_utils::point> >&, abigail::diff_utils::edit_script&, int&)\",file=\"/home/dodji/git/libabigail/abi-diff/build/../include/abg-diff-utils.h\",fullname=\"/home/dodji/git/libabigail/abi-diff/include/abg-diff-utils.h\",line=\"1322\"},{number=\"2.10\",enabled=\"y\",addr=\"0x00007ffff7d573c8\",func=\"abigail::diff_utils::compute_diff<char const*>(char const*, char const*, char const*, char const*, char const*, char const*, std::vector<abigail::diff_utils::point, std::allocator<abigail::diff_utils::point> >&, abigail::diff_utils::edit_script&, int&)\",file=\"/home/dodji/git/libabigail/abi-diff/build/../include/abg-diff-utils.h\",fullname=\"/home/dodji/git/libabigail/abi-diff/include/abg-diff-utils.h\",line=\"1322\"}";
 
@@ -350,6 +381,21 @@ test_var_list_children ()
     is_ok = parser.parse_var_list_children (0, to, vars);
     BOOST_REQUIRE (is_ok);
     BOOST_REQUIRE (vars.size () == 2);
+
+    bool has_more = true;
+    vars.clear ();
+    parser.push_input (gv_var_list_children0);
+    is_ok = parser.parse_var_list_children (0, to, vars, has_more);
+    BOOST_REQUIRE (is_ok);
+    BOOST_REQUIRE (!has_more);
+
+    vars.clear ();
+    parser.push_input (gv_var_list_children1);
+    is_ok = parser.parse_var_list_children (0, to, vars, has_more);
+    BOOST_REQUIRE (is_ok);
+    BOOST_REQUIRE (vars.size () == 1);
+    BOOST_REQUIRE (has_more);
+    BOOST_REQUIRE (to == strlen (gv_var_list_children1));
 }
 
 void
@@ -367,6 +413,18 @@ test_output_record ()
     is_ok = parser.parse_output_record (0, to, output);
     BOOST_REQUIRE (is_ok);
 
+    parser.push_input (gv_output_record_non_stop);
+    output.clear ();
+    is_ok = parser.parse_output_record (0, to, output);
+    BOOST_REQUIRE (is_ok);
+    BOOST_REQUIRE (output.out_of_band_records ().size () == 2);
+    BOOST_REQUIRE (output.out_of_band_records ().front ().is_running ());
+    BOOST_REQUIRE (output.out_of_band_records ().front ().thread_id () == 2);
+    BOOST_REQUIRE (output.out_of_band_records ().back ().is_stopped ());
+    BOOST_REQUIRE (output.out_of_band_records ().back ().thread_id () == 3);
+    BOOST_REQUIRE (output.out_of_band_records ().back ().stop_reason ()
+                   == IDebugger::BREAKPOINT_HIT);
+
     parser.push_input (gv_output_record2);
     is_ok = parser.parse_output_record (0, to, output);
     BOOST_REQUIRE (is_ok);
@@ -456,6 +514,54 @@ test_output_record ()
     }
 }
 
+void
+test_library_loaded_record ()
+{
+    UString::size_type to = 0;
+    Output output;
+    GDBMIParser parser (gv_library_loaded_record);
+    bool is_ok = parser.parse_output_record (0, to, output);
+    BOOST_REQUIRE (is_ok);
+    BOOST_REQUIRE (output.has_out_of_band_record ());
+    BOOST_REQUIRE (output.out_of_band_records ().front ().libraries_changed ());
+}
+
+void
+test_thread_info_list ()
+{
+    UString::size_type to = 0;
+    Output output;
+    GDBMIParser parser (gv_thread_info_list);
+    bool is_ok = parser.parse_output_record (0, to, output);
+    BOOST_REQUIRE (is_ok);
+    BOOST_REQUIRE (output.has_result_record ());
+    BOOST_REQUIRE (output.result_record ().has_thread_info_list ());
+
+    const list<IDebugger::ThreadInfo> &threads =
+        output.result_record ().thread_info_list ();
+    BOOST_REQUIRE (threads.size () == 3);
+
+    list<IDebugger::ThreadInfo>::const_iterator it = threads.begin ();
+    BOOST_REQUIRE (it->id () == 2);
+    BOOST_REQUIRE (it->name () == "worker");
+    BOOST_REQUIRE (it->target_id () == "Thread 0x7ffff6fd5700 (LWP 4242)");
+    BOOST_REQUIRE (it->has_frame ());
+    BOOST_REQUIRE (it->frame ().function_name () == "__lll_lock_wait");
+    BOOST_REQUIRE (it->frame ().library () == "/lib64/libpthread.so.0");
+
+    ++it;
+    BOOST_REQUIRE (it->id () == 1);
+    BOOST_REQUIRE (it->name ().empty ());
+    BOOST_REQUIRE (!it->is_running ());
+    BOOST_REQUIRE (it->frame ().file_name () == "threads.cc");
+    BOOST_REQUIRE (it->frame ().line () == 42);
+
+    ++it;
+    BOOST_REQUIRE (it->id () == 3);
+    BOOST_REQUIRE (it->is_running ());
+    BOOST_REQUIRE (!it->has_frame ());
+}
+
 void
 test_stack0 ()
 {
@@ -475,6 +581,100 @@ test_stack0 ()
     }
 }
 
+void
+test_stack_interned_strings ()
+{
+    // Build a deep call stack, like the one of a runaway recursion,
+    // in which only a few function and file names are repeated.
+    const unsigned nb_frames = 10000;
+    UString stack_str = "stack=[";
+    for (unsigned i = 0; i < nb_frames; ++i) {
+        if (i)
+            stack_str += ",";
+        stack_str += "frame={level=\"" + UString::from_int (i) + "\","
+            "addr=\"0x080485" + UString::from_int (i % 10) + "0\","
+            "func=\"func" + UString::from_int (i % 3) + "\","
+            "file=\"fooprog.cc\","
+            "fullname=\"/home/dodji/devel/tests/fooprog.cc\","
+            "line=\"" + UString::from_int (i + 1) + "\"}";
+    }
+    stack_str += "]";
+
+    common::StringInternTableSafePtr table (new common::StringInternTable);
+    GDBMIParser parser (stack_str);
+    parser.set_string_intern_table (table);
+
+    UString::size_type to = 0;
+    vector<IDebugger::Frame> call_stack;
+    Glib::Timer timer;
+    bool is_ok = parser.parse_call_stack (0, to, call_stack);
+    timer.stop ();
+    BOOST_TEST_MESSAGE ("parsed " << nb_frames << " frames in "
+                        << timer.elapsed () << "s");
+
+    BOOST_REQUIRE (is_ok);
+    BOOST_REQUIRE (call_stack.size () == nb_frames);
+    // 3 function names, 1 file name and 1 full file name.
+    BOOST_REQUIRE (table->size () == 5);
+    BOOST_REQUIRE (call_stack[0].function_name () == "func0");
+    BOOST_REQUIRE (call_stack[nb_frames - 1].file_name () == "fooprog.cc");
+    BOOST_REQUIRE (&call_stack[0].function_name ()
+                   == &call_stack[3].function_name ());
+    BOOST_REQUIRE (&call_stack[0].file_full_name ()
+                   == &call_stack[nb_frames - 1].file_full_name ());
+    BOOST_REQUIRE (call_stack[0] == call_stack[0]);
+    BOOST_REQUIRE (!(call_stack[0] == call_stack[1]));
+
+    // Once the frames are gone, purging the table releases the
+    // strings.
+    call_stack.clear ();
+    table->purge ();
+    BOOST_REQUIRE (table->size () == 0);
+}
+
+void
+test_intern_allocations ()
+{
+    // A few distinct names, each interned over and over, as the
+    // names of the frames of a deep call stack are.  The names are
+    // built before counting, and are too long to be stored in place
+    // by std::string.
+    const unsigned nb_distinct = 5, nb_duplicates = 10000;
+    vector<string> names;
+    for (unsigned i = 0; i < nb_distinct; ++i)
+        names.push_back ("/home/dodji/devel/tests/fooprog"
+                         + UString::from_int (i).raw () + ".cc");
+    common::StringInternTableSafePtr table (new common::StringInternTable);
+    vector<common::InternedString> handles;
+    handles.reserve (nb_distinct * (nb_duplicates + 1));
+
+    // The first time a name is interned, it gets allocated.
+    unsigned long nb_allocations = get_nb_allocations ();
+    for (unsigned i = 0; i < nb_distinct; ++i)
+        handles.push_back (table->intern (names[i]));
+    unsigned long nb_first_allocations =
+        get_nb_allocations () - nb_allocations;
+    BOOST_TEST_MESSAGE ("interning " << nb_distinct << " names cost "
+                        << nb_first_allocations << " allocations");
+    BOOST_REQUIRE (nb_first_allocations >= nb_distinct);
+    BOOST_REQUIRE (table->size () == nb_distinct);
+
+    // Interning them again allocates nothing.
+    nb_allocations = get_nb_allocations ();
+    for (unsigned n = 0; n < nb_duplicates; ++n)
+        for (unsigned i = 0; i < nb_distinct; ++i)
+            handles.push_back (table->intern (names[i]));
+    BOOST_REQUIRE (get_nb_allocations () == nb_allocations);
+    BOOST_REQUIRE (table->size () == nb_distinct);
+
+    // All the handles to a name share its only copy.
+    for (unsigned i = 0; i < handles.size (); ++i) {
+        BOOST_REQUIRE (handles[i].raw () == names[i % nb_distinct]);
+        BOOST_REQUIRE (&handles[i].raw ()
+                       == &handles[i % nb_distinct].raw ());
+    }
+}
+
 void
 test_stack_arguments0 ()
 {
@@ -827,6 +1027,35 @@ test_memory_values ()
     BOOST_REQUIRE_EQUAL (*mem_iter, 0x13u);
 }
 
+void
+test_memory_bytes ()
+{
+    std::list<IDebugger::MemoryBlock> blocks;
+    UString::size_type cur = 0;
+
+    // The two first blocks are contiguous, the third one comes after
+    // a hole.
+    GDBMIParser parser (gv_memory_bytes);
+    BOOST_REQUIRE (parser.parse_memory_bytes (cur, cur, blocks));
+    BOOST_REQUIRE_EQUAL (blocks.size (), 2u);
+    const IDebugger::MemoryBlock &first = blocks.front ();
+    BOOST_REQUIRE_EQUAL (first.first, 0x00601040u);
+    BOOST_REQUIRE_EQUAL (first.second.size (), 4u);
+    BOOST_REQUIRE_EQUAL (first.second[0], 0x10u);
+    BOOST_REQUIRE_EQUAL (first.second[1], 0xffu);
+    BOOST_REQUIRE_EQUAL (first.second[2], 0xa0u);
+    BOOST_REQUIRE_EQUAL (first.second[3], 0xb1u);
+    const IDebugger::MemoryBlock &second = blocks.back ();
+    BOOST_REQUIRE_EQUAL (second.first, 0x00602000u);
+    BOOST_REQUIRE_EQUAL (second.second.size (), 1u);
+    BOOST_REQUIRE_EQUAL (second.second[0], 0x42u);
+
+    GDBMIParser empty_parser ("memory=[]");
+    cur = 0;
+    BOOST_REQUIRE (empty_parser.parse_memory_bytes (cur, cur, blocks));
+    BOOST_REQUIRE (blocks.empty ());
+}
+
 void
 test_gdbmi_result ()
 {
@@ -947,6 +1176,31 @@ test_breakpoint ()
     BOOST_REQUIRE_EQUAL (breakpoint.sub_breakpoints ().size (), 10);
     BOOST_REQUIRE_EQUAL (breakpoint.sub_breakpoints ()[0].id (), "2.1");
     BOOST_REQUIRE_EQUAL (breakpoint.sub_breakpoints ()[9].id (), "2.10");
+
+    GDBMIParser broken_parser (gv_dprintf0, GDBMIParser::BROKEN_MODE);
+    breakpoint.clear ();
+    is_ok = broken_parser.parse_breakpoint (0, cur, breakpoint);
+    BOOST_REQUIRE (is_ok);
+    BOOST_REQUIRE (breakpoint.type () == IDebugger::Breakpoint::DPRINTF_TYPE);
+    BOOST_REQUIRE_EQUAL (breakpoint.dprintf_format (), "\"i = %d\\n\",i");
+    BOOST_REQUIRE_EQUAL (breakpoint.line (), 6);
+
+    parser.push_input (gv_hw_watchpoint0);
+    breakpoint.clear ();
+    is_ok = parser.parse_breakpoint (0, cur, breakpoint);
+    BOOST_REQUIRE (is_ok);
+    BOOST_REQUIRE (breakpoint.type ()
+                   == IDebugger::Breakpoint::WATCHPOINT_TYPE);
+    BOOST_REQUIRE (breakpoint.is_hardware_watchpoint ());
+    BOOST_REQUIRE_EQUAL (breakpoint.expression (), "i");
+
+    parser.push_input (gv_sw_watchpoint0);
+    breakpoint.clear ();
+    is_ok = parser.parse_breakpoint (0, cur, breakpoint);
+    BOOST_REQUIRE (is_ok);
+    BOOST_REQUIRE (breakpoint.type ()
+                   == IDebugger::Breakpoint::WATCHPOINT_TYPE);
+    BOOST_REQUIRE (!breakpoint.is_hardware_watchpoint ());
 }
 
 void
@@ -1034,7 +1288,11 @@ init_unit_test_suite (int /*argc*/, char ** /*argv*/)
     suite->add (BOOST_TEST_CASE (&test_running_async_output));
     suite->add (BOOST_TEST_CASE (&test_var_list_children));
     suite->add (BOOST_TEST_CASE (&test_output_record));
+    suite->add (BOOST_TEST_CASE (&test_library_loaded_record));
+    suite->add (BOOST_TEST_CASE (&test_thread_info_list));
     suite->add (BOOST_TEST_CASE (&test_stack0));
+    suite->add (BOOST_TEST_CASE (&test_stack_interned_strings));
+    suite->add (BOOST_TEST_CASE (&test_intern_allocations));
     suite->add (BOOST_TEST_CASE (&test_stack_arguments0));
     suite->add (BOOST_TEST_CASE (&test_stack_arguments1));
     suite->add (BOOST_TEST_CASE (&test_local_vars));
@@ -1047,6 +1305,7 @@ init_unit_test_suite (int /*argc*/, char ** /*argv*/)
     suite->add (BOOST_TEST_CASE (&test_changed_registers));
     suite->add (BOOST_TEST_CASE (&test_register_values));
     suite->add (BOOST_TEST_CASE (&test_memory_values));
+    suite->add (BOOST_TEST_CASE (&test_memory_bytes));
     suite->add (BOOST_TEST_CASE (&test_gdbmi_result));
     suite->add (BOOST_TEST_CASE (&test_breakpoint_table));
     suite->add (BOOST_TEST_CASE (&test_breakpoint));
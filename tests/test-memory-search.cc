@@ -0,0 +1,346 @@
+#include "config.h"
+#include <algorithm>
+#include <fstream>
+#include <string>
+#include <vector>
+#include <boost/test/minimal.hpp>
+#include <glib/gstdio.h>
+#include <glibmm/main.h>
+#include <glibmm/fileutils.h>
+#include "common/nmv-initializer.h"
+#include "common/nmv-exception.h"
+#include "nmv-debugger-utils.h"
+#include "nmv-memory-dumper.h"
+
+// Checks that MemorySearcher, that the memory view uses to search a
+// range of memory as it is read in chunks, finds the occurrences of a
+// pattern inside a chunk, across the boundary of two chunks, in the
+// tail of the last chunk, and across chunks smaller than the
+// pattern; and that it doesn't find them across a hole.
+//
+// Then checks that MemoryDumper, driving GDBEngine and the fake
+// GDB/MI server (fakegdbmi), writes and searches every block of a
+// chunk that has a hole of unreadable memory in its middle.
+//
+// Also checks find_changed_ranges, that the memory view uses to only
+// redraw the bytes that changed, against a byte per byte comparison:
+// with changes that start or end in the middle of a 64 bits word,
+// that span two words, in the bytes past the last whole word, and in
+// buffers which size isn't a multiple of 8.
+
+using namespace std;
+using namespace nemiver;
+using namespace nemiver::common;
+
+/// Search the chunks a_chunks of a_memory, which start at a_addr, for
+/// a_pattern.
+static vector<size_t>
+search (const string &a_memory,
+        size_t a_addr,
+        const vector<size_t> &a_chunk_sizes,
+        const string &a_pattern)
+{
+    MemorySearcher searcher;
+    searcher.reset (a_pattern);
+    vector<size_t> hits;
+    size_t offset = 0;
+    for (vector<size_t>::const_iterator it = a_chunk_sizes.begin ();
+         it != a_chunk_sizes.end ();
+         ++it) {
+        vector<uint8_t> chunk (a_memory.begin () + offset,
+                               a_memory.begin () + offset + *it);
+        searcher.search (a_addr + offset, chunk, hits);
+        offset += *it;
+    }
+    return hits;
+}
+
+static vector<size_t>
+sizes (size_t a_first, size_t a_second, size_t a_third = 0)
+{
+    vector<size_t> result;
+    result.push_back (a_first);
+    result.push_back (a_second);
+    if (a_third)
+        result.push_back (a_third);
+    return result;
+}
+
+static void
+test_search ()
+{
+    const string memory ("xxneedlexxxxxneedlexneedle");
+    const size_t addr = 0x1000;
+
+    // In one chunk.
+    vector<size_t> hits = search (memory, addr,
+                                  vector<size_t> (1, memory.size ()),
+                                  "needle");
+    BOOST_REQUIRE (hits.size () == 3);
+    BOOST_REQUIRE (hits[0] == addr + 2);
+    BOOST_REQUIRE (hits[1] == addr + 13);
+    BOOST_REQUIRE (hits[2] == addr + 20);
+
+    // Across the boundary of two chunks, at each possible place.
+    for (size_t cut = 14; cut < 19; ++cut) {
+        hits = search (memory, addr,
+                       sizes (cut, memory.size () - cut), "needle");
+        BOOST_REQUIRE (hits.size () == 3);
+        BOOST_REQUIRE (hits[1] == addr + 13);
+    }
+
+    // Ending the last chunk.
+    hits = search (memory, addr, sizes (20, memory.size () - 20), "needle");
+    BOOST_REQUIRE (hits.size () == 3);
+    BOOST_REQUIRE (hits[2] == addr + 20);
+
+    // Across a chunk smaller than the pattern.
+    hits = search (memory, addr, sizes (15, 2, memory.size () - 17),
+                   "needle");
+    BOOST_REQUIRE (hits.size () == 3);
+    BOOST_REQUIRE (hits[1] == addr + 13);
+
+    // Overlapping occurrences, across the boundary.
+    hits = search ("aaaaa", addr, sizes (2, 3), "aaa");
+    BOOST_REQUIRE (hits.size () == 3);
+    BOOST_REQUIRE (hits[0] == addr);
+    BOOST_REQUIRE (hits[2] == addr + 2);
+
+    // A pattern of one byte.
+    hits = search (memory, addr, sizes (3, memory.size () - 3), "n");
+    BOOST_REQUIRE (hits.size () == 3);
+}
+
+static void
+test_hole ()
+{
+    const size_t addr = 0x1000;
+    MemorySearcher searcher;
+    searcher.reset ("needle");
+    vector<size_t> hits;
+    string first ("xxxnee"), second ("dlexxx");
+    searcher.search (addr,
+                     vector<uint8_t> (first.begin (), first.end ()),
+                     hits);
+    // The memory in between couldn't be read.
+    searcher.search (addr + 0x100 + first.size (),
+                     vector<uint8_t> (second.begin (), second.end ()),
+                     hits);
+    BOOST_REQUIRE (hits.empty ());
+
+    // Nor is anything found once the search is reset.
+    searcher.reset ("needle");
+    searcher.search (addr,
+                     vector<uint8_t> (first.begin (), first.end ()),
+                     hits);
+    searcher.reset ("");
+    searcher.search (addr + first.size (),
+                     vector<uint8_t> (second.begin (), second.end ()),
+                     hits);
+    BOOST_REQUIRE (hits.empty ());
+}
+
+static Glib::RefPtr<Glib::MainLoop> loop =
+    Glib::MainLoop::create (Glib::MainContext::get_default ());
+
+static void
+on_hit_signal (size_t a_addr, vector<size_t> *a_hits)
+{
+    a_hits->push_back (a_addr);
+}
+
+static void
+on_finished_signal (size_t a_nb_read,
+                    size_t a_nb_unread,
+                    bool a_cancelled,
+                    size_t *a_result)
+{
+    a_result[0] = a_nb_read;
+    a_result[1] = a_nb_unread;
+    a_result[2] = a_cancelled;
+    loop->quit ();
+}
+
+static bool
+on_timeout ()
+{
+    MESSAGE ("timed out");
+    loop->quit ();
+    return false;
+}
+
+/// The changed ranges of a_old and a_new, found a byte at a time.
+static size_t
+changed_ranges_per_byte (const vector<uint8_t> &a_old,
+                         const vector<uint8_t> &a_new,
+                         vector<ByteRange> &a_ranges)
+{
+    a_ranges.clear ();
+    size_t nb_changed = 0;
+    for (size_t i = 0; i < a_new.size (); ++i) {
+        if (a_old[i] == a_new[i])
+            continue;
+        ++nb_changed;
+        // Less than 8 bytes apart: merged.
+        if (!a_ranges.empty () && i - a_ranges.back ().second < 8)
+            a_ranges.back ().second = i + 1;
+        else
+            a_ranges.push_back (ByteRange (i, i + 1));
+    }
+    return nb_changed;
+}
+
+/// Check find_changed_ranges on a buffer of a_size bytes, which bytes
+/// [a_begin, a_end) changed.
+static vector<ByteRange>
+changed_ranges (size_t a_size, size_t a_begin, size_t a_end,
+                size_t a_begin2 = 0, size_t a_end2 = 0)
+{
+    vector<uint8_t> old_bytes (a_size), new_bytes;
+    for (size_t i = 0; i < a_size; ++i)
+        old_bytes[i] = i;
+    new_bytes = old_bytes;
+    for (size_t i = a_begin; i < a_end; ++i)
+        new_bytes[i] = ~old_bytes[i];
+    for (size_t i = a_begin2; i < a_end2; ++i)
+        new_bytes[i] = ~old_bytes[i];
+
+    vector<ByteRange> ranges, expected;
+    size_t nb_changed = find_changed_ranges (old_bytes, new_bytes, ranges);
+    BOOST_REQUIRE (nb_changed
+                   == changed_ranges_per_byte (old_bytes, new_bytes,
+                                               expected));
+    BOOST_REQUIRE (ranges == expected);
+    return ranges;
+}
+
+static void
+test_changed_ranges ()
+{
+    BOOST_REQUIRE (changed_ranges (0, 0, 0).empty ());
+    BOOST_REQUIRE (changed_ranges (37, 0, 0).empty ());
+
+    // Inside a word, from and to unaligned offsets.
+    vector<ByteRange> ranges = changed_ranges (37, 3, 5);
+    BOOST_REQUIRE (ranges.size () == 1);
+    BOOST_REQUIRE (ranges[0] == ByteRange (3, 5));
+
+    // Across the boundary of two words.
+    ranges = changed_ranges (37, 6, 11);
+    BOOST_REQUIRE (ranges.size () == 1);
+    BOOST_REQUIRE (ranges[0] == ByteRange (6, 11));
+
+    // Two whole adjacent words.
+    ranges = changed_ranges (37, 8, 24);
+    BOOST_REQUIRE (ranges.size () == 1);
+    BOOST_REQUIRE (ranges[0] == ByteRange (8, 24));
+
+    // Changes in adjacent words, less than 8 bytes apart, are merged;
+    // farther apart, they are not.
+    ranges = changed_ranges (37, 2, 3, 9, 10);
+    BOOST_REQUIRE (ranges.size () == 1);
+    BOOST_REQUIRE (ranges[0] == ByteRange (2, 10));
+    ranges = changed_ranges (37, 2, 3, 11, 12);
+    BOOST_REQUIRE (ranges.size () == 2);
+    BOOST_REQUIRE (ranges[1] == ByteRange (11, 12));
+
+    // In the bytes past the last whole word.
+    ranges = changed_ranges (37, 36, 37);
+    BOOST_REQUIRE (ranges.size () == 1);
+    BOOST_REQUIRE (ranges[0] == ByteRange (36, 37));
+    ranges = changed_ranges (37, 30, 37);
+    BOOST_REQUIRE (ranges.size () == 1);
+    BOOST_REQUIRE (ranges[0] == ByteRange (30, 37));
+
+    // Smaller than a word.
+    ranges = changed_ranges (5, 1, 2, 4, 5);
+    BOOST_REQUIRE (ranges.size () == 1);
+    BOOST_REQUIRE (ranges[0] == ByteRange (1, 5));
+
+    // Every change of one or two runs of bytes, for sizes around the
+    // size of a few words.
+    for (size_t size = 1; size <= 26; ++size)
+        for (size_t begin = 0; begin < size; ++begin)
+            for (size_t end = begin + 1; end <= size; ++end)
+                for (size_t begin2 = end; begin2 <= size; begin2 += 3)
+                    changed_ranges (size, begin, end, begin2,
+                                    std::min (begin2 + 2, size));
+}
+
+static void
+test_dump_hole ()
+{
+    // The range 0x1000-0x1014 is dumped in one chunk, of which GDB
+    // can't read the 4 bytes at 0x1008.
+    const size_t addr = 0x1000;
+    const string first ("needle--"), second ("--needle");
+    const string scenario_path = "memory-hole-scenario";
+    const string dump_path = "memory-hole-dump";
+    {
+        ofstream scenario (scenario_path.c_str ());
+        scenario << "-data-read-memory-bytes\t^done,memory=["
+                    "{begin=\"0x1000\",offset=\"0x0\",end=\"0x1008\","
+                    "contents=\"6e6565646c652d2d\"},"
+                    "{begin=\"0x100c\",offset=\"0x0\",end=\"0x1014\","
+                    "contents=\"2d2d6e6565646c65\"}]\\n\n";
+    }
+    g_setenv ("NMV_FAKE_GDB_SCENARIO", scenario_path.c_str (), TRUE);
+
+    IDebuggerSafePtr debugger =
+        debugger_utils::load_debugger_iface_with_confmgr ();
+    debugger->set_event_loop_context (loop->get_context ());
+    debugger->set_non_persistent_debugger_path
+                                (NEMIVER_BUILDDIR "/fakegdbmi");
+    std::vector<UString> args, source_search_dir;
+    source_search_dir.push_back (".");
+    debugger->load_program ("fooprog", args, ".",
+                            source_search_dir, "", -1, false);
+
+    MemoryDumper dumper (debugger);
+    vector<size_t> hits;
+    size_t result[3] = {0, 0, 1};
+    dumper.hit_signal ().connect (sigc::bind (&on_hit_signal, &hits));
+    dumper.finished_signal ().connect
+                            (sigc::bind (&on_finished_signal, result));
+    dumper.start (addr, 0x14, dump_path, "needle");
+    Glib::signal_timeout ().connect (&on_timeout, 10000);
+    loop->run ();
+    debugger->exit_engine ();
+
+    BOOST_REQUIRE (result[0] == 16);
+    BOOST_REQUIRE (result[1] == 4);
+    BOOST_REQUIRE (!result[2]);
+
+    // The block after the hole is searched too.
+    BOOST_REQUIRE (hits.size () == 2);
+    BOOST_REQUIRE (hits[0] == addr);
+    BOOST_REQUIRE (hits[1] == addr + 0xe);
+
+    // Each block is written at its own offset; the hole reads as
+    // zeros.
+    string dump = Glib::file_get_contents (dump_path);
+    BOOST_REQUIRE (dump == first + string (4, '\0') + second);
+
+    g_unsetenv ("NMV_FAKE_GDB_SCENARIO");
+    g_unlink (scenario_path.c_str ());
+    g_unlink (dump_path.c_str ());
+}
+
+NEMIVER_API int
+test_main (int, char **)
+{
+    NEMIVER_TRY;
+
+    Initializer::do_init ();
+
+    THROW_IF_FAIL (loop);
+
+    test_search ();
+    test_hole ();
+    test_changed_ranges ();
+    test_dump_hole ();
+
+    NEMIVER_CATCH_NOX;
+
+    return 0;
+}
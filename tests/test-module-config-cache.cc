@@ -0,0 +1,175 @@
+#include "config.h"
+#include <string>
+#include <vector>
+#include <boost/test/minimal.hpp>
+#include <glibmm.h>
+#include <glib/gstdio.h>
+#include "common/nmv-initializer.h"
+#include "common/nmv-exception.h"
+#include "common/nmv-dynamic-module.h"
+#include "common/nmv-env.h"
+
+// Checks the registry of the modules found by the previous runs, that
+// DynamicModule::Loader::module_config looks up before parsing the
+// config file of a module: an unchanged config file is not parsed
+// again, even by another loader; a config file which size changed
+// is; so is one that gets shadowed by a config file added to a
+// directory that comes first in the search paths; and each list of
+// search paths has its own entries.  The registry must also be saved
+// as soon as it changes, with no main loop running.
+
+using namespace std;
+using namespace nemiver;
+using namespace nemiver::common;
+
+static const string TEST_DIR = "module-config-cache";
+
+/// A loader that counts the config files it parses.
+class CountingLoader : public DynamicModule::Loader {
+public:
+    unsigned nb_parsed;
+
+    CountingLoader () :
+        nb_parsed (0)
+    {
+    }
+
+    DynamicModule::ConfigSafePtr
+    parse_module_config_file (const UString &a_path)
+    {
+        ++nb_parsed;
+        return DynamicModule::Loader::parse_module_config_file (a_path);
+    }
+};//end class CountingLoader
+
+static string
+dir_path (const string &a_name)
+{
+    return Glib::build_filename (TEST_DIR, a_name);
+}
+
+static string
+conf_path (const string &a_dir)
+{
+    return Glib::build_filename (dir_path (a_dir), "foo.conf");
+}
+
+static void
+write_conf (const string &a_dir, const string &a_library_name)
+{
+    Glib::file_set_contents
+        (conf_path (a_dir),
+         "<moduleconfig>\n"
+         "    <module>\n"
+         "        <name>foo</name>\n"
+         "        <libraryname>" + a_library_name + "</libraryname>\n"
+         "    </module>\n"
+         "    <customsearchpaths>\n"
+         "        <path>" + dir_path (a_dir) + "</path>\n"
+         "    </customsearchpaths>\n"
+         "</moduleconfig>\n");
+}
+
+/// Get the config of the module foo from a new loader, that searches
+/// the directories a_dirs in turn.
+///
+/// \param a_nb_parsed set to the number of config files the loader
+/// parsed.
+/// \return the name of the library of the module.
+static UString
+foo_library_name (const vector<string> &a_dirs, unsigned &a_nb_parsed)
+{
+    CountingLoader loader;
+    loader.config_search_paths ().clear ();
+    for (vector<string>::const_iterator it = a_dirs.begin ();
+         it != a_dirs.end ();
+         ++it)
+        loader.config_search_paths ().push_back (dir_path (*it));
+    DynamicModule::ConfigSafePtr config = loader.module_config ("foo");
+    a_nb_parsed = loader.nb_parsed;
+    BOOST_REQUIRE (config);
+    return config->library_name;
+}
+
+static void
+clean ()
+{
+    g_unlink (conf_path ("first").c_str ());
+    g_unlink (conf_path ("second").c_str ());
+    g_unlink (Glib::build_filename (env::get_user_db_dir ().raw (),
+                                    "modules.cache").c_str ());
+}
+
+static void
+test_module_config_cache ()
+{
+    vector<string> dirs;
+    dirs.push_back ("first");
+    dirs.push_back ("second");
+    unsigned nb_parsed = 0;
+
+    // Not cached yet.
+    write_conf ("second", "foolib");
+    BOOST_REQUIRE (foo_library_name (dirs, nb_parsed) == "foolib");
+    BOOST_REQUIRE (nb_parsed == 1);
+    // Saved right away.
+    BOOST_REQUIRE (Glib::file_test
+                   (Glib::build_filename (env::get_user_db_dir ().raw (),
+                                          "modules.cache"),
+                    Glib::FILE_TEST_IS_REGULAR));
+
+    // A hit.
+    BOOST_REQUIRE (foo_library_name (dirs, nb_parsed) == "foolib");
+    BOOST_REQUIRE (nb_parsed == 0);
+
+    // Stale: the config file changed.
+    write_conf ("second", "foolib2");
+    BOOST_REQUIRE (foo_library_name (dirs, nb_parsed) == "foolib2");
+    BOOST_REQUIRE (nb_parsed == 1);
+    BOOST_REQUIRE (foo_library_name (dirs, nb_parsed) == "foolib2");
+    BOOST_REQUIRE (nb_parsed == 0);
+
+    // Shadowed: a config file got added to a directory searched
+    // before the one of the cached config.
+    write_conf ("first", "firstlib");
+    BOOST_REQUIRE (foo_library_name (dirs, nb_parsed) == "firstlib");
+    BOOST_REQUIRE (nb_parsed == 1);
+    BOOST_REQUIRE (foo_library_name (dirs, nb_parsed) == "firstlib");
+    BOOST_REQUIRE (nb_parsed == 0);
+
+    // Other search paths get their own entry, which doesn't replace
+    // the entry of the first ones.
+    vector<string> second_only;
+    second_only.push_back ("second");
+    BOOST_REQUIRE (foo_library_name (second_only, nb_parsed) == "foolib2");
+    BOOST_REQUIRE (nb_parsed == 1);
+    BOOST_REQUIRE (foo_library_name (second_only, nb_parsed) == "foolib2");
+    BOOST_REQUIRE (nb_parsed == 0);
+    BOOST_REQUIRE (foo_library_name (dirs, nb_parsed) == "firstlib");
+    BOOST_REQUIRE (nb_parsed == 0);
+}
+
+NEMIVER_API int
+test_main (int, char **)
+{
+    NEMIVER_TRY;
+
+    // Keep the registry of the user out of this.
+    g_setenv ("HOME", dir_path ("home").c_str (), TRUE);
+
+    Initializer::do_init ();
+
+    g_mkdir_with_parents (dir_path ("first").c_str (), S_IRWXU);
+    g_mkdir_with_parents (dir_path ("second").c_str (), S_IRWXU);
+    // The registry is only read once, so it must not be there from
+    // a previous run.
+    clean ();
+
+    test_module_config_cache ();
+
+    clean ();
+
+    NEMIVER_CATCH_NOX;
+
+    return 0;
+}
@@ -0,0 +1,153 @@
+#include "config.h"
+#include <iostream>
+#include <boost/test/minimal.hpp>
+#include "common/nmv-initializer.h"
+#include "common/nmv-safe-ptr-utils.h"
+#include "common/nmv-exception.h"
+#include "nmv-debugger-utils.h"
+
+// Debugs a program of three threads in non-stop mode, with GDBEngine
+// driving the fake GDB/MI server (fakegdbmi).  The fake server
+// refuses "-gdb-set mi-async", as GDB older than 7.8 does, so the
+// engine has to fall back to target-async.
+//
+//  - The program is run: thread 1 stops on a breakpoint, threads 2
+//    and 3 keep running.
+//  - Thread 1 is stepped: it stops again, then thread 2 hits a
+//    breakpoint.  As the user is looking at thread 1, which is
+//    stopped, the engine must stay on it and not report the stop of
+//    thread 2, but as a change of the state of the thread.
+//  - Thread 1 is continued: thread 3 hits a breakpoint.  As the
+//    thread of the user is running, the engine must report the stop
+//    of thread 3.
+
+using namespace nemiver;
+using namespace nemiver::common;
+
+static Glib::RefPtr<Glib::MainLoop> loop =
+    Glib::MainLoop::create (Glib::MainContext::get_default ());
+
+static int nb_stops = 0;
+static int nb_errors = 0;
+static bool saw_thread_2_stop = false;
+static bool done = false;
+
+static void
+on_engine_died_signal ()
+{
+    MESSAGE ("engine died");
+    loop->quit ();
+}
+
+static void
+on_error_signal (const UString &a_msg)
+{
+    MESSAGE ("error: " << a_msg);
+    ++nb_errors;
+}
+
+static void
+on_thread_state_changed_signal (int a_thread_id,
+                                bool a_is_running,
+                                IDebuggerSafePtr &a_debugger)
+{
+    MESSAGE ("thread " << a_thread_id
+             << (a_is_running ? " running" : " stopped"));
+    if (a_thread_id != 2 || a_is_running || nb_stops != 2)
+        return;
+    // Thread 2 stopped while the user looks at thread 1.
+    saw_thread_2_stop = true;
+    BOOST_REQUIRE (a_debugger->get_current_thread () == 1);
+    BOOST_REQUIRE (!a_debugger->is_thread_running (1));
+    BOOST_REQUIRE (!a_debugger->is_thread_running (2));
+    BOOST_REQUIRE (a_debugger->is_thread_running (3));
+    a_debugger->do_continue ();
+}
+
+static void
+on_stopped_signal (IDebugger::StopReason a_reason,
+                   bool /*a_has_frame*/,
+                   const IDebugger::Frame &/*a_frame*/,
+                   int a_thread_id,
+                   const string &/*a_bp_num*/,
+                   const UString &/*a_cookie*/,
+                   IDebuggerSafePtr &a_debugger)
+{
+    if (a_reason == IDebugger::EXITED_SIGNALLED
+        || a_reason == IDebugger::EXITED_NORMALLY
+        || a_reason == IDebugger::EXITED)
+        return;
+    ++nb_stops;
+    MESSAGE ("stop " << nb_stops << " of thread " << a_thread_id);
+    BOOST_REQUIRE (a_debugger->is_non_stop_mode ());
+    if (nb_stops == 1) {
+        BOOST_REQUIRE (a_thread_id == 1);
+        BOOST_REQUIRE (!a_debugger->is_thread_running (1));
+        BOOST_REQUIRE (a_debugger->is_thread_running (2));
+        BOOST_REQUIRE (a_debugger->is_thread_running (3));
+        a_debugger->step_over ();
+    } else if (nb_stops == 2) {
+        BOOST_REQUIRE (a_thread_id == 1);
+        BOOST_REQUIRE (a_reason == IDebugger::END_STEPPING_RANGE);
+    } else {
+        BOOST_REQUIRE (saw_thread_2_stop);
+        BOOST_REQUIRE (a_thread_id == 3);
+        BOOST_REQUIRE (a_debugger->is_thread_running (1));
+        BOOST_REQUIRE (!a_debugger->is_thread_running (2));
+        BOOST_REQUIRE (!a_debugger->is_thread_running (3));
+        done = true;
+        loop->quit ();
+    }
+}
+
+NEMIVER_API int
+test_main (int, char **)
+{
+    NEMIVER_TRY;
+
+    Initializer::do_init ();
+
+    THROW_IF_FAIL (loop);
+
+    g_setenv ("NMV_FAKE_GDB_NUM_THREADS", "3", TRUE);
+    g_setenv ("NMV_FAKE_GDB_NO_MI_ASYNC", "1", TRUE);
+
+    IDebuggerSafePtr debugger =
+        debugger_utils::load_debugger_iface_with_confmgr ();
+
+    debugger->set_event_loop_context (loop->get_context ());
+    debugger->set_non_persistent_debugger_path
+                                (NEMIVER_BUILDDIR "/fakegdbmi");
+    debugger->enable_pretty_printing (false);
+    debugger->set_non_stop_mode (true);
+
+    debugger->engine_died_signal ().connect (&on_engine_died_signal);
+
+    debugger->error_signal ().connect (&on_error_signal);
+
+    debugger->thread_state_changed_signal ().connect
+        (sigc::bind (&on_thread_state_changed_signal, debugger));
+
+    debugger->stopped_signal ().connect
+        (sigc::bind (&on_stopped_signal, debugger));
+
+    // The fake server doesn't look at the program; it just has to
+    // exist for the engine to accept it.
+    std::vector<UString> args, source_search_dir;
+    source_search_dir.push_back (".");
+    debugger->load_program ("fooprog", args, ".",
+                            source_search_dir, "", -1, false);
+    debugger->set_breakpoint ("main");
+    debugger->run ();
+    loop->run ();
+
+    BOOST_REQUIRE (done);
+    BOOST_REQUIRE (nb_stops == 3);
+    // Neither the refusal of mi-async, nor the execution commands,
+    // which must all be given --thread, should fail.
+    BOOST_REQUIRE (nb_errors == 0);
+
+    NEMIVER_CATCH_NOX;
+
+    return 0;
+}
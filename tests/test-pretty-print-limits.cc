@@ -0,0 +1,191 @@
+#include "config.h"
+#include <iostream>
+#include <boost/test/minimal.hpp>
+#include "common/nmv-initializer.h"
+#include "common/nmv-safe-ptr-utils.h"
+#include "common/nmv-exception.h"
+#include "nmv-debugger-utils.h"
+
+// Unfolds a variable that has a pretty-printer, with GDBEngine
+// driving the fake GDB/MI server (fakegdbmi), twice: first with the
+// number of children fetched through pretty-printers limited, then
+// without limit.  The fake server makes each child cost
+// NMV_FAKE_GDB_CHILD_COST_US microseconds, as a slow pretty-printer of
+// a big container would.  It reports what each unfolding cost, as
+// measured by the engine.
+//
+// Then the type of the variable is opted out of pretty-printing, and
+// the variable is created and unfolded a third time: it must have
+// lost its pretty-printer, and so the limit.  It also checks that a
+// pointer type opted out of pretty-printing isn't taken as a pattern.
+//
+// Usage: runtestprettyprintlimits [number-of-children]
+
+using namespace nemiver;
+using namespace nemiver::common;
+
+static Glib::RefPtr<Glib::MainLoop> loop =
+    Glib::MainLoop::create (Glib::MainContext::get_default ());
+
+static const int MAX_CHILDREN = 50;
+static int num_children = 2000;
+static IDebugger::VariableList variables;
+static unsigned int limited_cost_ms = 0;
+static unsigned int full_cost_ms = 0;
+static bool done = false;
+
+// The unfoldings, in order.
+enum Stage {
+    LIMITED_STAGE,
+    FULL_STAGE,
+    OPTED_OUT_STAGE
+};
+static Stage stage = LIMITED_STAGE;
+
+static void
+on_engine_died_signal ()
+{
+    MESSAGE ("engine died");
+    loop->quit ();
+}
+
+/// A type opted out of pretty-printing is matched as it is spelled:
+/// the '*' of a pointer type must not act as a wildcard.
+static void
+check_pointer_type_opt_out (IDebuggerSafePtr &a_debugger)
+{
+    a_debugger->disable_pretty_printing_for_type ("Foo<int*>", true);
+    BOOST_REQUIRE (a_debugger->is_pretty_printing_disabled_for_type
+                                                        ("Foo<int*>"));
+    BOOST_REQUIRE (!a_debugger->is_pretty_printing_disabled_for_type
+                                                        ("Foo<int**>"));
+    BOOST_REQUIRE (!a_debugger->is_pretty_printing_disabled_for_type
+                                                        ("Foo<int>"));
+    a_debugger->disable_pretty_printing_for_type ("Foo<int*>", false);
+    BOOST_REQUIRE (!a_debugger->is_pretty_printing_disabled_for_type
+                                                        ("Foo<int*>"));
+}
+
+static void on_variable_created (const IDebugger::VariableSafePtr a_var,
+                                 IDebuggerSafePtr &a_debugger);
+
+static void
+on_variable_unfolded (const IDebugger::VariableSafePtr a_var,
+                      IDebuggerSafePtr &a_debugger)
+{
+    MESSAGE ("unfolded " << a_var->internal_name () << ": "
+             << (int) a_var->members ().size () << " children in "
+             << (int) a_var->backend_cost_ms () << "ms");
+    if (stage == LIMITED_STAGE) {
+        BOOST_REQUIRE ((int) a_var->members ().size () == MAX_CHILDREN);
+        BOOST_REQUIRE (a_var->has_more_children ());
+        limited_cost_ms = a_var->backend_cost_ms ();
+        stage = FULL_STAGE;
+        a_debugger->set_pretty_printing_max_children (0);
+        a_debugger->create_variable
+            ("c", sigc::bind (&on_variable_created, a_debugger));
+    } else if (stage == FULL_STAGE) {
+        BOOST_REQUIRE ((int) a_var->members ().size () == num_children);
+        BOOST_REQUIRE (!a_var->has_more_children ());
+        full_cost_ms = a_var->backend_cost_ms ();
+        stage = OPTED_OUT_STAGE;
+        a_debugger->set_pretty_printing_max_children (MAX_CHILDREN);
+        a_debugger->disable_pretty_printing_for_type (a_var->type (), true);
+        BOOST_REQUIRE (a_debugger->is_pretty_printing_disabled_for_type
+                                                        (a_var->type ()));
+        a_debugger->create_variable
+            ("c", sigc::bind (&on_variable_created, a_debugger));
+    } else {
+        // Without its pretty-printer, the limit doesn't apply.
+        BOOST_REQUIRE ((int) a_var->members ().size () == num_children);
+        a_debugger->disable_pretty_printing_for_type (a_var->type (), false);
+        BOOST_REQUIRE (!a_debugger->is_pretty_printing_disabled_for_type
+                                                        (a_var->type ()));
+        check_pointer_type_opt_out (a_debugger);
+        done = true;
+        loop->quit ();
+    }
+}
+
+static void
+on_variable_created (const IDebugger::VariableSafePtr a_var,
+                     IDebuggerSafePtr &a_debugger)
+{
+    if (stage == OPTED_OUT_STAGE) {
+        BOOST_REQUIRE (!a_var->is_dynamic ());
+        BOOST_REQUIRE (a_var->visualizer () == "None");
+    } else {
+        BOOST_REQUIRE (a_var->is_dynamic ());
+    }
+    variables.push_back (a_var);
+    a_debugger->unfold_variable
+        (a_var, sigc::bind (&on_variable_unfolded, a_debugger));
+}
+
+static void
+on_stopped_signal (IDebugger::StopReason a_reason,
+                   bool /*a_has_frame*/,
+                   const IDebugger::Frame &/*a_frame*/,
+                   int /*a_thread_id*/,
+                   const string &/*a_bp_num*/,
+                   const UString &/*a_cookie*/,
+                   IDebuggerSafePtr &a_debugger)
+{
+    if (a_reason == IDebugger::EXITED_SIGNALLED
+        || a_reason == IDebugger::EXITED_NORMALLY
+        || a_reason == IDebugger::EXITED
+        || !variables.empty ())
+        return;
+    a_debugger->set_pretty_printing_max_children (MAX_CHILDREN);
+    a_debugger->create_variable
+        ("c", sigc::bind (&on_variable_created, a_debugger));
+}
+
+NEMIVER_API int
+test_main (int argc, char *argv[])
+{
+    NEMIVER_TRY;
+
+    Initializer::do_init ();
+
+    THROW_IF_FAIL (loop);
+
+    if (argc > 1)
+        num_children = atoi (argv[1]);
+    g_setenv ("NMV_FAKE_GDB_NUM_CHILDREN",
+              UString::from_int (num_children).c_str (), TRUE);
+    g_setenv ("NMV_FAKE_GDB_DYNAMIC", "1", TRUE);
+    g_setenv ("NMV_FAKE_GDB_CHILD_COST_US", "200", TRUE);
+
+    IDebuggerSafePtr debugger =
+        debugger_utils::load_debugger_iface_with_confmgr ();
+
+    debugger->set_event_loop_context (loop->get_context ());
+    debugger->set_non_persistent_debugger_path
+                                (NEMIVER_BUILDDIR "/fakegdbmi");
+
+    debugger->engine_died_signal ().connect (&on_engine_died_signal);
+
+    debugger->stopped_signal ().connect
+        (sigc::bind (&on_stopped_signal, debugger));
+
+    // The fake server doesn't look at the program; it just has to
+    // exist for the engine to accept it.
+    std::vector<UString> args, source_search_dir;
+    source_search_dir.push_back (".");
+    debugger->load_program ("fooprog", args, ".",
+                            source_search_dir, "", -1, false);
+    debugger->set_breakpoint ("main");
+    debugger->run ();
+    loop->run ();
+
+    BOOST_REQUIRE (done);
+    std::cout << MAX_CHILDREN << " children: " << limited_cost_ms << "ms\n"
+              << num_children << " children: " << full_cost_ms << "ms"
+              << std::endl;
+    BOOST_REQUIRE (limited_cost_ms < full_cost_ms);
+
+    NEMIVER_CATCH_NOX;
+
+    return 0;
+}
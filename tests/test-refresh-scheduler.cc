@@ -0,0 +1,307 @@
+#include "config.h"
+#include <cstring>
+#include <iostream>
+#include <boost/test/minimal.hpp>
+#include <glibmm/main.h>
+#include "common/nmv-initializer.h"
+#include "common/nmv-safe-ptr-utils.h"
+#include "common/nmv-exception.h"
+#include "nmv-debugger-utils.h"
+#include "nmv-refresh-scheduler.h"
+
+// Emulates the user holding F10 down, with GDBEngine driving the fake
+// GDB/MI server (fakegdbmi), whose every answer takes
+// NMV_FAKE_GDB_LATENCY_MS milliseconds.  Like the repeat of a held
+// key, a timer steps over the inferior 30 times per second, whenever
+// the debugger is ready, as the step action of the perspective is
+// only sensitive then.
+//
+// The panes are emulated too: each refresh lists the frames, then
+// their arguments once the frames are listed, and the local
+// variables, and creates a variable object.
+//
+// This is done twice, for the same time: first refreshing the panes
+// at each stop of the inferior, as the panes used to, then through a
+// RefreshScheduler.  It reports, for both, the number of stops, of
+// refreshes, and of refresh commands answered by GDB.  Once F10 is
+// released and the engine is done, it checks that only listing
+// commands got dropped: every refresh created its variable object.
+//
+// Usage: runtestrefreshscheduler [--check-coalescing] [seconds]
+//
+// With --check-coalescing, the program also fails unless the
+// scheduler sent fewer commands per stop.  That depends on the
+// timing of the machine, so 'make check' doesn't ask for it.
+
+using namespace nemiver;
+using namespace nemiver::common;
+
+static Glib::RefPtr<Glib::MainLoop> loop =
+    Glib::MainLoop::create (Glib::MainContext::get_default ());
+
+// The period of the repeat of a held key, in milliseconds.
+static const unsigned KEY_REPEAT_PERIOD = 33;
+
+static unsigned hold_duration_ms = 1000;
+
+// What happened during a session of holding F10.
+struct Session {
+    unsigned long nb_stops;
+    unsigned long nb_refreshes;
+    unsigned long nb_commands;
+    unsigned long nb_variables_created;
+    bool exited;
+
+    Session () :
+        nb_stops (0),
+        nb_refreshes (0),
+        nb_commands (0),
+        nb_variables_created (0),
+        exited (false)
+    {
+    }
+};
+
+static void
+on_engine_died_signal ()
+{
+    MESSAGE ("engine died");
+    loop->quit ();
+}
+
+// The callbacks are given the session they belong to, as the
+// answers to the last commands of a session can come during the next
+// one.
+
+static void
+on_frames_arguments_listed (const map<int, IDebugger::VariableList> &,
+                            Session *a_session)
+{
+    ++a_session->nb_commands;
+}
+
+static void
+on_frames_listed (const vector<IDebugger::Frame> &a_frames,
+                  IDebuggerSafePtr &a_debugger,
+                  Session *a_session)
+{
+    ++a_session->nb_commands;
+    // As the call stack pane does, list the arguments of the frames
+    // once it knows them.
+    a_debugger->list_frames_arguments
+        (0, (int) a_frames.size () - 1,
+         sigc::bind (&on_frames_arguments_listed, a_session), "");
+}
+
+static void
+on_local_variables_listed (const IDebugger::VariableList &,
+                           Session *a_session)
+{
+    ++a_session->nb_commands;
+}
+
+static void
+on_variable_created (const IDebugger::VariableSafePtr,
+                     Session *a_session)
+{
+    ++a_session->nb_variables_created;
+}
+
+// Refresh the emulated panes for the last stop.
+static void
+on_refresh_signal (IDebugger::StopReason a_reason,
+                   bool /*a_has_frame*/,
+                   const IDebugger::Frame &/*a_frame*/,
+                   int /*a_thread_id*/,
+                   const string &/*a_bp_num*/,
+                   const UString &/*a_cookie*/,
+                   IDebuggerSafePtr &a_debugger,
+                   Session *a_session)
+{
+    if (IDebugger::is_exited (a_reason))
+        return;
+    ++a_session->nb_refreshes;
+    a_debugger->list_frames
+        (0, 19, sigc::bind (&on_frames_listed, a_debugger, a_session), "");
+    a_debugger->list_local_variables
+        (sigc::bind (&on_local_variables_listed, a_session));
+    // Not a mere listing: that one must never be dropped.
+    a_debugger->create_variable
+        ("c", sigc::bind (&on_variable_created, a_session));
+}
+
+static void
+on_stopped_signal (IDebugger::StopReason a_reason,
+                   bool /*a_has_frame*/,
+                   const IDebugger::Frame &/*a_frame*/,
+                   int /*a_thread_id*/,
+                   const string &/*a_bp_num*/,
+                   const UString &/*a_cookie*/,
+                   Session *a_session)
+{
+    if (IDebugger::is_exited (a_reason)) {
+        a_session->exited = true;
+        loop->quit ();
+        return;
+    }
+    ++a_session->nb_stops;
+}
+
+static bool
+on_key_repeat (IDebuggerSafePtr &a_debugger)
+{
+    if (a_debugger->get_state () == IDebugger::READY)
+        a_debugger->step_over ();
+    return true;
+}
+
+static bool
+on_drain_timeout (IDebuggerSafePtr &a_debugger)
+{
+    // The engine is only ready once its command queue is empty.
+    if (a_debugger->get_state () != IDebugger::READY)
+        return true;
+    loop->quit ();
+    return false;
+}
+
+static bool
+on_key_released (IDebuggerSafePtr &a_debugger,
+                 sigc::connection *a_key_repeat)
+{
+    a_key_repeat->disconnect ();
+    Glib::signal_timeout ().connect
+        (sigc::bind (&on_drain_timeout, a_debugger), 10);
+    return false;
+}
+
+/// Hold F10 for hold_duration_ms milliseconds, and fill a_session
+/// with what happened.
+///
+/// \param a_coalesce if true, refresh the panes through a
+/// RefreshScheduler, otherwise at each stop.
+static void
+hold_step_over (bool a_coalesce, Session &a_session)
+{
+    IDebuggerSafePtr debugger =
+        debugger_utils::load_debugger_iface_with_confmgr ();
+
+    debugger->set_event_loop_context (loop->get_context ());
+    debugger->set_non_persistent_debugger_path
+                                (NEMIVER_BUILDDIR "/fakegdbmi");
+    debugger->enable_pretty_printing (false);
+
+    // The engine outlives the session, so its signals must not
+    // reach this session once it's over.
+    list<sigc::connection> connections;
+    connections.push_back (debugger->engine_died_signal ().connect
+                                            (&on_engine_died_signal));
+    connections.push_back (debugger->stopped_signal ().connect
+                           (sigc::bind (&on_stopped_signal, &a_session)));
+
+    // The scheduler doesn't outlive the session, and takes its
+    // connections to the engine with it.
+    SafePtr<RefreshScheduler> scheduler;
+    if (a_coalesce) {
+        scheduler.reset (new RefreshScheduler (debugger));
+        scheduler->stopped_signal ().connect
+            (sigc::bind (&on_refresh_signal, debugger, &a_session));
+    } else {
+        connections.push_back (debugger->stopped_signal ().connect
+                (sigc::bind (&on_refresh_signal, debugger, &a_session)));
+    }
+
+    // The fake server doesn't look at the program; it just has to
+    // exist for the engine to accept it.
+    std::vector<UString> args, source_search_dir;
+    source_search_dir.push_back (".");
+    debugger->load_program ("fooprog", args, ".",
+                            source_search_dir, "", -1, false);
+    debugger->set_breakpoint ("main");
+    debugger->run ();
+
+    sigc::connection key_repeat = Glib::signal_timeout ().connect
+        (sigc::bind (&on_key_repeat, debugger), KEY_REPEAT_PERIOD);
+    Glib::signal_timeout ().connect
+        (sigc::bind (&on_key_released, debugger, &key_repeat),
+         hold_duration_ms);
+    loop->run ();
+    key_repeat.disconnect ();
+
+    if (scheduler) {
+        BOOST_REQUIRE (scheduler->nb_refreshes () == a_session.nb_refreshes);
+        std::cout << scheduler->nb_dropped_commands ()
+                  << " refresh commands dropped by the scheduler"
+                  << std::endl;
+    }
+
+    list<sigc::connection>::iterator it;
+    for (it = connections.begin (); it != connections.end (); ++it)
+        it->disconnect ();
+    debugger->exit_engine ();
+}
+
+static void
+report (const char *a_name, const Session &a_session)
+{
+    std::cout << a_name << ": "
+              << a_session.nb_stops << " stops, "
+              << a_session.nb_refreshes << " refreshes, "
+              << a_session.nb_commands << " refresh commands answered"
+              << std::endl;
+}
+
+NEMIVER_API int
+test_main (int argc, char *argv[])
+{
+    NEMIVER_TRY;
+
+    Initializer::do_init ();
+
+    THROW_IF_FAIL (loop);
+
+    bool check_coalescing = false;
+    for (int i = 1; i < argc; ++i) {
+        if (!strcmp (argv[i], "--check-coalescing"))
+            check_coalescing = true;
+        else
+            hold_duration_ms = atoi (argv[i]) * 1000;
+    }
+
+    // Don't let the inferior exit before F10 is released.
+    g_setenv ("NMV_FAKE_GDB_NUM_STOPS", "1000000", TRUE);
+    g_setenv ("NMV_FAKE_GDB_LATENCY_MS", "2", TRUE);
+
+    Session each_stop, coalesced;
+    hold_step_over (false, each_stop);
+    hold_step_over (true, coalesced);
+
+    report ("refresh at each stop", each_stop);
+    report ("coalesced refreshes", coalesced);
+
+    BOOST_REQUIRE (!each_stop.exited && !coalesced.exited);
+    BOOST_REQUIRE (each_stop.nb_stops > 1 && coalesced.nb_stops > 1);
+    BOOST_REQUIRE (each_stop.nb_refreshes == each_stop.nb_stops);
+    BOOST_REQUIRE (coalesced.nb_refreshes <= coalesced.nb_stops);
+    // Without the scheduler, nothing is marked as a refresh, so
+    // nothing gets dropped: each refresh got its three listings.
+    BOOST_REQUIRE (each_stop.nb_commands == 3 * each_stop.nb_refreshes);
+    BOOST_REQUIRE (coalesced.nb_commands <= 3 * coalesced.nb_refreshes);
+    BOOST_REQUIRE (each_stop.nb_variables_created
+                   == each_stop.nb_refreshes);
+    BOOST_REQUIRE (coalesced.nb_variables_created
+                   == coalesced.nb_refreshes);
+
+    if (check_coalescing) {
+        BOOST_REQUIRE (coalesced.nb_refreshes < coalesced.nb_stops);
+        // Fewer commands per stop, i.e.
+        // coalesced.nb_commands / coalesced.nb_stops
+        //   < each_stop.nb_commands / each_stop.nb_stops
+        BOOST_REQUIRE (coalesced.nb_commands * each_stop.nb_stops
+                       < each_stop.nb_commands * coalesced.nb_stops);
+    }
+
+    NEMIVER_CATCH_NOX;
+
+    return 0;
+}
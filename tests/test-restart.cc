@@ -0,0 +1,141 @@
+#include "config.h"
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <boost/test/minimal.hpp>
+#include <glibmm/timer.h>
+#include "common/nmv-initializer.h"
+#include "common/nmv-safe-ptr-utils.h"
+#include "common/nmv-exception.h"
+#include "nmv-debugger-utils.h"
+
+// Loads a program, then re-loads it the way the debugging
+// perspective does to restart it, with GDBEngine driving the fake
+// GDB/MI server (fakegdbmi), and measures the time from
+// IDebugger::load_program to the program being loaded, in both
+// cases.  The fake server is made to take NMV_FAKE_GDB_STARTUP_MS
+// milliseconds to start, like GDB does while it loads the symbols of
+// a big program; the restart should not pay for that, as it is done
+// by the standby GDB.  The program checks that the restart used the
+// standby GDB, and the first load didn't.
+//
+// Usage: runtestrestart [--max-ms=N] [startup-ms]
+//
+// The latencies are only reported, unless --max-ms is given, in which
+// case the program fails if the restart takes longer than that.
+
+using namespace nemiver;
+using namespace nemiver::common;
+
+static Glib::RefPtr<Glib::MainLoop> loop =
+    Glib::MainLoop::create (Glib::MainContext::get_default ());
+
+static unsigned startup_ms = 500;
+static Glib::Timer load_timer;
+static double load_latency = -1;
+static double restart_latency = -1;
+static bool load_used_standby_gdb = true;
+static bool restart_used_standby_gdb = false;
+
+static void
+on_engine_died_signal ()
+{
+    MESSAGE ("engine died");
+    loop->quit ();
+}
+
+static void
+load_program (IDebuggerSafePtr &a_debugger, bool a_restarting)
+{
+    // The fake server doesn't look at the program; it just has to
+    // exist for the engine to accept it.
+    std::vector<UString> args, source_search_dir;
+    source_search_dir.push_back (".");
+    load_timer.start ();
+    a_debugger->load_program ("fooprog", args, ".",
+                              source_search_dir, "", -1, false,
+                              a_restarting);
+    a_debugger->set_breakpoint ("main");
+}
+
+/// Restart, once the user has been debugging long enough for the
+/// standby GDB, launched once the program was loaded, to be ready.
+static bool
+on_restart_timeout (IDebuggerSafePtr &a_debugger)
+{
+    load_program (a_debugger, /*a_restarting=*/true);
+    return false;
+}
+
+static void
+on_state_changed_signal (IDebugger::State a_state,
+                         IDebuggerSafePtr &a_debugger)
+{
+    if (a_state != IDebugger::INFERIOR_LOADED)
+        return;
+    load_timer.stop ();
+    if (load_latency < 0) {
+        load_latency = load_timer.elapsed ();
+        load_used_standby_gdb = a_debugger->is_using_standby_gdb ();
+        Glib::signal_timeout ().connect
+            (sigc::bind (&on_restart_timeout, a_debugger), 2 * startup_ms);
+    } else if (restart_latency < 0) {
+        restart_latency = load_timer.elapsed ();
+        restart_used_standby_gdb = a_debugger->is_using_standby_gdb ();
+        loop->quit ();
+    }
+}
+
+NEMIVER_API int
+test_main (int argc, char *argv[])
+{
+    NEMIVER_TRY;
+
+    Initializer::do_init ();
+
+    THROW_IF_FAIL (loop);
+
+    double max_ms = -1;
+    for (int i = 1; i < argc; ++i) {
+        if (!strncmp (argv[i], "--max-ms=", 9))
+            max_ms = atof (argv[i] + 9);
+        else
+            startup_ms = atoi (argv[i]);
+    }
+    g_setenv ("NMV_FAKE_GDB_STARTUP_MS",
+              UString::from_int (startup_ms).c_str (), TRUE);
+    g_unsetenv ("NMV_NO_STANDBY_GDB");
+
+    IDebuggerSafePtr debugger =
+        debugger_utils::load_debugger_iface_with_confmgr ();
+
+    debugger->set_event_loop_context (loop->get_context ());
+    debugger->set_non_persistent_debugger_path
+                                (NEMIVER_BUILDDIR "/fakegdbmi");
+    debugger->enable_pretty_printing (false);
+    debugger->set_standby_gdb (true);
+
+    debugger->engine_died_signal ().connect (&on_engine_died_signal);
+
+    debugger->state_changed_signal ().connect
+        (sigc::bind (&on_state_changed_signal, debugger));
+
+    load_program (debugger, /*a_restarting=*/false);
+    loop->run ();
+
+    BOOST_REQUIRE (load_latency >= 0);
+    BOOST_REQUIRE (restart_latency >= 0);
+    // There was no standby GDB yet for the first load, then the
+    // restart must have been done by it.
+    BOOST_REQUIRE (!load_used_standby_gdb);
+    BOOST_REQUIRE (restart_used_standby_gdb);
+    std::cout << "load: " << load_latency * 1000 << "ms\n"
+              << "restart: " << restart_latency * 1000 << "ms"
+              << std::endl;
+    if (max_ms >= 0)
+        BOOST_REQUIRE (restart_latency * 1000 <= max_ms);
+
+    NEMIVER_CATCH_NOX;
+
+    return 0;
+}
@@ -0,0 +1,64 @@
+#include "config.h"
+#include <sstream>
+#include <glib.h>
+#include <boost/test/minimal.hpp>
+#include "common/nmv-initializer.h"
+#include "common/nmv-exception.h"
+#include "common/nmv-scope-logger.h"
+
+using namespace std;
+using namespace nemiver::common;
+
+static void
+leaf ()
+{
+    LOG_SCOPE_NORMAL_D ("leaf", "scope-logger-test-domain");
+    // Take long enough to be measurable.
+    g_usleep (100);
+}
+
+static void
+node (int a_depth)
+{
+    LOG_SCOPE_NORMAL_D ("node", "scope-logger-test-domain");
+    if (a_depth > 0)
+        node (a_depth - 1);
+    leaf ();
+}
+
+NEMIVER_API int
+test_main (int, char **)
+{
+    NEMIVER_TRY;
+
+    Initializer::do_init ();
+
+    // Neither logged nor profiled.
+    BOOST_REQUIRE (!ScopeLogger::is_profiling ());
+    node (1);
+
+    ScopeLogger::start_profiling ();
+    for (int i = 0; i < 10; ++i)
+        node (1);
+    ScopeLogger::stop_profiling ();
+    // Not accounted anymore.
+    node (1);
+
+    ostringstream profile;
+    ScopeLogger::write_profile (profile);
+    // Each call path is a line of the folded stacks, with the
+    // exclusive time of its last scope.
+    string folded = profile.str ();
+    BOOST_REQUIRE (folded.find ("node;leaf ") != string::npos);
+    BOOST_REQUIRE (folded.find ("node;node;leaf ") != string::npos);
+    BOOST_REQUIRE (folded.find ("leaf;") == string::npos);
+
+    ostringstream summary;
+    ScopeLogger::write_profile_summary (summary);
+    // leaf is called twice per call of node (1): once from each node.
+    BOOST_REQUIRE (summary.str ().find ("\n20\t") != string::npos);
+
+    NEMIVER_CATCH_NOX;
+
+    return 0;
+}
@@ -0,0 +1,175 @@
+#include "config.h"
+#include <string>
+#include <vector>
+#include <boost/test/minimal.hpp>
+#include "common/nmv-initializer.h"
+#include "common/nmv-exception.h"
+#include "nmv-source-file-index.h"
+
+// Checks that SourceFileIndex, that the open file dialog uses to
+// browse and look up the source files of the program, keeps only the
+// absolute paths of the files, once each; lists the immediate
+// children of a directory; and looks files up by base name: prefix
+// matches first, then substring matches, then files which base name
+// starts like the query and contains the rest of it in order, case
+// insensitively and within the number of results asked for.
+
+using namespace std;
+using namespace nemiver;
+using namespace nemiver::common;
+
+static const char *FILES[] = {
+    "/src/main.cc",
+    "/src/nmv-dbg-perspective.cc",
+    "/src/nmv-dbg-perspective.h",
+    "/src/persp/nmv-call-stack.cc",
+    "/src/persp/nmv-Memory-View.cc",
+    "/src/persp/dbg/nmv-registers-view.cc",
+    "/src/persp/view.cc",
+    "/usr/include/stdio.h",
+    "/src/main.cc",
+    "relative/file.cc",
+    0
+};
+
+static void
+fill (SourceFileIndex &a_index)
+{
+    vector<UString> files;
+    for (const char **file = FILES; *file; ++file)
+        files.push_back (*file);
+    a_index.set_files ("/bin/prog", files);
+}
+
+static vector<string>
+find (const SourceFileIndex &a_index,
+      const char *a_query,
+      unsigned a_max_results = 100)
+{
+    vector<string> matches;
+    a_index.find (a_query, a_max_results, matches);
+    return matches;
+}
+
+static void
+test_files ()
+{
+    SourceFileIndex index;
+    BOOST_REQUIRE (!index.is_valid_for ("/bin/prog"));
+    fill (index);
+    BOOST_REQUIRE (index.is_valid_for ("/bin/prog"));
+    BOOST_REQUIRE (!index.is_valid_for ("/bin/other"));
+
+    // Sorted, without the duplicate nor the relative path.
+    const vector<string> &files = index.files ();
+    BOOST_REQUIRE (files.size () == 8);
+    BOOST_REQUIRE (files[0] == "/src/main.cc");
+    BOOST_REQUIRE (files[7] == "/usr/include/stdio.h");
+    for (unsigned i = 1; i < files.size (); ++i)
+        BOOST_REQUIRE (files[i - 1] < files[i]);
+
+    index.clear ();
+    BOOST_REQUIRE (!index.is_valid_for ("/bin/prog"));
+    BOOST_REQUIRE (index.files ().empty ());
+    BOOST_REQUIRE (find (index, "main").empty ());
+}
+
+static void
+test_children ()
+{
+    SourceFileIndex index;
+    fill (index);
+
+    vector<SourceFileIndex::Entry> children;
+    index.get_children ("/", children);
+    BOOST_REQUIRE (children.size () == 2);
+    BOOST_REQUIRE (children[0].path == "/src" && children[0].is_dir);
+    BOOST_REQUIRE (children[1].path == "/usr" && children[1].is_dir);
+
+    children.clear ();
+    index.get_children ("/src", children);
+    BOOST_REQUIRE (children.size () == 4);
+    BOOST_REQUIRE (children[0].name == "main.cc" && !children[0].is_dir);
+    BOOST_REQUIRE (children[1].name == "nmv-dbg-perspective.cc");
+    BOOST_REQUIRE (children[2].name == "nmv-dbg-perspective.h");
+    BOOST_REQUIRE (children[3].name == "persp" && children[3].is_dir);
+
+    // The trailing slash doesn't matter.
+    children.clear ();
+    index.get_children ("/src/persp/", children);
+    BOOST_REQUIRE (children.size () == 4);
+    BOOST_REQUIRE (children[0].path == "/src/persp/dbg");
+    BOOST_REQUIRE (children[0].is_dir);
+
+    children.clear ();
+    index.get_children ("/nowhere", children);
+    BOOST_REQUIRE (children.empty ());
+}
+
+static void
+test_find ()
+{
+    SourceFileIndex index;
+    fill (index);
+
+    vector<string> matches = find (index, "nmv-dbg");
+    BOOST_REQUIRE (matches.size () == 2);
+    BOOST_REQUIRE (matches[0] == "/src/nmv-dbg-perspective.cc");
+    BOOST_REQUIRE (matches[1] == "/src/nmv-dbg-perspective.h");
+
+    // Prefix matches come before substring matches.
+    matches = find (index, "view");
+    BOOST_REQUIRE (matches.size () == 3);
+    BOOST_REQUIRE (matches[0] == "/src/persp/view.cc");
+
+    matches = find (index, "ma");
+    BOOST_REQUIRE (matches.size () == 1);
+    BOOST_REQUIRE (matches[0] == "/src/main.cc");
+
+    // Case insensitively.
+    matches = find (index, "MEMORY");
+    BOOST_REQUIRE (matches.size () == 1);
+    BOOST_REQUIRE (matches[0] == "/src/persp/nmv-Memory-View.cc");
+
+    // Then base names that start like the query, and contain the
+    // rest of it in order.
+    matches = find (index, "nmvcall");
+    BOOST_REQUIRE (matches.size () == 1);
+    BOOST_REQUIRE (matches[0] == "/src/persp/nmv-call-stack.cc");
+
+    matches = find (index, "stack");
+    BOOST_REQUIRE (matches.size () == 1);
+    matches = find (index, "nmv-");
+    BOOST_REQUIRE (matches.size () == 5);
+    matches = find (index, "nmv-", 3);
+    BOOST_REQUIRE (matches.size () == 3);
+
+    // No file is returned twice.
+    matches = find (index, "nmv");
+    BOOST_REQUIRE (matches.size () == 5);
+    for (unsigned i = 0; i < matches.size (); ++i)
+        for (unsigned j = i + 1; j < matches.size (); ++j)
+            BOOST_REQUIRE (matches[i] != matches[j]);
+
+    // Too short a query to have trigrams only matches at the start.
+    BOOST_REQUIRE (find (index, "io").empty ());
+
+    BOOST_REQUIRE (find (index, "zzz").empty ());
+    BOOST_REQUIRE (find (index, "").empty ());
+}
+
+NEMIVER_API int
+test_main (int, char **)
+{
+    NEMIVER_TRY;
+
+    Initializer::do_init ();
+
+    test_files ();
+    test_children ();
+    test_find ();
+
+    NEMIVER_CATCH_NOX;
+
+    return 0;
+}
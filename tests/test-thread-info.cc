@@ -0,0 +1,156 @@
+#include "config.h"
+#include <iostream>
+#include <boost/test/minimal.hpp>
+#include <glibmm/timer.h>
+#include "common/nmv-initializer.h"
+#include "common/nmv-safe-ptr-utils.h"
+#include "common/nmv-exception.h"
+#include "nmv-debugger-utils.h"
+
+// Stops the "threads" program while it has a lot of threads alive,
+// and measures how long it takes to get the detailed list of its
+// threads with IDebugger::list_threads_info, compared to getting
+// their bare ids with IDebugger::list_threads.
+//
+// Usage: runtestthreadinfo [number-of-threads]
+
+using namespace nemiver;
+using namespace nemiver::common;
+
+static Glib::RefPtr<Glib::MainLoop> loop =
+    Glib::MainLoop::create (Glib::MainContext::get_default ());
+
+static const int DEFAULT_NUM_THREADS = 2000;
+static int num_parked_threads = DEFAULT_NUM_THREADS;
+static unsigned num_threads_listed = 0;
+static unsigned num_threads_info_listed = 0;
+static Glib::Timer timer;
+
+static void
+on_engine_died_signal ()
+{
+    MESSAGE ("engine died");
+    loop->quit ();
+}
+
+static void
+on_program_finished_signal ()
+{
+    MESSAGE ("program finished");
+    // The parked threads, plus the main thread.
+    BOOST_REQUIRE (num_threads_info_listed
+                   >= (unsigned) num_parked_threads + 1);
+    BOOST_REQUIRE (num_threads_listed == num_threads_info_listed);
+    loop->quit ();
+}
+
+static void
+on_stopped_signal (IDebugger::StopReason a_reason,
+                   bool /*a_has_frame*/,
+                   const IDebugger::Frame &/*a_frame*/,
+                   int /*a_thread_id*/,
+                   const string &/*a_bp_num*/,
+                   const UString &/*a_cookie*/,
+                   IDebuggerSafePtr &a_debugger)
+{
+    if (a_reason == IDebugger::BREAKPOINT_HIT) {
+        timer.start ();
+        a_debugger->list_threads_info ();
+        return;
+    }
+    a_debugger->do_continue ();
+}
+
+static void
+on_threads_info_listed_signal
+                        (const std::list<IDebugger::ThreadInfo> &a_threads,
+                         const UString &/*a_cookie*/,
+                         IDebuggerSafePtr &a_debugger)
+{
+    timer.stop ();
+    num_threads_info_listed = a_threads.size ();
+    std::cout << "-thread-info: " << a_threads.size () << " threads in "
+              << timer.elapsed () << "s" << std::endl;
+
+    unsigned num_with_frame = 0;
+    std::list<IDebugger::ThreadInfo>::const_iterator it;
+    for (it = a_threads.begin (); it != a_threads.end (); ++it) {
+        BOOST_REQUIRE (it->id () > 0);
+        BOOST_REQUIRE (!it->target_id ().empty ());
+        if (it->has_frame ())
+            ++num_with_frame;
+    }
+    BOOST_REQUIRE (num_with_frame == a_threads.size ());
+
+    timer.start ();
+    a_debugger->list_threads ();
+}
+
+static void
+on_threads_listed_signal (const std::list<int> &a_thread_ids,
+                          const UString &/*a_cookie*/,
+                          IDebuggerSafePtr &a_debugger)
+{
+    timer.stop ();
+    num_threads_listed = a_thread_ids.size ();
+    std::cout << "-thread-list-ids: " << a_thread_ids.size ()
+              << " threads in " << timer.elapsed () << "s" << std::endl;
+    a_debugger->do_continue ();
+}
+
+NEMIVER_API int
+test_main (int argc, char *argv[])
+{
+    NEMIVER_TRY;
+
+    Initializer::do_init ();
+
+    THROW_IF_FAIL (loop);
+
+    if (argc > 1)
+        num_parked_threads = atoi (argv[1]);
+    BOOST_REQUIRE (num_parked_threads > 0);
+
+    IDebuggerSafePtr debugger =
+        debugger_utils::load_debugger_iface_with_confmgr ();
+
+    debugger->set_event_loop_context (loop->get_context ());
+
+    //*****************************
+    //<connect to IDebugger events>
+    //*****************************
+
+    debugger->engine_died_signal ().connect (&on_engine_died_signal);
+
+    debugger->program_finished_signal ().connect
+        (&on_program_finished_signal);
+
+    debugger->stopped_signal ().connect
+        (sigc::bind (&on_stopped_signal, debugger));
+
+    debugger->threads_info_listed_signal ().connect
+        (sigc::bind (&on_threads_info_listed_signal, debugger));
+
+    debugger->threads_listed_signal ().connect
+        (sigc::bind (&on_threads_listed_signal, debugger));
+
+    //*****************************
+    //</connect to IDebugger events>
+    //*****************************
+
+    std::vector<UString> args, source_search_dir;
+    args.push_back (UString::from_int (num_parked_threads));
+    debugger->enable_pretty_printing (false);
+    source_search_dir.push_back (".");
+    debugger->load_program ("threads", args, ".",
+                            source_search_dir, "",
+                            false);
+    debugger->set_breakpoint ("all_threads_parked");
+
+    debugger->run ();
+    loop->run ();
+
+    NEMIVER_CATCH_NOX;
+
+    return 0;
+}
@@ -4,6 +4,7 @@
 #include <boost/test/unit_test.hpp>
 #include <glibmm.h>
 #include "common/nmv-ustring.h"
+#include "common/nmv-str-utils.h"
 #include "common/nmv-initializer.h"
 #include "common/nmv-exception.h"
 
@@ -40,6 +41,85 @@ void test_ustring_to_wstring ()
     BOOST_REQUIRE (!wstr.compare (0, wstr.size (), s_wstr));
 }
 
+void test_detect_encoding ()
+{
+    std::string encoding;
+    std::string::size_type bom_size = 0;
+
+    // Plain ASCII, long enough to be scanned word by word.
+    std::string ascii = "int main () {return 0;} // a long enough line";
+    str_utils::detect_buffer_encoding (ascii, encoding, bom_size);
+    BOOST_REQUIRE (encoding == "UTF-8");
+    BOOST_REQUIRE (bom_size == 0);
+
+    // A nul byte makes the buffer invalid UTF-8.
+    std::string with_nul = ascii;
+    with_nul[5] = '\0';
+    BOOST_REQUIRE (!str_utils::is_buffer_valid_utf8 (with_nul.c_str (),
+                                                    with_nul.size ()));
+
+    std::string utf8 = ascii + "// caf\xc3\xa9";
+    str_utils::detect_buffer_encoding (utf8, encoding, bom_size);
+    BOOST_REQUIRE (encoding == "UTF-8");
+
+    str_utils::detect_buffer_encoding ("\xEF\xBB\xBF" + ascii,
+                                       encoding, bom_size);
+    BOOST_REQUIRE (encoding == "UTF-8");
+    BOOST_REQUIRE (bom_size == 3);
+
+    str_utils::detect_buffer_encoding (std::string ("\xFF\xFEi\0", 4),
+                                       encoding, bom_size);
+    BOOST_REQUIRE (encoding == "UTF-16LE");
+    BOOST_REQUIRE (bom_size == 2);
+
+    std::string latin1 = ascii + "// caf\xe9";
+    str_utils::detect_buffer_encoding (latin1, encoding, bom_size);
+    BOOST_REQUIRE (encoding == "ISO-8859-1");
+
+    std::string latin9 = ascii + "// 10\xa4";
+    str_utils::detect_buffer_encoding (latin9, encoding, bom_size);
+    BOOST_REQUIRE (encoding == "ISO-8859-15");
+
+    // 0x93 and 0x94 are curly quotes in WINDOWS-1252.
+    std::string cp1252 = ascii + "// \x93quoted\x94";
+    str_utils::detect_buffer_encoding (cp1252, encoding, bom_size);
+    BOOST_REQUIRE (encoding == "WINDOWS-1252");
+}
+
+void test_ensure_buffer_is_in_utf8 ()
+{
+    std::list<std::string> encodings;
+    UString output;
+    std::string encoding;
+
+    std::string latin1 = "// caf\xe9";
+    BOOST_REQUIRE (str_utils::ensure_buffer_is_in_utf8 (latin1, encodings,
+                                                        "", output,
+                                                        encoding));
+    BOOST_REQUIRE (encoding == "ISO-8859-1");
+    BOOST_REQUIRE (output.raw () == "// caf\xc3\xa9");
+
+    // The known encoding is tried first.
+    BOOST_REQUIRE (str_utils::ensure_buffer_is_in_utf8 (latin1, encodings,
+                                                        "ISO-8859-15",
+                                                        output, encoding));
+    BOOST_REQUIRE (encoding == "ISO-8859-15");
+
+    // Then the encodings listed by the user, in order.
+    encodings.push_back ("UTF-8");
+    encodings.push_back ("WINDOWS-1252");
+    BOOST_REQUIRE (str_utils::ensure_buffer_is_in_utf8 (latin1, encodings,
+                                                        "", output,
+                                                        encoding));
+    BOOST_REQUIRE (encoding == "WINDOWS-1252");
+
+    // The byte order mark is stripped.
+    BOOST_REQUIRE (str_utils::ensure_buffer_is_in_utf8
+                        ("\xEF\xBB\xBF// caf\xc3\xa9", encodings,
+                         "", output, encoding));
+    BOOST_REQUIRE (output.raw () == "// caf\xc3\xa9");
+}
+
 using boost::unit_test::test_suite;
 
 NEMIVER_API test_suite*
@@ -52,6 +132,8 @@ init_unit_test_suite (int /*argc*/, char** /*argv*/)
     test_suite *suite = BOOST_TEST_SUITE ("Unicode tests");
     suite->add (BOOST_TEST_CASE (&test_wstring_to_ustring));
     suite->add (BOOST_TEST_CASE (&test_ustring_to_wstring));
+    suite->add (BOOST_TEST_CASE (&test_detect_encoding));
+    suite->add (BOOST_TEST_CASE (&test_ensure_buffer_is_in_utf8));
     return suite;
 
     NEMIVER_CATCH_NOX
@@ -0,0 +1,188 @@
+#include "config.h"
+#include <iostream>
+#include <boost/test/minimal.hpp>
+#include "common/nmv-initializer.h"
+#include "common/nmv-safe-ptr-utils.h"
+#include "common/nmv-exception.h"
+#include "nmv-debugger-utils.h"
+
+// Lists the changes of variables with GDBEngine driving the fake
+// GDB/MI server (fakegdbmi).  The fake server changes each variable
+// at each stop: its value and its type become the number of the
+// stop, and it gains a child.
+//
+//  - At the first stop, the variables a, b and c are created.
+//  - At the second stop, the changes of a are listed with a single
+//    "-var-update *": only a must be handed to the slot, the changes
+//    of b and c are kept aside.  Then c is deleted.
+//  - At the third stop, the changes of a are listed again, the
+//    changes of b being kept aside a second time.  Then the changes
+//    of b are listed on their own: the two changes kept aside must
+//    reach b, merged.  Those of c must be gone with it.
+
+using namespace nemiver;
+using namespace nemiver::common;
+
+static Glib::RefPtr<Glib::MainLoop> loop =
+    Glib::MainLoop::create (Glib::MainContext::get_default ());
+
+static int nb_stops = 0;
+static IDebugger::VariableList variables;
+static int nb_root_changes_listed = 0;
+static bool done = false;
+
+static void
+on_engine_died_signal ()
+{
+    MESSAGE ("engine died");
+    loop->quit ();
+}
+
+static void
+on_c_changes_listed (const IDebugger::VariableList &a_vars)
+{
+    MESSAGE ("c: " << (int) a_vars.size () << " changes");
+    // The changes of c were dropped with it.
+    BOOST_REQUIRE (a_vars.empty ());
+    done = true;
+    loop->quit ();
+}
+
+static void
+on_b_changes_listed (const IDebugger::VariableList &a_vars,
+                     IDebugger::VariableSafePtr a_c,
+                     IDebuggerSafePtr &a_debugger)
+{
+    MESSAGE ("b: " << (int) a_vars.size () << " changes");
+    // b itself and the two children it gained over two stops.
+    BOOST_REQUIRE (a_vars.size () == 3);
+    IDebugger::VariableSafePtr b = a_vars.front ();
+    BOOST_REQUIRE (b->internal_name () == "var2");
+    BOOST_REQUIRE (b->value () == "2");
+    BOOST_REQUIRE (b->type () == "Container<2>");
+    BOOST_REQUIRE (b->members ().size () == 2);
+    BOOST_REQUIRE (b->members ().front ()->value () == "0");
+    BOOST_REQUIRE (b->members ().back ()->value () == "1");
+    a_debugger->list_changed_variables (a_c, &on_c_changes_listed);
+}
+
+static void
+on_root_changes_listed (const IDebugger::VariableList &a_vars,
+                        const IDebugger::VariableSafePtr a_root)
+{
+    ++nb_root_changes_listed;
+    MESSAGE ("root " << a_root->internal_name () << ": "
+             << (int) a_vars.size () << " changes");
+    // Only the root asked about is handed to the slot, with its own
+    // changes.
+    BOOST_REQUIRE (a_root->internal_name () == "var1");
+    BOOST_REQUIRE (!a_vars.empty ());
+    BOOST_REQUIRE (a_vars.front ()->internal_name () == "var1");
+    BOOST_REQUIRE (a_vars.front ()->value ()
+                   == UString::from_int (nb_stops - 1));
+}
+
+static void
+on_variable_deleted (const IDebugger::VariableSafePtr,
+                     IDebuggerSafePtr &a_debugger)
+{
+    a_debugger->step_over ();
+}
+
+static void
+on_variable_created (const IDebugger::VariableSafePtr a_var,
+                     IDebuggerSafePtr &a_debugger)
+{
+    variables.push_back (a_var);
+    if (variables.size () == 3)
+        a_debugger->step_over ();
+}
+
+static void
+on_stopped_signal (IDebugger::StopReason a_reason,
+                   bool /*a_has_frame*/,
+                   const IDebugger::Frame &/*a_frame*/,
+                   int /*a_thread_id*/,
+                   const string &/*a_bp_num*/,
+                   const UString &/*a_cookie*/,
+                   IDebuggerSafePtr &a_debugger)
+{
+    if (a_reason == IDebugger::EXITED_SIGNALLED
+        || a_reason == IDebugger::EXITED_NORMALLY
+        || a_reason == IDebugger::EXITED) {
+        loop->quit ();
+        return;
+    }
+    ++nb_stops;
+    MESSAGE ("stop " << nb_stops);
+    if (nb_stops == 1) {
+        a_debugger->create_variable
+            ("a", sigc::bind (&on_variable_created, a_debugger));
+        a_debugger->create_variable
+            ("b", sigc::bind (&on_variable_created, a_debugger));
+        a_debugger->create_variable
+            ("c", sigc::bind (&on_variable_created, a_debugger));
+        return;
+    }
+
+    THROW_IF_FAIL (variables.size () == 3);
+    IDebugger::VariableList::const_iterator it = variables.begin ();
+    IDebugger::VariableSafePtr a = *it++;
+    IDebugger::VariableSafePtr b = *it++;
+    IDebugger::VariableSafePtr c = *it;
+
+    IDebugger::VariableList roots;
+    roots.push_back (a);
+    a_debugger->list_changed_variables (roots, &on_root_changes_listed);
+    if (nb_stops == 2) {
+        a_debugger->delete_variable
+            (c, sigc::bind (&on_variable_deleted, a_debugger));
+    } else {
+        a_debugger->list_changed_variables
+            (b, sigc::bind (&on_b_changes_listed, c, a_debugger));
+    }
+}
+
+NEMIVER_API int
+test_main (int, char **)
+{
+    NEMIVER_TRY;
+
+    Initializer::do_init ();
+
+    THROW_IF_FAIL (loop);
+
+    g_setenv ("NMV_FAKE_GDB_NUM_CHILDREN", "0", TRUE);
+    g_setenv ("NMV_FAKE_GDB_VAR_CHANGES", "1", TRUE);
+
+    IDebuggerSafePtr debugger =
+        debugger_utils::load_debugger_iface_with_confmgr ();
+
+    debugger->set_event_loop_context (loop->get_context ());
+    debugger->set_non_persistent_debugger_path
+                                (NEMIVER_BUILDDIR "/fakegdbmi");
+    debugger->enable_pretty_printing (false);
+
+    debugger->engine_died_signal ().connect (&on_engine_died_signal);
+
+    debugger->stopped_signal ().connect
+        (sigc::bind (&on_stopped_signal, debugger));
+
+    // The fake server doesn't look at the program; it just has to
+    // exist for the engine to accept it.
+    std::vector<UString> args, source_search_dir;
+    source_search_dir.push_back (".");
+    debugger->load_program ("fooprog", args, ".",
+                            source_search_dir, "", -1, false);
+    debugger->set_breakpoint ("main");
+    debugger->run ();
+    loop->run ();
+
+    BOOST_REQUIRE (done);
+    BOOST_REQUIRE (nb_stops == 3);
+    BOOST_REQUIRE (nb_root_changes_listed == 2);
+
+    NEMIVER_CATCH_NOX;
+
+    return 0;
+}
@@ -6,6 +6,7 @@
 #include "common/nmv-exception.h"
 #include "nmv-i-var-list.h"
 #include "nmv-debugger-utils.h"
+#include "alloc-counter.h"
 
 using namespace std;
 using namespace nemiver;
@@ -17,6 +18,11 @@ Glib::RefPtr<Glib::MainLoop> s_loop =
 
 IDebugger::Frame s_current_frame;
 
+// The number of allocations when the inferior first stopped, to
+// report how many allocations handling a stop of the inferior costs.
+static unsigned long gv_nb_allocations_at_stop = 0;
+static unsigned long gv_nb_stops = 0;
+
 void test_lookup_variable_in_func3 (IVarListSafePtr &a_var_list);
 
 void
@@ -54,6 +60,11 @@ on_stopped_signal (IDebugger::StopReason a_reason,
 
     if (a_reason == IDebugger::EXITED_NORMALLY) {
         MESSAGE ("program exited normally");
+        if (gv_nb_stops)
+            cout << "allocations/stop: "
+                 << (get_nb_allocations () - gv_nb_allocations_at_stop)
+                    / gv_nb_stops
+                 << endl;
         s_loop->quit ();
         return;
     }
@@ -63,6 +74,8 @@ on_stopped_signal (IDebugger::StopReason a_reason,
         return;
     }
 
+    if (!gv_nb_stops++)
+        gv_nb_allocations_at_stop = get_nb_allocations ();
     s_current_frame = a_frame;
 
     MESSAGE ("stopped in function: '"
@@ -183,6 +196,14 @@ test_main (int /*argc*/, char ** /*argv*/)
 
     Initializer::do_init ();
 
+    // An Object holds its reference count itself: creating one and
+    // handing it to a SafePtr costs a single allocation.
+    unsigned long nb_allocations = get_nb_allocations ();
+    {
+        SafePtr<Object, ObjectRef, ObjectUnref> object (new Object);
+    }
+    BOOST_REQUIRE (get_nb_allocations () - nb_allocations == 1);
+
     //load the IDebugger interface
     IDebuggerSafePtr debugger =
         debugger_utils::load_debugger_iface_with_confmgr ();
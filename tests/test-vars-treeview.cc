@@ -0,0 +1,151 @@
+#include "config.h"
+#include <iostream>
+#include <boost/test/minimal.hpp>
+#include <gtkmm/main.h>
+#include "common/nmv-initializer.h"
+#include "common/nmv-exception.h"
+#include "nmv-vars-treeview.h"
+#include "nmv-variables-utils.h"
+
+// Checks that the rows of the members of a variable shown in a
+// VarsTreeView are only created once the row of the variable gets
+// expanded, with the truncation of their types the variable was set
+// with; and that the index of the rows of the tree view finds the
+// rows of the members once they exist, is used to update them, and
+// forgets them once they are erased.
+//
+// It needs a display; without one, it does nothing.
+
+using namespace std;
+using namespace nemiver;
+using namespace nemiver::common;
+
+namespace vutil = nemiver::variables_utils2;
+
+static const int NB_MEMBERS = 1000;
+
+// Longer than the types that get truncated.
+static const char *LONG_TYPE =
+    "std::map<int, std::string, std::less<int>, "
+    "std::allocator<std::pair<int const, std::string> > >";
+
+static IDebugger::VariableSafePtr
+create_struct ()
+{
+    IDebugger::VariableSafePtr var
+        (new IDebugger::Variable ("var1", "s", "{...}", "struct S"));
+    for (int i = 0; i < NB_MEMBERS; ++i) {
+        UString name = "m" + UString::from_int (i);
+        var->append (IDebugger::VariableSafePtr
+                        (new IDebugger::Variable ("var1." + name,
+                                                  name, "0", LONG_TYPE)));
+    }
+    return var;
+}
+
+static IDebugger::VariableSafePtr
+nth_member (const IDebugger::VariableSafePtr &a_var, int a_index)
+{
+    IDebugger::VariableList::const_iterator it = a_var->members ().begin ();
+    for (int i = 0; i < a_index; ++i)
+        ++it;
+    return *it;
+}
+
+static void
+test_lazy_members ()
+{
+    VarsTreeViewSafePtr view (VarsTreeView::create ());
+    Glib::RefPtr<Gtk::TreeStore> store = view->get_tree_store ();
+    vutil::VariableColumns &columns = vutil::get_variable_columns ();
+
+    IDebugger::VariableSafePtr var = create_struct ();
+    IDebugger::VariableSafePtr member = nth_member (var, 500);
+    Gtk::TreeModel::iterator row_it = store->append ();
+    BOOST_REQUIRE (vutil::set_a_variable (var, *view, row_it, true));
+
+    // Only an empty row, so that the row of the variable can be
+    // expanded; the members have no row yet.
+    BOOST_REQUIRE ((*row_it)[columns.members_pending]);
+    BOOST_REQUIRE (row_it->children ().size () == 1);
+    IDebugger::VariableSafePtr child =
+        (*row_it->children ().begin ())[columns.variable];
+    BOOST_REQUIRE (!child);
+
+    Gtk::TreeModel::iterator found_it;
+    BOOST_REQUIRE (view->find_variable_row (var, found_it));
+    BOOST_REQUIRE (found_it == row_it);
+    BOOST_REQUIRE (!view->find_variable_row (member, found_it));
+
+    // Expanding the row creates the rows of the members, in place of
+    // the empty row.
+    BOOST_REQUIRE (view->expand_row (store->get_path (row_it), false));
+    BOOST_REQUIRE (!(*row_it)[columns.members_pending]);
+    BOOST_REQUIRE ((int) row_it->children ().size () == NB_MEMBERS);
+    child = (*row_it->children ().begin ())[columns.variable];
+    BOOST_REQUIRE (child && child->name () == "m0");
+
+    // Their types are truncated, as the one of the variable would be.
+    BOOST_REQUIRE (view->find_variable_row (member, found_it));
+    child = (*found_it)[columns.variable];
+    BOOST_REQUIRE (child.get () == member.get ());
+    Glib::ustring caption = (*found_it)[columns.type_caption];
+    BOOST_REQUIRE (caption.size () < Glib::ustring (LONG_TYPE).size ());
+    BOOST_REQUIRE (caption.substr (caption.size () - 3) == "...");
+
+    // Expanding it again creates nothing.
+    BOOST_REQUIRE (!vutil::materialize_pending_members (*view, row_it));
+    BOOST_REQUIRE ((int) row_it->children ().size () == NB_MEMBERS);
+
+    // A member is updated in the row the index finds.
+    member->value ("42");
+    BOOST_REQUIRE (vutil::update_a_variable (member, *view, row_it,
+                                             true, false, false));
+    Glib::ustring value = (*found_it)[columns.value];
+    BOOST_REQUIRE (value == "42");
+
+    // Erased rows drop out of the index.
+    store->erase (row_it);
+    BOOST_REQUIRE (!view->find_variable_row (member, found_it));
+    BOOST_REQUIRE (!view->find_variable_row (var, found_it));
+}
+
+static void
+test_untruncated_members ()
+{
+    VarsTreeViewSafePtr view (VarsTreeView::create ());
+    Glib::RefPtr<Gtk::TreeStore> store = view->get_tree_store ();
+    vutil::VariableColumns &columns = vutil::get_variable_columns ();
+
+    // The types of the members of a variable set without truncating
+    // its type are not truncated either.
+    IDebugger::VariableSafePtr var = create_struct ();
+    Gtk::TreeModel::iterator row_it = store->append ();
+    BOOST_REQUIRE (vutil::set_a_variable (var, *view, row_it, false));
+    BOOST_REQUIRE (view->expand_row (store->get_path (row_it), false));
+    BOOST_REQUIRE ((int) row_it->children ().size () == NB_MEMBERS);
+    Glib::ustring caption =
+        (*row_it->children ().begin ())[columns.type_caption];
+    BOOST_REQUIRE (caption == LONG_TYPE);
+}
+
+NEMIVER_API int
+test_main (int argc, char *argv[])
+{
+    NEMIVER_TRY;
+
+    Initializer::do_init ();
+
+    if (!gtk_init_check (&argc, &argv)) {
+        std::cout << "no display, not testing" << std::endl;
+        return 0;
+    }
+    Gtk::Main kit (argc, argv);
+
+    test_lazy_members ();
+    test_untruncated_members ();
+
+    NEMIVER_CATCH_NOX;
+
+    return 0;
+}
@@ -7,6 +7,12 @@
 #include "nmv-i-debugger.h"
 #include "nmv-debugger-utils.h"
 
+// Besides checking that watchpoints trigger, this runs the loop of
+// func4 in fooprog twice: first with a hardware watchpoint on a
+// member of a_person, then with a software watchpoint on the whole
+// of a_person, which is too wide for the debug registers, and
+// reports how long each run took.
+
 using namespace nemiver;
 using namespace nemiver::common;
 
@@ -15,6 +21,12 @@ Glib::RefPtr<Glib::MainLoop> loop =
 
 static int nb_watchpoint_trigger;
 static int nb_watchpoint_out_of_scope;
+static bool is_watching_i;
+static int nb_software_watchpoints_refused;
+static int nb_plans_checked;
+static unsigned run_number;
+static Glib::Timer func4_timer;
+static double func4_duration[2] = {-1, -1};
 
 void
 on_engine_died_signal ()
@@ -24,10 +36,24 @@ on_engine_died_signal ()
 }
 
 void
-on_program_finished_signal ()
+on_program_finished_signal (IDebuggerSafePtr &a_debugger)
 {
     MESSAGE ("program finished");
-    loop->quit ();
+    func4_timer.stop ();
+    if (run_number < 2)
+        func4_duration[run_number] = func4_timer.elapsed ();
+    if (++run_number < 2)
+        a_debugger->run ();
+    else
+        loop->quit ();
+}
+
+void
+on_error_signal (const UString &a_msg)
+{
+    MESSAGE ("error: " << a_msg);
+    if (a_msg.find ("software watchpoint") != UString::npos)
+        ++nb_software_watchpoints_refused;
 }
 
 void
@@ -43,6 +69,17 @@ on_breakpoints_set_signal (const std::map<string, IDebugger::Breakpoint> &a_brea
     }
 }
 
+void
+on_watchpoint_planned (const IDebugger::WatchpointPlan &a_plan,
+                       IDebugger::WatchpointPlan::Mode a_expected_mode)
+{
+    MESSAGE ("watchpoint on " << a_plan.expression () << ": "
+             << (int) a_plan.size () << " bytes, "
+             << (int) a_plan.chunks ().size () << " chunks");
+    BOOST_REQUIRE (a_plan.mode () == a_expected_mode);
+    ++nb_plans_checked;
+}
+
 void
 on_stopped_signal (IDebugger::StopReason a_reason,
                    bool a_has_frame,
@@ -57,16 +94,40 @@ on_stopped_signal (IDebugger::StopReason a_reason,
 
     if (a_reason == IDebugger::BREAKPOINT_HIT
         && a_has_frame
-        && a_frame.function_name () == "func1") {
+        && a_frame.function_name () == "func1"
+        && run_number == 0) {
         a_debugger->set_watchpoint ("i");
+        is_watching_i = true;
+    }
+    if (a_reason == IDebugger::BREAKPOINT_HIT
+        && a_has_frame
+        && a_frame.function_name () == "func4") {
+        if (run_number == 0) {
+            a_debugger->plan_watchpoint
+                ("a_person",
+                 sigc::bind (&on_watchpoint_planned,
+                             IDebugger::WatchpointPlan::SOFTWARE_MODE));
+            a_debugger->plan_watchpoint
+                ("a_person.m_age",
+                 sigc::bind (&on_watchpoint_planned,
+                             IDebugger::WatchpointPlan::HARDWARE_MODE));
+            // Refused, as it would be a software watchpoint.
+            a_debugger->set_watchpoint ("a_person");
+            a_debugger->set_watchpoint ("a_person.m_age");
+        } else {
+            a_debugger->set_watchpoint ("a_person", true, false, "",
+                                        /*a_allow_software=*/true);
+        }
+        func4_timer.start ();
     }
-    if (a_reason == IDebugger::WATCHPOINT_TRIGGER) {
+    if (a_reason == IDebugger::WATCHPOINT_TRIGGER && is_watching_i) {
         MESSAGE ("watchpoint triggered");
         ++nb_watchpoint_trigger;
     }
-    if (a_reason == IDebugger::WATCHPOINT_SCOPE) {
+    if (a_reason == IDebugger::WATCHPOINT_SCOPE && is_watching_i) {
         MESSAGE ("watchpoint gone out of scope");
         ++nb_watchpoint_out_of_scope;
+        is_watching_i = false;
     }
     a_debugger->do_continue ();
 }
@@ -74,6 +135,38 @@ on_stopped_signal (IDebugger::StopReason a_reason,
 NEMIVER_API int
 test_main (int, char **)
 {
+    // The split of objects into chunks the debug registers can
+    // watch.
+    IDebugger::WatchpointPlan plan;
+    debugger_utils::plan_watchpoint (0x1000, 4, 8, 4, plan);
+    BOOST_REQUIRE (plan.mode () == IDebugger::WatchpointPlan::HARDWARE_MODE);
+    BOOST_REQUIRE (plan.chunks ().size () == 1);
+    debugger_utils::plan_watchpoint (0x1006, 12, 8, 4, plan);
+    BOOST_REQUIRE (plan.mode () == IDebugger::WatchpointPlan::HARDWARE_MODE);
+    BOOST_REQUIRE (plan.chunks ().size () == 3);
+    BOOST_REQUIRE (plan.chunks ()[0].address == 0x1006);
+    BOOST_REQUIRE (plan.chunks ()[0].size == 2);
+    BOOST_REQUIRE (plan.chunks ()[1].address == 0x1008);
+    BOOST_REQUIRE (plan.chunks ()[1].size == 8);
+    BOOST_REQUIRE (plan.chunks ()[2].size == 2);
+    debugger_utils::plan_watchpoint (0x1000, 32, 8, 4, plan);
+    BOOST_REQUIRE (plan.mode () == IDebugger::WatchpointPlan::HARDWARE_MODE);
+    debugger_utils::plan_watchpoint (0x1000, 72, 8, 4, plan);
+    BOOST_REQUIRE (plan.mode () == IDebugger::WatchpointPlan::SOFTWARE_MODE);
+    debugger_utils::plan_watchpoint (0x1001, 32, 8, 4, plan);
+    BOOST_REQUIRE (plan.mode () == IDebugger::WatchpointPlan::SOFTWARE_MODE);
+
+    size_t address = 0, size = 0;
+    BOOST_REQUIRE (debugger_utils::parse_watchpoint_extent
+                        ("(char (*)[72]) 0x7fffffffe3a0", address, size));
+    BOOST_REQUIRE (address == 0x7fffffffe3a0 && size == 72);
+    BOOST_REQUIRE (debugger_utils::parse_watchpoint_extent
+                        ("(char (*)[4]) 0x601040 <i>", address, size));
+    BOOST_REQUIRE (address == 0x601040 && size == 4);
+    BOOST_REQUIRE (!debugger_utils::parse_watchpoint_extent
+                        ("Attempt to take address of value not located "
+                         "in memory.", address, size));
+
     NEMIVER_TRY
 
     Initializer::do_init ();
@@ -91,7 +184,9 @@ test_main (int, char **)
     debugger->engine_died_signal ().connect (&on_engine_died_signal);
 
     debugger->program_finished_signal ().connect
-                                            (&on_program_finished_signal);
+                    (sigc::bind (&on_program_finished_signal, debugger));
+
+    debugger->error_signal ().connect (&on_error_signal);
 
     debugger->breakpoints_list_signal ().connect
         (&on_breakpoints_set_signal);
@@ -105,6 +200,7 @@ test_main (int, char **)
                             source_search_dir, "", false);
     debugger->set_breakpoint ("main");
     debugger->set_breakpoint ("func1");
+    debugger->set_breakpoint ("func4");
     debugger->run ();
 
     loop->run ();
@@ -113,6 +209,13 @@ test_main (int, char **)
 
     BOOST_REQUIRE (nb_watchpoint_trigger == 2);
     BOOST_REQUIRE (nb_watchpoint_out_of_scope == 1);
+    BOOST_REQUIRE (nb_plans_checked == 2);
+    BOOST_REQUIRE (nb_software_watchpoints_refused == 1);
+    BOOST_REQUIRE (run_number == 2);
+    std::cout << "func4 with a hardware watchpoint: "
+              << func4_duration[0] * 1000 << "ms\n"
+              << "func4 with a software watchpoint: "
+              << func4_duration[1] * 1000 << "ms" << std::endl;
+    BOOST_REQUIRE (func4_duration[0] < func4_duration[1]);
     return 0;
 }
-
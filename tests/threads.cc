@@ -32,9 +32,70 @@ thread_func (void *arg)
     return NULL;
 }
 
+// When the program is given a number of threads on its command
+// line, it also starts that many threads which stay parked until
+// all of them are started, so that a debugger can stop the program
+// while they are all alive.
+static pthread_mutex_t parked_mutex = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t parked_cond = PTHREAD_COND_INITIALIZER;
+static int num_parked_threads = 0;
+static bool release_parked_threads = false;
+
+void*
+parked_thread_func (void *)
+{
+    pthread_mutex_lock (&parked_mutex);
+    ++num_parked_threads;
+    pthread_cond_broadcast (&parked_cond);
+    while (!release_parked_threads)
+        pthread_cond_wait (&parked_cond, &parked_mutex);
+    pthread_mutex_unlock (&parked_mutex);
+    return NULL;
+}
+
+// Called when all the parked threads are started.  Set a
+// breakpoint here to stop the program with all its threads alive.
+void __attribute__((noinline))
+all_threads_parked (int a_num_threads)
+{
+    __attribute__((unused)) volatile int n = a_num_threads;
+}
+
+static void
+park_threads (int a_num_threads)
+{
+    pthread_t *parked = new pthread_t[a_num_threads];
+    for (int i = 0; i < a_num_threads; ++i) {
+        if (pthread_create (&parked[i], NULL, &parked_thread_func, NULL)) {
+            cerr << "Failed to create parked thread number: "<< i << endl;
+            exit (EXIT_FAILURE);
+        }
+    }
+
+    pthread_mutex_lock (&parked_mutex);
+    while (num_parked_threads < a_num_threads)
+        pthread_cond_wait (&parked_cond, &parked_mutex);
+    pthread_mutex_unlock (&parked_mutex);
+
+    all_threads_parked (a_num_threads);
+
+    pthread_mutex_lock (&parked_mutex);
+    release_parked_threads = true;
+    pthread_cond_broadcast (&parked_cond);
+    pthread_mutex_unlock (&parked_mutex);
+
+    for (int i = 0; i < a_num_threads; ++i) {
+        pthread_join (parked[i], NULL);
+    }
+    delete [] parked;
+}
+
 int
-main ()
+main (int argc, char *argv[])
 {
+    if (argc > 1)
+        park_threads (atoi (argv[1]));
+
     for (int i = 0; i < NUM_THREADS; ++i) {
         threads[i].tnum = i;
         if (pthread_create (&threads[i].tid,